@@ -8,10 +8,10 @@
 #ifndef SYSYC_AST_H
 #define SYSYC_AST_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
-#include <memory>
-#include <variant>
+#include "ASTArena.h"
 
 // 前向声明
 class ASTNode;
@@ -90,6 +90,7 @@ enum class EqOp {
 
 /**
  * @brief AST节点基类
+ * @note 节点由 ASTArena 分配，子节点以裸指针引用
  */
 class ASTNode {
 public:
@@ -105,8 +106,8 @@ public:
  */
 class CompUnitNode : public ASTNode {
 public:
-    std::vector<std::shared_ptr<DeclNode>> decls;        // 全局声明
-    std::vector<std::shared_ptr<FuncDefNode>> funcDefs;  // 函数定义
+    std::vector<DeclNode*> decls;        // 全局声明
+    std::vector<FuncDefNode*> funcDefs;  // 函数定义
 
     CompUnitNode() : ASTNode("CompUnit") {}
 };
@@ -117,6 +118,7 @@ public:
 class DeclNode : public ASTNode {
 public:
     bool isConst = false;
+    uint64_t tokenHash = 0;  // 顶层声明的 token 序列哈希，用作增量编译缓存的键
 
     DeclNode() : ASTNode("Decl") {}
     explicit DeclNode(const std::string& t) : ASTNode(t) {}
@@ -128,7 +130,7 @@ public:
 class ConstDeclNode : public DeclNode {
 public:
     BType bType;
-    std::vector<std::shared_ptr<ConstDefNode>> constDefs;
+    std::vector<ConstDefNode*> constDefs;
 
     ConstDeclNode() : DeclNode("ConstDecl") { isConst = true; }
 };
@@ -139,7 +141,7 @@ public:
 class VarDeclNode : public DeclNode {
 public:
     BType bType;
-    std::vector<std::shared_ptr<VarDefNode>> varDefs;
+    std::vector<VarDefNode*> varDefs;
 
     VarDeclNode() : DeclNode("VarDecl") { isConst = false; }
 };
@@ -150,7 +152,7 @@ public:
 class ConstDefNode : public ASTNode {
 public:
     std::string ident;
-    std::shared_ptr<ExpNode> initVal;  // constInitVal -> constExp -> addExp
+    ExpNode* initVal = nullptr;  // constInitVal -> constExp -> addExp
 
     ConstDefNode() : ASTNode("ConstDef") {}
 };
@@ -161,7 +163,7 @@ public:
 class VarDefNode : public ASTNode {
 public:
     std::string ident;
-    std::shared_ptr<ExpNode> initVal;  // 可选，为nullptr表示没有初始化
+    ExpNode* initVal = nullptr;  // 可选，为nullptr表示没有初始化
 
     VarDefNode() : ASTNode("VarDef") {}
 };
@@ -171,7 +173,7 @@ public:
  */
 class InitValNode : public ASTNode {
 public:
-    std::shared_ptr<ExpNode> exp;
+    ExpNode* exp = nullptr;
 
     InitValNode() : ASTNode("InitVal") {}
 };
@@ -183,8 +185,9 @@ class FuncDefNode : public ASTNode {
 public:
     BType returnType;
     std::string ident;
-    std::vector<std::shared_ptr<FuncFParamNode>> params;
-    std::shared_ptr<BlockNode> block;
+    std::vector<FuncFParamNode*> params;
+    BlockNode* block = nullptr;
+    uint64_t tokenHash = 0;  // 整个函数定义的 token 序列哈希，用作增量编译缓存的键
 
     FuncDefNode() : ASTNode("FuncDef") {}
 };
@@ -205,7 +208,7 @@ public:
  */
 class BlockNode : public ASTNode {
 public:
-    std::vector<std::shared_ptr<BlockItemNode>> items;
+    std::vector<BlockItemNode*> items;
 
     BlockNode() : ASTNode("Block") {}
 };
@@ -215,8 +218,8 @@ public:
  */
 class BlockItemNode : public ASTNode {
 public:
-    std::shared_ptr<DeclNode> decl;  // 声明
-    std::shared_ptr<StmtNode> stmt;  // 语句
+    DeclNode* decl = nullptr;  // 声明
+    StmtNode* stmt = nullptr;  // 语句
 
     BlockItemNode() : ASTNode("BlockItem") {}
 };
@@ -240,16 +243,16 @@ public:
     StmtType stmtType;
 
     // ASSIGN类型
-    std::shared_ptr<LValNode> lVal;
-    std::shared_ptr<ExpNode> exp;
+    LValNode* lVal = nullptr;
+    ExpNode* exp = nullptr;
 
     // BLOCK类型
-    std::shared_ptr<BlockNode> block;
+    BlockNode* block = nullptr;
 
     // IF类型
-    std::shared_ptr<CondNode> cond;      // 原来写为CondNode
-    std::shared_ptr<StmtNode> thenStmt;
-    std::shared_ptr<StmtNode> elseStmt;  // 可选
+    CondNode* cond = nullptr;      // 原来写为CondNode
+    StmtNode* thenStmt = nullptr;
+    StmtNode* elseStmt = nullptr;  // 可选
 
     // RETURN类型 - 使用exp字段
 
@@ -270,7 +273,7 @@ public:
  */
 class CondNode : public ASTNode {
 public:
-    std::shared_ptr<LOrExpNode> lOrExp;
+    LOrExpNode* lOrExp = nullptr;
 
     CondNode() : ASTNode("Cond") {}
 };
@@ -309,9 +312,9 @@ public:
     };
 
     PrimaryType primaryType;
-    std::shared_ptr<ExpNode> exp;       // PAREN_EXP
-    std::shared_ptr<LValNode> lVal;     // LVAL
-    std::shared_ptr<NumberNode> number; // NUMBER
+    ExpNode* exp = nullptr;       // PAREN_EXP
+    LValNode* lVal = nullptr;     // LVAL
+    NumberNode* number = nullptr; // NUMBER
 
     PrimaryExpNode() : ExpNode("PrimaryExp"), primaryType(PrimaryType::NUMBER) {}
 };
@@ -328,11 +331,11 @@ public:
     };
 
     UnaryType unaryType;
-    std::shared_ptr<PrimaryExpNode> primaryExp; // PRIMARY
-    std::string funcName;                        // FUNC_CALL
-    std::vector<std::shared_ptr<ExpNode>> args; // FUNC_CALL
-    UnaryOp unaryOp;                            // UNARY_OP
-    std::shared_ptr<UnaryExpNode> unaryExp;     // UNARY_OP
+    PrimaryExpNode* primaryExp = nullptr; // PRIMARY
+    std::string funcName;                 // FUNC_CALL
+    std::vector<ExpNode*> args;           // FUNC_CALL
+    UnaryOp unaryOp;                      // UNARY_OP
+    UnaryExpNode* unaryExp = nullptr;     // UNARY_OP
 
     UnaryExpNode() : ExpNode("UnaryExp"), unaryType(UnaryType::PRIMARY) {}
 };
@@ -342,9 +345,9 @@ public:
  */
 class MulExpNode : public ExpNode {
 public:
-    std::shared_ptr<MulExpNode> left;   // 左操作数（可选）
-    BinaryOp op;                        // 运算符 (MUL, DIV, MOD)
-    std::shared_ptr<UnaryExpNode> right; // 右操作数或单独的unaryExp
+    MulExpNode* left = nullptr;     // 左操作数（可选）
+    BinaryOp op;                    // 运算符 (MUL, DIV, MOD)
+    UnaryExpNode* right = nullptr;  // 右操作数或单独的unaryExp
 
     MulExpNode() : ExpNode("MulExp"), op(BinaryOp::MUL) {}
 };
@@ -354,9 +357,9 @@ public:
  */
 class AddExpNode : public ExpNode {
 public:
-    std::shared_ptr<AddExpNode> left;   // 左操作数（可选）
-    BinaryOp op;                        // 运算符 (ADD, SUB)
-    std::shared_ptr<MulExpNode> right;  // 右操作数或单独的mulExp
+    AddExpNode* left = nullptr;     // 左操作数（可选）
+    BinaryOp op;                    // 运算符 (ADD, SUB)
+    MulExpNode* right = nullptr;    // 右操作数或单独的mulExp
 
     AddExpNode() : ExpNode("AddExp"), op(BinaryOp::ADD) {}
 };
@@ -366,9 +369,9 @@ public:
  */
 class RelExpNode : public ExpNode {
 public:
-    std::shared_ptr<RelExpNode> left;   // 左操作数（可选）
-    RelOp op;                           // 关系运算符
-    std::shared_ptr<AddExpNode> right;  // 右操作数或单独的addExp
+    RelExpNode* left = nullptr;     // 左操作数（可选）
+    RelOp op;                       // 关系运算符
+    AddExpNode* right = nullptr;    // 右操作数或单独的addExp
 
     RelExpNode() : ExpNode("RelExp"), op(RelOp::LT) {}
 };
@@ -378,9 +381,9 @@ public:
  */
 class EqExpNode : public ExpNode {
 public:
-    std::shared_ptr<EqExpNode> left;    // 左操作数（可选）
-    EqOp op;                            // 相等运算符
-    std::shared_ptr<RelExpNode> right;  // 右操作数或单独的relExp
+    EqExpNode* left = nullptr;      // 左操作数（可选）
+    EqOp op;                        // 相等运算符
+    RelExpNode* right = nullptr;    // 右操作数或单独的relExp
 
     EqExpNode() : ExpNode("EqExp"), op(EqOp::EQ) {}
 };
@@ -390,8 +393,8 @@ public:
  */
 class LAndExpNode : public ExpNode {
 public:
-    std::shared_ptr<LAndExpNode> left;  // 左操作数（可选）
-    std::shared_ptr<EqExpNode> right;   // 右操作数或单独的eqExp
+    LAndExpNode* left = nullptr;    // 左操作数（可选）
+    EqExpNode* right = nullptr;     // 右操作数或单独的eqExp
 
     LAndExpNode() : ExpNode("LAndExp") {}
 };
@@ -401,8 +404,8 @@ public:
  */
 class LOrExpNode : public ExpNode {
 public:
-    std::shared_ptr<LOrExpNode> left;   // 左操作数（可选）
-    std::shared_ptr<LAndExpNode> right; // 右操作数或单独的lAndExp
+    LOrExpNode* left = nullptr;     // 左操作数（可选）
+    LAndExpNode* right = nullptr;   // 右操作数或单独的lAndExp
 
     LOrExpNode() : ExpNode("LOrExp") {}
 };
@@ -0,0 +1,60 @@
+/*!
+ * @file ASTArena.h
+ * @brief 抽象语法树节点的bump分配器
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_ASTARENA_H
+#define SYSYC_ASTARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+class ASTNode;
+
+/**
+ * @brief 一次编译使用的AST内存池
+ *
+ * 节点从大块内存中顺序切分，节点之间以裸指针相互引用，
+ * 析构时统一调用各节点的析构函数并整体释放内存。
+ */
+class ASTArena {
+public:
+    ASTArena() = default;
+    ~ASTArena();
+
+    ASTArena(const ASTArena&) = delete;
+    ASTArena& operator=(const ASTArena&) = delete;
+
+    /**
+     * @brief 在池中构造一个节点
+     * @return T* 节点指针，生命周期与内存池相同
+     */
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        T* node = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        nodes.push_back(node);
+        return node;
+    }
+
+    /**
+     * @brief 已分配的节点数
+     */
+    size_t size() const { return nodes.size(); }
+
+private:
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* cur = nullptr;
+    size_t left = 0;
+    std::vector<ASTNode*> nodes;     // 用于析构
+
+    void* allocate(size_t size, size_t align);
+};
+
+#endif // SYSYC_ASTARENA_H
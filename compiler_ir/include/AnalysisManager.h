@@ -0,0 +1,48 @@
+/*!
+ * @file AnalysisManager.h
+ * @brief 按函数缓存的CFG分析结果
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_ANALYSISMANAGER_H
+#define SYSYC_ANALYSISMANAGER_H
+
+#include "Dominators.h"
+#include "LoopInfo.h"
+
+#include <memory>
+#include <unordered_map>
+
+class Function;
+
+/**
+ * @brief 按函数缓存支配树（含逆后序）与循环信息
+ *
+ * 分析在第一次请求时计算，之后直接复用；修改了CFG的遍运行后由
+ * PassManager 调用 invalidate 丢弃该函数的结果。只改指令、不改前驱/后继
+ * 的遍（Pass::preserves_cfg）不会使缓存失效。
+ */
+class AnalysisManager {
+public:
+    const Dominators &get_dominators(Function *f);
+
+    const LoopInfo &get_loop_info(Function *f);
+
+    /**
+     * @brief 丢弃函数 f 的全部分析结果
+     */
+    void invalidate(Function *f) { cache_.erase(f); }
+
+    void clear() { cache_.clear(); }
+
+private:
+    struct Entry {
+        std::unique_ptr<Dominators> dom;
+        std::unique_ptr<LoopInfo> loops;   //!< 依赖 dom，随之一起失效
+    };
+
+    std::unordered_map<Function *, Entry> cache_;
+};
+
+#endif // SYSYC_ANALYSISMANAGER_H
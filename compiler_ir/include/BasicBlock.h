@@ -31,7 +31,7 @@ class BasicBlock : public Value {
 private:
     std::list<BasicBlock *> pre_bbs_;     //!<  pre basic blocks
     std::list<BasicBlock *> succ_bbs_;    //!<  subsequence basic blocks
-    std::list<Instruction *> instr_list_; //!<  instruction in basic block
+    InstrList instr_list_;                //!<  instruction in basic block
     Function *parent_;                    //!<  belong to which function
     bool _fake;                           //!<  is fake basicblock
 
@@ -47,6 +47,16 @@ public:
     explicit BasicBlock(Module *m, const std::string &name, Function *parent,
                         bool fake);
 
+    /// 基本块单独成池
+    static void *operator new(std::size_t size, Module *m);
+
+    static void operator delete(void *p, Module *m);
+
+protected:
+    static void operator delete(void *) {}
+
+public:
+
     /*!
      *@brief 基本块的创建函数
      *@param m 所从属模块
@@ -61,7 +71,7 @@ public:
     static BasicBlock *create(Module *m, const std::string &name,
                               Function *parent, bool fake = false) {
         auto prefix = name.empty() ? "" : "label_";
-        return new BasicBlock(m, prefix + name, parent, fake);
+        return new (m) BasicBlock(m, prefix + name, parent, fake);
     }
 
     /*!
@@ -286,8 +296,9 @@ public:
      *@return 指令指针链表引用
      *@note
      *----------
+     *侵入式链表，遍历时不要删除当前指令
      */
-    std::list<Instruction *> &get_instructions() { return instr_list_; }
+    InstrList &get_instructions() { return instr_list_; }
 
     /*!
      *@brief 将基本块从从属的函数中删除
@@ -303,7 +314,7 @@ public:
      *----------
      *return parent, or null if none.
      */
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 };
 
 #endif
@@ -0,0 +1,40 @@
+/*!
+ * @file Cloning.h
+ * @brief 函数体克隆与调用点内联
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_CLONING_H
+#define SYSYC_CLONING_H
+
+#include "ValueMap.h"
+
+#include <vector>
+
+class BasicBlock;
+class CallInst;
+class Function;
+
+/**
+ * @brief 把 from 的全部基本块复制到 into 的末尾
+ *
+ * 每条指令以 deepcopy 复制后统一用 vmap 做一次 transplant，
+ * 操作数中的参数、基本块与指令都换成对应的副本；前驱/后继链按映射重建。
+ * 调用前可先在 vmap 中登记参数的替换值（内联时为实参）。
+ *
+ * @param vmap 旧值 -> 新值，复制出的基本块与指令也登记在其中
+ * @return 按原顺序排列的新基本块，第一个对应 from 的入口块
+ */
+std::vector<BasicBlock *> clone_function_body(Function *from, Function *into, ValueMap &vmap);
+
+/**
+ * @brief 把调用点替换为被调函数体的副本
+ *
+ * 调用所在块在调用处一分为二，调用前的部分跳到副本入口，副本中的 return
+ * 都改为跳到后半块；多个返回值在后半块开头以phi汇合。副本入口块中的
+ * alloca 移到调用者入口块。被调函数须有函数体，且入口块没有前驱。
+ */
+void inline_call(CallInst *call);
+
+#endif // SYSYC_CLONING_H
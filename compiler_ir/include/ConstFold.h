@@ -0,0 +1,40 @@
+/*!
+ * @file ConstFold.h
+ * @brief 常量折叠与传播
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_CONSTFOLD_H
+#define SYSYC_CONSTFOLD_H
+
+#include "PassManager.h"
+
+class Instruction;
+
+class Value;
+
+/**
+ * @brief 常量折叠与传播
+ *
+ * 操作数都是整数常量的 BinaryInst / CmpInst 用 calculate() 求值，zext 与
+ * sitofp 直接换算，再经 replace_all_use_with 把结果传播给所有使用者；
+ * 使用者重新进入工作表，因此一条常量链一次即可折叠完。
+ * 同时化简 x+0、x*1、x*0、x-x 等恒等式，以及各来源取值相同的phi。
+ */
+class ConstFold : public FunctionPass {
+public:
+    const char *get_name() const override { return "constfold"; }
+
+    bool preserves_cfg() const override { return true; }
+
+    bool run_on_function(Function *f) override;
+
+    /**
+     * @brief 求指令的折叠结果
+     * @return 可替换该指令的值；不能折叠时为空
+     */
+    static Value *fold(Instruction *instr);
+};
+
+#endif // SYSYC_CONSTFOLD_H
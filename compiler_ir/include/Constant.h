@@ -12,6 +12,9 @@
 #include "User.h"
 #include "Value.h"
 
+#include <cstdint>
+#include <vector>
+
 /*!
  *@brief 常量基类
  *constant variable
@@ -28,7 +31,7 @@ public:
      *constant variable
      */
     Constant(Type *ty, const std::string &name = "", unsigned num_ops = 0)
-            : User(ty, name, num_ops) {}
+            : User(ty, name, num_ops) { shared_ = true; }
 
     /*!
      *@brief 常量基类析构函数
@@ -73,6 +76,7 @@ public:
      *@param val 常量值
      *@param m 所属模块
      *@return 常量类对象指针
+     *@note 同一模块内相同的值返回同一对象，可按指针比较
      */
     static ConstantInt *get(int val, Module *m);
 
@@ -86,9 +90,9 @@ public:
 
     /*!
      *@brief 打印常量类变量
-     *@return 字符串
+     *@param os 输出流
      */
-    std::string print() override;
+    void print(std::ostream &os) override;
 };
 
 class ConstantFP : public Constant {
@@ -102,26 +106,42 @@ public:
 
     float get_value() const { return value_; }
 
+    /// 同一模块内按位相同的值返回同一对象
     static ConstantFP *get(float val, Module *m);
 
-    std::string print() override;
+    void print(std::ostream &os) override;
 };
 
 /*!
  *@brief 常量数组
  *constant int array
+ *
+ *全部标量按行优先展开，以 32 位位模式存放在一块连续内存中，
+ *多维形状由 ArrayType 给出，不再为每个元素单独创建常量对象。
+ *get_element_value 返回的子数组是指向父数组存储的视图。
  */
 class ConstantArray : public Constant {
 private:
-    std::vector<Constant *> const_array; ///! 常量数组
+    Type *scalar_type_;                 ///< 最内层元素类型（i32/float/i1）
+    std::vector<uint32_t> storage_;     ///< 自有的标量存储，子数组视图为空
+    const uint32_t *data_;              ///< 指向 storage_ 或父数组存储中的一段
+    size_t num_scalars_;                ///< 标量总数
+    std::vector<ConstantArray *> rows_; ///< 按需创建的子数组视图
+
     /*!
-     *@brief 常量整数类构造函数
+     *@brief 常量数组构造函数
      *@param ty 常量类型
-     *@param val 常量数值类型数组
-     *@return 自身类对象
+     *@param data 展开后的标量位模式，个数须等于 get_num_scalars(ty)
      *constant int array
      */
-    ConstantArray(ArrayType *ty, const std::vector<Constant *> &val);
+    ConstantArray(ArrayType *ty, std::vector<uint32_t> data);
+
+    /*!
+     *@brief 子数组视图构造函数
+     *@param ty 子数组类型
+     *@param data 父数组存储中本子数组的起始位置
+     */
+    ConstantArray(ArrayType *ty, const uint32_t *data);
 
 public:
     /*!
@@ -133,33 +153,88 @@ public:
     /*!
      *@brief 获取常量数组指定索引的常量数值
      *@param index 索引
-     *@return 常量类指针
+     *@return 标量元素返回唯一化的 ConstantInt/ConstantFP，多维数组返回子数组视图
      *constant int array
      */
     Constant *get_element_value(int index);
 
     /*!
      *@brief 获取常量类数组大小
-     *@return 常量数组大小
+     *@return 常量数组大小（最外一维的元素个数）
      *constant int array
      */
-    unsigned get_size_of_array() { return const_array.size(); }
+    unsigned get_size_of_array() {
+        return static_cast<ArrayType *>(get_type())->get_num_of_elements();
+    }
+
+    /*!
+     *@brief 获取最内层元素类型
+     */
+    Type *get_scalar_type() const { return scalar_type_; }
+
+    /*!
+     *@brief 获取展开后的标量个数
+     */
+    size_t get_num_scalars() const { return num_scalars_; }
+
+    /*!
+     *@brief 获取展开后的标量位模式，整数为补码，浮点为 IEEE 754 单精度
+     */
+    const uint32_t *get_raw_data() const { return data_; }
+
+    /*!
+     *@brief 判断全部元素是否为零
+     */
+    bool is_zero() const;
+
+    /*!
+     *@brief 获取数组类型最内层的元素类型
+     */
+    static Type *get_scalar_type(Type *ty);
+
+    /*!
+     *@brief 获取数组类型展开后的标量个数
+     */
+    static size_t get_num_scalars(Type *ty);
 
     /*!
      *@brief 常量数组类的创建函数
      *@param ty 数组元素的类型
-     *@param val 常量类数组
+     *@param val 常量类数组，元素可以是整数、浮点、零值或子数组常量
      *@return 常量数组类指针
+     *@note 初值个数少于数组长度时其余元素为零
      *constant int array
      */
     static ConstantArray *get(ArrayType *ty, const std::vector<Constant *> &val);
 
+    /*!
+     *@brief 由展开的整数初值创建常量数组
+     *@param ty 数组类型，最内层须为整数类型
+     *@param val 行优先展开的初值，不足部分补零
+     */
+    static ConstantArray *get(ArrayType *ty, const std::vector<int> &val);
+
+    /*!
+     *@brief 由展开的浮点初值创建常量数组
+     *@param ty 数组类型，最内层须为浮点类型
+     *@param val 行优先展开的初值，不足部分补零
+     */
+    static ConstantArray *get(ArrayType *ty, const std::vector<float> &val);
+
+    /*!
+     *@brief 由展开的位模式创建常量数组，不做转换
+     *@param ty 数组类型
+     *@param data 行优先展开的位模式，不足部分补零
+     */
+    static ConstantArray *get_raw(ArrayType *ty, std::vector<uint32_t> data);
+
     /*!
      *@brief 常量数组类打印函数
-     *@return 字符串
+     *@param os 输出流
+     *@note 全零的数组与子数组打印为 zeroinitializer，连续相同的元素只格式化一次
      *constant int array
      */
-    std::string print() override;
+    void print(std::ostream &os) override;
 
     /*!
      *@brief 常量整数类构造函数
@@ -174,28 +249,23 @@ public:
     IntegerList2Constant(const std::vector<int> &dim,
                          const std::vector<int> &init, Module *m) {
         std::vector < Constant * > st;
-        std::vector < Constant * > ost;
-        Type *ty = Type::get_int32_type(m);
-        for (int i: init) {
-            ost.emplace_back(ConstantInt::get(i, m));
+        if (dim.size() <= 1) {
+            for (int i: init) {
+                st.emplace_back(ConstantInt::get(i, m));
+            }
+            return st;
         }
-        int num_group = init.size();
+        Type *ty = Type::get_int32_type(m);
+        size_t group = 1;
         for (int i = (int) dim.size() - 1; i > 0; --i) {
-            num_group /= dim[i];
-            int offset = 0;
             ty = ArrayType::get(ty, dim[i]);
-            for (int gp = 0; gp < num_group; ++gp) {
-                std::vector < Constant * > arr;
-                for (int j = 0; j < dim[i]; ++j) {
-                    arr.push_back(ost[offset + j]);
-                }
-                st.push_back(ConstantArray::get(dynamic_cast<ArrayType *>(ty), arr));
-                offset += dim[i];
-            }
-            ost = st;
-            st.clear();
+            group *= dim[i];
         }
-        return ost;
+        for (size_t offset = 0; offset + group <= init.size(); offset += group) {
+            std::vector<int> arr(init.begin() + offset, init.begin() + offset + group);
+            st.push_back(ConstantArray::get(static_cast<ArrayType *>(ty), arr));
+        }
+        return st;
     };
 };
 
@@ -204,6 +274,9 @@ public:
  */
 class ConstantZero : public Constant {
 private:
+    /// 由 Module::get_constant_zero 唯一化创建
+    friend class Module;
+
     explicit ConstantZero(Type *ty) : Constant(ty, "", 0) {}
 
 public:
@@ -218,10 +291,10 @@ public:
 
     /*!
      *@brief 打印常量零值
-     *@return 字符串
+     *@param os 输出流
      *constant int zero
      */
-    std::string print() override;
+    void print(std::ostream &os) override;
 };
 
 #endif // SYSYC_CONSTANT_H
@@ -0,0 +1,36 @@
+/*!
+ * @file DeadCodeElim.h
+ * @brief 死代码删除
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_DEADCODEELIM_H
+#define SYSYC_DEADCODEELIM_H
+
+#include "PassManager.h"
+
+class Instruction;
+
+/**
+ * @brief 死代码删除
+ *
+ * 删除结果无人使用且没有副作用的指令（store、call、br、ret 之外的指令），
+ * 被删指令的操作数若随之失去所有使用者，也在同一遍中删除。
+ * 只被 store 写入、从未被读取或取地址的 alloca 连同这些 store 一并删除。
+ */
+class DeadCodeElim : public FunctionPass {
+public:
+    const char *get_name() const override { return "dce"; }
+
+    bool preserves_cfg() const override { return true; }
+
+    bool run_on_function(Function *f) override;
+
+    /**
+     * @brief 指令是否有副作用（不能因结果无人使用而删除）
+     */
+    static bool has_side_effect(Instruction *instr);
+};
+
+#endif // SYSYC_DEADCODEELIM_H
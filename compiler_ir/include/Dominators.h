@@ -0,0 +1,73 @@
+/*!
+ * @file Dominators.h
+ * @brief 支配树与支配边界
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_DOMINATORS_H
+#define SYSYC_DOMINATORS_H
+
+#include <unordered_map>
+#include <vector>
+
+class BasicBlock;
+
+class Function;
+
+/**
+ * @brief 函数的支配关系
+ *
+ * 沿 succ_bbs_ 求逆后序，再在 pre_bbs_ 上用 Cooper-Harvey-Kennedy 迭代求直接支配者，
+ * 最后按 Cytron 的方法求支配边界。只覆盖从入口可达的基本块，CFG 改动后需重新构造。
+ */
+class Dominators {
+public:
+    explicit Dominators(Function *f);
+
+    /**
+     * @brief 可达基本块的逆后序，首个元素为入口块
+     */
+    const std::vector<BasicBlock *> &get_rpo() const { return rpo_; }
+
+    bool is_reachable(BasicBlock *bb) const { return index_.count(bb) != 0; }
+
+    /**
+     * @brief 直接支配者；入口块与不可达块为空
+     */
+    BasicBlock *get_idom(BasicBlock *bb) const;
+
+    /**
+     * @brief a 是否支配 b（自身支配自身），O(1)
+     */
+    bool dominates(BasicBlock *a, BasicBlock *b) const;
+
+    /**
+     * @brief 支配树中的子节点
+     */
+    const std::vector<BasicBlock *> &get_children(BasicBlock *bb) const;
+
+    /**
+     * @brief 支配边界
+     */
+    const std::vector<BasicBlock *> &get_frontier(BasicBlock *bb) const;
+
+private:
+    void compute_rpo(BasicBlock *entry);
+
+    void compute_idom();
+
+    void compute_tree();
+
+    void compute_frontier();
+
+    std::unordered_map<BasicBlock *, int> index_;   //!< 基本块在逆后序中的下标
+    std::vector<BasicBlock *> rpo_;
+    std::vector<int> idom_;                         //!< 以逆后序下标表示，入口块指向自身
+    std::vector<std::vector<BasicBlock *>> children_;
+    std::vector<std::vector<BasicBlock *>> frontier_;
+    std::vector<int> tree_in_;                      //!< 支配树先序进入/离开序号，用于 dominates
+    std::vector<int> tree_out_;
+};
+
+#endif // SYSYC_DOMINATORS_H
@@ -10,9 +10,11 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <list>
 #include <map>
+#include <string>
 
 #include "BasicBlock.h"
 #include "Module.h"
@@ -48,7 +50,7 @@ public:
      * @brief Destroy the Function object
      *
      */
-    ~Function();
+    ~Function() = default;
 
     /**
      * @brief 创建函数对象
@@ -133,14 +135,20 @@ public:
      *
      * @note 获取管理的基本块链第一个基本块
      */
-    BasicBlock *get_entry_block() { return *basic_blocks_.begin(); }
+    BasicBlock *get_entry_block() {
+        if (lazy_body_ != kNoLazyBody) materialize();
+        return *basic_blocks_.begin();
+    }
 
     /**
      * @brief Get the basic blocks object，获取基本块链
      *
      * @return std::list<BasicBlock *>& 基本块链的引用
      */
-    std::list<BasicBlock *> &get_basic_blocks() { return basic_blocks_; }
+    std::list<BasicBlock *> &get_basic_blocks() {
+        if (lazy_body_ != kNoLazyBody) materialize();
+        return basic_blocks_;
+    }
 
     /**
      * @brief Get the args object，获取参数列表
@@ -155,7 +163,7 @@ public:
      * @return true 包含基本块
      * @return false 不包含基本块
      */
-    bool is_declaration() { return basic_blocks_.empty(); }
+    bool is_declaration() { return basic_blocks_.empty() && lazy_body_ == kNoLazyBody; }
 
     /**
      * @brief Set the instr name object，为参数和基本块设置名称
@@ -166,15 +174,46 @@ public:
     /**
      * @brief 打印函数
      *
-     * @return std::string 字符串
+     * @param os 输出流
+     * @note 设置了缓存文本的函数直接输出该文本
+     */
+    void print(std::ostream &os);
+
+    /**
+     * @brief 用增量编译缓存中的文本代替函数体
+     *
+     * @param ir 之前编译同一函数时 print 的输出
+     * @note 函数本身不含基本块，对优化遍而言与声明相同
+     */
+    void set_cached_ir(std::string ir) { cached_ir_ = std::move(ir); }
+
+    bool has_cached_ir() const { return !cached_ir_.empty(); }
+
+    /**
+     * @brief 函数体是否还在二进制中间代码文件中、尚未读入
+     */
+    bool is_materializable() const { return lazy_body_ != kNoLazyBody; }
+
+    /**
+     * @brief 标记函数体待读入
+     * @param body 函数体在模块读入器中的序号，见 IRBinaryReader
+     */
+    void set_lazy_body(uint32_t body) { lazy_body_ = body; }
+
+    /**
+     * @brief 读入尚未读入的函数体，已读入时什么也不做
+     * @note 访问基本块的接口会自动调用
      */
-    std::string print();
+    void materialize();
 
 private:
     std::list<BasicBlock *> basic_blocks_; // basic blocks
     std::list<Argument *> arguments_;      // arguments
     Module *parent_;
     unsigned seq_cnt_;
+    std::string cached_ir_;                // 缓存的完整函数文本，为空表示正常打印
+    static constexpr uint32_t kNoLazyBody = 0xffffffffu;
+    uint32_t lazy_body_ = kNoLazyBody;      // 待读入函数体的序号
 
     /**
      * @brief 创建函数参数列表
@@ -226,7 +265,7 @@ public:
      *
      * @return Argument* ，获取新的参数对象指针
      */
-    Argument *deepcopy() { return new Argument(type_, name_, parent_, arg_no_); }
+    Argument *deepcopy() { return new (parent_->get_parent()) Argument(type_, name_, parent_, arg_no_); }
 
     /**
      * @brief Get the arg no object，获取参数列表参数个数
@@ -242,9 +281,9 @@ public:
     /**
      * @brief 打印参数列表
      *
-     * @return std::string 字符串
+     * @param os 输出流
      */
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
 private:
     Function *parent_;
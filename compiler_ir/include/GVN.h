@@ -0,0 +1,31 @@
+/*!
+ * @file GVN.h
+ * @brief 全局值编号（公共子表达式删除）
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_GVN_H
+#define SYSYC_GVN_H
+
+#include "PassManager.h"
+
+/**
+ * @brief 全局值编号（公共子表达式删除）
+ *
+ * 以 (操作码, 比较谓词, 结果类型, 操作数) 为键对无副作用的算术、比较、类型转换
+ * 与 getelementptr 编号，加/乘与相等比较的操作数按交换律规范化。沿支配树先序遍历，
+ * 键已由支配块中的指令定义时用它替换当前指令。
+ * load 只在基本块内复用：同一地址上一次 load 的结果或 store 写入的值可直接使用，
+ * 遇到 call 或写其他地址的 store 时全部作废。
+ */
+class GVN : public FunctionPass {
+public:
+    const char *get_name() const override { return "gvn"; }
+
+    bool preserves_cfg() const override { return true; }
+
+    bool run_on_function(Function *f) override;
+};
+
+#endif // SYSYC_GVN_H
@@ -72,13 +72,13 @@ public:
      *@brief 获取扁平化数组
      *@return 常量扁平化数组
      */
-    std::vector<int> getFlattenInit() const { return _flatten_init_val; }
+    const std::vector<int> &getFlattenInit() const { return _flatten_init_val; }
 
     /*!
      *@brief 打印全局变量
-     *@return 字符串
+     *@param os 输出流
      */
-    std::string print();
+    void print(std::ostream &os);
 };
 
 #endif // SYSYC_GLOBALVARIABLE_H
@@ -0,0 +1,97 @@
+/*!
+ * @file IRArena.h
+ * @brief 中间代码对象的分池内存管理
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_IRARENA_H
+#define SYSYC_IRARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 一个 Module 的IR对象内存池
+ *
+ * Value（指令、基本块、函数、常量、全局量）与 Type 都通过
+ * operator new(size, Module *) 从所属模块的池中分配，按种类分入不同的池，
+ * 使同一基本块内的指令在内存中相邻。池记录每个对象的起始地址，
+ * 析构时统一调用虚析构函数并按块整体释放内存，无需遍历IR图。
+ *
+ * @note 各IR类都是单继承，对象起始地址即其 Value / Type 子对象的地址
+ */
+class IRArena {
+public:
+    /// @brief 对象种类，每种一个独立的池
+    enum Pool {
+        Instructions,
+        BasicBlocks,
+        Values,     // 函数、参数、常量、全局量
+        Types,
+        NumPools
+    };
+
+    IRArena() = default;
+    ~IRArena();
+
+    IRArena(const IRArena &) = delete;
+    IRArena &operator=(const IRArena &) = delete;
+
+    /**
+     * @brief 从指定池中分配一个对象的内存并登记
+     */
+    void *allocate(Pool pool, size_t size);
+
+    /**
+     * @brief 构造函数抛出异常时取消登记（内存随池释放）
+     */
+    void forget(Pool pool, void *p);
+
+    /**
+     * @brief 池中已登记的对象数（含子池）
+     */
+    size_t size(Pool pool) const;
+
+    /**
+     * @brief 作用域内把本线程在该池上的分配转到一个新的子池
+     *
+     * 并行生成函数体时每个任务各用一个子池，分配无需加锁。
+     * 子池归父池所有，其中的对象随父池一起析构。
+     */
+    class Local {
+    public:
+        explicit Local(IRArena &parent);
+        ~Local();
+
+        Local(const Local &) = delete;
+        Local &operator=(const Local &) = delete;
+
+    private:
+        IRArena *saved_parent_;
+        IRArena *saved_child_;
+    };
+
+private:
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    struct Slab {
+        std::vector<std::unique_ptr<char[]>> blocks;
+        char *cur = nullptr;
+        size_t left = 0;
+        std::vector<void *> objects;    // 用于析构
+    };
+
+    Slab pools_[NumPools];
+
+    std::mutex children_mutex_;
+    std::vector<std::unique_ptr<IRArena>> children_;
+
+    /// 本线程当前的重定向：对 redirect_parent_ 的分配改由 redirect_child_ 完成
+    static thread_local IRArena *redirect_parent_;
+    static thread_local IRArena *redirect_child_;
+};
+
+#endif // SYSYC_IRARENA_H
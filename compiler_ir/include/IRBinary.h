@@ -0,0 +1,115 @@
+/*!
+ * @file IRBinary.h
+ * @brief 二进制中间代码格式：写出与按需读入
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_IRBINARY_H
+#define SYSYC_IRBINARY_H
+
+#include "SourceBuffer.h"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Constant;
+class Function;
+class GlobalVariable;
+class Module;
+class Type;
+
+/**
+ * @brief 二进制格式的版本与各记录的约定
+ *
+ * 文件全部由小端 32 位字组成，依次为：
+ *   头部     magic "SYIR"、版本号、各节的字节偏移与文件总字节数
+ *   字符串表 数量，每项 (偏移, 长度)，随后是不带结尾零的字符数据（补齐到 4 字节）
+ *   类型表   按依赖顺序排列，元素类型总在引用它的类型之前
+ *   常量池   整数、浮点（按位）、零初始化与数组常量，数组按行优先直接存放全部标量的位模式
+ *   全局变量 名称、元素类型、是否常量、初值、扁平化初值
+ *   函数表   每个函数定长 5 个字：名称、类型、种类、函数体偏移、函数体字数
+ *   函数体   参数名、基本块（名称、前驱、后继、指令数）与指令数组
+ * 每条指令为 (opcode, 类型, 名称, 附加字, 操作数个数, 操作数...)，操作数的低 3 位
+ * 为种类（函数内指令/参数/基本块/常量/全局变量/函数），其余位为对应表中的序号。
+ * 前 5 节在加载时全部读入，函数体只在第一次被访问时才解码。
+ */
+struct IRBinaryFormat {
+    static constexpr uint32_t kMagic = 0x52495953;   // "SYIR"
+    static constexpr uint32_t kVersion = 2;   // 2: 数组常量改为展开的标量
+    static constexpr uint32_t kNone = 0xffffffffu;   // 无名称或无初值
+
+    enum OperandKind : uint32_t { Instr, Arg, Block, Const, Global, Func, kNumKinds };
+
+    enum ConstKind : uint32_t { Int, FP, Zero, Array };
+
+    enum FuncKind : uint32_t { Declaration, Body, CachedText };
+};
+
+/**
+ * @brief 把模块写成二进制中间代码
+ */
+class IRBinaryWriter {
+public:
+    /**
+     * @brief 写出整个模块；尚未读入的函数体会先被读入
+     * @note 带增量编译缓存文本的函数按文本原样保存
+     */
+    static void write(Module *m, std::ostream &os);
+};
+
+/**
+ * @brief 映射二进制中间代码文件并按需构造函数体
+ *
+ * load 只构造类型、常量、全局变量与函数声明，每个有函数体的函数标记为
+ * 待读入（Function::is_materializable）。之后第一次访问其基本块时由
+ * Function::materialize 调回 materialize，解码这一个函数。读入器由模块持有，
+ * 文件映射在模块析构前一直有效。读入不是线程安全的：并行处理函数前应先
+ * 对每个函数调用一次 materialize。
+ */
+class IRBinaryReader {
+public:
+    /**
+     * @brief 判断数据是否以本格式的 magic 开头
+     */
+    static bool is_binary(std::string_view data);
+
+    /**
+     * @brief 打开文件并构造模块骨架
+     * @throw std::runtime_error 文件无法打开、版本不符或内容损坏
+     */
+    static std::unique_ptr<Module> load(const std::string &path);
+
+    /**
+     * @brief 解码第 body 个函数体到 f 中
+     * @throw std::runtime_error 函数体内容损坏
+     */
+    void materialize(Function *f, uint32_t body);
+
+private:
+    IRBinaryReader() = default;
+
+    struct Cursor;
+
+    SourceBuffer buffer_;
+    std::string_view data_;
+    Module *module_ = nullptr;
+    std::vector<std::string_view> strings_;
+    std::vector<Type *> types_;
+    std::vector<Constant *> consts_;
+    std::vector<GlobalVariable *> globals_;
+    std::vector<Function *> funcs_;
+    std::vector<std::pair<uint32_t, uint32_t>> bodies_;   ///< 函数体的字节偏移与字数
+
+    void read_module();
+
+    std::string name_of(uint32_t index) const;
+
+    Type *type_of(uint32_t index) const;
+};
+
+#endif // SYSYC_IRBINARY_H
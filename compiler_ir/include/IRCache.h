@@ -0,0 +1,62 @@
+/*!
+ * @file IRCache.h
+ * @brief 按函数缓存打印好的中间代码，供增量编译复用
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_IRCACHE_H
+#define SYSYC_IRCACHE_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 磁盘上的函数级IR缓存
+ *
+ * 每个条目是一个文件 <目录>/<16位十六进制键>.ll，内容为 Function::print 的输出。
+ * 键由内容决定（函数的 token 序列、它能看到的全局声明与前面函数的签名、优化等级
+ * 以及 kFormatVersion），因此条目从不需要失效：源码改变后只会算出新的键。写入先写临时文件再改名，
+ * 多个进程或 -j 的多个线程共享同一目录是安全的。
+ */
+class IRCache {
+public:
+    /**
+     * @brief 生成结果的版本，混入每个键
+     * @note 中间代码生成、优化或打印的改动使同一源码得到不同的IR时加一，旧条目随之不再命中
+     */
+    static constexpr uint64_t kFormatVersion = 1;
+
+    /**
+     * @param dir 缓存目录，不存在时创建
+     */
+    explicit IRCache(std::string dir);
+
+    /**
+     * @brief 读取条目
+     * @return 命中返回true，ir 为缓存的函数文本
+     */
+    bool lookup(uint64_t key, std::string& ir) const;
+
+    /**
+     * @brief 写入条目，失败时静默忽略（缓存只是加速手段）
+     */
+    void store(uint64_t key, const std::string& ir) const;
+
+    /**
+     * @brief 把 v 混入哈希 h
+     */
+    static uint64_t combine(uint64_t h, uint64_t v);
+
+    /**
+     * @brief 把字符串混入哈希 h
+     */
+    static uint64_t combine(uint64_t h, const std::string& s);
+
+private:
+    std::string pathOf(uint64_t key) const;
+
+    std::string dir;
+};
+
+#endif // SYSYC_IRCACHE_H
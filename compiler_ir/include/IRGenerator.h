@@ -11,6 +11,9 @@
 #include <string>
 #include <memory>
 #include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "AST.h"
 #include "SymbolTable.h"
@@ -22,13 +25,15 @@
 #include "GlobalVariable.h"
 #include "Constant.h"
 #include "Type.h"
+#include "IRCache.h"
 
 /**
  * @brief IR生成器类 - 访问AST节点并生成LLVM IR
  */
 class IRGenerator {
 private:
-    Module* module;              // 当前模块
+    Module* module;              // 当前模块（由生成器持有，工作生成器只借用）
+    bool ownsModule;
     IRBuilder* builder;          // IR构建器
     SymbolTable symbolTable;     // 符号表
 
@@ -40,8 +45,23 @@ private:
     float tmpFloatVal;
     bool tmpIsFloat;
     bool isConstExpr;            // 是否在计算常量表达式
-
-    // 用于短路求值的基本块
+    std::ostream* diag;          // 语义错误输出流
+    size_t errorCount;           // 已报告的语义错误数
+    int optLevel;                // 优化等级（-O0 / -O1）
+    int jobs;                    // 生成函数体的线程数，<= 0 为硬件并发数
+
+    // 并行生成时所有函数先声明，函数体只能看到源码中在它之前（含自身）的函数
+    std::unordered_map<Value*, size_t> funcOrder;   // 函数 -> 源码中的序号
+    const std::unordered_map<Value*, size_t>* visibleOrder;  // 工作生成器指向父生成器的表
+    size_t funcLimit;                               // 当前函数的序号，SIZE_MAX 表示不限制
+
+    // 增量编译缓存
+    std::unique_ptr<IRCache> cache;    // 未启用时为空
+    uint64_t cacheContext;             // 全局声明与已处理函数签名的哈希
+    std::vector<std::pair<Function*, uint64_t>> cacheMisses;  // 生成结束后写回缓存的函数及其键
+    std::unordered_map<Function*, FuncDefNode*> cacheHits;    // 命中缓存、尚未生成函数体的函数
+
+    // 用于短路求值的基本块，由 visitCondBranch 系列函数沿条件树向下传递
     BasicBlock* trueBB;          // 条件为真时的目标基本块
     BasicBlock* falseBB;         // 条件为假时的目标基本块
 
@@ -60,14 +80,46 @@ public:
     /**
      * @brief 获取生成的Module
      * @return Module* 模块指针
+     * @note 与生成器同生命周期
      */
     Module* getModule() const { return module; }
 
+    /**
+     * @brief 将语义错误输出到指定流（默认std::cerr）
+     */
+    void setDiagnostics(std::ostream& os) { diag = &os; }
+
+    /**
+     * @brief 是否报告过语义错误；有错误时模块不完整，不能再做代码生成或执行
+     */
+    bool hasErrors() const { return errorCount > 0; }
+
+    /**
+     * @brief 设置优化等级，generate 结束前运行对应的优化流水线
+     * @param level 0 不优化（默认），1 为 -O1
+     */
+    void setOptLevel(int level) { optLevel = level; }
+
+    /**
+     * @brief 设置生成函数体的线程数
+     * @param n 1 为顺序生成，<= 0（默认）为硬件并发数
+     * @note 函数足够多时才会并行；结果与线程数无关
+     */
+    void setJobs(int n) { jobs = n; }
+
+    /**
+     * @brief 启用增量编译缓存
+     * @param dir 缓存目录
+     * @note 函数的键由其 token 序列、全部全局声明、之前各函数的签名与优化等级决定；
+     *       命中时直接复用上次打印的函数文本，不再生成函数体
+     */
+    void setCacheDir(const std::string& dir) { cache = std::make_unique<IRCache>(dir); }
+
     /**
      * @brief 生成IR（入口函数）
      * @param ast AST根节点
      */
-    void generate(std::shared_ptr<CompUnitNode> ast);
+    void generate(CompUnitNode* ast);
 
     /**
      * @brief 打印生成的IR
@@ -75,157 +127,228 @@ public:
      */
     std::string print();
 
+    /**
+     * @brief 将生成的IR直接写入输出流
+     * @param os 输出流
+     */
+    void print(std::ostream& os);
+
     // ==================== Visitor函数 ====================
 
     /**
      * @brief 访问编译单元节点
      */
-    void visitCompUnit(std::shared_ptr<CompUnitNode> node);
+    void visitCompUnit(CompUnitNode* node);
 
     /**
      * @brief 访问声明节点
      */
-    void visitDecl(std::shared_ptr<DeclNode> node);
+    void visitDecl(DeclNode* node);
 
     /**
      * @brief 访问常量声明节点
      */
-    void visitConstDecl(std::shared_ptr<ConstDeclNode> node);
+    void visitConstDecl(ConstDeclNode* node);
 
     /**
      * @brief 访问变量声明节点
      */
-    void visitVarDecl(std::shared_ptr<VarDeclNode> node);
+    void visitVarDecl(VarDeclNode* node);
 
     /**
      * @brief 访问常量定义节点
      */
-    void visitConstDef(std::shared_ptr<ConstDefNode> node, BType bType);
+    void visitConstDef(ConstDefNode* node, BType bType);
 
     /**
      * @brief 访问变量定义节点
      */
-    void visitVarDef(std::shared_ptr<VarDefNode> node, BType bType);
+    void visitVarDef(VarDefNode* node, BType bType);
 
     /**
      * @brief 访问函数定义节点
      */
-    void visitFuncDef(std::shared_ptr<FuncDefNode> node);
+    void visitFuncDef(FuncDefNode* node);
 
     /**
      * @brief 访问代码块节点
      */
-    void visitBlock(std::shared_ptr<BlockNode> node);
+    void visitBlock(BlockNode* node);
 
     /**
      * @brief 访问代码块项节点
      */
-    void visitBlockItem(std::shared_ptr<BlockItemNode> node);
+    void visitBlockItem(BlockItemNode* node);
 
     /**
      * @brief 访问语句节点
      */
-    void visitStmt(std::shared_ptr<StmtNode> node);
+    void visitStmt(StmtNode* node);
 
     /**
      * @brief 访问赋值语句
      */
-    void visitAssignStmt(std::shared_ptr<StmtNode> node);
+    void visitAssignStmt(StmtNode* node);
 
     /**
      * @brief 访问表达式语句
      */
-    void visitExpStmt(std::shared_ptr<StmtNode> node);
+    void visitExpStmt(StmtNode* node);
 
     /**
      * @brief 访问块语句
      */
-    void visitBlockStmt(std::shared_ptr<StmtNode> node);
+    void visitBlockStmt(StmtNode* node);
 
     /**
      * @brief 访问if语句
      */
-    void visitIfStmt(std::shared_ptr<StmtNode> node);
+    void visitIfStmt(StmtNode* node);
 
     /**
      * @brief 访问return语句
      */
-    void visitReturnStmt(std::shared_ptr<StmtNode> node);
+    void visitReturnStmt(StmtNode* node);
 
     /**
      * @brief 访问表达式节点（通用入口）
      * @return Value* 表达式的值
      */
-    Value* visitExp(std::shared_ptr<ExpNode> node);
+    Value* visitExp(ExpNode* node);
 
     /**
      * @brief 访问条件表达式节点
      * @return Value* 条件表达式的值
      */
-    Value* visitCond(std::shared_ptr<CondNode> node);
+    Value* visitCond(CondNode* node);
+
+    /**
+     * @brief 把条件翻译为跳转：为真跳到 thenTarget，为假跳到 elseTarget
+     * @note 每个叶子比较直接跳到最终目标，不经过 phi 物化布尔值
+     */
+    void visitCondBranch(CondNode* node, BasicBlock* thenTarget, BasicBlock* elseTarget);
+
+    /**
+     * @brief 逻辑或的跳转翻译，目标为 trueBB/falseBB
+     */
+    void visitCondBranch(LOrExpNode* node);
+
+    /**
+     * @brief 逻辑与的跳转翻译，目标为 trueBB/falseBB
+     */
+    void visitCondBranch(LAndExpNode* node);
+
+    /**
+     * @brief 叶子条件的跳转翻译，目标为 trueBB/falseBB
+     */
+    void visitCondBranch(EqExpNode* node);
 
     /**
      * @brief 访问左值节点
      * @param load 是否加载值（true返回值，false返回地址）
      * @return Value* 左值的值或地址
      */
-    Value* visitLVal(std::shared_ptr<LValNode> node, bool load = true);
+    Value* visitLVal(LValNode* node, bool load = true);
 
     /**
      * @brief 访问数字节点
      * @return Value* 数字常量值
      */
-    Value* visitNumber(std::shared_ptr<NumberNode> node);
+    Value* visitNumber(NumberNode* node);
 
     /**
      * @brief 访问基本表达式节点
      * @return Value* 表达式的值
      */
-    Value* visitPrimaryExp(std::shared_ptr<PrimaryExpNode> node);
+    Value* visitPrimaryExp(PrimaryExpNode* node);
 
     /**
      * @brief 访问一元表达式节点
      * @return Value* 表达式的值
      */
-    Value* visitUnaryExp(std::shared_ptr<UnaryExpNode> node);
+    Value* visitUnaryExp(UnaryExpNode* node);
 
     /**
      * @brief 访问乘法表达式节点
      * @return Value* 表达式的值
      */
-    Value* visitMulExp(std::shared_ptr<MulExpNode> node);
+    Value* visitMulExp(MulExpNode* node);
 
     /**
      * @brief 访问加法表达式节点
      * @return Value* 表达式的值
      */
-    Value* visitAddExp(std::shared_ptr<AddExpNode> node);
+    Value* visitAddExp(AddExpNode* node);
 
     /**
      * @brief 访问关系表达式节点
      * @return Value* 比较结果（i1类型）
      */
-    Value* visitRelExp(std::shared_ptr<RelExpNode> node);
+    Value* visitRelExp(RelExpNode* node);
 
     /**
      * @brief 访问相等表达式节点
      * @return Value* 比较结果（i1类型）
      */
-    Value* visitEqExp(std::shared_ptr<EqExpNode> node);
+    Value* visitEqExp(EqExpNode* node);
 
     /**
      * @brief 访问逻辑与表达式节点
      * @return Value* 逻辑与结果（i1类型）
      */
-    Value* visitLAndExp(std::shared_ptr<LAndExpNode> node);
+    Value* visitLAndExp(LAndExpNode* node);
 
     /**
      * @brief 访问逻辑或表达式节点
      * @return Value* 逻辑或结果（i1类型）
      */
-    Value* visitLOrExp(std::shared_ptr<LOrExpNode> node);
+    Value* visitLOrExp(LOrExpNode* node);
 
 private:
+    /**
+     * @brief 工作生成器：借用 parent 的 Module，复制其全局符号表，
+     *        在线程池上为一批函数生成函数体
+     */
+    explicit IRGenerator(const IRGenerator& parent);
+
+    /**
+     * @brief 创建函数并加入符号表，启用缓存时计算缓存键并查找
+     * @param cacheKey 输出本函数的缓存键
+     * @return 仍需生成函数体的函数；命中缓存时返回nullptr
+     */
+    Function* declareFuncDef(FuncDefNode* node, uint64_t& cacheKey);
+
+    /**
+     * @brief 生成已声明函数的函数体
+     */
+    void lowerFuncBody(FuncDefNode* node, Function* func);
+
+    /**
+     * @brief 函数体生成完毕：无诊断时登记写回缓存，否则转发诊断
+     */
+    void finishFuncDef(Function* func, uint64_t cacheKey, const std::string& errors);
+
+    /**
+     * @brief -O2 时为可能被内联的缓存命中函数补生成函数体
+     * @note 从有函数体的函数出发沿调用传递；补生成的函数仍按缓存文本打印
+     */
+    void lowerCachedCallees();
+
+    /**
+     * @brief 报告一个语义错误：计数并返回已写入 "Error: " 的诊断流
+     */
+    std::ostream& error();
+
+    /**
+     * @brief 先顺序声明全部函数，再在线程池上并行生成函数体
+     */
+    void lowerFuncsInParallel(const std::vector<FuncDefNode*>& funcDefs, int numThreads);
+
+    /**
+     * @brief 查找符号，跳过当前函数之后才定义的函数
+     */
+    SymbolInfo* lookupSymbol(const std::string& name);
+
     // ==================== 辅助函数 ====================
 
     /**
@@ -249,6 +372,11 @@ private:
      */
     void declareRuntimeFunctions();
 
+    /**
+     * @brief 把模块中的基本块、指令和 Use 数量计入 --stats 计数器
+     */
+    void countModule();
+
     /**
      * @brief 将值转换为i32类型（用于条件判断）
      */
@@ -259,15 +387,25 @@ private:
      */
     Value* ensureInt1(Value* val);
 
+    /**
+     * @brief 若相等表达式只是一个一元表达式（可带括号），返回该一元表达式，否则返回nullptr
+     */
+    static UnaryExpNode* soleUnaryExp(EqExpNode* node);
+
+    /**
+     * @brief 剥去只包着单个一元表达式的括号
+     */
+    static UnaryExpNode* stripParens(UnaryExpNode* node);
+
     /**
      * @brief 计算常量表达式的整数值
      */
-    int evalConstInt(std::shared_ptr<ExpNode> node);
+    int evalConstInt(ExpNode* node);
 
     /**
      * @brief 计算常量表达式的浮点值
      */
-    float evalConstFloat(std::shared_ptr<ExpNode> node);
+    float evalConstFloat(ExpNode* node);
 };
 
 #endif // SYSYC_IRGENERATOR_H
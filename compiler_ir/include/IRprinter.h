@@ -30,6 +30,15 @@
  */
 std::string print_as_op(Value *v, bool print_ty);
 
+/*!
+ *@brief 打印operands的名称，直接写入输出流
+ *@param os 输出流
+ *@note
+ *---------
+ *规则同 print_as_op(Value *, bool)，不构造临时字符串
+ */
+void print_as_op(std::ostream &os, Value *v, bool print_ty);
+
 /*!
  *@brief 打印比较operands的名称
  *@return 字符串
@@ -37,4 +46,13 @@ std::string print_as_op(Value *v, bool print_ty);
  *---------
  *
  */
-std::string print_cmp_type(CmpInst::CmpOp op);
+const char *print_cmp_type(CmpInst::CmpOp op);
+
+/*!
+ *@brief 打印浮点比较的谓词名称
+ *@return 字符串
+ *@note
+ *---------
+ *ne 用无序的 une，其余用有序比较，与 C 中浮点比较的语义一致
+ */
+const char *print_fcmp_type(CmpInst::CmpOp op);
@@ -0,0 +1,33 @@
+/*!
+ * @file Inliner.h
+ * @brief 小函数内联
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_INLINER_H
+#define SYSYC_INLINER_H
+
+#include "PassManager.h"
+
+/**
+ * @brief 把小函数的调用点替换为函数体副本
+ *
+ * 代价为被调函数中 phi、alloca 以外的指令条数，每个常量实参抵扣
+ * kConstArgBonus（折叠后还能再缩小）；代价不超过 kThreshold 时内联。
+ * 直接递归的函数不内联；调用者已超过 kMaxCallerSize 条指令后不再向其中内联。
+ * 源语言中函数只能调用在它之前定义的函数，按模块中的顺序处理即为自底向上，
+ * 被调函数在被内联前已经完成了自身的内联。
+ */
+class Inliner : public Pass {
+public:
+    static constexpr int kThreshold = 40;
+    static constexpr int kConstArgBonus = 5;
+    static constexpr int kMaxCallerSize = 2000;
+
+    const char *get_name() const override { return "inline"; }
+
+    bool run(Module *m, AnalysisManager &am) override;
+};
+
+#endif // SYSYC_INLINER_H
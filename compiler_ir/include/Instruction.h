@@ -11,7 +11,9 @@
 #include "BasicBlock.h"
 #include "Type.h"
 #include "User.h"
+#include "ValueMap.h"
 #include "cassert"
+#include <iterator>
 #include <map>
 
 class BasicBlock;
@@ -55,6 +57,16 @@ public:
 
     Instruction(Type *ty, OpID id, unsigned num_ops);
 
+    /// 指令单独成池，同一基本块内的指令在内存中相邻
+    static void *operator new(std::size_t size, Module *m);
+
+    static void operator delete(void *p, Module *m);
+
+protected:
+    static void operator delete(void *) {}
+
+public:
+
     inline const BasicBlock *get_parent() const { return parent_; }
 
     inline BasicBlock *get_parent() { return parent_; }
@@ -87,27 +99,13 @@ public:
     // 创建一个指令的深拷贝
     virtual Instruction *deepcopy(BasicBlock *parent) = 0;
 
-    // 利用map映射替换指令内部所有指针到新值
-    virtual void transplant(std::map<Value *, Value *> ptMap) {
-        // 替换UseList
-        auto it = use_list_.begin();
-        auto ite = use_list_.end();
-        while (it != ite) {
-            auto u = *it;
-            if (ptMap.find(u.val_) != ptMap.end()) {
-                *it = Use(ptMap[u.val_], u.arg_no_);
-            }
-            it++;
-        }
-        // 替换Operands
-        auto it1 = operands_.begin();
-        auto ite1 = operands_.end();
-        while (it1 != ite1) {
-            auto o = *it1;
-            if (ptMap.find(o) != ptMap.end()) {
-                *it1 = ptMap[o];
+    // 利用映射表替换指令内部所有指针到新值，每个操作数只查一次
+    virtual void transplant(const ValueMap &vmap) {
+        // UseList 由各使用者的 set_operand 维护，无需替换
+        for (unsigned i = 0; i < operands_.size(); i++) {
+            if (Value *v = vmap.lookup(operands_[i])) {
+                set_operand(i, v);
             }
-            it1++;
         }
     };
 
@@ -262,21 +260,13 @@ public:
 
     virtual BinaryInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        BinaryInst *newInst = new BinaryInst(type_, op_id_, parent);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+        BinaryInst *newInst = new (type_->get_module()) BinaryInst(type_, op_id_, parent);
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
     int calculate() final;
 
@@ -317,21 +307,13 @@ public:
 
     virtual CmpInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        CmpInst *newInst = new CmpInst(type_, cmp_op_, parent);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+        CmpInst *newInst = new (type_->get_module()) CmpInst(type_, cmp_op_, parent);
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
 private:
     CmpOp cmp_op_;
@@ -352,42 +334,22 @@ public:
 
     FunctionType *get_function_type() const;
 
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
     virtual CallInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        CallInst *newInst = new CallInst(type_, operands_.size(), parent);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+        CallInst *newInst = new (type_->get_module()) CallInst(type_, operands_.size(), parent);
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 
-    virtual void transplant(std::map<Value *, Value *> ptMap) override {
-        // 替换UseList
-        auto it = use_list_.begin();
-        auto ite = use_list_.end();
-        while (it != ite) {
-            auto u = *it;
-            if (ptMap.find(u.val_) != ptMap.end()) {
-                *it = Use(ptMap[u.val_], u.arg_no_);
-            }
-        }
+    virtual void transplant(const ValueMap &vmap) override {
+        // UseList 由各使用者的 set_operand 维护，无需替换
         // 替换Operands，跳过第一个。第一个为函数指针，无需处理
-        auto it1 = operands_.begin();
-        auto ite1 = operands_.end();
-        it1++;
-        while (it1 != ite1) {
-            auto o = *it1;
-            if (ptMap.find(o) != ptMap.end()) {
-                *it1 = ptMap[o];
+        for (unsigned i = 1; i < operands_.size(); i++) {
+            if (Value *v = vmap.lookup(operands_[i])) {
+                set_operand(i, v);
             }
         }
     };
@@ -419,21 +381,13 @@ public:
 
     BasicBlock *getFalseBB() const;
 
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
     virtual BranchInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        BranchInst *newInst = new BranchInst(num_ops_, parent);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+        BranchInst *newInst = new (type_->get_module()) BranchInst(num_ops_, parent);
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 };
@@ -453,21 +407,13 @@ public:
 
     bool is_void_ret() const;
 
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
     virtual ReturnInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        ReturnInst *newInst = new ReturnInst(parent, num_ops_);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+        ReturnInst *newInst = new (type_->get_module()) ReturnInst(parent, num_ops_);
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 };
@@ -488,22 +434,14 @@ public:
 
     Type *get_element_type() const;
 
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
     virtual GetElementPtrInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
         GetElementPtrInst *newInst =
-                new GetElementPtrInst(element_ty_, num_ops_, parent);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+                new (type_->get_module()) GetElementPtrInst(element_ty_, num_ops_, parent);
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 
@@ -524,21 +462,13 @@ public:
 
     Value *get_lval() { return this->get_operand(1); }
 
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
     virtual StoreInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        StoreInst *newInst = new StoreInst(parent);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+        StoreInst *newInst = new (type_->get_module()) StoreInst(parent);
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 };
@@ -557,21 +487,13 @@ public:
 
     Type *get_load_type() const;
 
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
     virtual LoadInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        LoadInst *newInst = new LoadInst(type_, parent);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+        LoadInst *newInst = new (type_->get_module()) LoadInst(type_, parent);
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 };
@@ -585,17 +507,13 @@ public:
 
     Type *get_alloca_type() const;
 
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
     virtual AllocaInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        AllocaInst *newInst = new AllocaInst(alloca_ty_, parent);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        newInst->operands_.clear();
+        AllocaInst *newInst = new (type_->get_module()) AllocaInst(alloca_ty_, parent);
+        // alloca 没有操作数；副本尚无使用者，不复制UseList
+        newInst->copy_operands_from(this);
         return newInst;
     };
 
@@ -605,7 +523,7 @@ public:
 
 private:
     Type *alloca_ty_;
-    bool init;
+    bool init = false;
 };
 
 // 位扩展指令
@@ -621,21 +539,13 @@ public:
 
     Type *get_dest_type() const;
 
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
     virtual ZextInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        ZextInst *newInst = new ZextInst(type_, parent);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+        ZextInst *newInst = new (type_->get_module()) ZextInst(type_, parent);
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 
@@ -651,20 +561,12 @@ private:
 public:
     static SiToFpInst *create_sitofp(Value *val, Type *ty, BasicBlock *bb);
     Type *get_dest_type() const;
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
     virtual SiToFpInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        SiToFpInst *newInst = new SiToFpInst(type_, parent);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+        SiToFpInst *newInst = new (type_->get_module()) SiToFpInst(type_, parent);
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 private:
@@ -679,20 +581,12 @@ private:
 public:
     static FpToSiInst *create_fptosi(Value *val, Type *ty, BasicBlock *bb);
     Type *get_dest_type() const;
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
      virtual FpToSiInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        FpToSiInst *newInst = new FpToSiInst(type_, parent);
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+        FpToSiInst *newInst = new (type_->get_module()) FpToSiInst(type_, parent);
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 private:
@@ -708,7 +602,7 @@ private:
     PhiInst(Type *ty, unsigned num_ops, BasicBlock *bb)
             : Instruction(ty, Instruction::phi, num_ops, bb) {}
 
-    Value *l_val_;
+    Value *l_val_ = nullptr;
 
 public:
     static PhiInst *create_phi(Type *ty, BasicBlock *bb);
@@ -728,52 +622,121 @@ public:
         for (int i = 1; i < (int) get_num_operand(); i += 2) {
             if ((Value *) bb == get_operand(i)) {
                 remove_operands(i - 1, i);
+                i -= 2;
             }
         }
     }
 
-    virtual std::string print() override;
+    virtual void print(std::ostream &os) override;
 
     virtual PhiInst *deepcopy(BasicBlock *parent) override {
         // 复制基本信息
-        PhiInst *newInst = new PhiInst(type_, num_ops_, parent);
+        PhiInst *newInst = new (type_->get_module()) PhiInst(type_, num_ops_, parent);
         newInst->l_val_ = l_val_;
-        // 复制UseList
-        newInst->use_list_.clear();
-        for (auto u: use_list_) {
-            newInst->use_list_.push_back(u);
-        }
-        // 复制Operands
-        newInst->operands_.clear();
-        for (auto o: operands_) {
-            newInst->operands_.push_back(o);
-        }
+        // 复制Operands（副本尚无使用者，不复制UseList）
+        newInst->copy_operands_from(this);
         return newInst;
     };
 
-    virtual void transplant(std::map<Value *, Value *> ptMap) override {
-        // 替换UseList
-        auto it = use_list_.begin();
-        auto ite = use_list_.end();
-        while (it != ite) {
-            auto u = *it;
-            if (ptMap.find(u.val_) != ptMap.end()) {
-                *it = Use(ptMap[u.val_], u.arg_no_);
-            }
+    virtual void transplant(const ValueMap &vmap) override {
+        // 替换Operands（值与来源块）
+        Instruction::transplant(vmap);
+        // 替换lval
+        l_val_ = vmap.map(l_val_);
+    };
+};
+
+/*!
+ *@brief 基本块内的指令链表
+ *
+ *以 Instruction 自带的 _prev_inst/_next_inst 串成侵入式双向链表，
+ *不另外分配链表节点，插入与删除都是 O(1)。一条指令同一时刻只能在一个链表中。
+ */
+class InstrList {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Instruction *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Instruction **;
+        using reference = Instruction *;
+
+        iterator(Instruction *cur, const InstrList *list) : cur_(cur), list_(list) {}
+
+        Instruction *operator*() const { return cur_; }
+
+        iterator &operator++() {
+            cur_ = cur_->getSuccInst();
+            return *this;
         }
-        // 替换Operands
-        auto it1 = operands_.begin();
-        auto ite1 = operands_.end();
-        while (it1 != ite1) {
-            auto o = *it1;
-            if (ptMap.find(o) != ptMap.end()) {
-                *it1 = ptMap[o];
-            }
+
+        iterator &operator--() {
+            cur_ = cur_ ? cur_->getPrevInst() : list_->tail_;
+            return *this;
         }
-        // 替换lval
-        if (ptMap.find(l_val_) != ptMap.end())
-            l_val_ = ptMap[l_val_];
+
+        bool operator==(const iterator &o) const { return cur_ == o.cur_; }
+
+        bool operator!=(const iterator &o) const { return cur_ != o.cur_; }
+
+    private:
+        Instruction *cur_;
+        const InstrList *list_;
     };
+
+    InstrList() = default;
+
+    InstrList(const InstrList &) = delete;
+
+    InstrList &operator=(const InstrList &) = delete;
+
+    iterator begin() const { return iterator(head_, this); }
+
+    iterator end() const { return iterator(nullptr, this); }
+
+    bool empty() const { return head_ == nullptr; }
+
+    size_t size() const { return size_; }
+
+    Instruction *front() const { return head_; }
+
+    Instruction *back() const { return tail_; }
+
+    void push_back(Instruction *instr) { insert(end(), instr); }
+
+    void push_front(Instruction *instr) { insert(begin(), instr); }
+
+    /*!
+     *@brief 在 pos 之前插入指令
+     */
+    void insert(iterator pos, Instruction *instr) {
+        Instruction *next = *pos;
+        Instruction *prev = next ? next->getPrevInst() : tail_;
+        instr->setPrevInst(prev);
+        instr->setSuccInst(next);
+        if (prev) prev->setSuccInst(instr); else head_ = instr;
+        if (next) next->setPrevInst(instr); else tail_ = instr;
+        size_++;
+    }
+
+    /*!
+     *@brief 从链表中摘下指令（须在本链表中）
+     */
+    void remove(Instruction *instr) {
+        Instruction *prev = instr->getPrevInst();
+        Instruction *next = instr->getSuccInst();
+        if (prev) prev->setSuccInst(next); else head_ = next;
+        if (next) next->setPrevInst(prev); else tail_ = prev;
+        instr->setPrevInst(nullptr);
+        instr->setSuccInst(nullptr);
+        size_--;
+    }
+
+private:
+    Instruction *head_ = nullptr;
+    Instruction *tail_ = nullptr;
+    size_t size_ = 0;
 };
 
 #endif // SYSYC_INSTRUCTION_H
@@ -0,0 +1,108 @@
+/*!
+ * @file Interpreter.h
+ * @brief 中间代码解释器：寄存器式字节码与直接线索化分派
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_INTERPRETER_H
+#define SYSYC_INTERPRETER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Function;
+class GlobalVariable;
+class Module;
+
+/**
+ * @brief 在进程内执行模块，代替 lli
+ *
+ * 每个函数在第一次被调用时翻译成字节码：每条指令的操作数都已解析为
+ * 帧内寄存器槽号，常量与全局变量地址放在帧开头的常量槽中，
+ * 调用时整体复制；phi 消去为前驱末尾与本块开头的两段复制。
+ * 执行时每条字节码带有处理代码的地址（computed goto），
+ * 取指后直接跳转，不经过 switch。
+ * IR 调用不在宿主栈上递归：调用者的返回位置与帧基址压入解释器自己的帧栈，
+ * 递归深度只受寄存器栈与 alloca 栈大小的限制。
+ *
+ * 库函数 getint/getch/getarray/putint/putch/putarray 从 set_input/set_output
+ * 设置的流读写，starttime/stoptime 不做任何事。除零、栈溢出或调用没有函数体
+ * 的函数时抛出 std::runtime_error。
+ */
+class Interpreter {
+public:
+    /**
+     * @param m 须已调用 set_print_name（生成IR后即已设置），模块在解释器生命周期内不能修改
+     */
+    explicit Interpreter(Module *m);
+
+    ~Interpreter();
+
+    void set_input(std::istream &in) { in_ = &in; }
+
+    void set_output(std::ostream &out) { out_ = &out; }
+
+    /**
+     * @brief 开启后记录每条字节码的执行次数，供 print_profile 输出
+     */
+    void set_profiling(bool enabled) { profiling_ = enabled; }
+
+    /**
+     * @brief 执行 main
+     * @return main 的返回值，void main 为 0
+     */
+    int run_main();
+
+    /**
+     * @brief 按函数列出每条执行过的中间代码指令及其执行次数
+     */
+    void print_profile(std::ostream &os) const;
+
+    /**
+     * @brief 开启计数以来执行的字节码条数
+     */
+    uint64_t get_executed() const;
+
+private:
+    struct Code;
+
+    union Slot {
+        int32_t i;
+        float f;
+        char *p;
+    };
+
+    Module *module_;
+    std::vector<std::unique_ptr<Code>> code_;
+    std::unordered_map<Function *, int> index_;
+    std::vector<char> globals_;
+    std::unordered_map<GlobalVariable *, char *> global_addr_;
+    std::vector<Slot> regs_;      ///< 所有帧的寄存器槽，按调用深度依次排列，不足时扩大
+    std::vector<char> memory_;    ///< 所有帧的 alloca 空间
+    std::istream *in_ = &std::cin;
+    std::ostream *out_ = &std::cout;
+    bool profiling_ = false;
+
+    void lower(Function *f, Code &code);
+
+    Code &code_of(int func);
+
+    /**
+     * @brief 寄存器栈不足 n 个槽时扩大
+     * @return 超过上限时为 false
+     * @note 扩大后指向 regs_ 的指针失效；alloca 栈不扩大，其中的地址始终有效
+     */
+    bool grow_regs(size_t n);
+
+    template<bool Profile>
+    Slot execute(int func, size_t reg_base, size_t mem_base);
+
+    void call_native(int id, Slot *r, const int32_t *args, Slot &ret);
+};
+
+#endif // SYSYC_INTERPRETER_H
@@ -9,7 +9,9 @@
 #ifndef SYSYC_LEXER_H
 #define SYSYC_LEXER_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <set>
@@ -74,13 +76,14 @@ enum class TokenType {
  */
 struct Token {
     TokenType type;
-    std::string value;
+    std::string_view value;   // 指向源缓冲区（或字符串字面量），不拥有内存
+    uint32_t offset;          // value 在源缓冲区中的字节偏移
     int line;
     int column;
     
-    Token() : type(TokenType::ERROR), value(""), line(0), column(0) {}
-    Token(TokenType t, const std::string& v, int l, int c) 
-        : type(t), value(v), line(l), column(c) {}
+    Token() : type(TokenType::ERROR), value(""), offset(0), line(0), column(0) {}
+    Token(TokenType t, std::string_view v, int l, int c, uint32_t off = 0)
+        : type(t), value(v), offset(off), line(l), column(c) {}
     
     /**
      * @brief 判断Token是否应该输出到结果文件
@@ -136,6 +139,7 @@ struct Token {
      * - KW, OP, SE:      输出 <类型, 编码>
      */
     std::string toString() const {
+        std::string value(this->value);
         std::string typeStr = getTypeString();
         int code = getTypeCode();
         
@@ -189,7 +193,7 @@ private:
     size_t pos;                   // 当前位置
     int line;                     // 当前行号
     int column;                   // 当前列号
-    std::vector<Token> tokens;    // Token序列
+    std::vector<Token> tokens;    // Token序列（value 指向 source）
     std::map<std::string, TokenType> keywords; // 关键字表
     
 public:
@@ -211,6 +215,7 @@ private:
     Token scanNumber();
     Token scanOperator();
     Token scanSeparator();
+    Token sourceToken(TokenType type, size_t start, size_t length, int startLine, int startCol) const;
     bool isAlpha(char c) const { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
     bool isDigit(char c) const { return c >= '0' && c <= '9'; }
     bool isAlnum(char c) const { return isAlpha(c) || isDigit(c) || c == '_'; }
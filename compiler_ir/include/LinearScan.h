@@ -0,0 +1,32 @@
+/*!
+ * @file LinearScan.h
+ * @brief 机器指令的线性扫描寄存器分配
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_LINEARSCAN_H
+#define SYSYC_LINEARSCAN_H
+
+#include "MachineIR.h"
+
+/**
+ * @brief 线性扫描寄存器分配
+ *
+ * 由块级活跃分析得到每个虚拟寄存器的活跃区间（首个定义/入口活跃点到最后
+ * 使用/出口活跃点的包络），按起点排序后依次分配。物理寄存器被指令固定
+ * 使用的区段（传参、返回值、除法、调用破坏）记为占用，与之重叠的区间
+ * 不能分到该寄存器，因此跨调用的值只会落在被调用者保存寄存器或栈上。
+ * 分不到寄存器时溢出结束最晚的区间；溢出值在每条指令前后经 r10/r11
+ * （浮点为 xmm14/xmm15）装入、写回。
+ */
+class LinearScan {
+public:
+    /**
+     * @brief 为 mf 分配寄存器并改写指令，记录用到的被调用者保存寄存器
+     * @return 溢出的虚拟寄存器个数
+     */
+    static int run(MFunction &mf);
+};
+
+#endif // SYSYC_LINEARSCAN_H
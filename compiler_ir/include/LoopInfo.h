@@ -0,0 +1,54 @@
+/*!
+ * @file LoopInfo.h
+ * @brief 自然循环分析
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_LOOPINFO_H
+#define SYSYC_LOOPINFO_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class BasicBlock;
+
+class Dominators;
+
+/**
+ * @brief 一个自然循环
+ */
+struct Loop {
+    BasicBlock *header = nullptr;
+    std::vector<BasicBlock *> latches;   //!< 回边的源块
+    std::vector<BasicBlock *> blocks;    //!< 循环体，含 header；按逆后序排列
+    Loop *parent = nullptr;              //!< 直接外层循环
+    int depth = 1;
+};
+
+/**
+ * @brief 函数的循环嵌套
+ *
+ * 目标支配源的边为回边；同一 header 的回边合并为一个循环，
+ * 循环体是不经过 header 能逆向走到回边源块的所有块。不可达块不属于任何循环。
+ */
+class LoopInfo {
+public:
+    explicit LoopInfo(const Dominators &dom);
+
+    const std::vector<std::unique_ptr<Loop>> &get_loops() const { return loops_; }
+
+    /**
+     * @brief 包含 bb 的最内层循环，不在循环中时为空
+     */
+    Loop *get_loop_for(BasicBlock *bb) const;
+
+    int get_loop_depth(BasicBlock *bb) const;
+
+private:
+    std::vector<std::unique_ptr<Loop>> loops_;   //!< 外层循环在前
+    std::unordered_map<BasicBlock *, Loop *> innermost_;
+};
+
+#endif // SYSYC_LOOPINFO_H
@@ -0,0 +1,182 @@
+/*!
+ * @file MachineIR.h
+ * @brief x86-64 机器指令表示，供指令选择、寄存器分配与汇编输出共用
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_MACHINEIR_H
+#define SYSYC_MACHINEIR_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 物理寄存器编号：0-15 为通用寄存器，16-31 为 xmm0-xmm15
+ *
+ * 虚拟寄存器从 kNumPRegs 开始编号，与物理寄存器共用一个编号空间，
+ * 寄存器分配把操作数里的虚拟寄存器号原地改写为物理寄存器号。
+ */
+enum PReg {
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15,
+    XMM0, XMM1, XMM2, XMM3, XMM4, XMM5, XMM6, XMM7,
+    XMM8, XMM9, XMM10, XMM11, XMM12, XMM13, XMM14, XMM15,
+    kNumPRegs
+};
+
+/// 寄存器类别
+enum class RegClass { GPR, XMM };
+
+inline bool is_vreg(int reg) { return reg >= kNumPRegs; }
+
+inline bool is_xmm(int preg) { return preg >= XMM0 && preg < kNumPRegs; }
+
+/**
+ * @brief 条件码，按 jcc/setcc 的后缀命名
+ */
+enum class Cond { E, NE, L, LE, G, GE, A, AE, B, BE, P, NP };
+
+/**
+ * @brief 取反条件码
+ */
+Cond invert(Cond cc);
+
+/**
+ * @brief 机器操作数
+ */
+struct MOperand {
+    enum Kind {
+        NONE,
+        REG,    ///< 寄存器（虚拟或物理），size 为访问宽度
+        IMM,    ///< 立即数
+        MEM,    ///< 内存：基址 + imm 偏移
+        BLOCK,  ///< 基本块，reg 为块序号
+        FUNC    ///< 函数符号
+    };
+    /// MEM 的基址种类
+    enum Base {
+        BASE_REG,    ///< reg 为基址寄存器
+        BASE_FRAME,  ///< reg 为栈槽号，输出时换算为相对 %rbp 的偏移
+        BASE_SYMBOL  ///< sym 为全局符号，%rip 相对寻址
+    };
+
+    Kind kind = NONE;
+    Base base = BASE_REG;
+    int reg = -1;
+    int size = 4;
+    int64_t imm = 0;
+    std::string sym;
+
+    static MOperand make_reg(int reg, int size);
+
+    static MOperand make_imm(int64_t value);
+
+    static MOperand make_mem(int base_reg, int64_t offset);
+
+    static MOperand make_frame(int slot, int64_t offset);
+
+    static MOperand make_symbol(const std::string &sym, int64_t offset);
+
+    static MOperand make_block(int index);
+
+    static MOperand make_func(const std::string &name);
+
+    bool is_reg() const { return kind == REG; }
+
+    bool is_imm() const { return kind == IMM; }
+
+    bool is_mem() const { return kind == MEM; }
+
+    /// 操作数读到的寄存器号（MEM 的基址寄存器），没有时为 -1
+    int base_reg() const { return kind == MEM && base == BASE_REG ? reg : -1; }
+};
+
+/**
+ * @brief 机器指令
+ *
+ * 操作数按 AT&T 顺序排列（源在前、目的在后）。各操作码读写哪些操作数由
+ * MInst::collect 统一给出；调用、除法等对固定物理寄存器的读写记在
+ * implicit_uses / implicit_defs 中。
+ */
+struct MInst {
+    enum Opcode {
+        MOV, LEA, MOVZX, MOVSX,            ///< 通用寄存器传送：src, dst
+        ADD, SUB, IMUL, AND, OR,           ///< 二地址运算：src, dst（dst 同时被读写）
+        CMP, TEST,                         ///< 比较：src, dst，只写标志
+        CDQ, IDIV,                         ///< 有符号除法，固定使用 eax/edx
+        SETCC, JCC, JMP,                   ///< 条件置位与跳转
+        CALL, RET,
+        MOVSS, CVTSI2SS, CVTTSS2SI,        ///< 单精度浮点传送与转换：src, dst
+        ADDSS, SUBSS, MULSS, DIVSS,        ///< 二地址浮点运算
+        UCOMISS                            ///< 浮点比较
+    };
+
+    Opcode op;
+    int size = 4;       ///< 整数指令的操作宽度（4 或 8），决定 l/q 后缀
+    Cond cc = Cond::E;  ///< SETCC / JCC 的条件
+    std::vector<MOperand> ops;
+    std::vector<int> implicit_uses;
+    std::vector<int> implicit_defs;
+
+    MInst(Opcode op, std::vector<MOperand> ops, int size = 4) : op(op), size(size), ops(std::move(ops)) {}
+
+    /**
+     * @brief 收集指令读、写的寄存器（含隐式操作数与内存基址）
+     */
+    void collect(std::vector<int> &uses, std::vector<int> &defs) const;
+
+    bool is_terminator() const { return op == JMP || op == JCC || op == RET; }
+};
+
+/**
+ * @brief 机器基本块
+ */
+struct MBlock {
+    std::string label;
+    std::vector<MInst> insts;
+};
+
+/**
+ * @brief 栈上对象（alloca 与溢出槽）
+ */
+struct FrameSlot {
+    int size;
+    int align;
+};
+
+/**
+ * @brief 机器函数
+ */
+struct MFunction {
+    std::string name;
+    std::vector<MBlock> blocks;
+    std::vector<RegClass> vreg_class;  ///< 下标为 vreg - kNumPRegs
+    std::vector<FrameSlot> slots;
+    int outgoing_size = 0;             ///< 调用时经栈传递参数所需的空间
+    std::vector<int> saved_regs;       ///< 寄存器分配后用到的被调用者保存寄存器
+
+    int new_vreg(RegClass cls) {
+        vreg_class.push_back(cls);
+        return kNumPRegs + static_cast<int>(vreg_class.size()) - 1;
+    }
+
+    RegClass class_of(int reg) const {
+        if (is_vreg(reg)) return vreg_class[reg - kNumPRegs];
+        return is_xmm(reg) ? RegClass::XMM : RegClass::GPR;
+    }
+
+    int new_slot(int size, int align) {
+        slots.push_back({size, align});
+        return static_cast<int>(slots.size()) - 1;
+    }
+};
+
+/**
+ * @brief 以给定宽度打印物理寄存器名（含 %）
+ */
+const char *preg_name(int preg, int size);
+
+#endif // SYSYC_MACHINEIR_H
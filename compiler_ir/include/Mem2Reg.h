@@ -0,0 +1,30 @@
+/*!
+ * @file Mem2Reg.h
+ * @brief 将局部变量的 alloca 提升为SSA寄存器
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_MEM2REG_H
+#define SYSYC_MEM2REG_H
+
+#include "PassManager.h"
+
+/**
+ * @brief 将局部变量的 alloca 提升为SSA寄存器
+ *
+ * 只被 load 读取、被 store 写入（不取地址）的 int/float alloca 视为可提升。
+ * 在各 store 所在块的迭代支配边界上放置phi，再沿支配树先序改名：
+ * load 换成当前到达的值，store 更新到达值，后继块中的phi补上 (值, 本块) 来源。
+ * 赋值前读取得到零值；不可达块中的 load/store 直接删除。
+ */
+class Mem2Reg : public FunctionPass {
+public:
+    const char *get_name() const override { return "mem2reg"; }
+
+    bool preserves_cfg() const override { return true; }
+
+    bool run_on_function(Function *f) override;
+};
+
+#endif // SYSYC_MEM2REG_H
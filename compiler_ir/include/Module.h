@@ -8,24 +8,39 @@
 #ifndef SYSYC_MODULE_H
 #define SYSYC_MODULE_H
 
+#include <cstdint>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 
 #include "Function.h"
 #include "GlobalVariable.h"
+#include "IRArena.h"
 #include "Instruction.h"
 #include "Type.h"
+#include "Uniquer.h"
 #include "Value.h"
 
 class GlobalVariable;
 
+class IRBinaryReader;
+
+class ConstantInt;
+
+class ConstantFP;
+
+class ConstantZero;
+
 /**
  * @brief 模块类，中间结构的大类
  *
  */
 class Module {
 private:
+    /// @brief 本模块所有类型与IR对象的内存池，最先构造、最后析构
+    IRArena arena_;
+
     /// @brief 各基础类型指针
     IntegerType *int1_ty_;
     IntegerType *int32_ty_;
@@ -34,9 +49,15 @@ private:
     FloatType *float32_ty_;
 
     /// @brief 指针映射图和数组映射图
-    std::map<Type *, PointerType *> pointer_map_;
-    std::map<std::pair < Type * , int>, ArrayType *>
-    array_map_;
+    Uniquer<Type *, PointerType> pointer_map_;
+    Uniquer<std::pair<Type *, int>, ArrayType, PairHash> array_map_;
+
+    /// @brief 常量唯一化表，同一模块内相同类型和值的常量只有一个对象
+    /// 并行生成函数体时各线程直接并发访问，见 Uniquer
+    Uniquer<std::pair<Type *, int>, ConstantInt, PairHash> const_int_map_;
+    /// 按位模式索引，区分 0.0 与 -0.0
+    Uniquer<uint32_t, ConstantFP> const_fp_map_;
+    Uniquer<Type *, ConstantZero> const_zero_map_;
 
     /// @brief 全局变量列表
     /// The Global Variables in the module
@@ -51,6 +72,8 @@ private:
     std::string module_name_;
     /// Original source file name for module, for test and debug
     std::string source_file_name_;
+    /// 从二进制中间代码加载时的读入器，函数体按需从中解码
+    std::unique_ptr<IRBinaryReader> materializer_;
 
 public:
     /**
@@ -64,7 +87,14 @@ public:
      * @brief Destroy the Module object
      *
      */
-    ~Module();
+    virtual ~Module();
+
+    /**
+     * @brief Get the arena object，获取本模块的IR对象内存池
+     *
+     * @return IRArena&
+     */
+    IRArena &get_arena() { return arena_; }
 
     /**
      * @brief Get the void type object，获取一个构建好的void类型指针
@@ -132,6 +162,31 @@ public:
      */
     ArrayType *get_array_type(Type *contained, unsigned num_elements);
 
+    /**
+     * @brief Get the constant int object，获取唯一化的整数常量
+     *
+     * @param ty 整数类型（i1 或 i32）
+     * @param val 常量值
+     * @return ConstantInt*
+     */
+    ConstantInt *get_constant_int(IntegerType *ty, int val);
+
+    /**
+     * @brief Get the constant fp object，获取唯一化的浮点常量
+     *
+     * @param val 常量值
+     * @return ConstantFP*
+     */
+    ConstantFP *get_constant_fp(float val);
+
+    /**
+     * @brief Get the constant zero object，获取唯一化的零初始化常量
+     *
+     * @param ty 常量类型
+     * @return ConstantZero*
+     */
+    ConstantZero *get_constant_zero(Type *ty);
+
     /**
      * @brief 添加函数
      *
@@ -177,18 +232,39 @@ public:
         return instr_id2string_[instr];
     }
 
+    /**
+     * @brief 设置函数体的读入器，模块析构时一并释放
+     *
+     * @param reader 二进制中间代码读入器
+     */
+    void set_materializer(std::unique_ptr<IRBinaryReader> reader);
+
+    /**
+     * @brief Get the materializer object，获取函数体的读入器
+     *
+     * @return IRBinaryReader* 不是从二进制中间代码加载时为空
+     */
+    IRBinaryReader *get_materializer() { return materializer_.get(); }
+
     /**
      * @brief Set the print name object，修正模块管理的函数下的名称
      *
      */
     void set_print_name();
 
+    /**
+     * @brief 打印中间代码，逐条写入输出流
+     *
+     * @param os 输出流
+     */
+    virtual void print(std::ostream &os);
+
     /**
      * @brief 打印中间代码
      *
      * @return std::string
      */
-    virtual std::string print();
+    std::string print();
 };
 
 #endif // SYSYC_MODULE_H
@@ -0,0 +1,53 @@
+/*!
+ * @file ParallelLexer.h
+ * @brief Lexes one large source buffer in chunks on several threads
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_PARALLELLEXER_H
+#define SYSYC_PARALLELLEXER_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "Lexer.h"
+
+/**
+ * @brief Chunked, multi-threaded equivalent of SLRLexer::analyze
+ *
+ * The buffer is cut just after a newline near each of N evenly spaced
+ * offsets. No token spans a newline and line comments end at one, so the
+ * only state that can cross a cut is an open block comment. Every chunk is
+ * lexed in parallel by its own SLRLexer (sharing the immutable DFA table)
+ * on the speculation that it starts outside a comment, with line and column
+ * relative to the chunk. A serial pass then walks the chunks in order; a
+ * chunk whose predecessor really ended inside a comment is re-lexed from
+ * just past the closing comment marker (or skipped entirely if it has
+ * none). Finally the token vectors are concatenated in parallel, adding each
+ * chunk's line and byte offset.
+ *
+ * The result is identical to SLRLexer::analyze on the whole buffer,
+ * including line, column and offset of every token and of END_OF_FILE.
+ * Token values are views into source, which must outlive them.
+ */
+class ParallelLexer {
+public:
+    /// Chunks smaller than this are not worth a thread
+    static constexpr size_t kMinChunk = 1 << 20;
+
+    /**
+     * @param threads Number of lexing threads, <= 0 for hardware concurrency
+     */
+    explicit ParallelLexer(int threads = 0);
+
+    /**
+     * @brief Tokenize source; the last token is END_OF_FILE
+     */
+    std::vector<Token> analyze(std::string_view source) const;
+
+private:
+    int threads;
+};
+
+#endif // SYSYC_PARALLELLEXER_H
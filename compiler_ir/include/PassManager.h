@@ -0,0 +1,106 @@
+/*!
+ * @file PassManager.h
+ * @brief 中间代码优化遍框架
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_PASSMANAGER_H
+#define SYSYC_PASSMANAGER_H
+
+#include "AnalysisManager.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+class Module;
+
+class Function;
+
+/**
+ * @brief 优化遍基类
+ */
+class Pass {
+public:
+    virtual ~Pass() = default;
+
+    /**
+     * @brief 遍名称，用作 --time-passes 的阶段名
+     * @note 须为字符串字面量
+     */
+    virtual const char *get_name() const = 0;
+
+    /**
+     * @brief 在整个模块上运行
+     * @param am 分析结果缓存，遍可从中取支配树等分析
+     * @return 是否修改了IR
+     */
+    virtual bool run(Module *m, AnalysisManager &am) = 0;
+
+    /**
+     * @brief 遍是否保持前驱/后继与跳转不变
+     * @note 为真时修改IR也不会使已缓存的CFG分析失效
+     */
+    virtual bool preserves_cfg() const { return false; }
+};
+
+/**
+ * @brief 函数级优化遍，依次在模块中每个有定义的函数上运行
+ */
+class FunctionPass : public Pass {
+public:
+    /**
+     * @brief 依次在每个函数上运行，修改了CFG的函数的分析结果随即失效
+     */
+    bool run(Module *m, AnalysisManager &am) override;
+
+    /**
+     * @brief 在单个函数上运行
+     * @return 是否修改了该函数
+     */
+    virtual bool run_on_function(Function *f) = 0;
+
+protected:
+    /**
+     * @brief 当前运行所用的分析缓存，仅在 run_on_function 内有效
+     */
+    AnalysisManager &get_analyses() { return *analyses_; }
+
+private:
+    AnalysisManager *analyses_ = nullptr;
+};
+
+/**
+ * @brief 按添加顺序运行一组优化遍
+ */
+class PassManager {
+public:
+    /**
+     * @brief 在流水线末尾添加一个遍
+     */
+    void add_pass(std::unique_ptr<Pass> pass) { passes_.push_back(std::move(pass)); }
+
+    template<typename T, typename... Args>
+    void add_pass(Args &&... args) {
+        passes_.push_back(std::unique_ptr<Pass>(new T(std::forward<Args>(args)...)));
+    }
+
+    /**
+     * @brief 依次运行所有遍，每个遍单独计时；各遍共享同一份分析缓存
+     * @return 是否有遍修改了IR
+     */
+    bool run(Module *m);
+
+    /**
+     * @brief 按优化等级构造默认流水线
+     * @param level 0 不做优化；1 为 -O1；2 在 -O1 的基础上内联小函数
+     */
+    static void build_pipeline(PassManager &pm, int level);
+
+private:
+    std::vector<std::unique_ptr<Pass>> passes_;
+    AnalysisManager analyses_;
+};
+
+#endif // SYSYC_PASSMANAGER_H
@@ -14,8 +14,13 @@
 #include <set>
 #include <string>
 #include <algorithm>
+#include <unordered_map>
+#include <utility>
 #include "SLRDFA.h"
 
+// Hopcroft partition refinement. Missing transitions go to an implicit sink
+// that starts in a block of its own, so a state is never merged with one that
+// has a transition where it has none.
 class DFAMinimizer {
 public:
     static std::shared_ptr<SLRDFA> minimize(std::shared_ptr<SLRDFA> originalDFA) {
@@ -24,81 +29,139 @@ public:
         if (!originalDFA || originalDFA->states.empty()) return minimizedDFA;
 
         std::vector<char> alphabet = buildAlphabet(originalDFA);
+        const int n = static_cast<int>(originalDFA->states.size());
+        const int k = static_cast<int>(alphabet.size());
+        const int sink = n;
+        const int total = n + 1;
+
+        std::unordered_map<SLRDFAState*, int> index;
+        for (int s = 0; s < n; ++s) index[originalDFA->states[s].get()] = s;
+        int charIndex[256];
+        std::fill(std::begin(charIndex), std::end(charIndex), -1);
+        for (int a = 0; a < k; ++a) charIndex[static_cast<unsigned char>(alphabet[a])] = a;
+
+        // Dense transition table, then its inverse in CSR form keyed by (target, char)
+        std::vector<int> delta(static_cast<size_t>(total) * k, sink);
+        for (int s = 0; s < n; ++s) {
+            for (auto &kv : originalDFA->states[s]->transitions) {
+                delta[static_cast<size_t>(s) * k + charIndex[static_cast<unsigned char>(kv.first)]] =
+                    index.at(kv.second.get());
+            }
+        }
+        std::vector<int> invStart(static_cast<size_t>(total) * k + 1, 0);
+        for (int s = 0; s < total; ++s) {
+            for (int a = 0; a < k; ++a) invStart[static_cast<size_t>(delta[static_cast<size_t>(s) * k + a]) * k + a + 1]++;
+        }
+        for (size_t i = 1; i < invStart.size(); ++i) invStart[i] += invStart[i - 1];
+        std::vector<int> invList(invStart.back());
+        {
+            std::vector<int> fill(invStart.begin(), invStart.end() - 1);
+            for (int s = 0; s < total; ++s) {
+                for (int a = 0; a < k; ++a) {
+                    invList[fill[static_cast<size_t>(delta[static_cast<size_t>(s) * k + a]) * k + a]++] = s;
+                }
+            }
+        }
 
-        std::vector<std::vector<std::shared_ptr<SLRDFAState>>> partitions;
-        partitions.reserve(originalDFA->states.size());
-        std::map<std::shared_ptr<SLRDFAState>, int> stateToGroup;
+        // Blocks are contiguous ranges of elems; the marked prefix of a block
+        // collects the states that move into the current splitter.
+        std::vector<int> elems(total), pos(total), blockOf(total);
+        std::vector<int> blockStart, blockEnd, marked;
 
-        std::map<std::string, int> keyToGroup;
-        auto getKey = [](std::shared_ptr<SLRDFAState> s){
+        std::map<std::string, std::vector<int>> initial;
+        auto getKey = [](const std::shared_ptr<SLRDFAState>& s){
             if (!s->isAccept) return std::string("N");
             return std::string("A_") + std::to_string(static_cast<int>(s->acceptType)) + "_" +
                    std::to_string(s->tokenNumber) + "_" + std::to_string(s->priority);
         };
-
-        for (auto s : originalDFA->states) {
-            std::string key = getKey(s);
-            if (!keyToGroup.count(key)) {
-                keyToGroup[key] = static_cast<int>(partitions.size());
-                partitions.push_back({});
+        for (int s = 0; s < n; ++s) initial[getKey(originalDFA->states[s])].push_back(s);
+        initial[std::string()].push_back(sink);       // no real state has an empty key
+
+        int cursor = 0;
+        for (auto &kv : initial) {
+            int b = static_cast<int>(blockStart.size());
+            blockStart.push_back(cursor);
+            for (int s : kv.second) {
+                elems[cursor] = s;
+                pos[s] = cursor++;
+                blockOf[s] = b;
             }
-            int gid = keyToGroup[key];
-            partitions[gid].push_back(s);
-            stateToGroup[s] = gid;
+            blockEnd.push_back(cursor);
+            marked.push_back(0);
         }
 
-        bool changed;
-        do {
-            changed = false;
-            std::vector<std::vector<std::shared_ptr<SLRDFAState>>> newPartitions;
-            newPartitions.reserve(partitions.size());
+        std::vector<std::pair<int, int>> worklist;
+        std::vector<char> pending;                    // (block, char) is on the worklist
+        auto push = [&](int b, int a) {
+            pending[static_cast<size_t>(b) * k + a] = 1;
+            worklist.emplace_back(b, a);
+        };
+        pending.assign(blockStart.size() * k, 0);
+        for (int b = 0; b < static_cast<int>(blockStart.size()); ++b) {
+            for (int a = 0; a < k; ++a) push(b, a);
+        }
 
-            for (auto &group : partitions) {
-                if (group.size() <= 1) {
-                    newPartitions.push_back(group);
-                    continue;
+        std::vector<int> splitter, touched;
+        while (!worklist.empty()) {
+            auto [b, a] = worklist.back();
+            worklist.pop_back();
+            pending[static_cast<size_t>(b) * k + a] = 0;
+
+            splitter.assign(elems.begin() + blockStart[b], elems.begin() + blockEnd[b]);
+            touched.clear();
+            for (int t : splitter) {
+                size_t key = static_cast<size_t>(t) * k + a;
+                for (int i = invStart[key]; i < invStart[key + 1]; ++i) {
+                    int p = invList[i];
+                    int x = blockOf[p];
+                    int slot = blockStart[x] + marked[x];
+                    if (pos[p] < slot) continue;
+                    if (marked[x] == 0) touched.push_back(x);
+                    std::swap(elems[pos[p]], elems[slot]);
+                    pos[elems[pos[p]]] = pos[p];
+                    pos[p] = slot;
+                    marked[x]++;
                 }
+            }
 
-                std::map<std::string, std::vector<std::shared_ptr<SLRDFAState>>> buckets;
-                buckets.clear();
-
-                for (auto s : group) {
-                    std::string sig;
-                    sig.reserve(alphabet.size() * 3);
-                    for (char c : alphabet) {
-                        auto it = s->transitions.find(c);
-                        int tgt = -1;
-                        if (it != s->transitions.end()) {
-                            auto t = it->second;
-                            auto found = stateToGroup.find(t);
-                            tgt = (found == stateToGroup.end()) ? -1 : found->second;
-                        }
-                        sig.push_back(c);
-                        sig.push_back('#');
-                        sig += std::to_string(tgt);
-                        sig.push_back(';');
+            for (int x : touched) {
+                int m = marked[x];
+                marked[x] = 0;
+                if (m == blockEnd[x] - blockStart[x]) continue;
+
+                int y = static_cast<int>(blockStart.size());
+                blockStart.push_back(blockStart[x]);
+                blockEnd.push_back(blockStart[x] + m);
+                marked.push_back(0);
+                blockStart[x] += m;
+                for (int i = blockStart[y]; i < blockEnd[y]; ++i) blockOf[elems[i]] = y;
+
+                pending.resize(blockStart.size() * k, 0);
+                bool ySmaller = blockEnd[y] - blockStart[y] <= blockEnd[x] - blockStart[x];
+                for (int c = 0; c < k; ++c) {
+                    if (pending[static_cast<size_t>(x) * k + c]) {
+                        push(y, c);
+                    } else {
+                        push(ySmaller ? y : x, c);
                     }
-                    buckets[sig].push_back(s);
-                }
-
-                if (buckets.size() == 1) {
-                    newPartitions.push_back(group);
-                } else {
-                    changed = true;
-                    for (auto &kv : buckets) newPartitions.push_back(kv.second);
                 }
             }
+        }
 
-            partitions = std::move(newPartitions);
-            stateToGroup.clear();
-            for (int gid = 0; gid < static_cast<int>(partitions.size()); ++gid) {
-                for (auto s : partitions[gid]) stateToGroup[s] = gid;
-            }
-        } while (changed);
+        // Number the new states in order of their lowest original state, keeping
+        // the result independent of the order splits happened in.
+        std::vector<int> groupOf(total, -1);
+        std::vector<int> representative;
+        for (int s = 0; s < n; ++s) {
+            int b = blockOf[s];
+            if (groupOf[b] >= 0) continue;
+            groupOf[b] = static_cast<int>(representative.size());
+            representative.push_back(s);
+        }
 
-        std::vector<std::shared_ptr<SLRDFAState>> groupToNewState(partitions.size());
-        for (int gid = 0; gid < static_cast<int>(partitions.size()); ++gid) {
-            auto s0 = partitions[gid][0];
+        std::vector<std::shared_ptr<SLRDFAState>> groupToNewState(representative.size());
+        for (size_t gid = 0; gid < representative.size(); ++gid) {
+            auto s0 = originalDFA->states[representative[gid]];
             std::shared_ptr<SLRDFAState> ns;
             if (s0->isAccept) {
                 ns = minimizedDFA->createAcceptState(s0->acceptType, s0->tokenNumber, s0->tokenValue, s0->priority);
@@ -106,21 +169,15 @@ public:
                 ns = minimizedDFA->createState();
             }
             groupToNewState[gid] = ns;
-            if (s0 == originalDFA->start) minimizedDFA->start = ns;
-        }
-        if (!minimizedDFA->start) {
-            int startGroup = stateToGroup[originalDFA->start];
-            minimizedDFA->start = groupToNewState[startGroup];
         }
+        minimizedDFA->start = groupToNewState[groupOf[blockOf[index.at(originalDFA->start.get())]]];
 
-        for (int gid = 0; gid < static_cast<int>(partitions.size()); ++gid) {
-            auto rep = partitions[gid][0];
+        for (size_t gid = 0; gid < representative.size(); ++gid) {
+            auto rep = originalDFA->states[representative[gid]];
             auto from = groupToNewState[gid];
             for (auto &kv : rep->transitions) {
-                char c = kv.first;
-                auto target = kv.second;
-                int tgtGroup = stateToGroup[target];
-                from->addTransition(c, groupToNewState[tgtGroup]);
+                int target = index.at(kv.second.get());
+                from->addTransition(kv.first, groupToNewState[groupOf[blockOf[target]]]);
             }
         }
 
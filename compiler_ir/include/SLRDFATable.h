@@ -0,0 +1,89 @@
+/*!
+ * @file SLRDFATable.h
+ * @brief Flat transition table lowered from the minimized lexer DFA
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_SLRDFATABLE_H
+#define SYSYC_SLRDFATABLE_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+#include "SLRDFA.h"
+
+/**
+ * @brief Array form of an SLRDFA used by the hot lexing loop.
+ *
+ * Input bytes are first mapped to byte classes (bytes with identical columns
+ * in every state share a class), so the transition table is
+ * next[state * numClasses + class]. State 0 is the dead state and the DFA
+ * start state is 1; accept information lives in parallel per-state arrays.
+ */
+class SLRDFATable {
+public:
+    static constexpr uint16_t kDead = 0;
+    static constexpr uint16_t kStart = 1;
+
+    std::array<uint8_t, 256> byteClass{};
+    int numClasses = 0;
+    std::vector<uint16_t> next;
+    std::vector<uint8_t> accepting;
+    std::vector<TokenType> acceptType;
+
+    uint16_t step(uint16_t state, char c) const {
+        return next[state * numClasses + byteClass[static_cast<unsigned char>(c)]];
+    }
+
+    static SLRDFATable fromDFA(const SLRDFA& dfa) {
+        SLRDFATable t;
+
+        // Dense state numbering: dead state, start state, then the rest
+        std::map<const SLRDFAState*, uint16_t> index;
+        index[dfa.start.get()] = kStart;
+        for (auto& s : dfa.states) {
+            if (!index.count(s.get())) {
+                uint16_t id = static_cast<uint16_t>(index.size() + 1);
+                index[s.get()] = id;
+            }
+        }
+        int numStates = static_cast<int>(index.size()) + 1;
+
+        // Full 256-wide columns, then merge identical ones into byte classes
+        std::vector<std::vector<uint16_t>> columns(256, std::vector<uint16_t>(numStates, kDead));
+        for (auto& kv : index) {
+            for (auto& tr : kv.first->transitions) {
+                columns[static_cast<unsigned char>(tr.first)][kv.second] = index[tr.second.get()];
+            }
+        }
+        std::map<std::vector<uint16_t>, uint8_t> classOf;
+        std::vector<const std::vector<uint16_t>*> classColumns;
+        for (int b = 0; b < 256; b++) {
+            auto it = classOf.find(columns[b]);
+            if (it == classOf.end()) {
+                it = classOf.emplace(columns[b], static_cast<uint8_t>(classColumns.size())).first;
+                classColumns.push_back(&columns[b]);
+            }
+            t.byteClass[b] = it->second;
+        }
+        t.numClasses = static_cast<int>(classColumns.size());
+
+        t.next.assign(static_cast<size_t>(numStates) * t.numClasses, kDead);
+        for (int s = 0; s < numStates; s++) {
+            for (int c = 0; c < t.numClasses; c++) t.next[s * t.numClasses + c] = (*classColumns[c])[s];
+        }
+
+        t.accepting.assign(numStates, 0);
+        t.acceptType.assign(numStates, TokenType::ERROR);
+        for (auto& kv : index) {
+            t.accepting[kv.second] = kv.first->isAccept;
+            t.acceptType[kv.second] = kv.first->acceptType;
+        }
+        return t;
+    }
+};
+
+#endif // SYSYC_SLRDFATABLE_H
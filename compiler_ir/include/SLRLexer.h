@@ -16,23 +16,31 @@
 #include <iostream>
 #include <cctype>
 #include "Lexer.h"
+#include "TokenStream.h"
 #include "SLRNFA.h"
 #include "SLRDFA.h"
 #include "SLRSubsetConstruction.h"
 #include "SLRDFAMinimizer.h"
+#include "SLRDFATable.h"
+#include "SLRScan.h"
 
-class SLRLexer {
+class SLRLexer : public TokenStream {
 private:
-    std::shared_ptr<SLRDFA> dfa;
+    std::shared_ptr<const SLRDFATable> dfa;  // Shared, read-only
+    std::string_view source;
+    int pos;
     int line;
     int column;
+    bool eofEmitted;
+    bool inComment;     // The last block comment ran to the end of the input
     
 public:
-    SLRLexer() : line(1), column(1) {
-        buildDFA();
-    }
+    SLRLexer() : dfa(sharedTable()), pos(0), line(1), column(1), eofEmitted(false), inComment(false) {}
     
-    void buildDFA() {
+    /**
+     * @brief Run the NFA -> DFA -> minimized DFA -> table construction
+     */
+    static std::shared_ptr<const SLRDFATable> buildDFA() {
         auto nfaBuilder = std::make_shared<NFA>();
         
         auto kwNFA = nfaBuilder->KWNFA();
@@ -47,118 +55,139 @@ public:
         
         SubsetConstruction constructor;
         auto rawDfa = constructor.convert(combinedNFA);
-        dfa = DFAMinimizer::minimize(rawDfa);
+        return std::make_shared<const SLRDFATable>(SLRDFATable::fromDFA(*DFAMinimizer::minimize(rawDfa)));
     }
+
+    /**
+     * @brief Transition table shared by all lexers in this process
+     * @note Decoded from the arrays embedded by dfa_tablegen when available,
+     *       otherwise built at runtime on first use
+     */
+    static std::shared_ptr<const SLRDFATable> sharedTable();
+
+private:
+    static std::shared_ptr<const SLRDFATable> loadDFA();
+
+public:
     
-    std::vector<Token> analyze(const std::string& sourceCode) {
+    /**
+     * @brief Tokenize sourceCode
+     * @note Token values are views into sourceCode, which must outlive them
+     */
+    std::vector<Token> analyze(std::string_view sourceCode) {
         std::vector<Token> tokens;
-        int pos = 0;
-        int length = sourceCode.length();
+        reset(sourceCode);
+        Token token;
+        while (next(token)) {
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+
+    /**
+     * @brief Start pulling tokens from sourceCode with next()
+     */
+    void reset(std::string_view sourceCode) {
+        source = sourceCode;
+        pos = 0;
         line = 1;
         column = 1;
+        eofEmitted = false;
+        inComment = false;
+    }
+
+    /**
+     * @brief Whether the input ended inside an unterminated block comment
+     * @note ParallelLexer uses this to carry comment state across chunk edges
+     */
+    bool endedInComment() const { return inComment; }
+
+    /**
+     * @brief Lex one token; the last token is always END_OF_FILE
+     * @return false once END_OF_FILE has been returned
+     */
+    bool next(Token& out) override {
+        const SLRDFATable& table = *dfa;
+        int length = source.length();
         
         while (pos < length) {
-            char currentChar = sourceCode[pos];
+            char currentChar = source[pos];
             
             // Skip whitespace
             if (std::isspace(currentChar)) {
-                if (currentChar == '\n') {
-                    line++;
-                    column = 1;
-                } else if (currentChar == '\t') {
-                    column += 4;
-                } else {
-                    column++;
-                }
-                pos++;
+                pos += SLRScan::skipBlanks(source.data() + pos, length - pos, line, column);
                 continue;
             }
             
             // Skip comments
             if (currentChar == '/' && pos + 1 < length) {
-                if (sourceCode[pos + 1] == '/') {
+                if (source[pos + 1] == '/') {
                     // Line comment
-                    while (pos < length && sourceCode[pos] != '\n') {
-                        pos++;
-                        column++;
-                    }
+                    pos += SLRScan::findNewline(source.data() + pos, length - pos, column);
                     continue;
-                } else if (sourceCode[pos + 1] == '*') {
+                } else if (source[pos + 1] == '*') {
                     // Block comment
                     pos += 2;
                     column += 2;
-                    while (pos + 1 < length) {
-                        if (sourceCode[pos] == '*' && sourceCode[pos + 1] == '/') {
-                            pos += 2;
-                            column += 2;
-                            break;
-                        }
-                        if (sourceCode[pos] == '\n') {
-                            line++;
-                            column = 1;
-                        } else {
-                            column++;
-                        }
-                        pos++;
-                    }
+                    pos += SLRScan::skipBlockComment(source.data() + pos, length - pos, line, column);
+                    inComment = pos < 2 || source[pos - 2] != '*' || source[pos - 1] != '/';
                     continue;
                 }
             }
             
-            auto currentState = dfa->start;
+            uint16_t currentState = SLRDFATable::kStart;
             int startPos = pos;
             int startLine = line;
             int startColumn = column;
-            std::shared_ptr<SLRDFAState> lastAcceptState = nullptr;
+            uint16_t lastAcceptState = SLRDFATable::kDead;
             int lastAcceptPos = -1;
             int currentPos = pos;
             
             // Longest match
             while (currentPos < length) {
-                char c = sourceCode[currentPos];
-                auto it = currentState->transitions.find(c);
-                if (it == currentState->transitions.end()) {
+                currentState = table.step(currentState, source[currentPos]);
+                if (currentState == SLRDFATable::kDead) {
                     break;
                 }
-                currentState = it->second;
                 currentPos++;
-                if (currentState->isAccept) {
+                if (table.accepting[currentState]) {
                     lastAcceptState = currentState;
                     lastAcceptPos = currentPos;
                 }
             }
             
-            if (lastAcceptState != nullptr && lastAcceptPos > startPos) {
-                std::string tokenValue = sourceCode.substr(startPos, lastAcceptPos - startPos);
-                Token token(lastAcceptState->acceptType, tokenValue, startLine, startColumn);
-                tokens.push_back(token);
+            if (lastAcceptState != SLRDFATable::kDead && lastAcceptPos > startPos) {
+                std::string_view tokenValue = source.substr(startPos, lastAcceptPos - startPos);
+                out = Token(table.acceptType[lastAcceptState], tokenValue, startLine, startColumn, startPos);
                 
                 // Update line and column
                 for (int i = startPos; i < lastAcceptPos; ++i) {
-                    if (sourceCode[i] == '\n') {
+                    if (source[i] == '\n') {
                         line++;
                         column = 1;
-                    } else if (sourceCode[i] == '\t') {
+                    } else if (source[i] == '\t') {
                         column += 4;
                     } else {
                         column++;
                     }
                 }
                 pos = lastAcceptPos;
+                return true;
             } else {
                 // Unrecognized character
-                std::string errorChar(1, sourceCode[startPos]);
-                Token token(TokenType::ERROR, errorChar, startLine, startColumn);
-                tokens.push_back(token);
+                out = Token(TokenType::ERROR, source.substr(startPos, 1), startLine, startColumn, startPos);
                 pos = startPos + 1;
                 column++;
+                return true;
             }
         }
         
-        // Add EOF token
-        tokens.push_back(Token(TokenType::END_OF_FILE, "$", line, column));
-        
-        return tokens;
+        if (eofEmitted) {
+            return false;
+        }
+        out = Token(TokenType::END_OF_FILE, "$", line, column, length);
+        eofEmitted = true;
+        return true;
     }
 };
 
@@ -18,8 +18,12 @@
 #include <iostream>
 #include <sstream>
 #include <unordered_set>
+#include <variant>
 #include "Lexer.h"
 #include "AST.h"
+#include "ASTArena.h"
+#include "SLRTable.h"
+#include "TokenStream.h"
 
 // Forward declarations
 class SLRParser;
@@ -44,99 +48,151 @@ struct Item {
     }
 };
 
-// Action types
-enum ActionType { ACC, SHIFT, REDUCE, ERR };
+// Semantic value - a compact tagged union moved (never copied) through the
+// value stack. AST nodes are owned by the parser's ASTArena.
+struct SemanticValue {
+    std::variant<std::monostate,
+                 std::string_view,                // Terminals; views the token source
+                 ASTNode*,                        // Any AST node
+                 BType,
+                 UnaryOp,
+                 std::vector<ConstDefNode*>,
+                 std::vector<VarDefNode*>,
+                 std::vector<FuncFParamNode*>,
+                 std::vector<BlockItemNode*>,
+                 std::vector<ExpNode*>> value;
+
+    SemanticValue() = default;
+    template <typename T>
+    SemanticValue(T v) : value(std::move(v)) {}
+
+    // Node of the expected static type, or nullptr (e.g. an empty ElsePart)
+    template <typename T>
+    T* node() const {
+        auto p = std::get_if<ASTNode*>(&value);
+        return p ? static_cast<T*>(*p) : nullptr;
+    }
+    template <typename T>
+    std::vector<T*>& list() { return std::get<std::vector<T*>>(value); }
 
-struct Action {
-    ActionType type;
-    int target;
+    std::string_view terminal() const { return std::get<std::string_view>(value); }
+    BType bType() const { return std::get<BType>(value); }
+    UnaryOp unaryOp() const { return std::get<UnaryOp>(value); }
 };
 
-// Semantic value - can hold AST node pointers
-struct SemanticValue {
-    std::string terminal;  // For terminals
-    
-    // AST nodes
-    std::shared_ptr<CompUnitNode> compUnit;
-    std::shared_ptr<DeclNode> decl;
-    std::shared_ptr<ConstDeclNode> constDecl;
-    std::shared_ptr<VarDeclNode> varDecl;
-    std::shared_ptr<ConstDefNode> constDef;
-    std::shared_ptr<VarDefNode> varDef;
-    std::shared_ptr<FuncDefNode> funcDef;
-    std::shared_ptr<FuncFParamNode> funcFParam;
-    std::shared_ptr<BlockNode> block;
-    std::shared_ptr<BlockItemNode> blockItem;
-    std::shared_ptr<StmtNode> stmt;
-    std::shared_ptr<LValNode> lVal;
-    std::shared_ptr<AddExpNode> exp;
-    std::shared_ptr<CondNode> cond;
-    std::shared_ptr<PrimaryExpNode> primaryExp;
-    std::shared_ptr<UnaryExpNode> unaryExp;
-    std::shared_ptr<MulExpNode> mulExp;
-    std::shared_ptr<AddExpNode> addExp;
-    std::shared_ptr<RelExpNode> relExp;
-    std::shared_ptr<EqExpNode> eqExp;
-    std::shared_ptr<LAndExpNode> lAndExp;
-    std::shared_ptr<LOrExpNode> lOrExp;
-    std::shared_ptr<NumberNode> number;
-    
-    BType bType;
-    UnaryOp unaryOp;
-    
-    // Lists
-    std::vector<std::shared_ptr<ConstDefNode>> constDefList;
-    std::vector<std::shared_ptr<VarDefNode>> varDefList;
-    std::vector<std::shared_ptr<FuncFParamNode>> funcFParams;
-    std::vector<std::shared_ptr<BlockItemNode>> blockItemList;
-    std::vector<std::shared_ptr<ExpNode>> funcRParams;
-    
-    SemanticValue() : bType(BType::INT), unaryOp(UnaryOp::PLUS) {}
+// Receives the parser's moves as they happen. With no sink attached the
+// parser formats nothing, so only callers that want a .spe log pay for it.
+class ParseLogSink {
+public:
+    virtual ~ParseLogSink() = default;
+    virtual void shift(const std::string& symbol, std::string_view text) = 0;
+    virtual void reduce(const std::string& lhs, const std::string& lookahead) = 0;
+    virtual void accept(const std::string& lookahead) = 0;
+    virtual void error(const std::string& message) = 0;
+};
+
+// Writes the numbered .spe format ("<step>\t<symbol>#<text>\tmove" ...) to a stream
+class StreamParseLog : public ParseLogSink {
+public:
+    explicit StreamParseLog(std::ostream& os) : out(&os) {}
+
+    void shift(const std::string& symbol, std::string_view text) override;
+    void reduce(const std::string& lhs, const std::string& lookahead) override;
+    void accept(const std::string& lookahead) override;
+    void error(const std::string& message) override;
+
+private:
+    std::ostream* out;
+    int step = 1;
 };
 
 class SLRParser {
+public:
+    // FNV-1a offset basis; the hash of an empty token span
+    static constexpr uint64_t kTokenHashBasis = 14695981039346656037ull;
+
 private:
     std::vector<Production> grammar;
     std::map<std::string, std::set<std::string>> first;
-    std::map<std::string, std::set<std::string>> follow;
     std::vector<std::set<Item>> canonicalCollection;
-    std::map<std::pair<int, std::string>, Action> actionTable;
-    std::map<std::pair<int, std::string>, int> gotoTable;
     std::set<std::string> terminals;
     std::set<std::string> nonTerminals;
+    std::shared_ptr<const SLRTables> tables;  // Shared, read-only
+    std::vector<int> tokenSymbol;             // TokenType -> terminal id (-1: none)
+    std::vector<int> prodLhs;                 // Production id - 1 -> lhs symbol id
+    std::vector<int> prodLen;                 // Production id - 1 -> symbols popped on reduce
     
-    std::shared_ptr<CompUnitNode> astRoot;
+    std::unique_ptr<ASTArena> arena;          // Owns the nodes of the last parse
+    CompUnitNode* astRoot;
     bool hasError;
-    std::stringstream parseLog;
-    int logStep;
+    std::ostream* diag;                       // Where parse errors are reported
+    ParseLogSink* parseLog;                   // Not owned; nullptr logs nothing
+    uint64_t elementHash;                     // Tokens shifted since the last top-level element
 
-public:
-    SLRParser() : hasError(false), logStep(1) {
+    explicit SLRParser(std::shared_ptr<const SLRTables> t) : tables(std::move(t)), astRoot(nullptr), hasError(false), diag(&std::cerr), parseLog(nullptr), elementHash(kTokenHashBasis) {
         initGrammar();
-        computeFirst();
-        computeFollow();
-        buildCollection();
-        buildTable();
+        if (tables) bindSymbols();
     }
+
+public:
+    SLRParser() : SLRParser(sharedTables()) {}
     
     bool parse(const std::vector<Token>& tokens);
-    std::shared_ptr<CompUnitNode> getAST() const { return astRoot; }
-    std::string getParseLog() const { return parseLog.str(); }
-    void saveParseLog(const std::string& filepath) const;
+
+    /**
+     * @brief Parse tokens pulled one lookahead at a time
+     * @return false if any syntax error was found; every error is reported
+     *         to the diagnostics stream, recovering at ';' and '}'
+     */
+    bool parse(TokenStream& tokens);
+    /**
+     * @brief Root of the last parsed AST
+     * @note Valid until the next parse() or until the parser is destroyed
+     */
+    CompUnitNode* getAST() const { return astRoot; }
+
+    /**
+     * @brief Send shifts and reductions of later parses to sink
+     * @note Pass nullptr (the default) to turn logging off
+     */
+    void setParseLog(ParseLogSink* sink) { parseLog = sink; }
+
+    /**
+     * @brief Report parse errors to os instead of std::cerr
+     */
+    void setDiagnostics(std::ostream& os) { diag = &os; }
+
+    /**
+     * @brief Run the full FIRST/FOLLOW/LR(0)/ACTION/GOTO construction
+     */
+    static std::shared_ptr<const SLRTables> buildTables();
+
+    /**
+     * @brief Tables shared by all parsers in this process
+     * @note Decoded from the blob embedded by slr_tablegen when available,
+     *       otherwise built at runtime on first use
+     */
+    static std::shared_ptr<const SLRTables> sharedTables();
     
 private:
+    static std::shared_ptr<const SLRTables> loadTables();
+
     void initGrammar();
+    void bindSymbols();
+    uint32_t computeGrammarHash() const;
     void computeFirst();
-    void computeFollow();
-    void buildCollection();
-    void buildTable();
+    void computeFollow(SLRTables& t);
+    void buildCollection(SLRTables& t);
+    void buildTable(SLRTables& t);
     
     std::set<Item> closure(std::set<Item> I);
     std::set<Item> gotoState(std::set<Item> I, std::string X);
-    std::string getTokenSymbol(const Token& t);
+    static std::string getTokenSymbol(TokenType type);
+    static uint64_t hashToken(uint64_t h, const Token& tok);
     
     // Semantic actions for AST construction
-    SemanticValue reduce(int prodId, std::vector<SemanticValue>& values);
+    // vals points at the production's rhs values on the value stack
+    SemanticValue reduce(int prodId, SemanticValue* vals);
     bool shouldLogSymbol(const std::string& symbol) const;
 };
 
@@ -0,0 +1,218 @@
+/*!
+ * @file SLRScan.h
+ * @brief Vectorized whitespace and comment skipping for SLRLexer
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_SLRSCAN_H
+#define SYSYC_SLRSCAN_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Skips blank runs and comment bodies one chunk at a time.
+ *
+ * Each chunk is classified once into bitmasks (bit i = byte i), and line and
+ * column are derived from those masks: popcount of newlines for the line,
+ * bytes after the last newline for the column. Tabs count 4 columns in
+ * blank runs and 1 inside comments, as the scalar lexer always did.
+ *
+ * The chunk width is 32 bytes with AVX2, 16 with SSE2 or AArch64 NEON;
+ * otherwise a byte loop fills the same masks. Inputs shorter than one chunk
+ * use the scalar tails below.
+ */
+class SLRScan {
+public:
+    /**
+     * @brief Length of the run of C-locale isspace() bytes at p
+     */
+    static size_t skipBlanks(const char* p, size_t n, int& line, int& column) {
+        size_t i = 0;
+        for (; i + kChunk <= n; i += kChunk) {
+            Masks m = classify(p + i);
+            uint64_t stop = ~m.blank & kFull;
+            uint64_t span = stop ? (stop & (0 - stop)) - 1 : kFull;
+            advance(span, m.newline, m.tab & span, line, column);
+            if (stop) return i + __builtin_ctzll(stop);
+        }
+        for (; i < n && isBlank(p[i]); i++) {
+            if (p[i] == '\n') {
+                line++;
+                column = 1;
+            } else if (p[i] == '\t') {
+                column += 4;
+            } else {
+                column++;
+            }
+        }
+        return i;
+    }
+
+    /**
+     * @brief Offset of the first '\n' at or after p (n if none)
+     */
+    static size_t findNewline(const char* p, size_t n, int& column) {
+        size_t i = 0;
+        for (; i + kChunk <= n; i += kChunk) {
+            uint64_t nl = classify(p + i).newline;
+            if (nl) {
+                i += __builtin_ctzll(nl);
+                column += static_cast<int>(i);
+                return i;
+            }
+        }
+        while (i < n && p[i] != '\n') i++;
+        column += static_cast<int>(i);
+        return i;
+    }
+
+    /**
+     * @brief Offset just past the first "*\/" in p[0, n)
+     * @note If there is none, stops before the last byte (which is then
+     *       lexed as a token), matching the original scalar loop
+     */
+    static size_t skipBlockComment(const char* p, size_t n, int& line, int& column) {
+        size_t i = 0;
+        // Need p[i + kChunk] to see a '/' that closes a '*' in the last lane
+        for (; i + kChunk < n; i += kChunk) {
+            Masks m = classify(p + i);
+            uint64_t slash = m.slash | (static_cast<uint64_t>(p[i + kChunk] == '/') << kChunk);
+            uint64_t end = m.star & (slash >> 1);
+            if (end) {
+                int j = __builtin_ctzll(end);
+                advance((uint64_t(1) << j) - 1, m.newline, 0, line, column);
+                column += 2;
+                return i + j + 2;
+            }
+            advance(kFull, m.newline, 0, line, column);
+        }
+        for (; i + 1 < n; i++) {
+            if (p[i] == '*' && p[i + 1] == '/') {
+                column += 2;
+                return i + 2;
+            }
+            if (p[i] == '\n') {
+                line++;
+                column = 1;
+            } else {
+                column++;
+            }
+        }
+        return i;
+    }
+
+private:
+    struct Masks {
+        uint64_t blank;
+        uint64_t newline;
+        uint64_t tab;
+        uint64_t star;
+        uint64_t slash;
+    };
+
+#if defined(__AVX2__)
+    static constexpr int kChunk = 32;
+
+    static Masks classify(const char* p) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        auto eq = [v](char c) {
+            return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+        };
+        __m256i nl = eq('\n'), tab = eq('\t');
+        // '\v' '\f' '\r' are 0x0b..0x0d: (v - 0x0b) as unsigned <= 2
+        __m256i off = _mm256_sub_epi8(v, _mm256_set1_epi8(0x0b));
+        __m256i vfr = _mm256_cmpeq_epi8(_mm256_min_epu8(off, _mm256_set1_epi8(2)), off);
+        __m256i blank = _mm256_or_si256(_mm256_or_si256(eq(' '), vfr), _mm256_or_si256(nl, tab));
+        auto bits = [](__m256i m) {
+            return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(m)));
+        };
+        return {bits(blank), bits(nl), bits(tab), bits(eq('*')), bits(eq('/'))};
+    }
+#elif defined(__SSE2__)
+    static constexpr int kChunk = 16;
+
+    static Masks classify(const char* p) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        auto eq = [v](char c) {
+            return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+        };
+        __m128i nl = eq('\n'), tab = eq('\t');
+        // '\v' '\f' '\r' are 0x0b..0x0d: (v - 0x0b) as unsigned <= 2
+        __m128i off = _mm_sub_epi8(v, _mm_set1_epi8(0x0b));
+        __m128i vfr = _mm_cmpeq_epi8(_mm_min_epu8(off, _mm_set1_epi8(2)), off);
+        __m128i blank = _mm_or_si128(_mm_or_si128(eq(' '), vfr), _mm_or_si128(nl, tab));
+        auto bits = [](__m128i m) {
+            return static_cast<uint64_t>(_mm_movemask_epi8(m));
+        };
+        return {bits(blank), bits(nl), bits(tab), bits(eq('*')), bits(eq('/'))};
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static constexpr int kChunk = 16;
+
+    static Masks classify(const char* p) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        auto eq = [v](char c) {
+            return vceqq_u8(v, vdupq_n_u8(static_cast<uint8_t>(c)));
+        };
+        uint8x16_t nl = eq('\n'), tab = eq('\t');
+        uint8x16_t vfr = vcleq_u8(vsubq_u8(v, vdupq_n_u8(0x0b)), vdupq_n_u8(2));
+        uint8x16_t blank = vorrq_u8(vorrq_u8(eq(' '), vfr), vorrq_u8(nl, tab));
+        // No movemask on NEON: weight each lane by its bit and sum per half
+        auto bits = [](uint8x16_t m) {
+            static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                                1, 2, 4, 8, 16, 32, 64, 128};
+            uint8x16_t w = vandq_u8(m, vld1q_u8(weights));
+            return static_cast<uint64_t>(vaddv_u8(vget_low_u8(w))) |
+                   (static_cast<uint64_t>(vaddv_u8(vget_high_u8(w))) << 8);
+        };
+        return {bits(blank), bits(nl), bits(tab), bits(eq('*')), bits(eq('/'))};
+    }
+#else
+    static constexpr int kChunk = 16;
+
+    static Masks classify(const char* p) {
+        Masks m = {0, 0, 0, 0, 0};
+        for (int k = 0; k < kChunk; k++) {
+            uint64_t bit = uint64_t(1) << k;
+            if (isBlank(p[k])) m.blank |= bit;
+            if (p[k] == '\n') m.newline |= bit;
+            if (p[k] == '\t') m.tab |= bit;
+            if (p[k] == '*') m.star |= bit;
+            if (p[k] == '/') m.slash |= bit;
+        }
+        return m;
+    }
+#endif
+
+    static constexpr uint64_t kFull = (uint64_t(1) << kChunk) - 1;
+
+    static bool isBlank(char c) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    /**
+     * @brief Account for the bytes in span; tabs (already masked to span)
+     *        cost 3 extra columns each
+     */
+    static void advance(uint64_t span, uint64_t newline, uint64_t tabs, int& line, int& column) {
+        uint64_t nl = newline & span;
+        if (nl) {
+            line += __builtin_popcountll(nl);
+            int last = 63 - __builtin_clzll(nl);
+            uint64_t after = span & ~((uint64_t(2) << last) - 1);
+            column = 1 + __builtin_popcountll(after) + 3 * __builtin_popcountll(tabs & after);
+        } else {
+            column += __builtin_popcountll(span) + 3 * __builtin_popcountll(tabs);
+        }
+    }
+};
+
+#endif // SYSYC_SLRSCAN_H
@@ -8,94 +8,183 @@
 #ifndef SYSYC_SLRSUBSETCONSTRUCTION_H
 #define SYSYC_SLRSUBSETCONSTRUCTION_H
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <vector>
-#include <map>
 #include <set>
-#include <queue>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include "SLRNFA.h"
 #include "SLRDFA.h"
 
 class SubsetConstruction {
 public:
-    std::shared_ptr<SLRDFA> convert(std::shared_ptr<NFA> nfa) { 
+    // A set of NFA states as a bitset over dense state indices
+    using StateSet = std::vector<uint64_t>;
+
+    struct StateSetHash {
+        size_t operator()(const StateSet& set) const {
+            uint64_t h = 1469598103934665603ull;
+            for (uint64_t word : set) {
+                h = (h ^ word) * 1099511628211ull;
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    std::shared_ptr<SLRDFA> convert(std::shared_ptr<NFA> nfa) {
         auto dfa = std::make_shared<SLRDFA>();
-        std::map<std::set<std::shared_ptr<NFAState>>, std::shared_ptr<SLRDFAState>> stateMap;
-        
-        std::set<std::shared_ptr<NFAState>> startSet = NFATools::epsilonClosure({nfa->start});
-        dfa->start = getOrCreateDFAState(startSet, dfa, stateMap);
+        indexStates(nfa);
 
-        std::queue<std::set<std::shared_ptr<NFAState>>> worklist;
-        worklist.push(startSet);
+        std::unordered_map<StateSet, std::shared_ptr<SLRDFAState>, StateSetHash> stateMap;
+        std::vector<StateSet> sets;     // discovery order; doubles as the BFS worklist
 
-        std::vector<char> alphabet = buildAlphabet(nfa);
+        StateSet startSet = emptySet();
+        addState(startSet, 0);
+        epsilonClosure(startSet);
+        dfa->start = getOrCreateDFAState(startSet, dfa, stateMap, sets);
 
-        while (!worklist.empty()) {
-            auto currentSet = worklist.front();
-            worklist.pop();
-            auto currentDFAState = stateMap[currentSet];
-            
-            for (char c : alphabet) {
-                std::set<std::shared_ptr<NFAState>> nextSet = NFATools::move(currentSet, c);
-
-                if (!nextSet.empty()) {
-                    std::set<std::shared_ptr<NFAState>> closureSet = NFATools::epsilonClosure(nextSet);
-
-                    if (stateMap.find(closureSet) == stateMap.end()) {
-                        auto nextDFAState = getOrCreateDFAState(closureSet, dfa, stateMap);
-                        currentDFAState->addTransition(c, nextDFAState);
-                        worklist.push(closureSet);
-                    } else {
-                        auto nextDFAState = stateMap[closureSet];
-                        currentDFAState->addTransition(c, nextDFAState);
+        std::vector<char> alphabet = buildAlphabet();
+        std::vector<StateSet> targets(256);
+        std::vector<bool> touched(256);
+
+        for (size_t next = 0; next < sets.size(); ++next) {
+            auto currentDFAState = stateMap[sets[next]];
+
+            // One pass over the members collects the move set of every character
+            std::fill(touched.begin(), touched.end(), false);
+            forEachState(sets[next], [&](int s) {
+                for (auto& edge : edges[s]) {
+                    auto slot = static_cast<unsigned char>(edge.first);
+                    if (!touched[slot]) {
+                        touched[slot] = true;
+                        targets[slot] = emptySet();
                     }
+                    for (int t : edge.second) addState(targets[slot], t);
                 }
+            });
+
+            for (char c : alphabet) {
+                auto slot = static_cast<unsigned char>(c);
+                if (!touched[slot]) continue;
+                epsilonClosure(targets[slot]);
+                currentDFAState->addTransition(c, getOrCreateDFAState(targets[slot], dfa, stateMap, sets));
             }
         }
         return dfa;
     }
-    
-    std::vector<char> buildAlphabet(std::shared_ptr<NFA> nfa) {
-        std::set<char> charset;
-        for (auto &state : nfa->states) {
-            for (auto &kv : state->transitions) {
-                char c = kv.first;
-                if (c != '\0') charset.insert(c);
+
+private:
+    std::vector<std::shared_ptr<NFAState>> states;              // index -> state, start is 0
+    std::vector<std::vector<int>> epsilon;                      // epsilon successors
+    std::vector<std::vector<std::pair<char, std::vector<int>>>> edges;  // non-epsilon edges
+    size_t words = 0;
+
+    // Numbers every state reachable from the start; sub-automata built separately
+    // reuse ids, so NFAState::id cannot serve as the index.
+    void indexStates(const std::shared_ptr<NFA>& nfa) {
+        states.clear();
+        epsilon.clear();
+        edges.clear();
+        std::unordered_map<NFAState*, int> index;
+        auto indexOf = [&](const std::shared_ptr<NFAState>& s) {
+            auto it = index.find(s.get());
+            if (it != index.end()) return it->second;
+            int id = static_cast<int>(states.size());
+            index.emplace(s.get(), id);
+            states.push_back(s);
+            return id;
+        };
+        indexOf(nfa->start);
+        for (size_t i = 0; i < states.size(); ++i) {
+            epsilon.emplace_back();
+            edges.emplace_back();
+            for (auto& kv : states[i]->transitions) {
+                std::vector<int> succ;
+                for (auto& target : kv.second) succ.push_back(indexOf(target));
+                if (kv.first == '\0') {
+                    epsilon[i] = std::move(succ);
+                } else {
+                    edges[i].emplace_back(kv.first, std::move(succ));
+                }
             }
         }
+        words = (states.size() + 63) / 64;
+    }
+
+    StateSet emptySet() const { return StateSet(words, 0); }
+
+    static bool addState(StateSet& set, int s) {
+        uint64_t bit = uint64_t(1) << (s & 63);
+        if (set[s >> 6] & bit) return false;
+        set[s >> 6] |= bit;
+        return true;
+    }
+
+    template <typename F>
+    static void forEachState(const StateSet& set, F&& f) {
+        for (size_t w = 0; w < set.size(); ++w) {
+            for (uint64_t bits = set[w]; bits != 0; bits &= bits - 1) {
+                f(static_cast<int>(w * 64 + __builtin_ctzll(bits)));
+            }
+        }
+    }
+
+    void epsilonClosure(StateSet& set) const {
+        std::vector<int> stack;
+        forEachState(set, [&](int s) { stack.push_back(s); });
+        while (!stack.empty()) {
+            int current = stack.back();
+            stack.pop_back();
+            for (int next : epsilon[current]) {
+                if (addState(set, next)) stack.push_back(next);
+            }
+        }
+    }
+
+    std::vector<char> buildAlphabet() const {
+        std::set<char> charset;
+        for (auto& out : edges) {
+            for (auto& edge : out) charset.insert(edge.first);
+        }
         return std::vector<char>(charset.begin(), charset.end());
     }
 
-    std::shared_ptr<SLRDFAState> getOrCreateDFAState(const std::set<std::shared_ptr<NFAState>>& nfaStates, 
-        std::shared_ptr<SLRDFA> dfa, 
-        std::map<std::set<std::shared_ptr<NFAState>>, std::shared_ptr<SLRDFAState>>& stateMap) {
-        
-        if (stateMap.find(nfaStates) != stateMap.end()) {
-            return stateMap[nfaStates];
+    std::shared_ptr<SLRDFAState> getOrCreateDFAState(const StateSet& nfaStates,
+        std::shared_ptr<SLRDFA> dfa,
+        std::unordered_map<StateSet, std::shared_ptr<SLRDFAState>, StateSetHash>& stateMap,
+        std::vector<StateSet>& sets) {
+
+        auto it = stateMap.find(nfaStates);
+        if (it != stateMap.end()) {
+            return it->second;
         }
 
-        auto dfaState = dfa->createState(); 
-        stateMap[nfaStates] = dfaState; 
-    
+        auto dfaState = dfa->createState();
+        stateMap.emplace(nfaStates, dfaState);
+        sets.push_back(nfaStates);
+
         setAcceptInfoFromNFAStates(nfaStates, dfaState);
-        
+
         return dfaState;
     }
 
-    void setAcceptInfoFromNFAStates(const std::set<std::shared_ptr<NFAState>>& nfaStates, 
-        std::shared_ptr<SLRDFAState> dfaState) {
-        
+    void setAcceptInfoFromNFAStates(const StateSet& nfaStates,
+        std::shared_ptr<SLRDFAState> dfaState) const {
+
         std::shared_ptr<NFAState> bestAcceptState = nullptr;
-        
-        for (auto state : nfaStates) {
-            if (state->isAccept) { 
-                if (bestAcceptState == nullptr || state->priority > bestAcceptState->priority) { 
+
+        forEachState(nfaStates, [&](int s) {
+            auto& state = states[s];
+            if (state->isAccept) {
+                if (bestAcceptState == nullptr || state->priority > bestAcceptState->priority) {
                     bestAcceptState = state;
                 }
             }
-        }
-        
+        });
+
         if (bestAcceptState != nullptr) {
             dfaState->isAccept = true;
             dfaState->acceptType = bestAcceptState->acceptType;
@@ -0,0 +1,107 @@
+/*!
+ * @file SLRTable.h
+ * @brief Precomputed SLR tables and their binary serialization format
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_SLRTABLE_H
+#define SYSYC_SLRTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Action types
+enum ActionType { ACC, SHIFT, REDUCE, ERR };
+
+struct Action {
+    ActionType type = ERR;
+    int target = 0;
+
+    bool operator==(const Action& other) const {
+        return type == other.type && target == other.target;
+    }
+};
+
+/**
+ * @brief Everything SLRParser::parse needs that is derived from the grammar.
+ *
+ * The tables only depend on initGrammar(), so they are built once (at build
+ * time by slr_tablegen, or lazily at runtime) and shared read-only by every
+ * parser instance.
+ *
+ * Grammar symbols are interned to dense ids: terminals take [0, numTerminals)
+ * and non-terminals take [numTerminals, symbols.size()). ACTION and GOTO are
+ * flat row-major arrays indexed by (state, id), so a parse step is a single
+ * load; empty ACTION cells are ERR and empty GOTO cells are -1.
+ *
+ * Binary layout (all integers little-endian):
+ *   "SLRT" u32 version u32 grammarHash
+ *   u32 nSymbols   { u16 len, bytes }            symbol names, by id
+ *   u32 nTerminals u32 nStates
+ *   u32 nAction    { u32 state, u16 sym, u8 type, u32 target }
+ *   u32 nGoto      { u32 state, u16 sym, u32 target }
+ *   u32 nFollow    { u16 nonTerminal, u16 n, u16 sym * n }
+ * Only non-empty cells are stored; the dense arrays are rebuilt on load.
+ */
+struct SLRTables {
+    static constexpr uint32_t kVersion = 2;
+
+    uint32_t grammarHash = 0;
+    std::vector<std::string> symbols;
+    int numTerminals = 0;
+    int numStates = 0;
+    std::map<std::string, std::set<std::string>> follow;
+
+    /**
+     * @brief Assign symbol ids and allocate empty tables for nStates states
+     */
+    void reset(const std::set<std::string>& terminals,
+               const std::set<std::string>& nonTerminals, int nStates);
+
+    /**
+     * @brief Id of a grammar symbol, or -1 if it is not part of the grammar
+     */
+    int symbolId(const std::string& name) const;
+
+    int numNonTerminals() const { return static_cast<int>(symbols.size()) - numTerminals; }
+    bool isTerminal(int sym) const { return sym >= 0 && sym < numTerminals; }
+
+    const Action& action(int state, int terminal) const {
+        return actionCells[state * numTerminals + terminal];
+    }
+    Action& action(int state, int terminal) {
+        return actionCells[state * numTerminals + terminal];
+    }
+    int goTo(int state, int nonTerminal) const {
+        return gotoCells[state * numNonTerminals() + (nonTerminal - numTerminals)];
+    }
+    int& goTo(int state, int nonTerminal) {
+        return gotoCells[state * numNonTerminals() + (nonTerminal - numTerminals)];
+    }
+
+    std::vector<unsigned char> serialize() const;
+
+    /**
+     * @brief Decode a blob produced by serialize()
+     * @return false if the blob is truncated, has a bad magic/version, or
+     *         was produced for a different grammar
+     */
+    static bool deserialize(const unsigned char* data, size_t size,
+                            uint32_t expectedGrammarHash, SLRTables& out);
+
+    bool operator==(const SLRTables& other) const;
+
+private:
+    std::map<std::string, int> ids;
+    std::vector<Action> actionCells;
+    std::vector<int> gotoCells;
+
+    void allocate();
+};
+
+#endif // SYSYC_SLRTABLE_H
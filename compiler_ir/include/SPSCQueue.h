@@ -0,0 +1,56 @@
+/*!
+ * @file SPSCQueue.h
+ * @brief Bounded lock-free single-producer/single-consumer ring buffer
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_SPSCQUEUE_H
+#define SYSYC_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Ring buffer with one writer thread and one reader thread
+ * @tparam Capacity number of slots, must be a power of two
+ */
+template <typename T, size_t Capacity>
+class SPSCQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SPSCQueue capacity must be a power of two");
+
+public:
+    bool tryPush(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - headCache == Capacity) {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache == Capacity) return false;
+        }
+        slots[t & (Capacity - 1)] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tailCache) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache) return false;
+        }
+        out = slots[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T slots[Capacity];
+    // Producer and consumer indices live on separate cache lines; each side
+    // keeps a stale copy of the other's index to avoid touching it per item
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t headCache = 0;
+    alignas(64) std::atomic<size_t> head{0};
+    size_t tailCache = 0;
+};
+
+#endif // SYSYC_SPSCQUEUE_H
@@ -0,0 +1,30 @@
+/*!
+ * @file SimplifyCFG.h
+ * @brief 控制流图化简
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_SIMPLIFYCFG_H
+#define SYSYC_SIMPLIFYCFG_H
+
+#include "PassManager.h"
+
+/**
+ * @brief 控制流图化简
+ *
+ * 反复执行以下变换直到不再变化，并同步维护前驱/后继链与phi的来源：
+ * - 删除基本块中第一条终结指令之后的指令（return 之后的语句）；
+ * - 条件为常量或两个目标相同的条件跳转改为无条件跳转；
+ * - 删除从入口不可达的基本块；
+ * - 唯一前驱以无条件跳转进入的基本块并入前驱；
+ * - 只含一条无条件跳转的空块由其前驱直接跳过（目标块有phi时不做）。
+ */
+class SimplifyCFG : public FunctionPass {
+public:
+    const char *get_name() const override { return "simplifycfg"; }
+
+    bool run_on_function(Function *f) override;
+};
+
+#endif // SYSYC_SIMPLIFYCFG_H
@@ -0,0 +1,47 @@
+/*!
+ * @file SourceBuffer.h
+ * @brief 只读源文件缓冲区（优先使用 mmap）
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_SOURCEBUFFER_H
+#define SYSYC_SOURCEBUFFER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief 源文件内容的只读视图
+ *
+ * 常规文件直接 mmap 到内存，词法分析产生的 Token 以 string_view 指向这段
+ * 内存，整个前端不再复制源码。无法映射时（空文件、管道等）退化为一次性
+ * 读入 std::string。Token 的生命周期不能超过其所在的 SourceBuffer。
+ */
+class SourceBuffer {
+public:
+    SourceBuffer() = default;
+    ~SourceBuffer();
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    /**
+     * @brief 打开并映射文件
+     * @return 文件无法打开时返回 false
+     */
+    bool open(const std::string& path);
+
+    std::string_view text() const { return {data_, size_}; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::string fallback_;      // 无法 mmap 时的文件内容
+
+    void close();
+};
+
+#endif // SYSYC_SOURCEBUFFER_H
@@ -0,0 +1,96 @@
+/*!
+ * @file Stats.h
+ * @brief 编译阶段计时、内存分配与计数统计（--time-passes / --stats）
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_STATS_H
+#define SYSYC_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief 进程级统计登记表
+ *
+ * 未启用时各接口只做一次原子读取即返回，不影响正常编译。
+ * 启用后：
+ * - 每个阶段累计耗时、调用次数、operator new 次数与字节数；
+ * - 具名计数器累加 token、归约、指令等数量。
+ * 阶段按首次出现的顺序输出；阶段之间可以嵌套（耗时为包含子阶段的总时间），
+ * 多线程下各线程的耗时相加。
+ */
+class Stats {
+public:
+    /// @brief 当前线程的累计分配量
+    struct AllocCount {
+        uint64_t allocs;
+        uint64_t bytes;
+    };
+
+    /**
+     * @brief 启用统计，启用后才开始累计分配量
+     */
+    static void enable();
+    static bool enabled();
+
+    /**
+     * @brief 累加一个阶段的耗时和分配量
+     */
+    static void addTime(const char* phase, uint64_t ns, uint64_t calls, AllocCount alloc);
+
+    /**
+     * @brief 累加具名计数器
+     */
+    static void count(const char* name, uint64_t n);
+
+    /// @brief 当前线程自启用以来的分配量
+    static AllocCount threadAllocs();
+
+    /**
+     * @brief 输出统计结果
+     * @param phases 输出阶段耗时表
+     * @param counters 输出计数器表
+     * @param json 以一个JSON对象输出（包含两部分）
+     */
+    static void report(std::ostream& os, bool phases, bool counters, bool json);
+
+    static uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief 作用域计时器：析构时把耗时和分配量计入 phase
+     * @note phase 须为字符串字面量等长期有效的字符串
+     */
+    class Timer {
+    public:
+        explicit Timer(const char* phase) : phase(enabled() ? phase : nullptr) {
+            if (this->phase) {
+                alloc = threadAllocs();
+                start = nowNs();
+            }
+        }
+
+        ~Timer() {
+            if (!phase) return;
+            uint64_t ns = nowNs() - start;
+            AllocCount end = threadAllocs();
+            addTime(phase, ns, 1, {end.allocs - alloc.allocs, end.bytes - alloc.bytes});
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        const char* phase;
+        uint64_t start = 0;
+        AllocCount alloc = {0, 0};
+    };
+};
+
+#endif // SYSYC_STATS_H
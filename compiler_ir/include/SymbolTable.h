@@ -8,10 +8,12 @@
 #ifndef SYSYC_SYMBOLTABLE_H
 #define SYSYC_SYMBOLTABLE_H
 
+#include <deque>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <map>
 #include <vector>
-#include <memory>
 #include "Value.h"
 #include "Type.h"
 
@@ -30,48 +32,115 @@ struct SymbolInfo {
 };
 
 /**
- * @brief 作用域类
+ * @brief 标识符驻留表：名字到稠密编号的开放寻址哈希表
+ *
+ * 线性探测，装填因子超过 1/2 时翻倍重建；编号按首次出现的顺序分配，
+ * 可直接用作数组下标。
  */
-class Scope {
+class IdentTable {
+private:
+    struct Slot {
+        size_t hash = 0;
+        int id = -1;             // -1 表示空槽
+    };
+
+    std::vector<Slot> slots;
+    std::vector<std::string> names;  // 编号 -> 名字
+
+    size_t probe(std::string_view name, size_t hash) const {
+        size_t mask = slots.size() - 1;
+        size_t i = hash & mask;
+        while (slots[i].id >= 0 && !(slots[i].hash == hash && names[slots[i].id] == name)) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        for (const Slot& slot : old) {
+            if (slot.id >= 0) {
+                slots[probe(names[slot.id], slot.hash)] = slot;
+            }
+        }
+    }
+
 public:
-    std::map<std::string, SymbolInfo> symbols;  // 符号表
-    
-    Scope() = default;
-    
+    IdentTable() : slots(64) {}
+
     /**
-     * @brief 在当前作用域中查找符号
-     * @param name 符号名称
-     * @return SymbolInfo* 符号信息指针，未找到返回nullptr
+     * @brief 查找名字的编号
+     * @return int 编号，从未驻留过返回-1
      */
-    SymbolInfo* lookup(const std::string& name) {
-        auto it = symbols.find(name);
-        if (it != symbols.end()) {
-            return &it->second;
-        }
-        return nullptr;
+    int find(std::string_view name) const {
+        return slots[probe(name, std::hash<std::string_view>()(name))].id;
     }
-    
+
     /**
-     * @brief 在当前作用域中插入符号
-     * @param name 符号名称
-     * @param info 符号信息
-     * @return bool 成功返回true，重复定义返回false
+     * @brief 驻留名字，已存在时返回原编号
      */
-    bool insert(const std::string& name, const SymbolInfo& info) {
-        if (symbols.find(name) != symbols.end()) {
-            return false;  // 重复定义
+    int intern(std::string_view name) {
+        size_t hash = std::hash<std::string_view>()(name);
+        size_t i = probe(name, hash);
+        if (slots[i].id >= 0) {
+            return slots[i].id;
         }
-        symbols[name] = info;
-        return true;
+        int id = static_cast<int>(names.size());
+        names.emplace_back(name);
+        slots[i] = Slot{hash, id};
+        if (names.size() * 2 > slots.size()) {
+            grow();
+        }
+        return id;
     }
+
+    const std::string& name(int id) const { return names[id]; }
+
+    size_t size() const { return names.size(); }
 };
 
 /**
  * @brief 符号表类 - 管理多层作用域
+ *
+ * 所有作用域共用一张表：每个名字的编号索引到其最内层绑定，绑定之间按
+ * 遮蔽关系串成链。绑定按定义顺序压入 bindings，退出作用域时弹出该作用域的
+ * 绑定并恢复被遮蔽的外层绑定，因此查找与插入都不随嵌套深度变慢。
  */
 class SymbolTable {
 private:
-    std::vector<std::shared_ptr<Scope>> scopes;  // 作用域栈
+    struct Binding {
+        SymbolInfo info;
+        int ident;               // 名字编号
+        int shadowed;            // 被遮蔽的同名外层绑定下标，无则为-1
+        size_t depth;            // 所在作用域深度
+    };
+
+    IdentTable idents;
+    std::deque<Binding> bindings;     // deque 保证 lookup 返回的指针在插入后仍有效
+    std::vector<int> innermost;       // 名字编号 -> 最内层绑定下标，无则为-1
+    std::vector<size_t> scopeMarks;   // 各作用域进入时 bindings 的长度
+
+    SymbolInfo* innermostOf(const std::string& name) {
+        int id = idents.find(name);
+        if (id < 0 || innermost[id] < 0) return nullptr;
+        return &bindings[innermost[id]].info;
+    }
+
+    bool bind(const std::string& name, const SymbolInfo& info) {
+        if (scopeMarks.empty()) return false;
+        int id = idents.intern(name);
+        if (static_cast<size_t>(id) >= innermost.size()) {
+            innermost.resize(id + 1, -1);
+        }
+        int prev = innermost[id];
+        if (prev >= 0 && bindings[prev].depth == getScopeDepth()) {
+            return false;  // 重复定义
+        }
+        bindings.push_back(Binding{info, id, prev, getScopeDepth()});
+        innermost[id] = static_cast<int>(bindings.size()) - 1;
+        return true;
+    }
 
 public:
     SymbolTable() {
@@ -83,15 +152,20 @@ public:
      * @brief 进入新的作用域
      */
     void enterScope() {
-        scopes.push_back(std::make_shared<Scope>());
+        scopeMarks.push_back(bindings.size());
     }
     
     /**
      * @brief 退出当前作用域
      */
     void exitScope() {
-        if (scopes.size() > 1) {  // 保留全局作用域
-            scopes.pop_back();
+        if (scopeMarks.size() > 1) {  // 保留全局作用域
+            while (bindings.size() > scopeMarks.back()) {
+                const Binding& b = bindings.back();
+                innermost[b.ident] = b.shadowed;
+                bindings.pop_back();
+            }
+            scopeMarks.pop_back();
         }
     }
     
@@ -100,7 +174,7 @@ public:
      * @return bool 在全局作用域返回true
      */
     bool isGlobalScope() const {
-        return scopes.size() == 1;
+        return scopeMarks.size() == 1;
     }
     
     /**
@@ -108,7 +182,7 @@ public:
      * @return size_t 作用域深度
      */
     size_t getScopeDepth() const {
-        return scopes.size();
+        return scopeMarks.size();
     }
     
     /**
@@ -120,9 +194,7 @@ public:
      * @return bool 成功返回true，重复定义返回false
      */
     bool insert(const std::string& name, Value* value, Type* type, bool isConst) {
-        if (scopes.empty()) return false;
-        SymbolInfo info(value, type, isConst, isGlobalScope());
-        return scopes.back()->insert(name, info);
+        return bind(name, SymbolInfo(value, type, isConst, isGlobalScope()));
     }
     
     /**
@@ -132,9 +204,7 @@ public:
      * @return bool 成功返回true
      */
     bool put(const std::string& name, Value* value) {
-        if (scopes.empty()) return false;
-        SymbolInfo info(value, nullptr, false, isGlobalScope());
-        return scopes.back()->insert(name, info);
+        return bind(name, SymbolInfo(value, nullptr, false, isGlobalScope()));
     }
     
     /**
@@ -143,14 +213,7 @@ public:
      * @return SymbolInfo* 符号信息指针，未找到返回nullptr
      */
     SymbolInfo* lookup(const std::string& name) {
-        // 从内层作用域向外查找
-        for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
-            SymbolInfo* info = (*it)->lookup(name);
-            if (info != nullptr) {
-                return info;
-            }
-        }
-        return nullptr;
+        return innermostOf(name);
     }
     
     /**
@@ -159,8 +222,10 @@ public:
      * @return SymbolInfo* 符号信息指针，未找到返回nullptr
      */
     SymbolInfo* lookupCurrentScope(const std::string& name) {
-        if (scopes.empty()) return nullptr;
-        return scopes.back()->lookup(name);
+        int id = idents.find(name);
+        if (id < 0 || innermost[id] < 0) return nullptr;
+        Binding& b = bindings[innermost[id]];
+        return b.depth == getScopeDepth() ? &b.info : nullptr;
     }
     
     /**
@@ -179,10 +244,9 @@ public:
      */
     std::map<std::string, Value*> variable() {
         std::map<std::string, Value*> result;
-        for (const auto& scope : scopes) {
-            for (const auto& pair : scope->symbols) {
-                result[pair.first] = pair.second.value;
-            }
+        // 按定义顺序覆盖，内层绑定覆盖外层同名绑定
+        for (const auto& b : bindings) {
+            result[idents.name(b.ident)] = b.info.value;
         }
         return result;
     }
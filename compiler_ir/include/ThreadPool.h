@@ -0,0 +1,70 @@
+/*!
+ * @file ThreadPool.h
+ * @brief 工作窃取线程池
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_THREADPOOL_H
+#define SYSYC_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 固定线程数的工作窃取线程池
+ *
+ * 每个工作线程拥有自己的任务队列，从队尾取任务；
+ * 自己的队列为空时从其他线程的队首窃取任务。
+ */
+class ThreadPool {
+public:
+    /**
+     * @param numThreads 线程数，<= 0 时使用硬件并发数
+     */
+    explicit ThreadPool(int numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief 提交任务（轮流放入各线程队列）
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief 阻塞直到所有已提交任务执行完毕
+     */
+    void wait();
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextQueue{0};
+
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    size_t pending = 0;              // 已提交但未完成的任务数
+    long queued = 0;                 // 仍在队列中的任务数（入队与取出可能短暂乱序）
+    bool stopping = false;
+
+    void workerLoop(size_t self);
+    bool tryTake(size_t self, std::function<void()>& task);
+};
+
+#endif // SYSYC_THREADPOOL_H
@@ -0,0 +1,68 @@
+/*!
+ * @file ThreadedTokenStream.h
+ * @brief Lexes on a background thread and hands tokens over an SPSC queue
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_THREADEDTOKENSTREAM_H
+#define SYSYC_THREADEDTOKENSTREAM_H
+
+#include <atomic>
+#include <string_view>
+#include <thread>
+#include "SLRLexer.h"
+#include "SPSCQueue.h"
+#include "TokenStream.h"
+
+/**
+ * @brief Token stream fed by a lexer running on its own thread
+ *
+ * Lexing and parsing overlap, and at most kCapacity tokens are in flight,
+ * so memory stays bounded for very large inputs. The lexer and the source
+ * must outlive the stream; the worker is stopped and joined on destruction.
+ */
+class ThreadedTokenStream : public TokenStream {
+public:
+    static constexpr size_t kCapacity = 4096;
+
+    ThreadedTokenStream(SLRLexer& lexer, std::string_view source)
+        : stop(false), finished(false) {
+        lexer.reset(source);
+        worker = std::thread([this, &lexer] {
+            Token t;
+            while (!stop.load(std::memory_order_relaxed) && lexer.next(t)) {
+                while (!queue.tryPush(t)) {
+                    if (stop.load(std::memory_order_relaxed)) return;
+                    std::this_thread::yield();
+                }
+            }
+            finished.store(true, std::memory_order_release);
+        });
+    }
+
+    ~ThreadedTokenStream() override {
+        stop.store(true, std::memory_order_relaxed);
+        worker.join();
+    }
+
+    ThreadedTokenStream(const ThreadedTokenStream&) = delete;
+    ThreadedTokenStream& operator=(const ThreadedTokenStream&) = delete;
+
+    bool next(Token& out) override {
+        while (!queue.tryPop(out)) {
+            // Re-check after seeing the flag: the last push happens before it
+            if (finished.load(std::memory_order_acquire)) return queue.tryPop(out);
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+private:
+    SPSCQueue<Token, kCapacity> queue;
+    std::atomic<bool> stop;
+    std::atomic<bool> finished;
+    std::thread worker;
+};
+
+#endif // SYSYC_THREADEDTOKENSTREAM_H
@@ -0,0 +1,46 @@
+/*!
+ * @file TokenStream.h
+ * @brief Pull-based token source consumed by SLRParser
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_TOKENSTREAM_H
+#define SYSYC_TOKENSTREAM_H
+
+#include <vector>
+#include "Lexer.h"
+
+/**
+ * @brief Source of tokens read one lookahead at a time
+ */
+class TokenStream {
+public:
+    virtual ~TokenStream() = default;
+
+    /**
+     * @brief Fetch the next token
+     * @return false when the stream is exhausted
+     */
+    virtual bool next(Token& out) = 0;
+};
+
+/**
+ * @brief Stream over an already materialized token vector
+ */
+class VectorTokenStream : public TokenStream {
+private:
+    const std::vector<Token>& tokens;
+    size_t ip;
+
+public:
+    explicit VectorTokenStream(const std::vector<Token>& t) : tokens(t), ip(0) {}
+
+    bool next(Token& out) override {
+        if (ip >= tokens.size()) return false;
+        out = tokens[ip++];
+        return true;
+    }
+};
+
+#endif // SYSYC_TOKENSTREAM_H
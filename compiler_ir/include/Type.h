@@ -8,6 +8,7 @@
 #ifndef SYSYC_TYPE_H
 #define SYSYC_TYPE_H
 
+#include <cstddef>
 #include <iostream>
 #include <vector>
 
@@ -66,6 +67,28 @@ public:
      */
     virtual ~Type() = default;
 
+    /**
+     * @brief 从所属模块的内存池中分配，类型随 Module 一起释放
+     *
+     * @param size 对象大小
+     * @param m 所属模块
+     * @note 用法为 new (m) T(...)；不支持普通 new
+     */
+    static void *operator new(std::size_t size, Module *m);
+
+    /**
+     * @brief 构造函数抛出异常时取消在内存池中的登记
+     */
+    static void operator delete(void *p, Module *m);
+
+    static void *operator new(std::size_t size) = delete;
+
+protected:
+    /// 内存归 Module 所有，不单独释放
+    static void operator delete(void *) {}
+
+public:
+
     /**
      * @brief Get the type id object，获取类型ID
      *
@@ -255,6 +278,13 @@ public:
      */
     Module *get_module();
 
+    /**
+     * @brief 打印类型
+     *
+     * @param os 输出流
+     */
+    void print(std::ostream &os);
+
     /**
      * @brief 打印类型
      *
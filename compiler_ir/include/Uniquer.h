@@ -0,0 +1,93 @@
+/*!
+ * @file Uniquer.h
+ * @brief 可并发访问的类型与常量唯一化表
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_UNIQUER_H
+#define SYSYC_UNIQUER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief std::pair 键的哈希
+ */
+struct PairHash {
+    template <typename A, typename B>
+    size_t operator()(const std::pair<A, B> &p) const {
+        size_t h = std::hash<A>()(p.first);
+        return h ^ (std::hash<B>()(p.second) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
+    }
+};
+
+/**
+ * @brief 键到唯一对象的并发唯一化表
+ *
+ * 表按键的哈希分成若干分片，每个分片各有一把锁，不同线程取不同的键时互不等待。
+ * 前面再加一层线程局部的直接映射缓存：同一线程反复取同一个键（如常量0、1）
+ * 时不加锁。缓存项带表的编号，表析构后地址被复用时旧项不会误命中。
+ *
+ * @tparam Key 键，需可默认构造、可比较
+ * @tparam T 唯一化的对象类型，表只保存指针，不负责释放
+ */
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class Uniquer {
+public:
+    Uniquer() : id_(next_id_.fetch_add(1, std::memory_order_relaxed)) {}
+
+    Uniquer(const Uniquer &) = delete;
+    Uniquer &operator=(const Uniquer &) = delete;
+
+    /**
+     * @brief 取键对应的对象，不存在时调用 make() 创建
+     * @note make 在分片锁内调用，同一个键只会创建一次
+     */
+    template <typename Make>
+    T *get(const Key &key, Make &&make) {
+        size_t h = Hash()(key);
+        CacheEntry &slot = cache_[(h ^ (h >> 17)) & (kCacheSize - 1)];
+        if (slot.owner == id_ && slot.value && slot.key == key) {
+            return slot.value;
+        }
+        Shard &shard = shards_[(h >> 7) % kShards];
+        T *value;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            T *&entry = shard.map[key];
+            if (!entry) entry = make();
+            value = entry;
+        }
+        slot = CacheEntry{id_, key, value};
+        return value;
+    }
+
+private:
+    static constexpr size_t kShards = 16;
+    static constexpr size_t kCacheSize = 64;
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<Key, T *, Hash> map;
+    };
+
+    struct CacheEntry {
+        uint64_t owner = 0;
+        Key key{};
+        T *value = nullptr;
+    };
+
+    Shard shards_[kShards];
+    const uint64_t id_;
+
+    inline static std::atomic<uint64_t> next_id_{1};
+    inline static thread_local CacheEntry cache_[kCacheSize];
+};
+
+#endif // SYSYC_UNIQUER_H
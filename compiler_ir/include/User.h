@@ -16,8 +16,20 @@ class User : public Value {
 private:
 protected:
     std::vector<Value *> operands_; // operands of this value
+    std::vector<Use> uses_;         // 与 operands_ 一一对应的 use 节点
     unsigned num_ops_;              // value值的个数
 
+    /*!
+     *@brief 摘下全部 use 节点
+     *@note uses_ 扩容或删除元素会搬移节点，搬移前先摘下
+     */
+    void unlink_uses();
+
+    /*!
+     *@brief 重新编号并把非空操作数的 use 节点挂回使用链
+     */
+    void link_uses();
+
 public:
     /*!
      *@brief User的构造函数
@@ -53,6 +65,12 @@ public:
      */
     void set_operand(unsigned i, Value *v);
 
+    /*!
+     *@brief 复制另一个 User 的全部操作数，并登记相应的 use
+     *@param src 被复制的 User
+     */
+    void copy_operands_from(const User *src);
+
     /*!
      *@brief 添加新的value数值指针
      *@param v value数值指针
@@ -82,6 +100,13 @@ public:
      */
     void remove_use_of_ops();
 
+    /*!
+     *@brief 按登记顺序挂接 Value::defer_shared_uses 推迟的 use
+     *@param uses 登记表
+     *@note 只挂接仍指向原操作数且尚未挂接的节点，与当时直接挂接的结果相同
+     */
+    static void link_deferred(const std::vector<DeferredUse> &uses);
+
     /*!
      *@brief 添加新的value数值指针
      *@param index1 索引1
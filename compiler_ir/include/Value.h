@@ -8,20 +8,57 @@
 #ifndef SYSYC_VALUE_H
 #define SYSYC_VALUE_H
 
+#include <cstddef>
 #include <iostream>
 #include <list>
 #include <string>
+#include <vector>
 
 class Type;
 
 class Value;
 
-/*! use结构体，作为中间IR的基础*/
+class Module;
+
+/*! use结构体，作为中间IR的基础
+ *
+ * 每个 User 为自己的每个操作数持有一个 Use 节点，节点以侵入式双向链表
+ * 挂在被使用的 Value 上，因此添加与删除一次使用都是 O(1)。
+ */
 struct Use {
     Value *val_;      // 使用value的value
     unsigned arg_no_; // the no. of operand, e.g., func(a, b), a is 0, b is 1
+    Use *next_ = nullptr;   // 同一 Value 的下一个使用
+    Use **prev_ = nullptr;  // 指向前一节点的 next_（或表头），未挂接时为空
     Use(Value *val, unsigned no) : val_(val), arg_no_(no) {} // 构造函数
 
+    /*!
+     *@brief 是否挂在某个 Value 的使用链上
+     */
+    bool is_linked() const { return prev_ != nullptr; }
+
+    /*!
+     *@brief 挂到使用链表头
+     *@param head 使用链的表头
+     */
+    void link(Use **head) {
+        next_ = *head;
+        if (next_) next_->prev_ = &next_;
+        prev_ = head;
+        *head = this;
+    }
+
+    /*!
+     *@brief 从所在的使用链上摘下
+     */
+    void unlink() {
+        if (!prev_) return;
+        *prev_ = next_;
+        if (next_) next_->prev_ = prev_;
+        next_ = nullptr;
+        prev_ = nullptr;
+    }
+
     /*!
      *@brief 判定两个use是否相等
      *@param 待比较的use-1
@@ -33,13 +70,70 @@ struct Use {
     }
 };
 
+/*! 推迟挂接的 use：使用者与操作数序号，见 Value::defer_shared_uses */
+struct DeferredUse {
+    Value *user_;
+    unsigned arg_no_;
+};
+
+/*! 一个 Value 的使用链视图，可用于范围 for */
+class UseList {
+public:
+    class iterator {
+    public:
+        explicit iterator(Use *u) : u_(u) {}
+
+        Use &operator*() const { return *u_; }
+
+        Use *operator->() const { return u_; }
+
+        iterator &operator++() {
+            u_ = u_->next_;
+            return *this;
+        }
+
+        bool operator==(const iterator &o) const { return u_ == o.u_; }
+
+        bool operator!=(const iterator &o) const { return u_ != o.u_; }
+
+    private:
+        Use *u_;
+    };
+
+    explicit UseList(Use *head) : head_(head) {}
+
+    iterator begin() const { return iterator(head_); }
+
+    iterator end() const { return iterator(nullptr); }
+
+    bool empty() const { return head_ == nullptr; }
+
+    /*!
+     *@brief 使用次数，O(n)
+     */
+    size_t size() const {
+        size_t n = 0;
+        for (Use *u = head_; u; u = u->next_) n++;
+        return n;
+    }
+
+private:
+    Use *head_;
+};
+
 /*! value类，作为中间IR的基础*/
 class Value {
 private:
 protected:
     Type *type_;
-    std::list <Use> use_list_; // 使用value的value list
-    std::string name_;        // value名称
+    Use *use_head_ = nullptr;  // 使用该value的use链（侵入式，节点由各 User 持有）
+    mutable std::string name_;    // value名称，带编号的名称在首次 get_name 时才生成
+    const char *slot_prefix_ = nullptr;   // 编号名称前缀，如 "op"
+    int slot_ = -1;           // 函数内编号，-1 表示未编号
+    bool shared_ = false;     // 各函数体共用的值（常量、全局量、函数）
+
+    /// 非空时本线程对共享值的 use 只登记不挂接
+    static thread_local std::vector<DeferredUse> *deferred_uses_;
 
 public:
     /*!
@@ -52,8 +146,30 @@ public:
 
     /*!
      *@brief Value的析构函数
+     *@note 由所属 Module 的 IRArena 统一调用
      */
-    ~Value() = default;
+    virtual ~Value() = default;
+
+    /*!
+     *@brief 从所属模块的内存池中分配，对象随 Module 一起释放
+     *@param size 对象大小
+     *@param m 所属模块
+     *@note 用法为 new (m) T(...)；不支持普通 new
+     */
+    static void *operator new(std::size_t size, Module *m);
+
+    /*!
+     *@brief 构造函数抛出异常时取消在内存池中的登记
+     */
+    static void operator delete(void *p, Module *m);
+
+    static void *operator new(std::size_t size) = delete;
+
+protected:
+    /// 内存归 Module 所有，不单独释放
+    static void operator delete(void *) {}
+
+public:
 
     /*!
      *@brief 获取value的类型
@@ -63,16 +179,30 @@ public:
 
     /*!
      *@brief 获取使用该value的use list
-     *@return 返回use-list的引用
+     *@return use-list 视图，遍历期间不要修改链表
      */
-    std::list <Use> &get_use_list() { return use_list_; }
+    UseList get_use_list() const { return UseList(use_head_); }
 
     /*!
      *@brief 添加use
-     *@param val 使用该value的value
-     *@param arg_no 在指令中的顺序
+     *@param use 使用者持有的 Use 节点
+     *@note O(1)，节点挂到链表头
      */
-    void add_use(Value *val, unsigned arg_no = 0);
+    void add_use(Use &use) {
+        if (shared_ && deferred_uses_) {
+            deferred_uses_->push_back({use.val_, use.arg_no_});
+            return;
+        }
+        use.link(&use_head_);
+    }
+
+    /*!
+     *@brief 并行生成函数体时，本线程对共享值的 use 改为登记到 uses
+     *@param uses 登记表，nullptr 恢复直接挂接
+     *@note 多个线程不能同时修改同一条 use 链；登记的 use 之后由
+     *      User::link_deferred 在单个线程上按顺序挂接
+     */
+    static void defer_shared_uses(std::vector<DeferredUse> *uses) { deferred_uses_ = uses; }
 
     /*!
      *@brief 对于value设置名称
@@ -80,21 +210,58 @@ public:
      *@return 名称设置的布尔结果
      *@note
      *---------
-     *名字为空即设置新名字，设置后不再进行修改
+     *名字为空且未编号即设置新名字，设置后不再进行修改
      */
     bool set_name(std::string name) {
-        if (name_ == "") {
+        if (name_ == "" && slot_ < 0) {
             name_ = name;
             return true;
         }
         return false;
     }
 
+    /*!
+     *@brief 为未命名的value分配编号，名称为 prefix + slot
+     *@param prefix 名称前缀，须为静态字符串
+     *@param slot 编号
+     *@return 是否分配成功
+     *@note
+     *---------
+     *与 set_name 相同，已有名称或编号时不再修改；只记录整数，不生成字符串
+     */
+    bool set_slot(const char *prefix, int slot) {
+        if (name_ == "" && slot_ < 0) {
+            slot_prefix_ = prefix;
+            slot_ = slot;
+            return true;
+        }
+        return false;
+    }
+
+    /*!
+     *@brief 名称是否由 set_slot 编号得到（而不是 set_name 指定的）
+     */
+    bool is_numbered() const { return slot_ >= 0; }
+
     /*!
      *@brief 获取value的名称
      *@return value字符串常量
+     *@note 编号名称在此时才格式化
      */
-    std::string get_name() const;
+    const std::string &get_name() const;
+
+    /*!
+     *@brief 将名称写入输出流
+     *@param os 输出流
+     *@note 编号名称直接格式化输出，不生成字符串
+     */
+    void print_name(std::ostream &os) const {
+        if (slot_ >= 0 && name_.empty()) {
+            os << slot_prefix_ << slot_;
+        } else {
+            os << name_;
+        }
+    }
 
     /*!
      *@brief 替换所有对于旧value的引用，改为新的
@@ -116,12 +283,19 @@ public:
 
     /*!
      *@brief value的打印
-     *@return 默认为空
+     *@param os 输出流，默认不输出
      *@note
      *--------
-     *后期根据不同类型的value进行修改，作为一个虚函数出现
+     *后期根据不同类型的value进行修改，作为一个虚函数出现；
+     *直接写入输出流，不在内存中拼接字符串
+     */
+    virtual void print(std::ostream &os) {}
+
+    /*!
+     *@brief 打印为字符串，便于调试
+     *@return 打印结果
      */
-    virtual std::string print() { return ""; }
+    std::string print();
 };
 
 #endif // SYSYC_VALUE_H
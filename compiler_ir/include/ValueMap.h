@@ -0,0 +1,100 @@
+/*!
+ * @file ValueMap.h
+ * @brief 克隆与内联用的值映射表
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_VALUEMAP_H
+#define SYSYC_VALUEMAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Value;
+
+/**
+ * @brief 旧值到新值的映射：以指针为键的开放寻址哈希表
+ *
+ * 线性探测，装填因子超过 1/2 时翻倍重建。键与值都只是指针，
+ * 整张表是一块连续数组，查找一次探测通常就能命中。
+ * 克隆时按引用传递，每个操作数只查一次。
+ */
+class ValueMap {
+public:
+    explicit ValueMap(size_t expected = 16) {
+        size_t cap = 16;
+        while (cap < expected * 2) cap *= 2;
+        slots_.resize(cap);
+    }
+
+    /**
+     * @brief 登记 key -> value，已存在时覆盖
+     */
+    void insert(Value *key, Value *value) {
+        Slot &slot = slots_[probe(key)];
+        if (slot.key == nullptr) {
+            slot.key = key;
+            if (++size_ * 2 > slots_.size()) {
+                slot.value = value;
+                grow();
+                return;
+            }
+        }
+        slot.value = value;
+    }
+
+    /**
+     * @brief 查找 key 的映射
+     * @return 映射到的值，没有登记时为 nullptr
+     */
+    Value *lookup(const Value *key) const { return slots_[probe(key)].value; }
+
+    /**
+     * @brief 取 v 映射到的值，没有登记时为 v 本身
+     */
+    Value *map(Value *v) const {
+        Value *mapped = lookup(v);
+        return mapped ? mapped : v;
+    }
+
+    size_t size() const { return size_; }
+
+    void clear() {
+        std::fill(slots_.begin(), slots_.end(), Slot());
+        size_ = 0;
+    }
+
+private:
+    struct Slot {
+        Value *key = nullptr;
+        Value *value = nullptr;
+    };
+
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+
+    size_t probe(const Value *key) const {
+        size_t mask = slots_.size() - 1;
+        // 对象按 8 字节以上对齐，低位恒为零，先乘再取高位打散
+        size_t i = static_cast<size_t>((reinterpret_cast<uintptr_t>(key) * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+        while (slots_[i].key != nullptr && slots_[i].key != key) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void grow() {
+        std::vector<Slot> old(slots_.size() * 2);
+        old.swap(slots_);
+        for (const Slot &slot: old) {
+            if (slot.key != nullptr) {
+                slots_[probe(slot.key)] = slot;
+            }
+        }
+    }
+};
+
+#endif // SYSYC_VALUEMAP_H
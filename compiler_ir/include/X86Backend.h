@@ -0,0 +1,36 @@
+/*!
+ * @file X86Backend.h
+ * @brief x86-64 汇编输出（GNU as 的 AT&T 语法，System V ABI）
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_X86BACKEND_H
+#define SYSYC_X86BACKEND_H
+
+#include "MachineIR.h"
+
+#include <ostream>
+
+class Module;
+
+/**
+ * @brief 模块级的汇编生成入口
+ *
+ * 对每个定义的函数依次做指令选择（X86ISel）、寄存器分配（LinearScan）和
+ * 汇编输出；全局变量写入 .data / .rodata，函数中用到的浮点常量汇总成
+ * 模块末尾的常量池。栈帧以 %rbp 为基址：被调用者保存寄存器的保存区在最上，
+ * 其下依次是各栈槽，最底部留出经栈传参的空间，总大小按 16 字节对齐。
+ */
+class X86Backend {
+public:
+    /**
+     * @brief 把模块翻译为汇编写到 os
+     */
+    static void emit(Module *m, std::ostream &os);
+
+private:
+    static void emit_function(const MFunction &mf, std::ostream &os);
+};
+
+#endif // SYSYC_X86BACKEND_H
@@ -0,0 +1,99 @@
+/*!
+ * @file X86ISel.h
+ * @brief 中间代码到 x86-64 机器指令的指令选择
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_X86ISEL_H
+#define SYSYC_X86ISEL_H
+
+#include "MachineIR.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+class BasicBlock;
+class CmpInst;
+class Function;
+class GetElementPtrInst;
+class Instruction;
+class Type;
+class Value;
+
+/**
+ * @brief 逐函数的指令选择
+ *
+ * 每个有结果的指令和参数对应一个虚拟寄存器，按 System V 调用约定传参。
+ * 只被同一基本块末尾的条件跳转使用的比较直接生成 cmp + jcc；
+ * 下标全为常量的 getelementptr 折叠进访存的寻址方式。
+ * phi 消去为两段复制：前驱末尾写入 phi 专属的临时寄存器，
+ * 本块开头再复制给 phi 的结果，避免并行复制的覆盖问题。
+ */
+class X86ISel {
+public:
+    /**
+     * @param float_consts 模块共享的浮点常量池（位模式 -> 标号）
+     */
+    explicit X86ISel(std::map<uint32_t, std::string> &float_consts) : float_consts_(float_consts) {}
+
+    MFunction lower(Function *f);
+
+    /**
+     * @brief 中间代码类型在内存中的字节数
+     */
+    static int size_of(Type *ty);
+
+private:
+    std::map<uint32_t, std::string> &float_consts_;
+    MFunction *mf_ = nullptr;
+    MBlock *cur_ = nullptr;
+    std::unordered_map<Value *, int> vregs_;
+    std::unordered_map<Value *, int> phi_temps_;
+    std::unordered_map<Value *, int> slots_;
+    std::unordered_map<BasicBlock *, int> block_index_;
+
+    MInst &emit(MInst::Opcode op, std::vector<MOperand> ops, int size = 4);
+
+    int vreg_of(Value *v);
+
+    RegClass class_of(Type *ty) const;
+
+    int width_of(Type *ty) const;
+
+    MOperand value_op(Value *v);
+
+    MOperand reg_op(Value *v);
+
+    MOperand address(Value *ptr);
+
+    MOperand gep_address(GetElementPtrInst *gep);
+
+    void copy(const MOperand &src, const MOperand &dst, RegClass cls);
+
+    void lower_args(Function *f);
+
+    void lower_inst(Instruction *instr);
+
+    void lower_binary(Instruction *instr);
+
+    void lower_cmp(CmpInst *cmp);
+
+    Cond emit_compare(CmpInst *cmp, int &parity);
+
+    void lower_br(Instruction *instr);
+
+    void lower_call(Instruction *instr);
+
+    void emit_phi_copies(BasicBlock *from, BasicBlock *to);
+
+    bool is_fused_cmp(Instruction *instr) const;
+
+    static bool only_addressed(Instruction *gep);
+
+    std::string float_label(float value);
+};
+
+#endif // SYSYC_X86ISEL_H
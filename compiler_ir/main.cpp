@@ -12,10 +12,43 @@
 #include <vector>
 #include <exception>
 #include <dirent.h>
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
+#include <functional>
+#include "SourceBuffer.h"
 #include "SLRLexer.h"
+#include "ThreadedTokenStream.h"
 #include "SLRParser.h"
 #include "AST.h"
 #include "IRGenerator.h"
+#include "ThreadPool.h"
+#include "Stats.h"
+#include "X86Backend.h"
+#include "Interpreter.h"
+#include "IRBinary.h"
+#include "ParallelLexer.h"
+
+// 源文件不小于该大小时，-i 模式下词法分析与语法分析在两个线程上流水进行
+static const size_t kThreadedLexThreshold = 1 << 20;
+
+// 源文件不小于该大小时，-l/-p/-i 模式下按块在多个线程上并行做词法分析
+static const size_t kParallelLexThreshold = 16 << 20;
+
+// 中间代码优化等级，由 -O0 / -O1 / -O2 设置，对所有编译模式生效
+static int optLevel = 0;
+
+// 增量编译缓存目录，由 --cache-dir=DIR 设置，为空表示不使用缓存
+static std::string cacheDir;
+
+// 由 --profile 设置：-r 执行结束后在标准错误输出每条指令的执行次数
+static bool profileRun = false;
+
+// 单个文件内生成函数体的线程数，由 --ir-jobs=N 设置；0 为硬件并发数，
+// -j 已按文件并行，未指定时改为 1
+static int irJobs = 0;
 
 /**
  * @brief 打印使用说明
@@ -26,9 +59,43 @@ void printUsage(const char* programName) {
     std::cout << "  -l, --lexer    仅执行词法分析" << std::endl;
     std::cout << "  -p, --parser   执行词法和语法分析" << std::endl;
     std::cout << "  -i, --ir       执行完整编译（生成LLVM IR）" << std::endl;
+    std::cout << "  -S, --asm      生成 x86-64 汇编（System V ABI），输出到标准输出" << std::endl;
+    std::cout << "  -r, --run      生成IR后用内置解释器执行，返回值为 main 的返回值" << std::endl;
+    std::cout << "  -b, --binary <源文件> <输出文件>  生成IR并写成二进制中间代码" << std::endl;
+    std::cout << "                 -i/-S/-r 的输入也可以是二进制中间代码，此时跳过前端，函数体用到时才读入" << std::endl;
     std::cout << "  -t, --test     运行内置测试" << std::endl;
     std::cout << "  -a, --all      运行所有测试用例并输出结果到文件" << std::endl;
+    std::cout << "  -j N <文件或目录>...  使用N个线程并行编译，结果写到源文件旁的 .tok/.spe/.ll" << std::endl;
+    std::cout << "  --server       常驻进程，从标准输入接收编译请求，结果以带长度的分段写到标准输出" << std::endl;
     std::cout << "  -h, --help     显示此帮助信息" << std::endl;
+    std::cout << "  --time-passes  在标准错误输出各阶段耗时与内存分配" << std::endl;
+    std::cout << "  --stats[=json] 在标准错误输出 token/归约/指令等计数（json: 以JSON格式输出全部统计）" << std::endl;
+    std::cout << "  -O0, -O1, -O2  中间代码优化等级（默认 -O0；-O1: mem2reg、常量折叠、GVN、死代码删除、CFG化简）" << std::endl;
+    std::cout << "                 -O2: 在 -O1 基础上内联小函数" << std::endl;
+    std::cout << "  --profile      与 -r 一起使用，在标准错误输出每条IR指令的执行次数" << std::endl;
+    std::cout << "  --cache-dir=DIR  按函数缓存生成的IR，未改动的函数直接复用上次的结果" << std::endl;
+    std::cout << "  --ir-jobs=N    函数较多时用N个线程并行生成函数体（默认CPU核数，1 为顺序生成）" << std::endl;
+}
+
+/**
+ * @brief 解析线程数等正整数参数
+ * @return 整个字符串是不超过 int 范围的正整数时为 true
+ */
+bool parsePositive(std::string_view text, int& value) {
+    const char* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    return ec == std::errc() && ptr == end && value > 0;
+}
+
+/**
+ * @brief 对整个源文件做词法分析，大文件分块并行
+ */
+std::vector<Token> lexAll(SLRLexer& lexer, std::string_view sourceCode) {
+    Stats::Timer timer("lex");
+    if (sourceCode.size() >= kParallelLexThreshold) {
+        return ParallelLexer().analyze(sourceCode);
+    }
+    return lexer.analyze(sourceCode);
 }
 
 /**
@@ -41,19 +108,16 @@ int analyzeFileVerbose(const std::string& filename) {
     std::cout << "========================================" << std::endl;
 
     // 读取源文件
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    SourceBuffer source;
+    if (!source.open(filename)) {
         std::cout << "错误: 无法打开文件" << std::endl;
         return 1;
     }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string sourceCode = buffer.str();
-    file.close();
+    std::string_view sourceCode = source.text();
 
     // 词法分析
     SLRLexer lexer;
-    auto tokens = lexer.analyze(sourceCode);
+    auto tokens = lexAll(lexer, sourceCode);
 
     std::cout << "\n========== 词法分析结果 ==========" << std::endl;
     for (const auto& token : tokens) {
@@ -84,6 +148,170 @@ int analyzeFileVerbose(const std::string& filename) {
     return (hasLexError || !parseSuccess) ? 1 : 0;
 }
 
+/**
+ * @brief 统计词法分析耗时的 Token 流包装
+ *
+ * -i 模式下词法分析与语法分析交织进行，这里把语法分析器等待下一个 Token
+ * 的时间记为 lex 阶段（在独立线程上词法分析时即为等待时间）。
+ */
+class TimedTokenStream : public TokenStream {
+public:
+    explicit TimedTokenStream(TokenStream& inner) : inner(inner) {}
+
+    ~TimedTokenStream() override {
+        Stats::addTime("lex", ns, 1, alloc);
+        Stats::count("tokens", tokens);
+    }
+
+    bool next(Token& out) override {
+        Stats::AllocCount a0 = Stats::threadAllocs();
+        uint64_t t0 = Stats::nowNs();
+        bool ok = inner.next(out);
+        ns += Stats::nowNs() - t0;
+        Stats::AllocCount a1 = Stats::threadAllocs();
+        alloc.allocs += a1.allocs - a0.allocs;
+        alloc.bytes += a1.bytes - a0.bytes;
+        if (ok && out.type != TokenType::END_OF_FILE) tokens++;
+        return ok;
+    }
+
+private:
+    TokenStream& inner;
+    uint64_t ns = 0;
+    uint64_t tokens = 0;
+    Stats::AllocCount alloc = {0, 0};
+};
+
+/**
+ * @brief 流式语法分析，启用统计时额外记录词法分析耗时
+ */
+bool parseStream(SLRParser& parser, TokenStream& tokens) {
+    Stats::Timer timer("parse");
+    if (!Stats::enabled()) return parser.parse(tokens);
+    TimedTokenStream timed(tokens);
+    return parser.parse(timed);
+}
+
+/**
+ * @brief 单个源文件的编译结果
+ */
+enum class CaseStatus {
+    NOT_FOUND,      // 无法打开源文件
+    LEX_ERROR,      // 词法错误
+    PARSE_ERROR,    // 语法错误
+    OK              // 已生成IR
+};
+
+/**
+ * @brief 编译一段源码：Token 写到 tokOut，语法分析过程交给 parser 上设置的日志接收者，
+ *        生成IR后交给 emitIR 输出（词法或语法错误时不调用）
+ * @param lexer/parser 由调用者持有，可在多次编译间复用
+ * @param diag 语法/语义错误输出流
+ */
+CaseStatus compileSource(std::string_view sourceCode, const std::string& filepath,
+                         SLRLexer& lexer, SLRParser& parser,
+                         std::ostream& tokOut, std::ostream& diag,
+                         const std::function<void(IRGenerator&)>& emitIR) {
+    // 2. 词法分析 & 输出 Token
+    std::vector<Token> tokens;
+    {
+        Stats::Timer timer("lex");
+        tokens = lexer.analyze(sourceCode);
+    }
+    for (const auto& token : tokens) {
+        if (token.type != TokenType::END_OF_FILE) {
+            tokOut << token.toString() << std::endl;
+        }
+    }
+
+    bool hasLexError = false;
+    for (const auto& token : tokens) {
+        if (token.type == TokenType::ERROR) hasLexError = true;
+    }
+
+    // 3. 语法分析
+    parser.setDiagnostics(diag);
+    bool parseSuccess;
+    {
+        Stats::Timer timer("parse");
+        parseSuccess = parser.parse(tokens);
+    }
+
+    // 4. 中间代码生成 (仅当语法正确时)
+    if (parseSuccess && !hasLexError) {
+        auto ast = parser.getAST();
+        if (ast) {
+            IRGenerator generator(filepath);
+            generator.setDiagnostics(diag);
+            generator.setOptLevel(optLevel);
+            if (!cacheDir.empty()) generator.setCacheDir(cacheDir);
+            generator.setJobs(irJobs);
+            generator.generate(ast);
+            emitIR(generator);
+        }
+    }
+
+    if (hasLexError) return CaseStatus::LEX_ERROR;
+    if (!parseSuccess) return CaseStatus::PARSE_ERROR;
+    return CaseStatus::OK;
+}
+
+/**
+ * @brief 编译一个源文件，结果写到同名的 .tok / .spe / .ll 文件
+ * @param diag 语法/语义错误输出流
+ */
+CaseStatus compileToFiles(const std::string& filepath, std::ostream& diag) {
+    // 获取不带后缀的文件名 (例如 accept1)
+    std::string stem = filepath.substr(0, filepath.find_last_of('.'));
+
+    // 1. 读取源文件
+    SourceBuffer source;
+    if (!source.open(filepath)) {
+        return CaseStatus::NOT_FOUND;
+    }
+
+    SLRLexer lexer;
+    SLRParser parser;
+    CaseStatus status;
+    // 语法分析过程直接写入 .spe，不在内存中攒完整日志
+    std::string relPath = stem + ".spe";
+    std::ofstream speFile(relPath);
+    StreamParseLog parseLog(speFile);
+    if (speFile.is_open()) parser.setParseLog(&parseLog);
+    {
+        std::ofstream tokFile(stem + ".tok");
+        status = compileSource(source.text(), filepath, lexer, parser, tokFile, diag,
+                               [&](IRGenerator& generator) {
+            std::ofstream llFile(stem + ".ll");
+            generator.print(llFile);
+        });
+    }
+    if (!speFile.is_open()) {
+        diag << "无法写入语法输出文件 " << relPath << std::endl;
+    }
+    return status;
+}
+
+/**
+ * @brief 打印单个用例的摘要
+ */
+void printCaseSummary(const std::string& testCase, CaseStatus status) {
+    switch (status) {
+        case CaseStatus::NOT_FOUND:
+            std::cout << " FILE NOT FOUND" << std::endl;
+            break;
+        case CaseStatus::LEX_ERROR:
+            std::cout << " LEX ERROR -> " << testCase << ".tok" << std::endl;
+            break;
+        case CaseStatus::PARSE_ERROR:
+            std::cout << " PARSE ERROR -> " << testCase << ".tok" << std::endl;
+            break;
+        case CaseStatus::OK:
+            std::cout << " OK -> " << testCase << ".tok, " << testCase << ".ll" << std::endl;
+            break;
+    }
+}
+
 /**
  * @brief 运行所有测试用例并生成输出文件
  */
@@ -105,83 +333,173 @@ void runAllTestcases(const std::string& testDir) {
 
     for (const auto& testCase : allCases) {
         std::string filepath = testDir + "/" + testCase;
-        // 获取不带后缀的文件名 (例如 accept1)
-        std::string stem = filepath.substr(0, filepath.find_last_of('.'));
 
         std::cout << "Processing [" << testCase << "]..." << std::flush;
 
-        // 1. 读取源文件
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
-            std::cout << " FILE NOT FOUND" << std::endl;
-            continue;
-        }
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        std::string sourceCode = buffer.str();
-        file.close();
+        CaseStatus status = compileToFiles(filepath, std::cerr);
+        printCaseSummary(testCase, status);
+        if (status == CaseStatus::OK) successCount++;
+    }
 
-        // 2. 词法分析 & 输出到 .tok 文件
-        SLRLexer lexer;
-        auto tokens = lexer.analyze(sourceCode);
+    std::cout << "\n======================================" << std::endl;
+    std::cout << "完成! 成功生成IR: " << successCount << "/" << allCases.size() << std::endl;
+    std::cout << "请检查 " << testDir << " 目录下的生成文件。" << std::endl;
+    std::cout << "======================================" << std::endl;
+}
 
-        {
-            std::ofstream tokFile(stem + ".tok");
-            for (const auto& token : tokens) {
-                if (token.type != TokenType::END_OF_FILE) {
-                    tokFile << token.toString() << std::endl;
+/**
+ * @brief 收集待编译的源文件：普通文件原样保留，目录递归查找 *.sy（按路径排序）
+ */
+std::vector<std::string> collectSources(const std::vector<std::string>& paths) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> files;
+    for (const auto& path : paths) {
+        std::error_code ec;
+        if (fs::is_directory(path, ec)) {
+            std::vector<std::string> found;
+            for (auto it = fs::recursive_directory_iterator(path, ec);
+                 !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                if (it->is_regular_file(ec) && it->path().extension() == ".sy") {
+                    found.push_back(it->path().string());
                 }
             }
+            std::sort(found.begin(), found.end());
+            files.insert(files.end(), found.begin(), found.end());
+        } else {
+            files.push_back(path);
         }
+    }
+    return files;
+}
 
-        bool hasLexError = false;
-        for (const auto& token : tokens) {
-            if (token.type == TokenType::ERROR) hasLexError = true;
+/**
+ * @brief 并行批量编译（-j N）
+ *
+ * 每个源文件是一个独立任务，在工作窃取线程池上运行；各任务拥有自己的
+ * 词法/语法分析器和 Module，DFA 与 SLR 分析表在进程内只读共享。
+ * 诊断信息按任务缓存，全部完成后按输入顺序输出，因此结果与线程数无关。
+ */
+int runBatch(const std::vector<std::string>& paths, int jobs) {
+    std::vector<std::string> files = collectSources(paths);
+    std::vector<CaseStatus> status(files.size(), CaseStatus::NOT_FOUND);
+    std::vector<std::string> diagnostics(files.size());
+
+    {
+        ThreadPool pool(jobs);
+        if (pool.size() > 1 && irJobs == 0) irJobs = 1;
+        for (size_t i = 0; i < files.size(); i++) {
+            pool.submit([&, i] {
+                std::ostringstream diag;
+                status[i] = compileToFiles(files[i], diag);
+                diagnostics[i] = diag.str();
+            });
         }
+        pool.wait();
+    }
 
-        // 3. 语法分析
-        SLRParser parser;
-        bool parseSuccess = parser.parse(tokens);
-        std::string caseName = testCase;
-        size_t dotPos = caseName.find_last_of('.');
-        if (dotPos != std::string::npos) caseName = caseName.substr(0, dotPos);
-        std::string relPath = stem + ".spe";
-        try {
-            parser.saveParseLog(relPath);
-        } catch (const std::exception& e) {
-            std::cerr << "无法写入语法输出文件 " << relPath << ": " << e.what() << std::endl;
-        }
+    int successCount = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        std::cerr << diagnostics[i];
+        std::cout << "[" << files[i] << "]";
+        printCaseSummary(files[i].substr(0, files[i].find_last_of('.')), status[i]);
+        if (status[i] == CaseStatus::OK) successCount++;
+    }
+    std::cout << "完成! 成功生成IR: " << successCount << "/" << files.size() << std::endl;
+    return successCount == static_cast<int>(files.size()) ? 0 : 1;
+}
+
+// --server 的 source 请求中源码字节数的上限，超出时不读取源码，直接回复 bad-request
+static const size_t kMaxServerSource = 256 << 20;
+
+/**
+ * @brief 写出一个带长度前缀的响应分段：<名称> <字节数>\n<内容>
+ */
+static void writeSection(std::ostream& out, const char* name, const std::string& payload) {
+    out << name << " " << payload.size() << "\n" << payload;
+}
 
-        // 3. 中间代码生成 & 输出到 .ll 文件 (仅当语法正确时)
-        bool irGenerated = false;
-        if (parseSuccess && !hasLexError) {
-            auto ast = parser.getAST();
-            if (ast) {
-                IRGenerator generator(filepath);
-                generator.generate(ast);
-
-                std::ofstream llFile(stem + ".ll");
-                llFile << generator.print();
-                llFile.close();
-                irGenerated = true;
+/**
+ * @brief 编译服务器（--server）
+ *
+ * 进程常驻，DFA、SLR 分析表以及一组词法/语法分析器只构建一次，
+ * 之后每条请求只付出编译本身的开销。请求从 in 逐条读取：
+ *   compile <路径>\n                 编译磁盘上的文件
+ *   source <字节数> <名称>\n<源码>    编译随请求发送的源码，字节数不超过 kMaxServerSource
+ *   quit\n                           退出（输入结束同样退出）
+ * 每条请求在 out 上得到一个响应，依次为
+ *   status ok|lex-error|parse-error|not-found|bad-request\n
+ *   tok/spe/ll/diag 四个 "<名称> <字节数>\n<内容>" 分段（不适用的分段为空）
+ *   end\n
+ * 响应写完即刷新，便于编辑器或CI进程按行读取。
+ */
+int runServer(std::istream& in, std::ostream& out) {
+    SLRLexer lexer;
+    SLRParser parser;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream request(line);
+        std::string command, name;
+        request >> command;
+        if (command == "quit") break;
+        if (command.empty()) continue;
+
+        std::string source;
+        std::ostringstream tok, spe, ll, diag;
+        const char* status = "bad-request";
+        bool haveSource = false;
+        if (command == "compile" && std::getline(request >> std::ws, name) && !name.empty()) {
+            SourceBuffer buffer;
+            if (buffer.open(name)) {
+                source.assign(buffer.text());
+                haveSource = true;
+            } else {
+                status = "not-found";
             }
+        } else if (command == "source") {
+            size_t length = 0;
+            bool tooLarge = false;
+            if (request >> length && std::getline(request >> std::ws, name)) {
+                // 长度由客户端给出，过大或分配失败时只拒绝这一条请求，服务器继续运行
+                try {
+                    tooLarge = length > kMaxServerSource;
+                    if (!tooLarge) source.resize(length);
+                } catch (const std::bad_alloc&) {
+                    tooLarge = true;
+                }
+                if (!tooLarge) {
+                    in.read(&source[0], static_cast<std::streamsize>(length));
+                    haveSource = static_cast<size_t>(in.gcount()) == length;
+                }
+            }
+            if (tooLarge) {
+                diag << "错误: 源码不能超过 " << kMaxServerSource << " 字节" << std::endl;
+            } else if (!haveSource) {
+                diag << "错误: 请求格式应为 source <字节数> <名称>，随后是源码" << std::endl;
+            }
+        } else {
+            diag << "错误: 未知请求 " << command << std::endl;
         }
 
-        // 打印摘要
-        if (hasLexError) {
-            std::cout << " LEX ERROR -> " << testCase << ".tok" << std::endl;
-        } else if (!parseSuccess) {
-            std::cout << " PARSE ERROR -> " << testCase << ".tok" << std::endl;
-        } else {
-            std::cout << " OK -> " << testCase << ".tok, " << testCase << ".ll" << std::endl;
-            successCount++;
+        if (haveSource) {
+            StreamParseLog parseLog(spe);
+            parser.setParseLog(&parseLog);
+            CaseStatus result = compileSource(source, name, lexer, parser, tok, diag,
+                                              [&](IRGenerator& generator) { generator.print(ll); });
+            parser.setParseLog(nullptr);
+            switch (result) {
+                case CaseStatus::LEX_ERROR: status = "lex-error"; break;
+                case CaseStatus::PARSE_ERROR: status = "parse-error"; break;
+                default: status = "ok"; break;
+            }
         }
+        out << "status " << status << "\n";
+        writeSection(out, "tok", tok.str());
+        writeSection(out, "spe", spe.str());
+        writeSection(out, "ll", ll.str());
+        writeSection(out, "diag", diag.str());
+        out << "end" << std::endl;
     }
-
-    std::cout << "\n======================================" << std::endl;
-    std::cout << "完成! 成功生成IR: " << successCount << "/" << allCases.size() << std::endl;
-    std::cout << "请检查 " << testDir << " 目录下的生成文件。" << std::endl;
-    std::cout << "======================================" << std::endl;
+    return 0;
 }
 
 /**
@@ -193,18 +511,15 @@ int showDetailedLexer(const std::string& filename) {
     std::cout << "词法分析: " << filename << std::endl;
     std::cout << "========================================" << std::endl;
 
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    SourceBuffer source;
+    if (!source.open(filename)) {
         std::cout << "错误: 无法打开文件" << std::endl;
         return 1;
     }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string sourceCode = buffer.str();
-    file.close();
+    std::string_view sourceCode = source.text();
 
     SLRLexer lexer;
-    auto tokens = lexer.analyze(sourceCode);
+    auto tokens = lexAll(lexer, sourceCode);
 
     std::cout << "\n单词符号序列:" << std::endl;
     std::cout << "----------------------------------------" << std::endl;
@@ -234,26 +549,26 @@ int showDetailedLexer(const std::string& filename) {
 /**
  * @brief 手动构建AST进行IR生成测试 (仅用于 -t 测试)
  */
-std::shared_ptr<CompUnitNode> buildSimpleAST() {
-    auto compUnit = std::make_shared<CompUnitNode>();
+CompUnitNode* buildSimpleAST(ASTArena& arena) {
+    auto compUnit = arena.make<CompUnitNode>();
 
     // int a = 10;
-    auto varDecl = std::make_shared<VarDeclNode>();
+    auto varDecl = arena.make<VarDeclNode>();
     varDecl->bType = BType::INT;
-    auto varDef = std::make_shared<VarDefNode>();
+    auto varDef = arena.make<VarDefNode>();
     varDef->ident = "a";
-    auto num10 = std::make_shared<NumberNode>();
+    auto num10 = arena.make<NumberNode>();
     num10->intVal = 10;
-    auto primary10 = std::make_shared<PrimaryExpNode>();
+    auto primary10 = arena.make<PrimaryExpNode>();
     primary10->primaryType = PrimaryExpNode::PrimaryType::NUMBER;
     primary10->number = num10;
-    auto unary10 = std::make_shared<UnaryExpNode>();
+    auto unary10 = arena.make<UnaryExpNode>();
     unary10->unaryType = UnaryExpNode::UnaryType::PRIMARY;
     unary10->primaryExp = primary10;
-    auto mul10 = std::make_shared<MulExpNode>();
+    auto mul10 = arena.make<MulExpNode>();
     mul10->left = nullptr;
     mul10->right = unary10;
-    auto add10 = std::make_shared<AddExpNode>();
+    auto add10 = arena.make<AddExpNode>();
     add10->left = nullptr;
     add10->right = mul10;
     varDef->initVal = add10;
@@ -261,53 +576,53 @@ std::shared_ptr<CompUnitNode> buildSimpleAST() {
     compUnit->decls.push_back(varDecl);
 
     // int main() { a = 10; return 0; }
-    auto mainFunc = std::make_shared<FuncDefNode>();
+    auto mainFunc = arena.make<FuncDefNode>();
     mainFunc->returnType = BType::INT;
     mainFunc->ident = "main";
-    auto block = std::make_shared<BlockNode>();
+    auto block = arena.make<BlockNode>();
 
-    auto assignStmt = std::make_shared<StmtNode>();
+    auto assignStmt = arena.make<StmtNode>();
     assignStmt->stmtType = StmtType::ASSIGN;
-    auto lVal = std::make_shared<LValNode>();
+    auto lVal = arena.make<LValNode>();
     lVal->ident = "a";
     assignStmt->lVal = lVal;
-    auto num10_2 = std::make_shared<NumberNode>();
+    auto num10_2 = arena.make<NumberNode>();
     num10_2->intVal = 10;
-    auto primary10_2 = std::make_shared<PrimaryExpNode>();
+    auto primary10_2 = arena.make<PrimaryExpNode>();
     primary10_2->primaryType = PrimaryExpNode::PrimaryType::NUMBER;
     primary10_2->number = num10_2;
-    auto unary10_2 = std::make_shared<UnaryExpNode>();
+    auto unary10_2 = arena.make<UnaryExpNode>();
     unary10_2->unaryType = UnaryExpNode::UnaryType::PRIMARY;
     unary10_2->primaryExp = primary10_2;
-    auto mul10_2 = std::make_shared<MulExpNode>();
+    auto mul10_2 = arena.make<MulExpNode>();
     mul10_2->left = nullptr;
     mul10_2->right = unary10_2;
-    auto add10_2 = std::make_shared<AddExpNode>();
+    auto add10_2 = arena.make<AddExpNode>();
     add10_2->left = nullptr;
     add10_2->right = mul10_2;
     assignStmt->exp = add10_2;
-    auto item1 = std::make_shared<BlockItemNode>();
+    auto item1 = arena.make<BlockItemNode>();
     item1->stmt = assignStmt;
     block->items.push_back(item1);
 
-    auto retStmt = std::make_shared<StmtNode>();
+    auto retStmt = arena.make<StmtNode>();
     retStmt->stmtType = StmtType::RETURN;
-    auto num0 = std::make_shared<NumberNode>();
+    auto num0 = arena.make<NumberNode>();
     num0->intVal = 0;
-    auto primary0 = std::make_shared<PrimaryExpNode>();
+    auto primary0 = arena.make<PrimaryExpNode>();
     primary0->primaryType = PrimaryExpNode::PrimaryType::NUMBER;
     primary0->number = num0;
-    auto unary0 = std::make_shared<UnaryExpNode>();
+    auto unary0 = arena.make<UnaryExpNode>();
     unary0->unaryType = UnaryExpNode::UnaryType::PRIMARY;
     unary0->primaryExp = primary0;
-    auto mul0 = std::make_shared<MulExpNode>();
+    auto mul0 = arena.make<MulExpNode>();
     mul0->left = nullptr;
     mul0->right = unary0;
-    auto add0 = std::make_shared<AddExpNode>();
+    auto add0 = arena.make<AddExpNode>();
     add0->left = nullptr;
     add0->right = mul0;
     retStmt->exp = add0;
-    auto item2 = std::make_shared<BlockItemNode>();
+    auto item2 = arena.make<BlockItemNode>();
     item2->stmt = retStmt;
     block->items.push_back(item2);
 
@@ -336,18 +651,61 @@ int main() {
 )";
     std::cout << "源代码:" << code << std::endl;
 
-    auto ast = buildSimpleAST();
+    ASTArena arena;
+    auto ast = buildSimpleAST(arena);
     IRGenerator generator("test.sy");
     generator.generate(ast);
 
     std::cout << "生成的LLVM IR:" << std::endl;
-    std::cout << generator.print() << std::endl;
+    generator.print(std::cout);
+    std::cout << std::endl;
 }
 
 /**
- * @brief 主函数
+ * @brief -i/-S/-r/-b 的最后一步：输出中间代码、汇编或二进制中间代码，或者解释执行
+ * @param mode 命令行的第一个参数
+ * @param output -b 的输出文件
+ * @return 进程退出码，-r 时为 main 的返回值
  */
-int main(int argc, char* argv[]) {
+int finishModule(Module* module, const std::string& mode, const std::string& output) {
+    if (mode == "-S" || mode == "--asm") {
+        // 指令选择、寄存器分配与汇编输出
+        Stats::Timer timer("codegen");
+        X86Backend::emit(module, std::cout);
+        return 0;
+    }
+    if (mode == "-r" || mode == "--run") {
+        // 解释执行，程序的输入输出即本进程的标准输入输出
+        Interpreter interp(module);
+        interp.set_profiling(profileRun);
+        int ret;
+        try {
+            ret = interp.run_main();
+        } catch (const std::runtime_error& e) {
+            std::cerr << "错误: " << e.what() << std::endl;
+            return 1;
+        }
+        if (profileRun) interp.print_profile(std::cerr);
+        return ret & 0xff;
+    }
+    if (mode == "-b" || mode == "--binary") {
+        std::ofstream out(output, std::ios::binary);
+        if (out) IRBinaryWriter::write(module, out);
+        if (!out) {
+            std::cerr << "错误: 无法写入 " << output << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    module->print(std::cout);
+    std::cout << std::endl;
+    return 0;
+}
+
+/**
+ * @brief 执行命令行指定的功能
+ */
+int runCommand(int argc, char* argv[]) {
     if (argc < 2) {
         printUsage(argv[0]);
         return 1;
@@ -374,6 +732,25 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
+    if (arg1 == "-j" || arg1 == "--jobs") {
+        if (argc < 4) {
+            std::cerr << "错误: 用法 -j N <文件或目录>..." << std::endl;
+            return 1;
+        }
+        int jobs;
+        if (!parsePositive(argv[2], jobs)) {
+            std::cerr << "错误: -j 的线程数须为正整数: " << argv[2] << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::vector<std::string> paths(argv + 3, argv + argc);
+        return runBatch(paths, jobs);
+    }
+
+    if (arg1 == "--server") {
+        return runServer(std::cin, std::cout);
+    }
+
     if (arg1 == "-l" || arg1 == "--lexer") {
         if (argc < 3) {
             std::cerr << "错误: 请指定源文件" << std::endl;
@@ -391,35 +768,64 @@ int main(int argc, char* argv[]) {
         return analyzeFileVerbose(argv[2]);
     }
 
-    if (arg1 == "-i" || arg1 == "--ir") {
+    // -S、-r、-b 与 -i 共用前端，只是最后输出汇编、直接执行或写出二进制，且不打印提示信息
+    bool emitBinary = arg1 == "-b" || arg1 == "--binary";
+    bool quiet = arg1 == "-S" || arg1 == "--asm" || arg1 == "-r" || arg1 == "--run" || emitBinary;
+    if (arg1 == "-i" || arg1 == "--ir" || quiet) {
         if (argc < 3) {
             std::cerr << "错误: 请指定源文件" << std::endl;
             return 1;
         }
+        if (emitBinary && argc < 4) {
+            std::cerr << "错误: 请指定输出文件" << std::endl;
+            return 1;
+        }
 
         std::string filename = argv[2];
-        std::cout << "========================================" << std::endl;
-        std::cout << "分析文件并生成IR: " << filename << std::endl;
-        std::cout << "========================================" << std::endl;
-
-        // 1. 读取源文件
-        std::ifstream file(filename);
-        if (!file.is_open()) {
+        std::string output = emitBinary ? argv[3] : "";
+        SourceBuffer source;
+        if (!source.open(filename)) {
             std::cerr << "错误: 无法打开文件" << std::endl;
             return 1;
         }
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        std::string sourceCode = buffer.str();
-        file.close();
 
-        // 2. 词法分析
-        SLRLexer lexer;
-        auto tokens = lexer.analyze(sourceCode);
+        // 已经是二进制中间代码时直接加载，不经过前端与优化
+        if (IRBinaryReader::is_binary(source.text())) {
+            // 函数体在使用时才解码，内容损坏的异常也可能在输出过程中抛出
+            try {
+                std::unique_ptr<Module> module = IRBinaryReader::load(filename);
+                return finishModule(module.get(), arg1, output);
+            } catch (const std::runtime_error& e) {
+                std::cerr << "错误: " << e.what() << std::endl;
+                return 1;
+            }
+        }
 
-        // 3. 语法分析
+        if (!quiet) {
+            std::cout << "========================================" << std::endl;
+            std::cout << "分析文件并生成IR: " << filename << std::endl;
+            std::cout << "========================================" << std::endl;
+        }
+
+        // 1. 读取源文件
+        std::string_view sourceCode = source.text();
+
+        // 2. 词法分析 + 3. 语法分析：Token 以流的方式交给语法分析器，
+        //    大文件在独立线程上做词法分析，特别大的文件先分块并行做完词法分析
+        SLRLexer lexer;
         SLRParser parser;
-        bool parseSuccess = parser.parse(tokens);
+        bool parseSuccess;
+        if (sourceCode.size() >= kParallelLexThreshold) {
+            std::vector<Token> tokens = lexAll(lexer, sourceCode);
+            VectorTokenStream stream(tokens);
+            parseSuccess = parseStream(parser, stream);
+        } else if (sourceCode.size() >= kThreadedLexThreshold) {
+            ThreadedTokenStream tokens(lexer, sourceCode);
+            parseSuccess = parseStream(parser, tokens);
+        } else {
+            lexer.reset(sourceCode);
+            parseSuccess = parseStream(parser, lexer);
+        }
 
         if (!parseSuccess) {
             std::cerr << "错误: 语法分析失败，无法生成中间代码" << std::endl;
@@ -427,7 +833,7 @@ int main(int argc, char* argv[]) {
         }
 
         // 4. 中间代码生成
-        std::cout << "\n========== 中间代码生成 ==========" << std::endl;
+        if (!quiet) std::cout << "\n========== 中间代码生成 ==========" << std::endl;
         auto ast = parser.getAST();
 
         if (!ast) {
@@ -436,11 +842,68 @@ int main(int argc, char* argv[]) {
         }
 
         IRGenerator generator(filename);
+        generator.setOptLevel(optLevel);
+        if (!cacheDir.empty() && !quiet) generator.setCacheDir(cacheDir);
+        generator.setJobs(irJobs);
         generator.generate(ast);
-        std::cout << generator.print() << std::endl;
-        return 0;
+        // 有语义错误的模块中留有空操作数，指令选择、字节码翻译与二进制写出都无法处理
+        if (generator.hasErrors() && quiet) {
+            bool run = arg1 == "-r" || arg1 == "--run";
+            std::cerr << "错误: 存在语义错误，无法"
+                      << (run ? "执行" : emitBinary ? "写出二进制中间代码" : "生成汇编") << std::endl;
+            return 1;
+        }
+        return finishModule(generator.getModule(), arg1, output);
     }
 
     // 默认只做词法分析
     return showDetailedLexer(arg1);
 }
+
+/**
+ * @brief 主函数
+ * @note --time-passes / --stats / -O / --profile / --cache-dir / --ir-jobs 可出现在任意位置，先从参数中去掉再分派
+ */
+int main(int argc, char* argv[]) {
+    bool timePasses = false, counters = false, json = false;
+    std::vector<char*> args;
+    for (int i = 0; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i > 0 && (arg == "--time-passes" || arg == "--time-passes=json")) {
+            timePasses = true;
+            json = json || arg != "--time-passes";
+        } else if (i > 0 && (arg == "--stats" || arg == "--stats=json")) {
+            counters = true;
+            json = json || arg != "--stats";
+        } else if (i > 0 && (arg == "-O0" || arg == "-O1" || arg == "-O2")) {
+            optLevel = arg[2] - '0';
+        } else if (i > 0 && arg == "--profile") {
+            profileRun = true;
+        } else if (i > 0 && arg.rfind("--cache-dir=", 0) == 0) {
+            cacheDir = arg.substr(12);
+        } else if (i > 0 && arg.rfind("--ir-jobs=", 0) == 0) {
+            if (!parsePositive(std::string_view(arg).substr(10), irJobs)) {
+                std::cerr << "错误: --ir-jobs 的线程数须为正整数: " << arg.substr(10) << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    if (json) timePasses = counters = true;
+    args.push_back(nullptr);
+    if (!timePasses && !counters) return runCommand(static_cast<int>(args.size()) - 1, args.data());
+
+    Stats::enable();
+    {
+        // 先构造共享的 DFA 与 SLR 分析表，使其单独计为一个阶段
+        Stats::Timer timer("tables");
+        SLRParser::sharedTables();
+        SLRLexer::sharedTable();
+    }
+    int ret = runCommand(static_cast<int>(args.size()) - 1, args.data());
+    std::cout << std::flush;
+    Stats::report(std::cerr, timePasses, counters, json);
+    return ret;
+}
@@ -0,0 +1,34 @@
+/*!
+ * @file ASTArena.cpp
+ * @brief 抽象语法树节点的bump分配器实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "ASTArena.h"
+#include "AST.h"
+#include <cstdint>
+
+ASTArena::~ASTArena() {
+    // 子节点可能晚于父节点分配，这里只调用析构函数，不涉及节点间引用
+    for (auto* node : nodes) {
+        node->~ASTNode();
+    }
+}
+
+void* ASTArena::allocate(size_t size, size_t align) {
+    uintptr_t p = reinterpret_cast<uintptr_t>(cur);
+    size_t pad = (align - p % align) % align;
+    if (cur == nullptr || pad + size > left) {
+        size_t blockSize = size + align > kBlockSize ? size + align : kBlockSize;
+        blocks.emplace_back(new char[blockSize]);
+        cur = blocks.back().get();
+        left = blockSize;
+        p = reinterpret_cast<uintptr_t>(cur);
+        pad = (align - p % align) % align;
+    }
+    char* result = cur + pad;
+    cur = result + size;
+    left -= pad + size;
+    return result;
+}
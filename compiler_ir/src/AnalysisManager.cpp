@@ -0,0 +1,27 @@
+/*!
+ * @file AnalysisManager.cpp
+ * @brief 按函数缓存的CFG分析结果实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "AnalysisManager.h"
+#include "Stats.h"
+
+const Dominators &AnalysisManager::get_dominators(Function *f) {
+    auto &entry = cache_[f];
+    if (!entry.dom) {
+        entry.dom = std::make_unique<Dominators>(f);
+        Stats::count("dominator trees built", 1);
+    }
+    return *entry.dom;
+}
+
+const LoopInfo &AnalysisManager::get_loop_info(Function *f) {
+    const Dominators &dom = get_dominators(f);
+    auto &entry = cache_[f];
+    if (!entry.loops) {
+        entry.loops = std::make_unique<LoopInfo>(dom);
+    }
+    return *entry.loops;
+}
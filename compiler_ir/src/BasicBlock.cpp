@@ -6,6 +6,7 @@
  */
 #include "BasicBlock.h"
 #include "Function.h"
+#include "IRArena.h"
 #include "IRprinter.h"
 #include "Module.h"
 #include <cassert>
@@ -36,24 +37,9 @@ BasicBlock::BasicBlock(Module *m, const std::string &name = "",
  *@param 待添加的指令指针
  *@note
  *----------
- *在基本块的尾部添加指令
- *&emsp; 设置待添加的指令后缀为空
- *&emsp; **if** 如果指令链表为空
- *&emsp;&emsp; 设置指令为后继为空
- *&emsp;&emsp; 不为空，则获取指令链表的最后一个指令
- *&emsp;&emsp; 设置插入指令的前继为最后一个指令
- *&emsp;&emsp; 最后一个指令后继为待插入指令
- *&emsp; 尾部插入指令
+ *在基本块的尾部添加指令，前后继由指令链表维护
  */
 void BasicBlock::add_instruction(Instruction *instr) {
-    instr->setSuccInst(nullptr);
-    if (instr_list_.empty()) {
-        instr->setSuccInst(nullptr);
-    } else {
-        Instruction *last_inst = instr_list_.back();
-        instr->setPrevInst(last_inst);
-        last_inst->setSuccInst(instr);
-    }
     instr_list_.push_back(instr);
 }
 
@@ -66,6 +52,14 @@ void BasicBlock::add_instruction(Instruction *instr) {
  */
 Module *BasicBlock::get_module() { return get_parent()->get_parent(); }
 
+void *BasicBlock::operator new(std::size_t size, Module *m) {
+    return m->get_arena().allocate(IRArena::BasicBlocks, size);
+}
+
+void BasicBlock::operator delete(void *p, Module *m) {
+    m->get_arena().forget(IRArena::BasicBlocks, p);
+}
+
 /*!
  *@brief 将基本块从从属的函数中删除
  *@note
@@ -79,24 +73,9 @@ void BasicBlock::erase_from_parent() { this->get_parent()->remove(this); }
  *@param 待添加的指令指针
  *@note
  *----------
- *在基本块的头部添加指令
- *&emsp; 设置待添加的指令前继为空
- *&emsp; **if** 如果指令链表为空
- *&emsp;&emsp; 设置指令为后继为空
- *&emsp;&emsp; 不为空，则获取指令链表的第一个指令
- *&emsp;&emsp; 设置插入指令的后继为第一个指令
- *&emsp;&emsp; 第一个指令前继为待插入指令
- *&emsp; 头部插入指令
+ *在基本块的头部添加指令，前后继由指令链表维护
  */
 void BasicBlock::add_instr_begin(Instruction *instr) {
-    instr->setPrevInst(nullptr);
-    if (instr_list_.empty()) {
-        instr->setSuccInst(nullptr);
-    } else {
-        Instruction *first_inst = instr_list_.front();
-        instr->setSuccInst(first_inst);
-        first_inst->setPrevInst(instr);
-    }
     instr_list_.push_front(instr);
 }
 
@@ -109,9 +88,7 @@ void BasicBlock::add_instr_begin(Instruction *instr) {
  *&emsp; 设置指令的从属基本块
  *&emsp; 获取指令链表的开始
  *&emsp;&emsp; **for** 循环，遍历获得phi指令点
- *&emsp; **if** 如果不是链表头，phi节点前继为节点前继
- *&emsp; **if** 如果不是链表尾，phi节点后继设置为节点本身
- *&emsp; 修正插入节点的连接关系，前继和后继的修改
+ *&emsp; 插入到第一条非phi指令之前
  */
 void BasicBlock::add_instr_after_phi(Instruction *instr) {
     instr->set_parent(this);
@@ -122,24 +99,6 @@ void BasicBlock::add_instr_after_phi(Instruction *instr) {
             break;
         }
     }
-    //获取插入点
-    Instruction *front = nullptr, *back = nullptr;
-    if (it != instr_list_.begin()) {
-        front = *(--it);
-        ++it;
-    }
-    if (it != instr_list_.end()) {
-        back = *it;
-    }
-    if (front != nullptr) {
-        front->setSuccInst(instr);
-    }
-    if (back != nullptr) {
-        back->setPrevInst(instr);
-    }
-    // 设置待插入节点的前后继
-    instr->setPrevInst(front);
-    instr->setSuccInst(back);
     instr_list_.insert(it, instr);
 }
 
@@ -148,26 +107,11 @@ void BasicBlock::add_instr_after_phi(Instruction *instr) {
  *@param 待删除的指令指针
  *@note
  *----------
- *&emsp; 删除维护的指令链表中的指令
- *&emsp; 获取删除的指令的前后指令
- *&emsp; 修正指令的链接关系：
- *&emsp; **if** 如果前置指令不为空
- *&emsp;&emsp; 为前置指令设置新的后置指令
- *&emsp; **if** 如果后置指令不为空
- *&emsp;&emsp; 为后置指令设置新的前置指令
- *&emsp; 被删除的指令进行相关use的删除
+ *&emsp; 从指令链表中摘下指令，O(1)
+ *&emsp; 被删除的指令进行相关use的删除，每个操作数 O(1)
  */
 void BasicBlock::delete_instr(Instruction *instr) {
     instr_list_.remove(instr);
-    Instruction *prev = instr->getPrevInst();
-    Instruction *succ = instr->getSuccInst();
-    //修正指令的链接关系
-    if (prev != nullptr) {
-        prev->setSuccInst(succ);
-    }
-    if (succ != nullptr) {
-        succ->setPrevInst(prev);
-    }
     //被删除的指令进行相关use的删除
     instr->remove_use_of_ops();
 }
@@ -221,44 +165,42 @@ const Instruction *BasicBlock::get_terminator() const {
  *&emsp; 依次打印维护的指令链表内容
  *&emsp; 如果基本块无终结指令，默认添加
  */
-std::string BasicBlock::print() {
+void BasicBlock::print(std::ostream &os) {
     if (_fake) {
-        return "";
+        return;
     }
-    std::string bb_ir;
-    bb_ir += this->get_name();
-    bb_ir += ":";
+    this->print_name(os);
+    os << ":";
     // print prebb
     if (!this->get_pre_basic_blocks().empty()) {
-        bb_ir += "                                                ; preds = ";
+        os << "                                                ; preds = ";
     }
     for (auto bb: this->get_pre_basic_blocks()) {
         if (bb != *this->get_pre_basic_blocks().begin())
-            bb_ir += ", ";
-        bb_ir += print_as_op(bb, false);
+            os << ", ";
+        print_as_op(os, bb, false);
     }
 
     // print func
     if (!this->get_parent()) {
-        bb_ir += "\n";
-        bb_ir += "; Error: Block without parent!";
+        os << "\n";
+        os << "; Error: Block without parent!";
     }
-    bb_ir += "\n";
+    os << "\n";
     for (auto instr: this->get_instructions()) {
-        bb_ir += "  ";
-        bb_ir += instr->print();
-        bb_ir += "\n";
+        os << "  ";
+        instr->print(os);
+        os << "\n";
     }
 
     // 空BasicBlock，自动加上return语句
     if (get_terminator() == nullptr) {
-        bb_ir += "  ";
+        os << "  ";
         if (get_parent()->get_return_type()->is_void_type()) {
-            bb_ir += "ret void\n";
+            os << "ret void\n";
         } else {
-            bb_ir += "ret i32 0\n";
+            os << "ret i32 0\n";
         }
     }
 
-    return bb_ir;
 }
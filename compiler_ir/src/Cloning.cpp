@@ -0,0 +1,142 @@
+/*!
+ * @file Cloning.cpp
+ * @brief 函数体克隆与调用点内联实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "Cloning.h"
+#include "BasicBlock.h"
+#include "Constant.h"
+#include "Function.h"
+#include "Instruction.h"
+#include "Module.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+std::vector<BasicBlock *> clone_function_body(Function *from, Function *into, ValueMap &vmap) {
+    Module *m = into->get_parent();
+    std::vector<BasicBlock *> blocks;
+    blocks.reserve(from->get_num_basic_blocks());
+    for (auto bb: from->get_basic_blocks()) {
+        BasicBlock *copy = BasicBlock::create(m, "", into);
+        vmap.insert(bb, copy);
+        blocks.push_back(copy);
+    }
+
+    // 先全部复制再统一改写，前面的指令可以引用后面块中的值（phi）
+    std::vector<Instruction *> copies;
+    size_t index = 0;
+    for (auto bb: from->get_basic_blocks()) {
+        BasicBlock *copy = blocks[index++];
+        for (auto instr: bb->get_instructions()) {
+            Instruction *c = instr->deepcopy(copy);
+            vmap.insert(instr, c);
+            copies.push_back(c);
+        }
+        for (auto pred: bb->get_pre_basic_blocks()) {
+            copy->add_pre_basic_block(static_cast<BasicBlock *>(vmap.lookup(pred)));
+        }
+        for (auto succ: bb->get_succ_basic_blocks()) {
+            copy->add_succ_basic_block(static_cast<BasicBlock *>(vmap.lookup(succ)));
+        }
+    }
+    for (auto c: copies) {
+        c->transplant(vmap);
+    }
+    return blocks;
+}
+
+void inline_call(CallInst *call) {
+    auto callee = static_cast<Function *>(call->get_operand(0));
+    BasicBlock *bb = call->get_parent();
+    Function *caller = bb->get_parent();
+    Module *m = caller->get_parent();
+    Type *ret_type = call->get_type();
+
+    // 1. 复制被调函数体，形参换成实参
+    ValueMap vmap(callee->get_num_basic_blocks() * 8 + callee->get_num_of_args());
+    unsigned arg_no = 1;
+    for (auto arg: callee->get_args()) {
+        vmap.insert(arg, call->get_operand(arg_no++));
+    }
+    std::vector<BasicBlock *> blocks = clone_function_body(callee, caller, vmap);
+
+    // 2. 调用之后的指令移入 after，后继及其phi改以 after 为前驱
+    BasicBlock *after = BasicBlock::create(m, "", caller);
+    std::vector<Instruction *> tail;
+    for (Instruction *instr = call->getSuccInst(); instr; instr = instr->getSuccInst()) {
+        tail.push_back(instr);
+    }
+    for (auto instr: tail) {
+        bb->get_instructions().remove(instr);
+        instr->set_parent(after);
+        after->add_instruction(instr);
+    }
+    after->get_succ_basic_blocks() = std::move(bb->get_succ_basic_blocks());
+    bb->get_succ_basic_blocks().clear();
+    for (auto succ: after->get_succ_basic_blocks()) {
+        auto &preds = succ->get_pre_basic_blocks();
+        std::replace(preds.begin(), preds.end(), bb, after);
+        for (auto instr: succ->get_instructions()) {
+            if (!instr->is_phi()) break;
+            for (unsigned i = 1; i < instr->get_num_operand(); i += 2) {
+                if (instr->get_operand(i) == bb) instr->set_operand(i, after);
+            }
+        }
+    }
+
+    // 3. 副本中的 return 改为跳到 after；没有终结指令的块按打印时的约定视为返回零值
+    std::vector<std::pair<Value *, BasicBlock *>> rets;
+    for (auto copy: blocks) {
+        Instruction *term = copy->get_terminator();
+        if (term != nullptr && !term->is_ret()) continue;
+        if (!ret_type->is_void_type()) {
+            Value *val = term != nullptr ? term->get_operand(0) : ConstantZero::get(ret_type, m);
+            rets.emplace_back(val, copy);
+        }
+        if (term != nullptr) copy->delete_instr(term);
+        BranchInst::create_br(after, copy);
+    }
+
+    // 4. 返回值替换调用结果
+    if (!ret_type->is_void_type() && !call->get_use_list().empty()) {
+        Value *result;
+        if (rets.empty()) {
+            result = ConstantZero::get(ret_type, m);
+        } else if (rets.size() == 1) {
+            result = rets.front().first;
+        } else {
+            auto phi = PhiInst::create_phi(ret_type, after);
+            after->get_instructions().remove(phi);
+            after->add_instr_begin(phi);
+            for (auto &[val, from]: rets) {
+                phi->add_phi_pair_operand(val, from);
+            }
+            result = phi;
+        }
+        call->replace_all_use_with(result);
+    }
+    bb->delete_instr(call);
+    BranchInst::create_br(blocks.front(), bb);
+
+    // 5. 固定大小的栈对象放到调用者入口，不随调用点所在的控制流重复分配
+    BasicBlock *entry = caller->get_entry_block();
+    std::vector<Instruction *> allocas;
+    for (auto instr: blocks.front()->get_instructions()) {
+        if (instr->is_alloca()) allocas.push_back(instr);
+    }
+    for (auto r = allocas.rbegin(); r != allocas.rend(); ++r) {
+        blocks.front()->get_instructions().remove(*r);
+        (*r)->set_parent(entry);
+        entry->add_instr_begin(*r);
+    }
+
+    // 6. 副本与 after 紧跟在调用块之后，打印出的顺序与控制流一致
+    auto &list = caller->get_basic_blocks();
+    auto first_new = std::prev(list.end(), static_cast<long>(blocks.size()) + 1);
+    auto pos = std::next(std::find(list.begin(), first_new, bb));
+    if (pos != first_new) list.splice(pos, list, first_new, list.end());
+}
@@ -0,0 +1,190 @@
+/*!
+ * @file ConstFold.cpp
+ * @brief 常量折叠与传播实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "ConstFold.h"
+#include "BasicBlock.h"
+#include "Constant.h"
+#include "Function.h"
+#include "Instruction.h"
+#include "Module.h"
+#include "Stats.h"
+
+#include <algorithm>
+#include <climits>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+/// 折叠范围限定为 i32：i1 的有符号比较语义与 calculate() 不一致
+ConstantInt *as_int32_const(Value *v) {
+    auto c = dynamic_cast<ConstantInt *>(v);
+    return c != nullptr && c->get_type()->is_int32_type() ? c : nullptr;
+}
+
+bool is_const(ConstantInt *c, int val) { return c != nullptr && c->get_value() == val; }
+
+Value *fold_binary(Instruction *instr, Module *m) {
+    Value *lhs = instr->get_operand(0);
+    Value *rhs = instr->get_operand(1);
+    if (!lhs->get_type()->is_int32_type() || !rhs->get_type()->is_int32_type() ||
+        !instr->get_type()->is_int32_type()) {
+        return nullptr;
+    }
+    ConstantInt *cl = as_int32_const(lhs);
+    ConstantInt *cr = as_int32_const(rhs);
+    auto op = instr->get_instr_type();
+    if (cl != nullptr && cr != nullptr) {
+        // 除零与 INT_MIN / -1 保留到运行时
+        if ((op == Instruction::sdiv || op == Instruction::mod) &&
+            (cr->get_value() == 0 || (cr->get_value() == -1 && cl->get_value() == INT_MIN))) {
+            return nullptr;
+        }
+        return ConstantInt::get(instr->calculate(), m);
+    }
+    switch (op) {
+        case Instruction::add:
+            if (is_const(cr, 0)) return lhs;
+            if (is_const(cl, 0)) return rhs;
+            break;
+        case Instruction::sub:
+            if (is_const(cr, 0)) return lhs;
+            if (lhs == rhs) return ConstantInt::get(0, m);
+            break;
+        case Instruction::mul:
+            if (is_const(cr, 1)) return lhs;
+            if (is_const(cl, 1)) return rhs;
+            if (is_const(cl, 0) || is_const(cr, 0)) return ConstantInt::get(0, m);
+            break;
+        case Instruction::sdiv:
+            if (is_const(cr, 1)) return lhs;
+            break;
+        case Instruction::mod:
+            if (is_const(cr, 1)) return ConstantInt::get(0, m);
+            break;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+Value *fold_cmp(CmpInst *cmp, Module *m) {
+    Value *lhs = cmp->get_operand(0);
+    Value *rhs = cmp->get_operand(1);
+    if (!lhs->get_type()->is_int32_type() || !rhs->get_type()->is_int32_type()) {
+        return nullptr;
+    }
+    if (as_int32_const(lhs) != nullptr && as_int32_const(rhs) != nullptr) {
+        return ConstantInt::get(cmp->calculate() != 0, m);
+    }
+    if (lhs == rhs) {
+        switch (cmp->get_cmp_op()) {
+            case CmpInst::EQ:
+            case CmpInst::GE:
+            case CmpInst::LE:
+                return ConstantInt::get(true, m);
+            default:
+                return ConstantInt::get(false, m);
+        }
+    }
+    return nullptr;
+}
+
+/// 各来源取值相同（忽略指向自身的来源）的phi等价于该值
+Value *fold_phi(Instruction *phi) {
+    Value *same = nullptr;
+    for (int i = 0; i < (int) phi->get_num_operand(); i += 2) {
+        Value *val = phi->get_operand(i);
+        if (val == phi || val == same) {
+            continue;
+        }
+        if (same != nullptr) {
+            return nullptr;
+        }
+        same = val;
+    }
+    return same;
+}
+
+}  // namespace
+
+Value *ConstFold::fold(Instruction *instr) {
+    Module *m = instr->get_module();
+    switch (instr->get_instr_type()) {
+        case Instruction::add:
+        case Instruction::sub:
+        case Instruction::mul:
+        case Instruction::sdiv:
+        case Instruction::mod:
+            return fold_binary(instr, m);
+        case Instruction::cmp:
+            return fold_cmp(static_cast<CmpInst *>(instr), m);
+        case Instruction::zext: {
+            auto c = dynamic_cast<ConstantInt *>(instr->get_operand(0));
+            if (c != nullptr && instr->get_type()->is_int32_type()) {
+                return ConstantInt::get(c->get_value() != 0 ? 1 : 0, m);
+            }
+            return nullptr;
+        }
+        case Instruction::sitofp: {
+            // 只折叠能被 float 精确表示、且按 "%f" 打印不丢精度的整数
+            ConstantInt *c = as_int32_const(instr->get_operand(0));
+            if (c != nullptr && c->get_value() >= -(1 << 24) && c->get_value() <= (1 << 24)) {
+                return ConstantFP::get(static_cast<float>(c->get_value()), m);
+            }
+            return nullptr;
+        }
+        case Instruction::phi:
+            return fold_phi(instr);
+        default:
+            return nullptr;
+    }
+}
+
+bool ConstFold::run_on_function(Function *f) {
+    std::vector<Instruction *> worklist;
+    std::unordered_set<Instruction *> pending;
+    for (auto bb: f->get_basic_blocks()) {
+        for (auto instr: bb->get_instructions()) {
+            worklist.push_back(instr);
+            pending.insert(instr);
+        }
+    }
+    // 逆序入栈，按程序顺序出栈
+    std::reverse(worklist.begin(), worklist.end());
+
+    uint64_t folded = 0;
+    std::vector<Instruction *> users;
+    while (!worklist.empty()) {
+        Instruction *instr = worklist.back();
+        worklist.pop_back();
+        if (pending.erase(instr) == 0) {
+            continue;
+        }
+        Value *result = fold(instr);
+        if (result == nullptr) {
+            continue;
+        }
+        users.clear();
+        for (auto &use: instr->get_use_list()) {
+            auto user = dynamic_cast<Instruction *>(use.val_);
+            if (user != nullptr && user != instr) {
+                users.push_back(user);
+            }
+        }
+        instr->replace_all_use_with(result);
+        instr->get_parent()->delete_instr(instr);
+        folded++;
+        for (auto user: users) {
+            if (pending.insert(user).second) {
+                worklist.push_back(user);
+            }
+        }
+    }
+    Stats::count("constants folded", folded);
+    return folded != 0;
+}
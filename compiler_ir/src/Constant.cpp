@@ -6,6 +6,10 @@
  */
 #include "Constant.h"
 #include "Module.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -16,7 +20,7 @@
  *@return 常量类对象指针
  */
 ConstantInt *ConstantInt::get(int val, Module *m) {
-    return new ConstantInt(Type::get_int32_type(m), val);
+    return m->get_constant_int(Type::get_int32_type(m), val);
 }
 
 /*!
@@ -26,12 +30,12 @@ ConstantInt *ConstantInt::get(int val, Module *m) {
  *@return 常量类对象指针
  */
 ConstantInt *ConstantInt::get(bool val, Module *m) {
-    return new ConstantInt(Type::get_int1_type(m), val ? 1 : 0);
+    return m->get_constant_int(Type::get_int1_type(m), val ? 1 : 0);
 }
 
 /*!
  *@brief 打印常量类变量
- *@return 字符串
+ *@param os 输出流
  *@note
  *---------
  *获取常量类型
@@ -41,42 +45,106 @@ ConstantInt *ConstantInt::get(bool val, Module *m) {
  *&emsp; 将其数组转换为字符串输出
  *&emsp; 返回字符串
  */
-std::string ConstantInt::print() {
-    std::string const_ir;
+void ConstantInt::print(std::ostream &os) {
     Type *ty = this->get_type();
     if (ty->is_integer_type() &&
         static_cast<IntegerType *>(ty)->get_num_bits() == 1) {
         // int1
-        const_ir += (this->get_value() == 0) ? "false" : "true";
+        os << (this->get_value() == 0 ? "false" : "true");
     } else {
         // int32
-        const_ir += std::to_string(this->get_value());
+        os << this->get_value();
     }
-    return const_ir;
 }
 
 ConstantFP *ConstantFP::get(float val, Module *m) {
-    return new ConstantFP(Type::get_float_type(m), val);
+    return m->get_constant_fp(val);
 }
 
-std::string ConstantFP::print() {
-    return std::to_string(value_);
+void ConstantFP::print(std::ostream &os) {
+    // 与 std::to_string 的 "%f" 格式一致，但不产生临时字符串
+    char buf[64];
+    int n = std::snprintf(buf, sizeof(buf), "%f", value_);
+    os.write(buf, n);
 }
 
+namespace {
+
+/// 按 ConstantInt/ConstantFP::print 的格式写出一个标量
+int format_scalar(char *buf, size_t size, Type *scalar, uint32_t bits) {
+    if (scalar->is_float_type()) {
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return std::snprintf(buf, size, "%f", v);
+    }
+    if (static_cast<IntegerType *>(scalar)->get_num_bits() == 1) {
+        return std::snprintf(buf, size, "%s", bits == 0 ? "false" : "true");
+    }
+    return std::snprintf(buf, size, "%d", static_cast<int32_t>(bits));
+}
+
+bool all_zero(const uint32_t *data, size_t n) {
+    return std::all_of(data, data + n, [](uint32_t bits) { return bits == 0; });
+}
+
+/// 写出 ty 类型、从 data 开始的数组常量，不含类型前缀
+void print_array(std::ostream &os, ArrayType *ty, Type *scalar, const uint32_t *data, size_t n) {
+    if (all_zero(data, n)) {
+        os << "zeroinitializer";
+        return;
+    }
+    Type *elem = ty->get_element_type();
+    unsigned count = ty->get_num_of_elements();
+    std::string elem_name = elem->print();
+    os << "[";
+    if (elem->is_array_type()) {
+        size_t stride = n / count;
+        for (unsigned i = 0; i < count; i++) {
+            if (i > 0) os << ", ";
+            os << elem_name << " ";
+            print_array(os, static_cast<ArrayType *>(elem), scalar, data + i * stride, stride);
+        }
+    } else {
+        // 连续相同的元素只格式化一次，之后整段重复写出
+        char buf[96];
+        for (unsigned i = 0; i < count;) {
+            unsigned j = i + 1;
+            while (j < count && data[j] == data[i]) j++;
+            std::string text = elem_name + " ";
+            text.append(buf, format_scalar(buf, sizeof(buf), scalar, data[i]));
+            for (unsigned k = i; k < j; k++) {
+                if (k > 0) os << ", ";
+                os.write(text.data(), static_cast<std::streamsize>(text.size()));
+            }
+            i = j;
+        }
+    }
+    os << "]";
+}
+
+}  // namespace
+
 /*!
- *@brief 常量整数类构造函数
+ *@brief 常量数组构造函数
  *@param ty 常量类型
- *@param val 常量数值类型数组
- *@return 自身类对象
+ *@param data 展开后的标量位模式
  *constant int array
  */
-ConstantArray::ConstantArray(ArrayType *ty, const std::vector<Constant *> &val)
-        : Constant(ty, "", val.size()) {
-    for (int i = 0; i < (int) val.size(); i++)
-        set_operand(i, val[i]);
-    this->const_array.assign(val.begin(), val.end());
+ConstantArray::ConstantArray(ArrayType *ty, std::vector<uint32_t> data)
+        : Constant(ty, "", 0), scalar_type_(get_scalar_type(ty)),
+          storage_(std::move(data)), data_(storage_.data()), num_scalars_(storage_.size()) {
+    assert(num_scalars_ == get_num_scalars(ty) && "ConstantArray: wrong number of scalars");
 }
 
+/*!
+ *@brief 子数组视图构造函数
+ *@param ty 子数组类型
+ *@param data 父数组存储中本子数组的起始位置
+ */
+ConstantArray::ConstantArray(ArrayType *ty, const uint32_t *data)
+        : Constant(ty, "", 0), scalar_type_(get_scalar_type(ty)),
+          data_(data), num_scalars_(get_num_scalars(ty)) {}
+
 /*!
  *@brief 获取常量数组指定索引的常量数值
  *@param index 索引
@@ -84,7 +152,39 @@ ConstantArray::ConstantArray(ArrayType *ty, const std::vector<Constant *> &val)
  *constant int array
  */
 Constant *ConstantArray::get_element_value(int index) {
-    return this->const_array[index];
+    Type *elem = get_type()->get_array_element_type();
+    Module *m = get_type()->get_module();
+    if (elem->is_array_type()) {
+        if (rows_.empty()) rows_.resize(get_size_of_array(), nullptr);
+        ConstantArray *&row = rows_[index];
+        if (!row) {
+            size_t stride = num_scalars_ / get_size_of_array();
+            row = new (m) ConstantArray(static_cast<ArrayType *>(elem), data_ + index * stride);
+        }
+        return row;
+    }
+    uint32_t bits = data_[index];
+    if (elem->is_float_type()) {
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return ConstantFP::get(v, m);
+    }
+    return m->get_constant_int(static_cast<IntegerType *>(elem), static_cast<int>(bits));
+}
+
+bool ConstantArray::is_zero() const { return all_zero(data_, num_scalars_); }
+
+Type *ConstantArray::get_scalar_type(Type *ty) {
+    while (ty->is_array_type()) ty = ty->get_array_element_type();
+    return ty;
+}
+
+size_t ConstantArray::get_num_scalars(Type *ty) {
+    size_t n = 1;
+    for (; ty->is_array_type(); ty = ty->get_array_element_type()) {
+        n *= static_cast<ArrayType *>(ty)->get_num_of_elements();
+    }
+    return n;
 }
 
 /*!
@@ -92,31 +192,57 @@ Constant *ConstantArray::get_element_value(int index) {
  *@param ty 数组元素的类型
  *@param val 常量类数组
  *@return 常量数组类指针
+ *@note 按元素展开：子数组整段复制，零值留空，其余元素不足时补零
  *constant int array
  */
 ConstantArray *ConstantArray::get(ArrayType *ty,
                                   const std::vector<Constant *> &val) {
-    return new ConstantArray(ty, val);
+    Type *elem = ty->get_element_type();
+    size_t stride = get_num_scalars(elem);
+    std::vector<uint32_t> data(get_num_scalars(ty), 0);
+    assert(val.size() <= ty->get_num_of_elements() && "ConstantArray: too many elements");
+    for (size_t i = 0; i < val.size(); i++) {
+        uint32_t *dst = data.data() + i * stride;
+        if (auto ci = dynamic_cast<ConstantInt *>(val[i])) {
+            *dst = static_cast<uint32_t>(ci->get_value());
+        } else if (auto cf = dynamic_cast<ConstantFP *>(val[i])) {
+            float v = cf->get_value();
+            std::memcpy(dst, &v, sizeof(v));
+        } else if (auto ca = dynamic_cast<ConstantArray *>(val[i])) {
+            assert(ca->get_num_scalars() == stride && "ConstantArray: element type mismatch");
+            std::copy(ca->get_raw_data(), ca->get_raw_data() + stride, dst);
+        } else {
+            assert(dynamic_cast<ConstantZero *>(val[i]) && "ConstantArray: unsupported element");
+        }
+    }
+    return new (ty->get_module()) ConstantArray(ty, std::move(data));
+}
+
+ConstantArray *ConstantArray::get(ArrayType *ty, const std::vector<int> &val) {
+    assert(get_scalar_type(ty)->is_integer_type() && "ConstantArray: not an integer array");
+    return get_raw(ty, std::vector<uint32_t>(val.begin(), val.end()));
+}
+
+ConstantArray *ConstantArray::get(ArrayType *ty, const std::vector<float> &val) {
+    assert(get_scalar_type(ty)->is_float_type() && "ConstantArray: not a float array");
+    std::vector<uint32_t> data(val.size());
+    if (!val.empty()) std::memcpy(data.data(), val.data(), val.size() * sizeof(float));
+    return get_raw(ty, std::move(data));
+}
+
+ConstantArray *ConstantArray::get_raw(ArrayType *ty, std::vector<uint32_t> data) {
+    assert(data.size() <= get_num_scalars(ty) && "ConstantArray: too many elements");
+    data.resize(get_num_scalars(ty), 0);
+    return new (ty->get_module()) ConstantArray(ty, std::move(data));
 }
 
 /*!
  *@brief 常量数组类打印函数
- *@return 字符串
+ *@param os 输出流
  *constant int array
  */
-std::string ConstantArray::print() {
-    std::string const_ir;
-    const_ir += "[";
-    for (int i = 0; i < static_cast<int>(this->get_size_of_array()); i++) {
-        const_ir += get_element_value(i)->get_type()->print();
-        const_ir += " ";
-        const_ir += get_element_value(i)->print();
-        const_ir += ", ";
-    }
-    const_ir.pop_back();
-    const_ir.pop_back();
-    const_ir += "]";
-    return const_ir;
+void ConstantArray::print(std::ostream &os) {
+    print_array(os, static_cast<ArrayType *>(get_type()), scalar_type_, data_, num_scalars_);
 }
 
 /*!
@@ -127,12 +253,12 @@ std::string ConstantArray::print() {
  *constant int zero
  */
 ConstantZero *ConstantZero::get(Type *ty, Module *m) {
-    return new ConstantZero(ty);
+    return m->get_constant_zero(ty);
 }
 
 /*!
  *@brief 打印常量零值
- *@return 字符串
+ *@param os 输出流
  *constant int zero
  */
-std::string ConstantZero::print() { return "zeroinitializer"; }
+void ConstantZero::print(std::ostream &os) { os << "zeroinitializer"; }
@@ -0,0 +1,86 @@
+/*!
+ * @file DeadCodeElim.cpp
+ * @brief 死代码删除实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "DeadCodeElim.h"
+#include "BasicBlock.h"
+#include "Function.h"
+#include "Instruction.h"
+#include "Stats.h"
+
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+/// alloca 的使用者全部是以它为地址的 store
+bool is_write_only(Instruction *alloca) {
+    for (auto &use: alloca->get_use_list()) {
+        auto user = dynamic_cast<Instruction *>(use.val_);
+        if (user == nullptr || !user->is_store() || use.arg_no_ != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool DeadCodeElim::has_side_effect(Instruction *instr) {
+    return instr->is_store() || instr->is_call() || instr->isTerminator();
+}
+
+bool DeadCodeElim::run_on_function(Function *f) {
+    std::vector<Instruction *> worklist;
+    std::unordered_set<Instruction *> pending;
+    for (auto bb: f->get_basic_blocks()) {
+        for (auto instr: bb->get_instructions()) {
+            worklist.push_back(instr);
+            pending.insert(instr);
+        }
+    }
+
+    uint64_t removed = 0;
+    std::vector<Value *> operands;
+    auto erase = [&](Instruction *instr) {
+        operands.assign(instr->get_operands().begin(), instr->get_operands().end());
+        pending.erase(instr);
+        instr->get_parent()->delete_instr(instr);
+        removed++;
+        // 操作数可能随之变为死代码
+        for (auto op: operands) {
+            auto def = dynamic_cast<Instruction *>(op);
+            if (def != nullptr && pending.insert(def).second) {
+                worklist.push_back(def);
+            }
+        }
+    };
+
+    // 从后往前出栈，先删使用者，再删被使用者
+    while (!worklist.empty()) {
+        Instruction *instr = worklist.back();
+        worklist.pop_back();
+        if (pending.erase(instr) == 0) {
+            continue;
+        }
+        if (instr->is_alloca() && is_write_only(instr)) {
+            std::vector<Instruction *> stores;
+            for (auto &use: instr->get_use_list()) {
+                stores.push_back(static_cast<Instruction *>(use.val_));
+            }
+            for (auto store: stores) {
+                erase(store);
+            }
+            erase(instr);
+            continue;
+        }
+        if (!has_side_effect(instr) && instr->get_use_list().empty()) {
+            erase(instr);
+        }
+    }
+    Stats::count("dead instructions removed", removed);
+    return removed != 0;
+}
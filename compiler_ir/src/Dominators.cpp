@@ -0,0 +1,159 @@
+/*!
+ * @file Dominators.cpp
+ * @brief 支配树与支配边界实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "Dominators.h"
+#include "BasicBlock.h"
+#include "Function.h"
+
+#include <algorithm>
+#include <list>
+#include <utility>
+
+Dominators::Dominators(Function *f) {
+    compute_rpo(f->get_entry_block());
+    compute_idom();
+    compute_tree();
+    compute_frontier();
+}
+
+namespace {
+
+const std::vector<BasicBlock *> kNoBlocks;
+
+}  // namespace
+
+BasicBlock *Dominators::get_idom(BasicBlock *bb) const {
+    auto it = index_.find(bb);
+    if (it == index_.end() || it->second == 0) {
+        return nullptr;
+    }
+    return rpo_[idom_[it->second]];
+}
+
+bool Dominators::dominates(BasicBlock *a, BasicBlock *b) const {
+    auto ia = index_.find(a);
+    auto ib = index_.find(b);
+    if (ia == index_.end() || ib == index_.end()) {
+        return false;
+    }
+    return tree_in_[ia->second] <= tree_in_[ib->second] && tree_out_[ib->second] <= tree_out_[ia->second];
+}
+
+const std::vector<BasicBlock *> &Dominators::get_children(BasicBlock *bb) const {
+    auto it = index_.find(bb);
+    return it == index_.end() ? kNoBlocks : children_[it->second];
+}
+
+const std::vector<BasicBlock *> &Dominators::get_frontier(BasicBlock *bb) const {
+    auto it = index_.find(bb);
+    return it == index_.end() ? kNoBlocks : frontier_[it->second];
+}
+
+void Dominators::compute_rpo(BasicBlock *entry) {
+    // 显式栈的深度优先遍历，避免长链CFG上递归过深
+    using SuccIter = std::list<BasicBlock *>::iterator;
+    std::vector<std::pair<BasicBlock *, SuccIter>> stack;
+    std::unordered_map<BasicBlock *, bool> visited;
+    visited[entry] = true;
+    stack.emplace_back(entry, entry->get_succ_basic_blocks().begin());
+    while (!stack.empty()) {
+        auto &top = stack.back();
+        if (top.second == top.first->get_succ_basic_blocks().end()) {
+            rpo_.push_back(top.first);
+            stack.pop_back();
+            continue;
+        }
+        BasicBlock *succ = *top.second++;
+        if (!visited[succ]) {
+            visited[succ] = true;
+            stack.emplace_back(succ, succ->get_succ_basic_blocks().begin());
+        }
+    }
+    std::reverse(rpo_.begin(), rpo_.end());
+    for (int i = 0; i < (int) rpo_.size(); i++) {
+        index_[rpo_[i]] = i;
+    }
+}
+
+void Dominators::compute_idom() {
+    int n = (int) rpo_.size();
+    idom_.assign(n, -1);
+    idom_[0] = 0;
+    auto intersect = [this](int a, int b) {
+        while (a != b) {
+            while (a > b) a = idom_[a];
+            while (b > a) b = idom_[b];
+        }
+        return a;
+    };
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 1; i < n; i++) {
+            int new_idom = -1;
+            for (auto pre: rpo_[i]->get_pre_basic_blocks()) {
+                auto it = index_.find(pre);
+                if (it == index_.end() || idom_[it->second] == -1) {
+                    continue;
+                }
+                new_idom = new_idom == -1 ? it->second : intersect(it->second, new_idom);
+            }
+            if (new_idom != idom_[i]) {
+                idom_[i] = new_idom;
+                changed = true;
+            }
+        }
+    }
+}
+
+void Dominators::compute_tree() {
+    int n = (int) rpo_.size();
+    children_.assign(n, {});
+    for (int i = 1; i < n; i++) {
+        children_[idom_[i]].push_back(rpo_[i]);
+    }
+    tree_in_.assign(n, 0);
+    tree_out_.assign(n, 0);
+    int clock = 0;
+    std::vector<std::pair<int, size_t>> stack{{0, 0}};
+    tree_in_[0] = clock++;
+    while (!stack.empty()) {
+        auto &top = stack.back();
+        if (top.second == children_[top.first].size()) {
+            tree_out_[top.first] = clock++;
+            stack.pop_back();
+            continue;
+        }
+        int child = index_[children_[top.first][top.second++]];
+        tree_in_[child] = clock++;
+        stack.emplace_back(child, 0);
+    }
+}
+
+void Dominators::compute_frontier() {
+    int n = (int) rpo_.size();
+    frontier_.assign(n, {});
+    for (int i = 1; i < n; i++) {
+        auto &pres = rpo_[i]->get_pre_basic_blocks();
+        if (pres.size() < 2) {
+            continue;
+        }
+        for (auto pre: pres) {
+            auto it = index_.find(pre);
+            if (it == index_.end()) {
+                continue;
+            }
+            // 同一块的边界按 i 递增追加，只需与末尾比较即可去重
+            for (int runner = it->second; runner != idom_[i]; runner = idom_[runner]) {
+                auto &df = frontier_[runner];
+                if (df.empty() || df.back() != rpo_[i]) {
+                    df.push_back(rpo_[i]);
+                }
+            }
+        }
+    }
+}
@@ -6,8 +6,10 @@
  */
 
 #include "Function.h"
+#include "IRBinary.h"
 #include "IRprinter.h"
 #include "Module.h"
+#include "Stats.h"
 
 /**
  * @brief Construct a new Function object
@@ -20,6 +22,7 @@
  */
 Function::Function(FunctionType *ty, const std::string &name, Module *parent)
         : Value(ty, name), parent_(parent), seq_cnt_(0) {
+    shared_ = true;
     parent->add_function(this);
     build_args();
 }
@@ -34,7 +37,7 @@ Function::Function(FunctionType *ty, const std::string &name, Module *parent)
  */
 Function *Function::create(FunctionType *ty, const std::string &name,
                            Module *parent) {
-    return new Function(ty, name, parent);
+    return new (parent) Function(ty, name, parent);
 }
 
 /**
@@ -69,7 +72,10 @@ unsigned Function::get_num_of_args() const {
  *
  * @return unsigned ，函数管理的基本快数量
  */
-unsigned Function::get_num_basic_blocks() const { return basic_blocks_.size(); }
+unsigned Function::get_num_basic_blocks() const {
+    if (lazy_body_ != kNoLazyBody) const_cast<Function *>(this)->materialize();
+    return basic_blocks_.size();
+}
 
 /**
  * @brief Get the parent object，获取函数所属模块
@@ -120,7 +126,7 @@ void Function::build_args() {
     auto *func_ty = get_function_type();
     unsigned num_args = get_num_of_args();
     for (int i = 0; i < (int) num_args; i++) {
-        arguments_.push_back(new Argument(func_ty->get_param_type(i), "", this, i));
+        arguments_.push_back(new (parent_) Argument(func_ty->get_param_type(i), "", this, i));
     }
 }
 
@@ -129,112 +135,117 @@ void Function::build_args() {
  *
  * @param bb 基本块指针
  */
-void Function::add_basic_block(BasicBlock *bb) { basic_blocks_.push_back(bb); }
+void Function::add_basic_block(BasicBlock *bb) {
+    if (lazy_body_ != kNoLazyBody) materialize();
+    basic_blocks_.push_back(bb);
+}
+
+void Function::materialize() {
+    if (lazy_body_ == kNoLazyBody) return;
+    // 先清除标记，读入时添加基本块不会再次进入
+    uint32_t body = lazy_body_;
+    lazy_body_ = kNoLazyBody;
+    parent_->get_materializer()->materialize(this, body);
+}
 
 /**
  * @brief Set the instr name object，为参数和基本块设置名称
  *
  * @note 针对函数的参数设置名称
  * @note 针对函数内部的基本块设置名称，并针对每个基本块的指令设置名称
+ * @note 一次线性遍历，只为尚未命名的value记录整数编号，名称在打印时格式化
  */
 void Function::set_instr_name() {
+    Stats::Timer timer("Function::set_instr_name");
+    /// 未读入的函数体在读入时命名
+    if (lazy_body_ != kNoLazyBody) return;
     /// 针对函数的参数设置名称，
-    std::map < Value * , int > seq;
     for (auto arg: this->get_args()) {
-        if (seq.find(arg) == seq.end()) {
-            auto seq_num = seq.size() + seq_cnt_;
-            if (arg->set_name("arg" + std::to_string(seq_num))) {
-                seq.insert({arg, seq_num});
-            }
+        if (arg->set_slot("arg", seq_cnt_)) {
+            seq_cnt_++;
         }
     }
     /// 针对函数内部的基本块设置名称，并针对每个基本块的指令设置名称
     for (auto bb: basic_blocks_) {
-        if (seq.find(bb) == seq.end()) {
-            auto seq_num = seq.size() + seq_cnt_;
-            if (bb->set_name("label" + std::to_string(seq_num))) {
-                seq.insert({bb, seq_num});
-            }
+        if (bb->set_slot("label", seq_cnt_)) {
+            seq_cnt_++;
         }
         for (auto instr: bb->get_instructions()) {
-            if (!instr->is_void() && seq.find(instr) == seq.end()) {
-                auto seq_num = seq.size() + seq_cnt_;
-                if (instr->set_name("op" + std::to_string(seq_num))) {
-                    seq.insert({instr, seq_num});
-                }
+            if (!instr->is_void() && instr->set_slot("op", seq_cnt_)) {
+                seq_cnt_++;
             }
         }
     }
-    seq_cnt_ += seq.size();
 }
 
 /**
  * @brief 打印函数
  *
- * @return std::string 字符串
+ * @param os 输出流
  * @note 判断函数是声明还是定义
  * @note 依次添加函数类型和名称
  * @note 函数为声明/定义，不同添加规则
  * @note 函数为声明，换行结束/为定义，依次打印基本块
  */
-std::string Function::print() {
+void Function::print(std::ostream &os) {
+    if (has_cached_ir()) {
+        os << cached_ir_;
+        return;
+    }
+    materialize();
     set_instr_name();
-    std::string func_ir;
     if (this->is_declaration()) {
-        func_ir += "declare ";
+        os << "declare ";
     } else {
-        func_ir += "define ";
+        os << "define ";
     }
 
-    func_ir += this->get_return_type()->print();
-    func_ir += " ";
-    func_ir += print_as_op(this, false);
-    func_ir += "(";
+    this->get_return_type()->print(os);
+    os << " ";
+    print_as_op(os, this, false);
+    os << "(";
 
     // print arg
     if (this->is_declaration()) {
         for (int i = 0; i < static_cast<int>(this->get_num_of_args()); i++) {
             if (i)
-                func_ir += ", ";
-            func_ir += static_cast<FunctionType *>(this->get_type())
+                os << ", ";
+            static_cast<FunctionType *>(this->get_type())
                     ->get_param_type(i)
-                    ->print();
+                    ->print(os);
         }
     } else {
         for (auto arg = this->arg_begin(); arg != arg_end(); arg++) {
             if (arg != this->arg_begin()) {
-                func_ir += ", ";
+                os << ", ";
             }
-            func_ir += static_cast<Argument *>(*arg)->print();
+            static_cast<Argument *>(*arg)->print(os);
         }
     }
-    func_ir += ")";
+    os << ")";
 
     // print bb
     if (this->is_declaration()) {
-        func_ir += "\n";
+        os << "\n";
     } else {
-        func_ir += " {";
-        func_ir += "\n";
+        os << " {";
+        os << "\n";
         for (auto bb: this->get_basic_blocks()) {
-            func_ir += bb->print();
+            bb->print(os);
         }
-        func_ir += "}";
+        os << "}";
     }
 
-    return func_ir;
 }
 
 /**
  * @brief 打印参数列表
  *
- * @return std::string 字符串
+ * @param os 输出流
  * @note 依次打印参数的类型和名称
  */
-std::string Argument::print() {
-    std::string arg_ir;
-    arg_ir += this->get_type()->print();
-    arg_ir += " %";
-    arg_ir += this->get_name();
-    return arg_ir;
+void Argument::print(std::ostream &os) {
+    this->get_type()->print(os);
+    os << " %";
+    this->print_name(os);
 }
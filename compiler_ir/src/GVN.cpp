@@ -0,0 +1,170 @@
+/*!
+ * @file GVN.cpp
+ * @brief 全局值编号（公共子表达式删除）实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "GVN.h"
+#include "BasicBlock.h"
+#include "Function.h"
+#include "Instruction.h"
+#include "Stats.h"
+
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct ExprKey {
+    Instruction::OpID op;
+    int pred;                     //!< CmpInst 的比较谓词，其他指令为 -1
+    Type *type;
+    std::vector<Value *> operands;
+
+    bool operator==(const ExprKey &rhs) const {
+        return op == rhs.op && pred == rhs.pred && type == rhs.type && operands == rhs.operands;
+    }
+};
+
+struct ExprKeyHash {
+    size_t operator()(const ExprKey &key) const {
+        size_t h = std::hash<int>()(key.op * 8 + key.pred + 1);
+        h = h * 31 + std::hash<Type *>()(key.type);
+        for (auto op: key.operands) {
+            h = h * 31 + std::hash<Value *>()(op);
+        }
+        return h;
+    }
+};
+
+bool is_commutative(Instruction *instr) {
+    switch (instr->get_instr_type()) {
+        case Instruction::add:
+        case Instruction::mul:
+        case Instruction::fadd:
+        case Instruction::fmul:
+            return true;
+        case Instruction::cmp: {
+            auto op = static_cast<CmpInst *>(instr)->get_cmp_op();
+            return op == CmpInst::EQ || op == CmpInst::NE;
+        }
+        default:
+            return false;
+    }
+}
+
+/// 可编号的指令：结果只取决于操作数
+bool is_pure(Instruction *instr) {
+    switch (instr->get_instr_type()) {
+        case Instruction::add:
+        case Instruction::sub:
+        case Instruction::mul:
+        case Instruction::sdiv:
+        case Instruction::mod:
+        case Instruction::fadd:
+        case Instruction::fsub:
+        case Instruction::fmul:
+        case Instruction::fdiv:
+        case Instruction::cmp:
+        case Instruction::getelementptr:
+        case Instruction::zext:
+        case Instruction::sitofp:
+        case Instruction::fptosi:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void make_key(Instruction *instr, ExprKey &key) {
+    key.op = instr->get_instr_type();
+    key.pred = key.op == Instruction::cmp ? static_cast<CmpInst *>(instr)->get_cmp_op() : -1;
+    key.type = instr->get_type();
+    key.operands.assign(instr->get_operands().begin(), instr->get_operands().end());
+    if (key.operands.size() == 2 && is_commutative(instr) && std::less<Value *>()(key.operands[1], key.operands[0])) {
+        std::swap(key.operands[0], key.operands[1]);
+    }
+}
+
+}  // namespace
+
+bool GVN::run_on_function(Function *f) {
+    const Dominators &dom = get_analyses().get_dominators(f);
+    std::unordered_map<ExprKey, Instruction *, ExprKeyHash> table;
+    std::vector<ExprKey> undo;       // 按插入顺序记录键，离开支配子树时撤销
+    std::vector<size_t> marks;
+    std::unordered_map<Value *, Value *> memory;   // 地址 -> 块内已知的内容
+    std::vector<Instruction *> dead;
+    ExprKey key;
+    uint64_t removed = 0;
+
+    auto replace = [&](Instruction *instr, Value *val) {
+        instr->replace_all_use_with(val);
+        dead.push_back(instr);
+        removed++;
+    };
+
+    // second 为 true 表示离开该块的支配子树
+    std::vector<std::pair<BasicBlock *, bool>> stack{{f->get_entry_block(), false}};
+    while (!stack.empty()) {
+        auto [bb, leaving] = stack.back();
+        stack.pop_back();
+        if (leaving) {
+            while (undo.size() > marks.back()) {
+                table.erase(undo.back());
+                undo.pop_back();
+            }
+            marks.pop_back();
+            continue;
+        }
+        marks.push_back(undo.size());
+        memory.clear();
+        dead.clear();
+        for (auto instr: bb->get_instructions()) {
+            if (instr->is_load()) {
+                Value *ptr = instr->get_operand(0);
+                auto it = memory.find(ptr);
+                if (it != memory.end() && it->second->get_type() == instr->get_type()) {
+                    replace(instr, it->second);
+                } else {
+                    memory[ptr] = instr;
+                }
+                continue;
+            }
+            if (instr->is_store()) {
+                // 不做别名分析：写入后只信任本地址
+                memory.clear();
+                memory[instr->get_operand(1)] = instr->get_operand(0);
+                continue;
+            }
+            if (instr->is_call()) {
+                memory.clear();
+                continue;
+            }
+            if (!is_pure(instr)) {
+                continue;
+            }
+            make_key(instr, key);
+            auto it = table.find(key);
+            if (it != table.end()) {
+                replace(instr, it->second);
+                continue;
+            }
+            table.emplace(key, instr);
+            undo.push_back(key);
+        }
+        for (auto instr: dead) {
+            bb->delete_instr(instr);
+        }
+        stack.emplace_back(bb, true);
+        auto &children = dom.get_children(bb);
+        for (auto child = children.rbegin(); child != children.rend(); ++child) {
+            stack.emplace_back(*child, false);
+        }
+    }
+    Stats::count("redundant instructions removed", removed);
+    return removed != 0;
+}
@@ -23,6 +23,7 @@
 GlobalVariable::GlobalVariable(std::string name, Module *m, Type *ty,
                                bool is_const, Constant *init)
         : User(ty, name, init != nullptr), is_const_(is_const), init_val_(init) {
+    shared_ = true;
     m->add_global_variable(this);
     if (init) {
         this->set_operand(0, init);
@@ -45,12 +46,12 @@ GlobalVariable::GlobalVariable(std::string name, Module *m, Type *ty,
 GlobalVariable *GlobalVariable::create(std::string name, Module *m, Type *ty,
                                        bool is_const,
                                        Constant *init = nullptr) {
-    return new GlobalVariable(name, m, PointerType::get(ty), is_const, init);
+    return new (m) GlobalVariable(name, m, PointerType::get(ty), is_const, init);
 }
 
 /*!
  *@brief 打印全局变量
- *@return 字符串
+ *@param os 输出流
  *@note
  *--------
  *初始化字符串
@@ -59,13 +60,11 @@ GlobalVariable *GlobalVariable::create(std::string name, Module *m, Type *ty,
  *添加数据指针所指向数据的类型
  *添加变量初值
  */
-std::string GlobalVariable::print() {
-    std::string global_val_ir;
-    global_val_ir += print_as_op(this, false);
-    global_val_ir += " = ";
-    global_val_ir += (this->is_const() ? "constant " : "global ");
-    global_val_ir += this->get_type()->get_pointer_element_type()->print();
-    global_val_ir += " ";
-    global_val_ir += this->get_init()->print();
-    return global_val_ir;
+void GlobalVariable::print(std::ostream &os) {
+    print_as_op(os, this, false);
+    os << " = ";
+    os << (this->is_const() ? "constant " : "global ");
+    this->get_type()->get_pointer_element_type()->print(os);
+    os << " ";
+    this->get_init()->print(os);
 }
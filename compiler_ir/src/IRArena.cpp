@@ -0,0 +1,84 @@
+/*!
+ * @file IRArena.cpp
+ * @brief 中间代码对象的分池内存管理实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "IRArena.h"
+#include "Type.h"
+#include "Value.h"
+
+#include <algorithm>
+#include <cstdint>
+
+IRArena::~IRArena() {
+    // 析构函数只释放对象自身持有的容器，不访问其他IR对象，因此顺序无关
+    for (int pool = 0; pool < Types; pool++) {
+        for (void *p: pools_[pool].objects) {
+            static_cast<Value *>(p)->~Value();
+        }
+    }
+    for (void *p: pools_[Types].objects) {
+        static_cast<Type *>(p)->~Type();
+    }
+}
+
+thread_local IRArena *IRArena::redirect_parent_ = nullptr;
+thread_local IRArena *IRArena::redirect_child_ = nullptr;
+
+void *IRArena::allocate(Pool pool, size_t size) {
+    if (redirect_parent_ == this) {
+        return redirect_child_->allocate(pool, size);
+    }
+    constexpr size_t align = alignof(std::max_align_t);
+    Slab &slab = pools_[pool];
+    size = (size + align - 1) / align * align;
+    if (slab.cur == nullptr || size > slab.left) {
+        // new char[] 返回的内存按 max_align_t 对齐
+        size_t blockSize = std::max(size, kBlockSize);
+        slab.blocks.emplace_back(new char[blockSize]);
+        slab.cur = slab.blocks.back().get();
+        slab.left = blockSize;
+    }
+    void *result = slab.cur;
+    slab.cur += size;
+    slab.left -= size;
+    slab.objects.push_back(result);
+    return result;
+}
+
+void IRArena::forget(Pool pool, void *p) {
+    if (redirect_parent_ == this) {
+        redirect_child_->forget(pool, p);
+        return;
+    }
+    auto &objects = pools_[pool].objects;
+    auto it = std::find(objects.rbegin(), objects.rend(), p);
+    if (it != objects.rend()) objects.erase(std::next(it).base());
+}
+
+size_t IRArena::size(Pool pool) const {
+    size_t n = pools_[pool].objects.size();
+    for (auto &child: children_) {
+        n += child->size(pool);
+    }
+    return n;
+}
+
+IRArena::Local::Local(IRArena &parent)
+        : saved_parent_(redirect_parent_), saved_child_(redirect_child_) {
+    IRArena *child;
+    {
+        std::lock_guard<std::mutex> lock(parent.children_mutex_);
+        parent.children_.push_back(std::make_unique<IRArena>());
+        child = parent.children_.back().get();
+    }
+    redirect_parent_ = &parent;
+    redirect_child_ = child;
+}
+
+IRArena::Local::~Local() {
+    redirect_parent_ = saved_parent_;
+    redirect_child_ = saved_child_;
+}
@@ -0,0 +1,632 @@
+/*!
+ * @file IRBinary.cpp
+ * @brief 二进制中间代码格式实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "IRBinary.h"
+#include "BasicBlock.h"
+#include "Constant.h"
+#include "Function.h"
+#include "GlobalVariable.h"
+#include "Instruction.h"
+#include "Module.h"
+#include "Stats.h"
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+using Format = IRBinaryFormat;
+
+uint32_t encode(uint32_t index, Format::OperandKind kind) { return index << 3 | kind; }
+
+/**
+ * @brief 写出时的各张表：类型、常量与字符串都在第一次用到时登记
+ */
+class Encoder {
+public:
+    explicit Encoder(Module *m) : module_(m) {}
+
+    void write(std::ostream &os);
+
+private:
+    Module *module_;
+    std::vector<uint32_t> strings_, types_, consts_, globals_, funcs_, bodies_;
+    std::string string_bytes_;
+    std::unordered_map<std::string, uint32_t> string_ids_;
+    std::unordered_map<Type *, uint32_t> type_ids_;
+    std::unordered_map<Constant *, uint32_t> const_ids_;
+    std::unordered_map<GlobalVariable *, uint32_t> global_ids_;
+    std::unordered_map<Function *, uint32_t> func_ids_;
+    uint32_t num_strings_ = 0, num_types_ = 0, num_consts_ = 0;
+
+    uint32_t string_id(const std::string &s);
+
+    uint32_t name_id(Value *v) { return v->is_numbered() || v->get_name().empty() ? Format::kNone : string_id(v->get_name()); }
+
+    uint32_t type_id(Type *ty);
+
+    uint32_t const_id(Constant *c);
+
+    void encode_body(Function *f);
+};
+
+uint32_t Encoder::string_id(const std::string &s) {
+    auto it = string_ids_.find(s);
+    if (it != string_ids_.end()) return it->second;
+    strings_.push_back(static_cast<uint32_t>(string_bytes_.size()));
+    strings_.push_back(static_cast<uint32_t>(s.size()));
+    string_bytes_ += s;
+    return string_ids_[s] = num_strings_++;
+}
+
+uint32_t Encoder::type_id(Type *ty) {
+    auto it = type_ids_.find(ty);
+    if (it != type_ids_.end()) return it->second;
+    // 先登记元素类型，读入时按顺序构造即可
+    std::vector<uint32_t> record{static_cast<uint32_t>(ty->get_type_id())};
+    if (ty->is_pointer_type()) {
+        record.push_back(type_id(ty->get_pointer_element_type()));
+    } else if (ty->is_array_type()) {
+        auto arr = static_cast<ArrayType *>(ty);
+        record.push_back(type_id(arr->get_element_type()));
+        record.push_back(arr->get_num_of_elements());
+    } else if (ty->is_function_type()) {
+        auto fty = static_cast<FunctionType *>(ty);
+        record.push_back(type_id(fty->get_return_type()));
+        record.push_back(fty->get_num_of_args());
+        for (unsigned i = 0; i < fty->get_num_of_args(); i++) {
+            record.push_back(type_id(fty->get_param_type(i)));
+        }
+    }
+    types_.insert(types_.end(), record.begin(), record.end());
+    return type_ids_[ty] = num_types_++;
+}
+
+uint32_t Encoder::const_id(Constant *c) {
+    auto it = const_ids_.find(c);
+    if (it != const_ids_.end()) return it->second;
+    std::vector<uint32_t> record;
+    if (auto ci = dynamic_cast<ConstantInt *>(c)) {
+        record = {Format::Int, type_id(c->get_type()), static_cast<uint32_t>(ci->get_value())};
+    } else if (auto cf = dynamic_cast<ConstantFP *>(c)) {
+        float v = cf->get_value();
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        record = {Format::FP, bits};
+    } else if (dynamic_cast<ConstantZero *>(c)) {
+        record = {Format::Zero, type_id(c->get_type())};
+    } else if (auto ca = dynamic_cast<ConstantArray *>(c)) {
+        record = {Format::Array, type_id(c->get_type()), static_cast<uint32_t>(ca->get_num_scalars())};
+        record.insert(record.end(), ca->get_raw_data(), ca->get_raw_data() + ca->get_num_scalars());
+    } else {
+        throw std::runtime_error("IRBinaryWriter: unsupported constant");
+    }
+    consts_.insert(consts_.end(), record.begin(), record.end());
+    return const_ids_[c] = num_consts_++;
+}
+
+void Encoder::encode_body(Function *f) {
+    std::unordered_map<Value *, uint32_t> locals;
+    uint32_t index = 0;
+    for (auto arg: f->get_args()) locals[arg] = encode(index++, Format::Arg);
+    index = 0;
+    for (auto bb: f->get_basic_blocks()) locals[bb] = encode(index++, Format::Block);
+    index = 0;
+    for (auto bb: f->get_basic_blocks()) {
+        for (auto instr: bb->get_instructions()) locals[instr] = encode(index++, Format::Instr);
+    }
+
+    auto operand = [&](Value *v) -> uint32_t {
+        auto it = locals.find(v);
+        if (it != locals.end()) return it->second;
+        if (auto c = dynamic_cast<Constant *>(v)) return encode(const_id(c), Format::Const);
+        if (auto gv = dynamic_cast<GlobalVariable *>(v)) return encode(global_ids_.at(gv), Format::Global);
+        if (auto callee = dynamic_cast<Function *>(v)) return encode(func_ids_.at(callee), Format::Func);
+        throw std::runtime_error("IRBinaryWriter: operand of @" + f->get_name() + " is not in the module");
+    };
+
+    auto &out = bodies_;
+    for (auto arg: f->get_args()) out.push_back(name_id(arg));
+    out.push_back(f->get_num_basic_blocks());
+    for (auto bb: f->get_basic_blocks()) {
+        out.push_back(name_id(bb));
+        out.push_back(bb->is_fake_block());
+        out.push_back(static_cast<uint32_t>(bb->get_pre_basic_blocks().size()));
+        for (auto pred: bb->get_pre_basic_blocks()) out.push_back(locals.at(pred) >> 3);
+        out.push_back(static_cast<uint32_t>(bb->get_succ_basic_blocks().size()));
+        for (auto succ: bb->get_succ_basic_blocks()) out.push_back(locals.at(succ) >> 3);
+        out.push_back(static_cast<uint32_t>(bb->get_num_of_instr()));
+    }
+    for (auto bb: f->get_basic_blocks()) {
+        for (auto instr: bb->get_instructions()) {
+            uint32_t extra = 0;
+            if (instr->is_cmp()) extra = static_cast<CmpInst *>(instr)->get_cmp_op();
+            if (instr->is_alloca()) extra = static_cast<AllocaInst *>(instr)->get_init();
+            out.push_back(instr->get_instr_type());
+            out.push_back(type_id(instr->get_type()));
+            out.push_back(instr->is_void() ? Format::kNone : name_id(instr));
+            out.push_back(extra);
+            out.push_back(instr->get_num_operand());
+            for (auto op: instr->get_operands()) out.push_back(operand(op));
+        }
+    }
+}
+
+void Encoder::write(std::ostream &os) {
+    // 1. 全局变量与函数先编号，函数体中可以引用任意一个
+    uint32_t index = 0;
+    for (auto gv: module_->get_global_variable()) global_ids_[gv] = index++;
+    index = 0;
+    for (auto f: module_->get_functions()) func_ids_[f] = index++;
+
+    // 2. 全局变量
+    for (auto gv: module_->get_global_variable()) {
+        globals_.push_back(string_id(gv->get_name()));
+        globals_.push_back(type_id(gv->get_type()->get_pointer_element_type()));
+        globals_.push_back(gv->is_const());
+        globals_.push_back(gv->get_init() ? const_id(gv->get_init()) : Format::kNone);
+        const std::vector<int> &flat = gv->getFlattenInit();
+        globals_.push_back(static_cast<uint32_t>(flat.size()));
+        for (int v: flat) globals_.push_back(static_cast<uint32_t>(v));
+    }
+
+    // 3. 函数表与函数体，函数体偏移先记为相对函数体节的字数
+    for (auto f: module_->get_functions()) {
+        funcs_.push_back(string_id(f->get_name()));
+        funcs_.push_back(type_id(f->get_type()));
+        if (f->has_cached_ir()) {
+            std::ostringstream text;
+            f->print(text);
+            funcs_.insert(funcs_.end(), {Format::CachedText, string_id(text.str()), 0});
+        } else if (f->is_declaration()) {
+            funcs_.insert(funcs_.end(), {Format::Declaration, 0, 0});
+        } else {
+            auto start = static_cast<uint32_t>(bodies_.size());
+            encode_body(f);
+            funcs_.insert(funcs_.end(), {Format::Body, start, static_cast<uint32_t>(bodies_.size()) - start});
+        }
+    }
+
+    // 4. 按节排列：头部，字符串表，类型表，常量池，全局变量，函数表，函数体
+    string_bytes_.resize((string_bytes_.size() + 3) / 4 * 4, '\0');
+    const uint32_t header_words = 8;
+    uint32_t offset = header_words * 4;
+    auto section = [&](size_t words) {
+        uint32_t start = offset;
+        offset += static_cast<uint32_t>(words * 4);
+        return start;
+    };
+    uint32_t strings_off = section(1 + strings_.size() + string_bytes_.size() / 4);
+    uint32_t types_off = section(1 + types_.size());
+    uint32_t consts_off = section(1 + consts_.size());
+    uint32_t globals_off = section(1 + globals_.size());
+    uint32_t funcs_off = section(1 + funcs_.size());
+    uint32_t bodies_off = section(bodies_.size());
+    for (size_t i = 0; i < funcs_.size(); i += 5) {
+        if (funcs_[i + 2] == Format::Body) funcs_[i + 3] = bodies_off + funcs_[i + 3] * 4;
+    }
+
+    auto put = [&](const std::vector<uint32_t> &words) {
+        os.write(reinterpret_cast<const char *>(words.data()), static_cast<std::streamsize>(words.size() * 4));
+    };
+    put({Format::kMagic, Format::kVersion, strings_off, types_off, consts_off, globals_off, funcs_off, offset});
+    put({num_strings_});
+    put(strings_);
+    os.write(string_bytes_.data(), static_cast<std::streamsize>(string_bytes_.size()));
+    put({num_types_});
+    put(types_);
+    put({num_consts_});
+    put(consts_);
+    put({static_cast<uint32_t>(global_ids_.size())});
+    put(globals_);
+    put({static_cast<uint32_t>(func_ids_.size())});
+    put(funcs_);
+    put(bodies_);
+    Stats::count("binary IR bytes written", offset);
+}
+
+}  // namespace
+
+void IRBinaryWriter::write(Module *m, std::ostream &os) {
+    Stats::Timer timer("IRBinaryWriter::write");
+    Encoder(m).write(os);
+}
+
+/**
+ * @brief 在映射的文件上顺序读取 32 位字，越界时抛出异常
+ */
+struct IRBinaryReader::Cursor {
+    std::string_view data;
+    size_t pos;
+
+    uint32_t next() {
+        if (pos + 4 > data.size()) throw std::runtime_error("binary IR: unexpected end of file");
+        uint32_t word;
+        std::memcpy(&word, data.data() + pos, 4);
+        pos += 4;
+        return word;
+    }
+
+    /**
+     * @brief 读取一个元素个数，每个元素至少占一个字，不能超过剩余的字数
+     */
+    uint32_t count() {
+        uint32_t word = next();
+        if (word > (data.size() - pos) / 4) throw std::runtime_error("binary IR: count out of range");
+        return word;
+    }
+
+    /**
+     * @brief 读取一个作为表序号的字
+     */
+    uint32_t index(size_t limit) {
+        uint32_t word = next();
+        if (word >= limit) throw std::runtime_error("binary IR: index out of range");
+        return word;
+    }
+};
+
+bool IRBinaryReader::is_binary(std::string_view data) {
+    uint32_t magic;
+    if (data.size() < 4) return false;
+    std::memcpy(&magic, data.data(), 4);
+    return magic == IRBinaryFormat::kMagic;
+}
+
+std::unique_ptr<Module> IRBinaryReader::load(const std::string &path) {
+    Stats::Timer timer("IRBinaryReader::load");
+    std::unique_ptr<IRBinaryReader> reader(new IRBinaryReader);
+    if (!reader->buffer_.open(path)) throw std::runtime_error("cannot open " + path);
+    reader->data_ = reader->buffer_.text();
+    if (!is_binary(reader->data_)) throw std::runtime_error(path + " is not a binary IR file");
+
+    auto module = std::make_unique<Module>(path);
+    reader->module_ = module.get();
+    reader->read_module();
+    module->set_materializer(std::move(reader));
+    return module;
+}
+
+std::string IRBinaryReader::name_of(uint32_t index) const {
+    if (index == IRBinaryFormat::kNone) return "";
+    if (index >= strings_.size()) throw std::runtime_error("binary IR: index out of range");
+    return std::string(strings_[index]);
+}
+
+Type *IRBinaryReader::type_of(uint32_t index) const {
+    if (index >= types_.size()) throw std::runtime_error("binary IR: index out of range");
+    return types_[index];
+}
+
+void IRBinaryReader::read_module() {
+    Module *m = module_;
+    Cursor header{data_, 4};
+    if (header.next() != Format::kVersion) throw std::runtime_error("binary IR: unsupported version");
+    uint32_t strings_off = header.next(), types_off = header.next(), consts_off = header.next();
+    uint32_t globals_off = header.next(), funcs_off = header.next();
+    if (header.next() != data_.size()) throw std::runtime_error("binary IR: file size mismatch");
+
+    // 字符串只记下在映射中的位置，用到时才复制
+    Cursor in{data_, strings_off};
+    uint32_t n = in.count();
+    size_t bytes = strings_off + 4 + static_cast<size_t>(n) * 8;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t offset = in.next(), length = in.next();
+        if (bytes + offset + length > data_.size()) throw std::runtime_error("binary IR: string out of range");
+        strings_.push_back(data_.substr(bytes + offset, length));
+    }
+
+    in.pos = types_off;
+    n = in.count();
+    for (uint32_t i = 0; i < n; i++) {
+        Type *ty = nullptr;
+        switch (in.next()) {
+            case Type::VoidTyID: ty = m->get_void_type(); break;
+            case Type::LabelTyID: ty = m->get_label_type(); break;
+            case Type::IntegerTy1ID: ty = m->get_int1_type(); break;
+            case Type::IntegerTy32ID: ty = m->get_int32_type(); break;
+            case Type::FloatTyID: ty = m->get_float_type(); break;
+            case Type::PointerTyID: ty = m->get_pointer_type(types_[in.index(i)]); break;
+            case Type::ArrayTyID: {
+                Type *elem = types_[in.index(i)];
+                ty = m->get_array_type(elem, in.next());
+                break;
+            }
+            case Type::FunctionTyID: {
+                Type *ret = types_[in.index(i)];
+                std::vector<Type *> params(in.count());
+                for (auto &param: params) param = types_[in.index(i)];
+                ty = FunctionType::get(ret, params);
+                break;
+            }
+            default:
+                throw std::runtime_error("binary IR: bad type record");
+        }
+        types_.push_back(ty);
+    }
+
+    in.pos = consts_off;
+    n = in.count();
+    for (uint32_t i = 0; i < n; i++) {
+        Constant *c = nullptr;
+        switch (in.next()) {
+            case Format::Int: {
+                Type *ty = type_of(in.next());
+                if (!ty->is_integer_type()) throw std::runtime_error("binary IR: bad constant type");
+                c = m->get_constant_int(static_cast<IntegerType *>(ty), static_cast<int>(in.next()));
+                break;
+            }
+            case Format::FP: {
+                uint32_t bits = in.next();
+                float v;
+                std::memcpy(&v, &bits, sizeof(v));
+                c = m->get_constant_fp(v);
+                break;
+            }
+            case Format::Zero:
+                c = m->get_constant_zero(type_of(in.next()));
+                break;
+            case Format::Array: {
+                Type *ty = type_of(in.next());
+                Type *scalar = ConstantArray::get_scalar_type(ty);
+                if (!ty->is_array_type() || !(scalar->is_integer_type() || scalar->is_float_type())) {
+                    throw std::runtime_error("binary IR: bad constant type");
+                }
+                uint32_t words = in.count();
+                if (words != ConstantArray::get_num_scalars(ty)) throw std::runtime_error("binary IR: bad array size");
+                std::vector<uint32_t> data(words);
+                for (auto &bits: data) bits = in.next();
+                c = ConstantArray::get_raw(static_cast<ArrayType *>(ty), std::move(data));
+                break;
+            }
+            default:
+                throw std::runtime_error("binary IR: bad constant record");
+        }
+        consts_.push_back(c);
+    }
+
+    in.pos = globals_off;
+    n = in.count();
+    for (uint32_t i = 0; i < n; i++) {
+        std::string name = name_of(in.next());
+        Type *ty = type_of(in.next());
+        bool is_const = in.next() != 0;
+        uint32_t init = in.next();
+        if (init != Format::kNone && init >= consts_.size()) throw std::runtime_error("binary IR: index out of range");
+        Constant *init_val = init == Format::kNone ? nullptr : consts_[init];
+        auto gv = GlobalVariable::create(name, m, ty, is_const, init_val);
+        std::vector<int> flat(in.count());
+        for (auto &v: flat) v = static_cast<int>(in.next());
+        if (!flat.empty()) gv->setFlattenInit(flat);
+        globals_.push_back(gv);
+    }
+
+    in.pos = funcs_off;
+    n = in.count();
+    for (uint32_t i = 0; i < n; i++) {
+        std::string name = name_of(in.next());
+        Type *ty = type_of(in.next());
+        if (!ty->is_function_type()) throw std::runtime_error("binary IR: bad function type");
+        auto f = Function::create(static_cast<FunctionType *>(ty), name, m);
+        uint32_t kind = in.next(), offset = in.next(), words = in.next();
+        if (kind == Format::CachedText) {
+            f->set_cached_ir(name_of(offset));
+        } else if (kind == Format::Body) {
+            if (offset + static_cast<size_t>(words) * 4 > data_.size()) {
+                throw std::runtime_error("binary IR: function body out of range");
+            }
+            f->set_lazy_body(static_cast<uint32_t>(bodies_.size()));
+            bodies_.emplace_back(offset, words);
+        }
+        funcs_.push_back(f);
+    }
+}
+
+void IRBinaryReader::materialize(Function *f, uint32_t body) {
+    Stats::Timer timer("IRBinaryReader::materialize");
+    Stats::count("functions materialized", 1);
+    Module *m = module_;
+    auto [offset, words] = bodies_.at(body);
+    Cursor in{data_.substr(0, offset + static_cast<size_t>(words) * 4), offset};
+
+    for (auto arg: f->get_args()) {
+        std::string name = name_of(in.next());
+        if (!name.empty()) arg->set_name(name);
+    }
+    std::vector<Argument *> args(f->get_args().begin(), f->get_args().end());
+
+    // 1. 先建出全部基本块，前驱/后继等指令建完后再照原样填入
+    std::vector<BasicBlock *> blocks(in.count());
+    std::vector<std::vector<uint32_t>> preds(blocks.size()), succs(blocks.size());
+    std::vector<uint32_t> sizes(blocks.size());
+    size_t num_instrs = 0;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        std::string name = name_of(in.next());
+        bool fake = in.next() != 0;
+        blocks[i] = new (m) BasicBlock(m, name, f, fake);
+        preds[i].resize(in.count());
+        for (auto &pred: preds[i]) pred = in.index(blocks.size());
+        succs[i].resize(in.count());
+        for (auto &succ: succs[i]) succ = in.index(blocks.size());
+        sizes[i] = in.count();
+        num_instrs += sizes[i];
+    }
+    if (num_instrs > (in.data.size() - in.pos) / 20) throw std::runtime_error("binary IR: count out of range");
+
+    // 2. 预读每条指令的类型：后面的指令（phi 的来源、按块顺序在后面定义的值）
+    //    被提前引用时先用同类型的占位值代替
+    std::vector<size_t> records(num_instrs);
+    std::vector<Type *> instr_types(num_instrs);
+    Cursor scan = in;
+    for (size_t i = 0; i < num_instrs; i++) {
+        records[i] = scan.pos;
+        scan.next();
+        instr_types[i] = type_of(scan.next());
+        scan.pos += 8;
+        scan.pos += static_cast<size_t>(scan.next()) * 4;
+    }
+    std::vector<Value *> instrs(num_instrs, nullptr);
+    std::vector<Value *> placeholders(num_instrs, nullptr);
+
+    auto operand = [&](uint32_t word) -> Value * {
+        uint32_t index = word >> 3;
+        switch (word & 7) {
+            case Format::Instr:
+                if (index >= num_instrs) break;
+                if (instrs[index]) return instrs[index];
+                if (!placeholders[index]) placeholders[index] = new (m) Value(instr_types[index]);
+                return placeholders[index];
+            case Format::Arg:
+                if (index < args.size()) return args[index];
+                break;
+            case Format::Block:
+                if (index < blocks.size()) return blocks[index];
+                break;
+            case Format::Const:
+                if (index < consts_.size()) return consts_[index];
+                break;
+            case Format::Global:
+                if (index < globals_.size()) return globals_[index];
+                break;
+            case Format::Func:
+                if (index < funcs_.size()) return funcs_[index];
+                break;
+            default:
+                break;
+        }
+        throw std::runtime_error("binary IR: bad operand in @" + f->get_name());
+    };
+    auto block_of = [&](Value *v) {
+        auto bb = dynamic_cast<BasicBlock *>(v);
+        if (bb == nullptr) throw std::runtime_error("binary IR: bad branch target in @" + f->get_name());
+        return bb;
+    };
+
+    // 3. 按块顺序重建指令，各 create 函数负责挂接 use
+    size_t index = 0;
+    std::vector<Value *> ops;
+    for (size_t b = 0; b < blocks.size(); b++) {
+        BasicBlock *bb = blocks[b];
+        for (uint32_t k = 0; k < sizes[b]; k++, index++) {
+            in.pos = records[index];
+            auto op = static_cast<Instruction::OpID>(in.next());
+            Type *ty = type_of(in.next());
+            std::string name = name_of(in.next());
+            uint32_t extra = in.next();
+            ops.resize(in.count());
+            for (auto &v: ops) v = operand(in.next());
+            auto need = [&](size_t count) {
+                if (ops.size() != count) throw std::runtime_error("binary IR: bad operand count in @" + f->get_name());
+            };
+            auto need_pointer = [&](Value *v) {
+                if (!v->get_type()->is_pointer_type()) throw std::runtime_error("binary IR: bad pointer in @" + f->get_name());
+            };
+
+            Instruction *instr = nullptr;
+            switch (op) {
+                case Instruction::ret:
+                    instr = ops.empty() ? ReturnInst::create_void_ret(bb) : ReturnInst::create_ret(ops[0], bb);
+                    break;
+                case Instruction::br:
+                    if (ops.size() == 1) {
+                        instr = BranchInst::create_br(block_of(ops[0]), bb);
+                    } else {
+                        need(3);
+                        instr = BranchInst::create_cond_br(ops[0], block_of(ops[1]), block_of(ops[2]), bb);
+                    }
+                    break;
+                case Instruction::add:
+                case Instruction::sub:
+                case Instruction::mul:
+                case Instruction::sdiv:
+                case Instruction::mod:
+                case Instruction::fadd:
+                case Instruction::fsub:
+                case Instruction::fmul:
+                case Instruction::fdiv:
+                    need(2);
+                    instr = new (m) BinaryInst(ty, op, ops[0], ops[1], bb);
+                    break;
+                case Instruction::cmp:
+                    need(2);
+                    instr = CmpInst::create_cmp(static_cast<CmpInst::CmpOp>(extra), ops[0], ops[1], bb, m);
+                    break;
+                case Instruction::alloca: {
+                    if (!ty->is_pointer_type()) throw std::runtime_error("binary IR: bad alloca in @" + f->get_name());
+                    auto alloca = AllocaInst::create_alloca(ty->get_pointer_element_type(), bb);
+                    if (extra) alloca->set_init();
+                    instr = alloca;
+                    break;
+                }
+                case Instruction::load:
+                    need(1);
+                    need_pointer(ops[0]);
+                    instr = LoadInst::create_load(ty, ops[0], bb);
+                    break;
+                case Instruction::store:
+                    need(2);
+                    need_pointer(ops[1]);
+                    instr = StoreInst::create_store(ops[0], ops[1], bb);
+                    break;
+                case Instruction::phi: {
+                    if (ops.size() % 2) throw std::runtime_error("binary IR: bad phi in @" + f->get_name());
+                    auto phi = PhiInst::create_phi(ty, bb);
+                    for (size_t i = 0; i < ops.size(); i += 2) phi->add_phi_pair_operand(ops[i], ops[i + 1]);
+                    instr = phi;
+                    break;
+                }
+                case Instruction::call: {
+                    auto callee = ops.empty() ? nullptr : dynamic_cast<Function *>(ops[0]);
+                    if (callee == nullptr || callee->get_num_of_args() + 1 != ops.size()) {
+                        throw std::runtime_error("binary IR: bad call in @" + f->get_name());
+                    }
+                    instr = CallInst::create(callee, std::vector<Value *>(ops.begin() + 1, ops.end()), bb);
+                    break;
+                }
+                case Instruction::getelementptr:
+                    if (ops.empty()) throw std::runtime_error("binary IR: bad getelementptr in @" + f->get_name());
+                    need_pointer(ops[0]);
+                    instr = GetElementPtrInst::create_gep(ops[0], std::vector<Value *>(ops.begin() + 1, ops.end()), bb);
+                    break;
+                case Instruction::zext:
+                    need(1);
+                    instr = ZextInst::create_zext(ops[0], ty, bb);
+                    break;
+                case Instruction::sitofp:
+                    need(1);
+                    instr = SiToFpInst::create_sitofp(ops[0], ty, bb);
+                    break;
+                case Instruction::fptosi:
+                    need(1);
+                    instr = FpToSiInst::create_fptosi(ops[0], ty, bb);
+                    break;
+                default:
+                    throw std::runtime_error("binary IR: bad opcode in @" + f->get_name());
+            }
+            if (!name.empty()) instr->set_name(name);
+            instrs[index] = instr;
+            if (Value *placeholder = placeholders[index]) {
+                placeholder->replace_all_use_with(instr);
+                placeholder->~Value();
+                Value::operator delete(placeholder, m);
+            }
+        }
+    }
+
+    // 4. 前驱/后继按写出时的顺序恢复，不依赖分支指令的创建顺序
+    for (size_t b = 0; b < blocks.size(); b++) {
+        auto &pre = blocks[b]->get_pre_basic_blocks();
+        pre.clear();
+        for (auto i: preds[b]) pre.push_back(blocks[i]);
+        auto &succ = blocks[b]->get_succ_basic_blocks();
+        succ.clear();
+        for (auto i: succs[b]) succ.push_back(blocks[i]);
+    }
+    f->set_instr_name();
+}
@@ -0,0 +1,59 @@
+/*!
+ * @file IRCache.cpp
+ * @brief 按函数缓存打印好的中间代码实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "IRCache.h"
+#include <unistd.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+IRCache::IRCache(std::string dir) : dir(std::move(dir)) {
+    std::error_code ec;
+    std::filesystem::create_directories(this->dir, ec);
+}
+
+std::string IRCache::pathOf(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.ll", static_cast<unsigned long long>(key));
+    return dir + "/" + name;
+}
+
+bool IRCache::lookup(uint64_t key, std::string& ir) const {
+    std::ifstream in(pathOf(key), std::ios::binary);
+    if (!in) return false;
+    std::ostringstream buf;
+    buf << in.rdbuf();
+    ir = buf.str();
+    return !ir.empty();
+}
+
+void IRCache::store(uint64_t key, const std::string& ir) const {
+    std::string path = pathOf(key);
+    std::ostringstream tmp;
+    tmp << path << ".tmp" << getpid() << "-" << std::hash<std::thread::id>()(std::this_thread::get_id());
+    {
+        std::ofstream out(tmp.str(), std::ios::binary);
+        if (!out) return;
+        out << ir;
+        if (!out) return;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp.str(), path, ec);
+    if (ec) std::filesystem::remove(tmp.str(), ec);
+}
+
+uint64_t IRCache::combine(uint64_t h, uint64_t v) {
+    // boost::hash_combine 的 64 位版本
+    return h ^ (v + 0x9e3779b97f4a7c15ull + (h << 12) + (h >> 4));
+}
+
+uint64_t IRCache::combine(uint64_t h, const std::string& s) {
+    return combine(h, std::hash<std::string>()(s));
+}
@@ -6,14 +6,31 @@
  */
 
 #include "IRGenerator.h"
+#include "PassManager.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdint>
 #include <stdexcept>
 #include <sstream>
+#include <thread>
+
+namespace {
+
+// 函数少于此数时顺序生成，建线程池不划算
+constexpr size_t kParallelFuncThreshold = 64;
+
+// 每个线程平均分到的任务数，任务太大时工作窃取难以均衡
+constexpr size_t kTasksPerThread = 8;
+
+}  // namespace
 
 // ==================== 构造函数和析构函数 ====================
 
 IRGenerator::IRGenerator(const std::string& sourceFileName) {
     // 创建模块
     module = new Module("sysy2025_compiler");
+    ownsModule = true;
 
     // 创建IR构建器（初始基本块为nullptr）
     builder = new IRBuilder(nullptr, module);
@@ -25,6 +42,13 @@ IRGenerator::IRGenerator(const std::string& sourceFileName) {
     tmpFloatVal = 0.0f;
     tmpIsFloat = false;
     isConstExpr = false;
+    diag = &std::cerr;
+    errorCount = 0;
+    optLevel = 0;
+    jobs = 0;
+    visibleOrder = &funcOrder;
+    funcLimit = SIZE_MAX;
+    cacheContext = 0;
     trueBB = nullptr;
     falseBB = nullptr;
 
@@ -32,23 +56,84 @@ IRGenerator::IRGenerator(const std::string& sourceFileName) {
     declareRuntimeFunctions();
 }
 
+IRGenerator::IRGenerator(const IRGenerator& parent) : symbolTable(parent.symbolTable) {
+    module = parent.module;
+    ownsModule = false;
+    builder = new IRBuilder(nullptr, module);
+
+    currentFunction = nullptr;
+    currentBB = nullptr;
+    tmpIntVal = 0;
+    tmpFloatVal = 0.0f;
+    tmpIsFloat = false;
+    isConstExpr = false;
+    diag = parent.diag;
+    errorCount = 0;
+    optLevel = parent.optLevel;
+    jobs = 1;
+    visibleOrder = parent.visibleOrder;
+    funcLimit = SIZE_MAX;
+    cacheContext = 0;
+    trueBB = nullptr;
+    falseBB = nullptr;
+}
+
 IRGenerator::~IRGenerator() {
     delete builder;
-    // Module由用户管理，不在这里删除
+    // 释放模块即整体释放其内存池中的全部IR对象
+    if (ownsModule) delete module;
 }
 
-void IRGenerator::generate(std::shared_ptr<CompUnitNode> ast) {
+void IRGenerator::generate(CompUnitNode* ast) {
     if (ast) {
+        Stats::Timer timer("IRGenerator::generate");
         visitCompUnit(ast);
+        if (cache && optLevel >= 2) lowerCachedCallees();
+        // 优化在命名之前进行，被删除的值不占用编号
+        if (optLevel > 0) {
+            PassManager pm;
+            PassManager::build_pipeline(pm, optLevel);
+            pm.run(module);
+        }
         // 设置打印名称
         module->set_print_name();
+        if (cache) {
+            for (auto& [func, key] : cacheMisses) {
+                std::ostringstream text;
+                func->print(text);
+                cache->store(key, text.str());
+            }
+            Stats::count("functions compiled", cacheMisses.size());
+        }
+    }
+    if (Stats::enabled()) countModule();
+}
+
+void IRGenerator::countModule() {
+    uint64_t bbs = 0, instrs = 0, uses = 0;
+    for (auto func : module->get_functions()) {
+        for (auto bb : func->get_basic_blocks()) {
+            bbs++;
+            for (auto instr : bb->get_instructions()) {
+                instrs++;
+                uses += instr->get_num_operand();
+            }
+        }
     }
+    Stats::count("functions", module->get_functions().size());
+    Stats::count("basic blocks", bbs);
+    Stats::count("instructions", instrs);
+    Stats::count("uses", uses);
 }
 
 std::string IRGenerator::print() {
     return module->print();
 }
 
+void IRGenerator::print(std::ostream& os) {
+    module->print(os);
+}
+
 // ==================== 辅助函数 ====================
 
 Type* IRGenerator::bTypeToLLVMType(BType bType) {
@@ -128,24 +213,24 @@ Value* IRGenerator::ensureInt1(Value* val) {
     return val;
 }
 
-int IRGenerator::evalConstInt(std::shared_ptr<ExpNode> node) {
+int IRGenerator::evalConstInt(ExpNode* node) {
     // 简化的常量求值 - 仅支持数字字面量
-    if (auto numNode = std::dynamic_pointer_cast<NumberNode>(node)) {
+    if (auto numNode = dynamic_cast<NumberNode*>(node)) {
         return numNode->intVal;
     }
-    if (auto addNode = std::dynamic_pointer_cast<AddExpNode>(node)) {
+    if (auto addNode = dynamic_cast<AddExpNode*>(node)) {
         if (!addNode->left && addNode->right) {
             // 仅有右操作数（mulExp）
             return evalConstInt(addNode->right);
         }
     }
-    if (auto mulNode = std::dynamic_pointer_cast<MulExpNode>(node)) {
+    if (auto mulNode = dynamic_cast<MulExpNode*>(node)) {
         if (!mulNode->left && mulNode->right) {
             // 仅有右操作数（unaryExp）
             return evalConstInt(mulNode->right);
         }
     }
-    if (auto unaryNode = std::dynamic_pointer_cast<UnaryExpNode>(node)) {
+    if (auto unaryNode = dynamic_cast<UnaryExpNode*>(node)) {
         if (unaryNode->unaryType == UnaryExpNode::UnaryType::PRIMARY) {
             return evalConstInt(unaryNode->primaryExp);
         } else if (unaryNode->unaryType == UnaryExpNode::UnaryType::UNARY_OP) {
@@ -157,7 +242,7 @@ int IRGenerator::evalConstInt(std::shared_ptr<ExpNode> node) {
             }
         }
     }
-    if (auto primaryNode = std::dynamic_pointer_cast<PrimaryExpNode>(node)) {
+    if (auto primaryNode = dynamic_cast<PrimaryExpNode*>(node)) {
         if (primaryNode->primaryType == PrimaryExpNode::PrimaryType::NUMBER) {
             return primaryNode->number->intVal;
         } else if (primaryNode->primaryType == PrimaryExpNode::PrimaryType::PAREN_EXP) {
@@ -167,23 +252,23 @@ int IRGenerator::evalConstInt(std::shared_ptr<ExpNode> node) {
     return 0;
 }
 
-float IRGenerator::evalConstFloat(std::shared_ptr<ExpNode> node) {
-    if (auto numNode = std::dynamic_pointer_cast<NumberNode>(node)) {
+float IRGenerator::evalConstFloat(ExpNode* node) {
+    if (auto numNode = dynamic_cast<NumberNode*>(node)) {
         return numNode->isFloat ? numNode->floatVal : (float)numNode->intVal;
     }
-    if (auto addNode = std::dynamic_pointer_cast<AddExpNode>(node)) {
+    if (auto addNode = dynamic_cast<AddExpNode*>(node)) {
         if (!addNode->left && addNode->right) {
             // 仅有右操作数（mulExp）
             return evalConstFloat(addNode->right);
         }
     }
-    if (auto mulNode = std::dynamic_pointer_cast<MulExpNode>(node)) {
+    if (auto mulNode = dynamic_cast<MulExpNode*>(node)) {
         if (!mulNode->left && mulNode->right) {
             // 仅有右操作数（unaryExp）
             return evalConstFloat(mulNode->right);
         }
     }
-    if (auto unaryNode = std::dynamic_pointer_cast<UnaryExpNode>(node)) {
+    if (auto unaryNode = dynamic_cast<UnaryExpNode*>(node)) {
         if (unaryNode->unaryType == UnaryExpNode::UnaryType::PRIMARY) {
             return evalConstFloat(unaryNode->primaryExp);
         } else if (unaryNode->unaryType == UnaryExpNode::UnaryType::UNARY_OP) {
@@ -195,7 +280,7 @@ float IRGenerator::evalConstFloat(std::shared_ptr<ExpNode> node) {
             }
         }
     }
-    if (auto primaryNode = std::dynamic_pointer_cast<PrimaryExpNode>(node)) {
+    if (auto primaryNode = dynamic_cast<PrimaryExpNode*>(node)) {
         if (primaryNode->primaryType == PrimaryExpNode::PrimaryType::NUMBER) {
             return primaryNode->number->isFloat ? primaryNode->number->floatVal : (float)primaryNode->number->intVal;
         } else if (primaryNode->primaryType == PrimaryExpNode::PrimaryType::PAREN_EXP) {
@@ -207,45 +292,128 @@ float IRGenerator::evalConstFloat(std::shared_ptr<ExpNode> node) {
 
 // ==================== Visitor函数实现 ====================
 
-void IRGenerator::visitCompUnit(std::shared_ptr<CompUnitNode> node) {
+void IRGenerator::visitCompUnit(CompUnitNode* node) {
     // 先处理全局声明
     for (auto& decl : node->decls) {
         visitDecl(decl);
     }
 
+    // 函数体可以引用任意全局声明，因此全部声明都进入缓存键；
+    // 编译器生成的IR改变时由 IRCache::kFormatVersion 区分新旧条目
+    if (cache) {
+        cacheContext = IRCache::combine(IRCache::combine(0, IRCache::kFormatVersion), optLevel);
+        for (auto& decl : node->decls) {
+            cacheContext = IRCache::combine(cacheContext, decl->tokenHash);
+        }
+    }
+
     // 再处理函数定义
+    int numThreads = jobs > 0 ? jobs : static_cast<int>(std::thread::hardware_concurrency());
+    if (numThreads > 1 && node->funcDefs.size() >= kParallelFuncThreshold) {
+        lowerFuncsInParallel(node->funcDefs, numThreads);
+        return;
+    }
     for (auto& funcDef : node->funcDefs) {
         visitFuncDef(funcDef);
     }
 }
 
-void IRGenerator::visitDecl(std::shared_ptr<DeclNode> node) {
-    if (auto constDecl = std::dynamic_pointer_cast<ConstDeclNode>(node)) {
+void IRGenerator::lowerFuncsInParallel(const std::vector<FuncDefNode*>& funcDefs, int numThreads) {
+    // 第一阶段：按源码顺序声明，函数列表、符号表与缓存键都与顺序生成相同
+    struct Pending {
+        FuncDefNode* node;
+        Function* func;
+        uint64_t cacheKey;
+        size_t index;
+        std::string errors;
+    };
+    std::vector<Pending> pending;
+    for (size_t i = 0; i < funcDefs.size(); i++) {
+        uint64_t cacheKey = 0;
+        Function* func = declareFuncDef(funcDefs[i], cacheKey);
+        if (func) pending.push_back({funcDefs[i], func, cacheKey, i, std::string()});
+    }
+
+    // 第二阶段：每个任务生成一段连续的函数体，共享值的 use 按任务登记
+    size_t numTasks = std::max<size_t>(1, std::min(pending.size(), numThreads * kTasksPerThread));
+    size_t chunk = (pending.size() + numTasks - 1) / std::max<size_t>(numTasks, 1);
+    std::vector<std::vector<DeferredUse>> deferred(numTasks);
+    std::vector<size_t> taskErrors(numTasks, 0);
+    {
+        ThreadPool pool(numThreads);
+        for (size_t t = 0; t < numTasks; t++) {
+            size_t begin = t * chunk;
+            size_t end = std::min(pending.size(), begin + chunk);
+            if (begin >= end) break;
+            pool.submit([this, &pending, &deferred, &taskErrors, t, begin, end] {
+                IRArena::Local arena(module->get_arena());
+                Value::defer_shared_uses(&deferred[t]);
+                IRGenerator worker(*this);
+                for (size_t i = begin; i < end; i++) {
+                    std::ostringstream funcDiag;
+                    worker.diag = &funcDiag;
+                    worker.funcLimit = pending[i].index;
+                    worker.lowerFuncBody(pending[i].node, pending[i].func);
+                    pending[i].errors = funcDiag.str();
+                }
+                taskErrors[t] = worker.errorCount;
+                Value::defer_shared_uses(nullptr);
+            });
+        }
+        pool.wait();
+    }
+
+    // 按源码顺序挂接 use、输出诊断，结果与顺序生成一致
+    for (auto& uses : deferred) {
+        User::link_deferred(uses);
+    }
+    for (size_t n : taskErrors) errorCount += n;
+    for (auto& p : pending) {
+        if (cache) {
+            finishFuncDef(p.func, p.cacheKey, p.errors);
+        } else {
+            *diag << p.errors;
+        }
+    }
+}
+
+SymbolInfo* IRGenerator::lookupSymbol(const std::string& name) {
+    SymbolInfo* info = symbolTable.lookup(name);
+    // 函数以无类型的全局符号登记
+    if (info && funcLimit != SIZE_MAX && info->isGlobal && info->type == nullptr) {
+        auto it = visibleOrder->find(info->value);
+        if (it != visibleOrder->end() && it->second > funcLimit) return nullptr;
+    }
+    return info;
+}
+
+void IRGenerator::visitDecl(DeclNode* node) {
+    if (auto constDecl = dynamic_cast<ConstDeclNode*>(node)) {
         visitConstDecl(constDecl);
-    } else if (auto varDecl = std::dynamic_pointer_cast<VarDeclNode>(node)) {
+    } else if (auto varDecl = dynamic_cast<VarDeclNode*>(node)) {
         visitVarDecl(varDecl);
     }
 }
 
-void IRGenerator::visitConstDecl(std::shared_ptr<ConstDeclNode> node) {
+void IRGenerator::visitConstDecl(ConstDeclNode* node) {
     for (auto& constDef : node->constDefs) {
         visitConstDef(constDef, node->bType);
     }
 }
 
-void IRGenerator::visitVarDecl(std::shared_ptr<VarDeclNode> node) {
+void IRGenerator::visitVarDecl(VarDeclNode* node) {
     for (auto& varDef : node->varDefs) {
         visitVarDef(varDef, node->bType);
     }
 }
 
-void IRGenerator::visitConstDef(std::shared_ptr<ConstDefNode> node, BType bType) {
+void IRGenerator::visitConstDef(ConstDefNode* node, BType bType) {
     Type* type = bTypeToLLVMType(bType);
     std::string name = node->ident;
 
     // 检查重复定义
     if (symbolTable.lookupCurrentScope(name) != nullptr) {
-        std::cerr << "Error: 重复定义变量 " << name << std::endl;
+        error() << "重复定义变量 " << name << std::endl;
         return;
     }
 
@@ -279,13 +447,13 @@ void IRGenerator::visitConstDef(std::shared_ptr<ConstDefNode> node, BType bType)
     }
 }
 
-void IRGenerator::visitVarDef(std::shared_ptr<VarDefNode> node, BType bType) {
+void IRGenerator::visitVarDef(VarDefNode* node, BType bType) {
     Type* type = bTypeToLLVMType(bType);
     std::string name = node->ident;
 
     // 检查重复定义
     if (symbolTable.lookupCurrentScope(name) != nullptr) {
-        std::cerr << "Error: 重复定义变量 " << name << std::endl;
+        error() << "重复定义变量 " << name << std::endl;
         return;
     }
 
@@ -320,7 +488,25 @@ void IRGenerator::visitVarDef(std::shared_ptr<VarDefNode> node, BType bType) {
     }
 }
 
-void IRGenerator::visitFuncDef(std::shared_ptr<FuncDefNode> node) {
+void IRGenerator::visitFuncDef(FuncDefNode* node) {
+    uint64_t cacheKey = 0;
+    Function* func = declareFuncDef(node, cacheKey);
+    if (!func) return;
+
+    // 只缓存没有语义错误的函数：先收集本函数的诊断，结束时再转发
+    std::ostream* outerDiag = diag;
+    std::ostringstream funcDiag;
+    if (cache) diag = &funcDiag;
+
+    lowerFuncBody(node, func);
+
+    if (cache) {
+        diag = outerDiag;
+        finishFuncDef(func, cacheKey, funcDiag.str());
+    }
+}
+
+Function* IRGenerator::declareFuncDef(FuncDefNode* node, uint64_t& cacheKey) {
     // 获取返回类型
     Type* retType = bTypeToLLVMType(node->returnType);
 
@@ -335,12 +521,38 @@ void IRGenerator::visitFuncDef(std::shared_ptr<FuncDefNode> node) {
 
     // 创建函数
     Function* func = Function::create(funcType, node->ident, module);
-    currentFunction = func;
-    builder->set_curFunc(func);
+    funcOrder.emplace(func, funcOrder.size());
 
     // 将函数添加到符号表（用于递归调用）
     symbolTable.put(node->ident, func);
 
+    // 函数体只能调用在它之前定义的函数，键中只需要这些函数的签名
+    cacheKey = 0;
+    if (cache) {
+        cacheKey = IRCache::combine(cacheContext, node->tokenHash);
+        cacheContext = IRCache::combine(cacheContext, node->ident);
+        cacheContext = IRCache::combine(cacheContext, static_cast<uint64_t>(node->returnType));
+        for (auto& param : node->params) {
+            cacheContext = IRCache::combine(cacheContext, static_cast<uint64_t>(param->bType));
+        }
+        // -O2 会把之前定义的函数内联进来，它们的函数体也影响之后函数的IR
+        if (optLevel >= 2) cacheContext = IRCache::combine(cacheContext, node->tokenHash);
+        std::string ir;
+        if (cache->lookup(cacheKey, ir)) {
+            func->set_cached_ir(std::move(ir));
+            cacheHits.emplace(func, node);
+            Stats::count("functions reused from cache", 1);
+            return nullptr;
+        }
+    }
+    return func;
+}
+
+void IRGenerator::lowerFuncBody(FuncDefNode* node, Function* func) {
+    Type* retType = func->get_return_type();
+    currentFunction = func;
+    builder->set_curFunc(func);
+
     // 创建入口基本块
     BasicBlock* entryBB = BasicBlock::create(module, node->ident + "_ENTRY", func);
     currentBB = entryBB;
@@ -382,7 +594,51 @@ void IRGenerator::visitFuncDef(std::shared_ptr<FuncDefNode> node) {
     currentFunction = nullptr;
 }
 
-void IRGenerator::visitBlock(std::shared_ptr<BlockNode> node) {
+void IRGenerator::lowerCachedCallees() {
+    // 内联器看不到只有缓存文本的函数，调用它的函数会与不用缓存时不同
+    std::vector<Function*> work;
+    for (auto func : module->get_functions()) {
+        if (!func->has_cached_ir() && !func->is_declaration()) work.push_back(func);
+    }
+    // 命中缓存的函数上次没有语义错误，补生成时不再输出诊断
+    std::ostream* outerDiag = diag;
+    std::ostringstream ignored;
+    diag = &ignored;
+    while (!work.empty()) {
+        Function* func = work.back();
+        work.pop_back();
+        for (auto bb : func->get_basic_blocks()) {
+            for (auto instr : bb->get_instructions()) {
+                if (!instr->is_call()) continue;
+                auto it = cacheHits.find(static_cast<Function*>(instr->get_operand(0)));
+                if (it == cacheHits.end()) continue;
+                auto [callee, node] = *it;
+                cacheHits.erase(it);
+                funcLimit = funcOrder.at(callee);
+                lowerFuncBody(node, callee);
+                funcLimit = SIZE_MAX;
+                work.push_back(callee);
+                Stats::count("cached functions lowered for inlining", 1);
+            }
+        }
+    }
+    diag = outerDiag;
+}
+
+std::ostream& IRGenerator::error() {
+    errorCount++;
+    return *diag << "Error: ";
+}
+
+void IRGenerator::finishFuncDef(Function* func, uint64_t cacheKey, const std::string& errors) {
+    if (errors.empty()) {
+        cacheMisses.emplace_back(func, cacheKey);
+    } else {
+        *diag << errors;
+    }
+}
+
+void IRGenerator::visitBlock(BlockNode* node) {
     // 进入新作用域
     symbolTable.enterScope();
 
@@ -394,7 +650,7 @@ void IRGenerator::visitBlock(std::shared_ptr<BlockNode> node) {
     symbolTable.exitScope();
 }
 
-void IRGenerator::visitBlockItem(std::shared_ptr<BlockItemNode> node) {
+void IRGenerator::visitBlockItem(BlockItemNode* node) {
     if (node->decl) {
         visitDecl(node->decl);
     } else if (node->stmt) {
@@ -402,7 +658,7 @@ void IRGenerator::visitBlockItem(std::shared_ptr<BlockItemNode> node) {
     }
 }
 
-void IRGenerator::visitStmt(std::shared_ptr<StmtNode> node) {
+void IRGenerator::visitStmt(StmtNode* node) {
     switch (node->stmtType) {
         case StmtType::ASSIGN:
             visitAssignStmt(node);
@@ -422,7 +678,7 @@ void IRGenerator::visitStmt(std::shared_ptr<StmtNode> node) {
     }
 }
 
-void IRGenerator::visitAssignStmt(std::shared_ptr<StmtNode> node) {
+void IRGenerator::visitAssignStmt(StmtNode* node) {
     // 获取左值地址
     Value* addr = visitLVal(node->lVal, false);
 
@@ -433,35 +689,27 @@ void IRGenerator::visitAssignStmt(std::shared_ptr<StmtNode> node) {
     builder->create_store(val, addr);
 }
 
-void IRGenerator::visitExpStmt(std::shared_ptr<StmtNode> node) {
+void IRGenerator::visitExpStmt(StmtNode* node) {
     if (node->exp) {
         visitExp(node->exp);
     }
 }
 
-void IRGenerator::visitBlockStmt(std::shared_ptr<StmtNode> node) {
+void IRGenerator::visitBlockStmt(StmtNode* node) {
     if (node->block) {
         visitBlock(node->block);
     }
 }
 
-void IRGenerator::visitIfStmt(std::shared_ptr<StmtNode> node) {
+void IRGenerator::visitIfStmt(StmtNode* node) {
     // 创建基本块
     BasicBlock* thenBB = BasicBlock::create(module, "", currentFunction);
     BasicBlock* elseBB = node->elseStmt ?
         BasicBlock::create(module, "", currentFunction) : nullptr;
     BasicBlock* mergeBB = BasicBlock::create(module, "", currentFunction);
 
-    // 计算条件
-    Value* condVal = visitCond(node->cond);
-    condVal = ensureInt1(condVal);
-
     // 条件跳转
-    if (elseBB) {
-        builder->create_cond_br(condVal, thenBB, elseBB);
-    } else {
-        builder->create_cond_br(condVal, thenBB, mergeBB);
-    }
+    visitCondBranch(node->cond, thenBB, elseBB ? elseBB : mergeBB);
 
     // 生成then分支
     currentBB = thenBB;
@@ -490,7 +738,7 @@ void IRGenerator::visitIfStmt(std::shared_ptr<StmtNode> node) {
     builder->set_insert_point(mergeBB);
 }
 
-void IRGenerator::visitReturnStmt(std::shared_ptr<StmtNode> node) {
+void IRGenerator::visitReturnStmt(StmtNode* node) {
     // Bug Fix 3: 检查返回类型是否与函数签名匹配
     if (currentFunction) {
         Type* funcRetType = currentFunction->get_return_type();
@@ -519,53 +767,158 @@ void IRGenerator::visitReturnStmt(std::shared_ptr<StmtNode> node) {
     }
 }
 
-Value* IRGenerator::visitExp(std::shared_ptr<ExpNode> node) {
+Value* IRGenerator::visitExp(ExpNode* node) {
     // 根据具体类型分发
-    if (auto addExp = std::dynamic_pointer_cast<AddExpNode>(node)) {
+    if (auto addExp = dynamic_cast<AddExpNode*>(node)) {
         return visitAddExp(addExp);
     }
-    if (auto mulExp = std::dynamic_pointer_cast<MulExpNode>(node)) {
+    if (auto mulExp = dynamic_cast<MulExpNode*>(node)) {
         return visitMulExp(mulExp);
     }
-    if (auto unaryExp = std::dynamic_pointer_cast<UnaryExpNode>(node)) {
+    if (auto unaryExp = dynamic_cast<UnaryExpNode*>(node)) {
         return visitUnaryExp(unaryExp);
     }
-    if (auto primaryExp = std::dynamic_pointer_cast<PrimaryExpNode>(node)) {
+    if (auto primaryExp = dynamic_cast<PrimaryExpNode*>(node)) {
         return visitPrimaryExp(primaryExp);
     }
-    if (auto lVal = std::dynamic_pointer_cast<LValNode>(node)) {
+    if (auto lVal = dynamic_cast<LValNode*>(node)) {
         return visitLVal(lVal, true);
     }
-    if (auto number = std::dynamic_pointer_cast<NumberNode>(node)) {
+    if (auto number = dynamic_cast<NumberNode*>(node)) {
         return visitNumber(number);
     }
-    if (auto relExp = std::dynamic_pointer_cast<RelExpNode>(node)) {
+    if (auto relExp = dynamic_cast<RelExpNode*>(node)) {
         return visitRelExp(relExp);
     }
-    if (auto eqExp = std::dynamic_pointer_cast<EqExpNode>(node)) {
+    if (auto eqExp = dynamic_cast<EqExpNode*>(node)) {
         return visitEqExp(eqExp);
     }
-    if (auto lAndExp = std::dynamic_pointer_cast<LAndExpNode>(node)) {
+    if (auto lAndExp = dynamic_cast<LAndExpNode*>(node)) {
         return visitLAndExp(lAndExp);
     }
-    if (auto lOrExp = std::dynamic_pointer_cast<LOrExpNode>(node)) {
+    if (auto lOrExp = dynamic_cast<LOrExpNode*>(node)) {
         return visitLOrExp(lOrExp);
     }
 
     return nullptr;
 }
 
-Value* IRGenerator::visitCond(std::shared_ptr<CondNode> node) {
+Value* IRGenerator::visitCond(CondNode* node) {
     if (node->lOrExp) {
         return visitLOrExp(node->lOrExp);
     }
     return nullptr;
 }
 
-Value* IRGenerator::visitLVal(std::shared_ptr<LValNode> node, bool load) {
-    SymbolInfo* info = symbolTable.lookup(node->ident);
+void IRGenerator::visitCondBranch(CondNode* node, BasicBlock* thenTarget, BasicBlock* elseTarget) {
+    BasicBlock* savedTrue = trueBB;
+    BasicBlock* savedFalse = falseBB;
+    trueBB = thenTarget;
+    falseBB = elseTarget;
+    visitCondBranch(node->lOrExp);
+    trueBB = savedTrue;
+    falseBB = savedFalse;
+}
+
+void IRGenerator::visitCondBranch(LOrExpNode* node) {
+    if (!node->left) {
+        visitCondBranch(node->right);
+        return;
+    }
+
+    // 左边为真直接跳到真出口，为假才计算右边
+    BasicBlock* rhsBB = BasicBlock::create(module, "", currentFunction);
+    BasicBlock* savedFalse = falseBB;
+    falseBB = rhsBB;
+    visitCondBranch(node->left);
+    falseBB = savedFalse;
+
+    currentBB = rhsBB;
+    builder->set_insert_point(rhsBB);
+    visitCondBranch(node->right);
+}
+
+void IRGenerator::visitCondBranch(LAndExpNode* node) {
+    if (!node->left) {
+        visitCondBranch(node->right);
+        return;
+    }
+
+    // 左边为假直接跳到假出口，为真才计算右边
+    BasicBlock* rhsBB = BasicBlock::create(module, "", currentFunction);
+    BasicBlock* savedTrue = trueBB;
+    trueBB = rhsBB;
+    visitCondBranch(node->left);
+    trueBB = savedTrue;
+
+    currentBB = rhsBB;
+    builder->set_insert_point(rhsBB);
+    visitCondBranch(node->right);
+}
+
+void IRGenerator::visitCondBranch(EqExpNode* node) {
+    BasicBlock* thenTarget = trueBB;
+    BasicBlock* elseTarget = falseBB;
+
+    // !x 只需交换跳转目标，不生成取反的比较
+    UnaryExpNode* unary = soleUnaryExp(node);
+    bool peeled = false;
+    while (unary && unary->unaryType == UnaryExpNode::UnaryType::UNARY_OP &&
+           unary->unaryOp == UnaryOp::NOT) {
+        peeled = true;
+        std::swap(thenTarget, elseTarget);
+        unary = stripParens(unary->unaryExp);
+    }
+
+    // 括号内的逻辑表达式继续按跳转翻译
+    if (unary && unary->unaryType == UnaryExpNode::UnaryType::PRIMARY &&
+        unary->primaryExp->primaryType == PrimaryExpNode::PrimaryType::PAREN_EXP) {
+        if (auto lOrExp = dynamic_cast<LOrExpNode*>(unary->primaryExp->exp)) {
+            BasicBlock* savedTrue = trueBB;
+            BasicBlock* savedFalse = falseBB;
+            trueBB = thenTarget;
+            falseBB = elseTarget;
+            visitCondBranch(lOrExp);
+            trueBB = savedTrue;
+            falseBB = savedFalse;
+            return;
+        }
+    }
+
+    Value* condVal = peeled ? visitUnaryExp(unary) : visitEqExp(node);
+
+    // 常量条件直接跳转
+    if (auto constVal = dynamic_cast<ConstantInt*>(condVal)) {
+        builder->create_br(constVal->get_value() ? thenTarget : elseTarget);
+        return;
+    }
+    if (condVal->get_type()->is_float_type()) {
+        condVal = builder->create_fcmp_ne(condVal, ConstantFP::get(0.0f, module));
+    }
+    builder->create_cond_br(ensureInt1(condVal), thenTarget, elseTarget);
+}
+
+UnaryExpNode* IRGenerator::soleUnaryExp(EqExpNode* node) {
+    if (node->left || node->right->left) return nullptr;
+    AddExpNode* add = node->right->right;
+    if (add->left || add->right->left) return nullptr;
+    return stripParens(add->right->right);
+}
+
+UnaryExpNode* IRGenerator::stripParens(UnaryExpNode* node) {
+    while (node->unaryType == UnaryExpNode::UnaryType::PRIMARY &&
+           node->primaryExp->primaryType == PrimaryExpNode::PrimaryType::PAREN_EXP) {
+        auto add = dynamic_cast<AddExpNode*>(node->primaryExp->exp);
+        if (!add || add->left || add->right->left) break;
+        node = add->right->right;
+    }
+    return node;
+}
+
+Value* IRGenerator::visitLVal(LValNode* node, bool load) {
+    SymbolInfo* info = lookupSymbol(node->ident);
     if (!info) {
-        std::cerr << "Error: 未定义的变量 " << node->ident << std::endl;
+        error() << "未定义的变量 " << node->ident << std::endl;
         return nullptr;
     }
 
@@ -584,7 +937,7 @@ Value* IRGenerator::visitLVal(std::shared_ptr<LValNode> node, bool load) {
     }
 }
 
-Value* IRGenerator::visitNumber(std::shared_ptr<NumberNode> node) {
+Value* IRGenerator::visitNumber(NumberNode* node) {
     if (node->isFloat) {
         return ConstantFP::get(node->floatVal, module);
     } else {
@@ -592,7 +945,7 @@ Value* IRGenerator::visitNumber(std::shared_ptr<NumberNode> node) {
     }
 }
 
-Value* IRGenerator::visitPrimaryExp(std::shared_ptr<PrimaryExpNode> node) {
+Value* IRGenerator::visitPrimaryExp(PrimaryExpNode* node) {
     switch (node->primaryType) {
         case PrimaryExpNode::PrimaryType::PAREN_EXP:
             return visitExp(node->exp);
@@ -605,16 +958,17 @@ Value* IRGenerator::visitPrimaryExp(std::shared_ptr<PrimaryExpNode> node) {
     }
 }
 
-Value* IRGenerator::visitUnaryExp(std::shared_ptr<UnaryExpNode> node) {
+Value* IRGenerator::visitUnaryExp(UnaryExpNode* node) {
     switch (node->unaryType) {
         case UnaryExpNode::UnaryType::PRIMARY:
             return visitPrimaryExp(node->primaryExp);
 
         case UnaryExpNode::UnaryType::FUNC_CALL: {
             // 查找函数
-            Value* funcVal = symbolTable.getValue(node->funcName);
+            SymbolInfo* funcInfo = lookupSymbol(node->funcName);
+            Value* funcVal = funcInfo ? funcInfo->value : nullptr;
             if (!funcVal) {
-                std::cerr << "Error: 未定义的函数 " << node->funcName << std::endl;
+                error() << "未定义的函数 " << node->funcName << std::endl;
                 return nullptr;
             }
 
@@ -653,7 +1007,7 @@ Value* IRGenerator::visitUnaryExp(std::shared_ptr<UnaryExpNode> node) {
     return nullptr;
 }
 
-Value* IRGenerator::visitMulExp(std::shared_ptr<MulExpNode> node) {
+Value* IRGenerator::visitMulExp(MulExpNode* node) {
     if (!node->left) {
         // 只有右操作数（unaryExp）
         return visitUnaryExp(node->right);
@@ -687,7 +1041,7 @@ Value* IRGenerator::visitMulExp(std::shared_ptr<MulExpNode> node) {
     }
 }
 
-Value* IRGenerator::visitAddExp(std::shared_ptr<AddExpNode> node) {
+Value* IRGenerator::visitAddExp(AddExpNode* node) {
     if (!node->left) {
         // 只有右操作数（mulExp）
         return visitMulExp(node->right);
@@ -718,7 +1072,7 @@ Value* IRGenerator::visitAddExp(std::shared_ptr<AddExpNode> node) {
     }
 }
 
-Value* IRGenerator::visitRelExp(std::shared_ptr<RelExpNode> node) {
+Value* IRGenerator::visitRelExp(RelExpNode* node) {
     if (!node->left) {
         // 只有右操作数（addExp）
         Value* val = visitAddExp(node->right);
@@ -757,7 +1111,7 @@ Value* IRGenerator::visitRelExp(std::shared_ptr<RelExpNode> node) {
     }
 }
 
-Value* IRGenerator::visitEqExp(std::shared_ptr<EqExpNode> node) {
+Value* IRGenerator::visitEqExp(EqExpNode* node) {
     if (!node->left) {
         // 只有右操作数（relExp）
         return visitRelExp(node->right);
@@ -790,7 +1144,7 @@ Value* IRGenerator::visitEqExp(std::shared_ptr<EqExpNode> node) {
     }
 }
 
-Value* IRGenerator::visitLAndExp(std::shared_ptr<LAndExpNode> node) {
+Value* IRGenerator::visitLAndExp(LAndExpNode* node) {
     if (!node->left) {
         // 只有右操作数（eqExp）
         return visitEqExp(node->right);
@@ -830,7 +1184,7 @@ Value* IRGenerator::visitLAndExp(std::shared_ptr<LAndExpNode> node) {
     return phi;
 }
 
-Value* IRGenerator::visitLOrExp(std::shared_ptr<LOrExpNode> node) {
+Value* IRGenerator::visitLOrExp(LOrExpNode* node) {
     if (!node->left) {
         // 只有右操作数（lAndExp）
         return visitLAndExp(node->right);
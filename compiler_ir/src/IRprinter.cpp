@@ -7,6 +7,8 @@
 
 #include "IRprinter.h"
 
+#include <sstream>
+
 /*!
  *@brief 打印operands的名称
  *@return 字符串
@@ -21,23 +23,36 @@
  *&emsp; 返回字符串
  */
 std::string print_as_op(Value *v, bool print_ty) {
-    std::string op_ir;
+    std::ostringstream os;
+    print_as_op(os, v, print_ty);
+    return os.str();
+}
+
+/*!
+ *@brief 打印operands的名称，直接写入输出流
+ *@param os 输出流
+ *@note
+ *---------
+ *规则同 print_as_op(Value *, bool)，不构造临时字符串
+ */
+void print_as_op(std::ostream &os, Value *v, bool print_ty) {
     if (print_ty) {
-        op_ir += v->get_type()->print();
-        op_ir += " ";
+        v->get_type()->print(os);
+        os << " ";
     }
 
     if (dynamic_cast<GlobalVariable *>(v)) {
-        op_ir += "@" + v->get_name();
+        os << "@";
+        v->print_name(os);
     } else if (dynamic_cast<Function *>(v)) {
-        op_ir += "@" + v->get_name();
+        os << "@";
+        v->print_name(os);
     } else if (dynamic_cast<Constant *>(v)) {
-        op_ir += v->print();
+        v->print(os);
     } else {
-        op_ir += "%" + v->get_name();
+        os << "%";
+        v->print_name(os);
     }
-
-    return op_ir;
 }
 
 /*!
@@ -47,7 +62,7 @@ std::string print_as_op(Value *v, bool print_ty) {
  *---------
  *
  */
-std::string print_cmp_type(CmpInst::CmpOp op) {
+const char *print_cmp_type(CmpInst::CmpOp op) {
     switch (op) {
         case CmpInst::GE:
             return "sge";
@@ -66,3 +81,30 @@ std::string print_cmp_type(CmpInst::CmpOp op) {
     }
     return "wrong cmpop";
 }
+
+/*!
+ *@brief 打印浮点比较的谓词名称
+ *@return 字符串
+ *@note
+ *---------
+ *ne 用无序的 une，其余用有序比较，与 C 中浮点比较的语义一致
+ */
+const char *print_fcmp_type(CmpInst::CmpOp op) {
+    switch (op) {
+        case CmpInst::GE:
+            return "oge";
+        case CmpInst::GT:
+            return "ogt";
+        case CmpInst::LE:
+            return "ole";
+        case CmpInst::LT:
+            return "olt";
+        case CmpInst::EQ:
+            return "oeq";
+        case CmpInst::NE:
+            return "une";
+        default:
+            break;
+    }
+    return "wrong cmpop";
+}
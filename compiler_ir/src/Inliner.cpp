@@ -0,0 +1,77 @@
+/*!
+ * @file Inliner.cpp
+ * @brief 小函数内联实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "Inliner.h"
+#include "BasicBlock.h"
+#include "Cloning.h"
+#include "Constant.h"
+#include "Function.h"
+#include "Instruction.h"
+#include "Module.h"
+#include "Stats.h"
+
+#include <vector>
+
+namespace {
+
+int function_size(Function *f) {
+    int size = 0;
+    for (auto bb: f->get_basic_blocks()) {
+        for (auto instr: bb->get_instructions()) {
+            if (!instr->is_phi() && !instr->is_alloca()) size++;
+        }
+    }
+    return size;
+}
+
+bool calls_itself(Function *f) {
+    for (auto bb: f->get_basic_blocks()) {
+        for (auto instr: bb->get_instructions()) {
+            if (instr->is_call() && instr->get_operand(0) == f) return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+bool Inliner::run(Module *m, AnalysisManager &am) {
+    int inlined = 0;
+    for (auto caller: m->get_functions()) {
+        if (caller->is_declaration()) continue;
+        // 只处理原有的调用点，副本中的调用在被调函数中已经处理过
+        std::vector<CallInst *> calls;
+        for (auto bb: caller->get_basic_blocks()) {
+            for (auto instr: bb->get_instructions()) {
+                if (instr->is_call()) calls.push_back(static_cast<CallInst *>(instr));
+            }
+        }
+        int caller_size = function_size(caller);
+        bool changed = false;
+        for (auto call: calls) {
+            auto callee = static_cast<Function *>(call->get_operand(0));
+            // 缓存命中的函数只有在 -O2 时被补生成函数体（IRGenerator::lowerCachedCallees），否则与声明一样不能内联
+            if (callee == caller || callee->is_declaration() ||
+                !callee->get_entry_block()->get_pre_basic_blocks().empty() || calls_itself(callee)) {
+                continue;
+            }
+            int size = function_size(callee);
+            int cost = size;
+            for (unsigned i = 1; i < call->get_num_operand(); i++) {
+                if (dynamic_cast<Constant *>(call->get_operand(i))) cost -= kConstArgBonus;
+            }
+            if (cost > kThreshold || caller_size + size > kMaxCallerSize) continue;
+            inline_call(call);
+            caller_size += size;
+            inlined++;
+            changed = true;
+        }
+        if (changed) am.invalidate(caller);
+    }
+    Stats::count("calls inlined", inlined);
+    return inlined > 0;
+}
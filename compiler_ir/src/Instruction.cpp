@@ -8,11 +8,13 @@
 #include "Type.h"
 #include "Module.h"
 #include "Function.h"
+#include "IRArena.h"
 #include "BasicBlock.h"
 #include "Instruction.h"
 #include "Constant.h"
 #include "IRprinter.h"
 #include <cassert>
+#include <cstdint>
 #include <vector>
 #include <algorithm>
 
@@ -27,6 +29,14 @@ Instruction::Instruction(Type *ty, OpID id, unsigned num_ops)
 
 }
 
+void *Instruction::operator new(std::size_t size, Module *m) {
+    return m->get_arena().allocate(IRArena::Instructions, size);
+}
+
+void Instruction::operator delete(void *p, Module *m) {
+    m->get_arena().forget(IRArena::Instructions, p);
+}
+
 Function *Instruction::get_function() {
     return parent_->get_parent();
 }
@@ -55,39 +65,39 @@ void BinaryInst::assertValid() {
 }
 
 BinaryInst *BinaryInst::create_add(Value *v1, Value *v2, BasicBlock *bb, Module *m) {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::add, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::add, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_sub(Value *v1, Value *v2, BasicBlock *bb, Module *m) {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::sub, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::sub, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_mul(Value *v1, Value *v2, BasicBlock *bb, Module *m) {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::mul, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::mul, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_sdiv(Value *v1, Value *v2, BasicBlock *bb, Module *m) {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::sdiv, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::sdiv, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_mod(Value *v1, Value *v2, BasicBlock *bb, Module *m) {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::mod, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::mod, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fadd(Value *v1, Value *v2, BasicBlock *bb, Module *m) {
-    return new BinaryInst(Type::get_float_type(m), Instruction::fadd, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::fadd, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fsub(Value *v1, Value *v2, BasicBlock *bb, Module *m) {
-    return new BinaryInst(Type::get_float_type(m), Instruction::fsub, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::fsub, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fmul(Value *v1, Value *v2, BasicBlock *bb, Module *m) {
-    return new BinaryInst(Type::get_float_type(m), Instruction::fmul, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::fmul, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fdiv(Value *v1, Value *v2, BasicBlock *bb, Module *m) {
-    return new BinaryInst(Type::get_float_type(m), Instruction::fdiv, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::fdiv, v1, v2, bb);
 }
 
 bool BinaryInst::isStaticCalculable() {
@@ -96,41 +106,43 @@ bool BinaryInst::isStaticCalculable() {
     return cl != nullptr && cr != nullptr;
 }
 
-std::string BinaryInst::print() {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_instr_op_name();
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += ", ";
+void BinaryInst::print(std::ostream &os) {
+    os << "%";
+    this->print_name(os);
+    os << " = ";
+    os << this->get_instr_op_name();
+    os << " ";
+    this->get_operand(0)->get_type()->print(os);
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << ", ";
     if (Type::is_eq_type(this->get_operand(0)->get_type(), this->get_operand(1)->get_type())) {
-        instr_ir += print_as_op(this->get_operand(1), false);
+        print_as_op(os, this->get_operand(1), false);
     } else {
-        instr_ir += print_as_op(this->get_operand(1), true);
+        print_as_op(os, this->get_operand(1), true);
     }
-    return instr_ir;
 }
 
 int BinaryInst::calculate() {
     assert(isStaticCalculable() && "Only static op can be calculated");
     auto cl = dynamic_cast<ConstantInt *>(get_operand(0))->get_value();
     auto cr = dynamic_cast<ConstantInt *>(get_operand(1))->get_value();
+    // 按 i32 补码回绕，与运行时结果一致，避免宿主上的有符号溢出
+    auto ul = static_cast<uint32_t>(cl);
+    auto ur = static_cast<uint32_t>(cr);
     switch (get_instr_type()) {
         case add:
-            return cl + cr;
+            return static_cast<int>(ul + ur);
         case sub:
-            return cl - cr;
+            return static_cast<int>(ul - ur);
         case mul:
-            return cl * cr;
+            return static_cast<int>(ul * ur);
         case sdiv:
             if (cr == 0) return 0;
+            if (cr == -1) return static_cast<int>(0u - ul);
             return cl / cr;
         case mod:
-            if (cr == 0) return 0;
+            if (cr == 0 || cr == -1) return 0;
             return cl % cr;
         default:
             return 0;
@@ -179,33 +191,31 @@ void CmpInst::assertValid() {
 
 CmpInst *CmpInst::create_cmp(CmpOp op, Value *lhs, Value *rhs,
                              BasicBlock *bb, Module *m) {
-    return new CmpInst(m->get_int1_type(), op, lhs, rhs, bb);
+    return new (m) CmpInst(m->get_int1_type(), op, lhs, rhs, bb);
 }
 
 CmpInst *CmpInst::create_fcmp(CmpOp op, Value *lhs, Value *rhs,
                               BasicBlock *bb, Module *m) {
-    return new CmpInst(m->get_int1_type(), op, lhs, rhs, bb);
-}
-
-std::string CmpInst::print() {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_operand(0)->get_type()->is_float_type() ? "fcmp" : "icmp";
-    instr_ir += " ";
-    instr_ir += print_cmp_type(this->cmp_op_);
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += ", ";
+    return new (m) CmpInst(m->get_int1_type(), op, lhs, rhs, bb);
+}
+
+void CmpInst::print(std::ostream &os) {
+    os << "%";
+    this->print_name(os);
+    os << " = ";
+    bool is_float = this->get_operand(0)->get_type()->is_float_type();
+    os << (is_float ? "fcmp " : "icmp ");
+    os << (is_float ? print_fcmp_type(this->cmp_op_) : print_cmp_type(this->cmp_op_));
+    os << " ";
+    this->get_operand(0)->get_type()->print(os);
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << ", ";
     if (Type::is_eq_type(this->get_operand(0)->get_type(), this->get_operand(1)->get_type())) {
-        instr_ir += print_as_op(this->get_operand(1), false);
+        print_as_op(os, this->get_operand(1), false);
     } else {
-        instr_ir += print_as_op(this->get_operand(1), true);
+        print_as_op(os, this->get_operand(1), true);
     }
-    return instr_ir;
 }
 
 bool CmpInst::isStaticCalculable() {
@@ -247,37 +257,35 @@ CallInst::CallInst(Function *func, std::vector<Value *> args, BasicBlock *bb)
 }
 
 CallInst *CallInst::create(Function *func, std::vector<Value *> args, BasicBlock *bb) {
-    return new CallInst(func, args, bb);
+    return new (bb->get_module()) CallInst(func, args, bb);
 }
 
 FunctionType *CallInst::get_function_type() const {
     return static_cast<FunctionType *>(get_operand(0)->get_type());
 }
 
-std::string CallInst::print() {
-    std::string instr_ir;
+void CallInst::print(std::ostream &os) {
     if (!this->is_void()) {
-        instr_ir += "%";
-        instr_ir += this->get_name();
-        instr_ir += " = ";
+        os << "%";
+        this->print_name(os);
+        os << " = ";
     }
-    instr_ir += this->get_module()->get_instr_op_name(this->get_instr_type());
-    instr_ir += " ";
-    instr_ir += this->get_function_type()->get_return_type()->print();
+    os << this->get_module()->get_instr_op_name(this->get_instr_type());
+    os << " ";
+    this->get_function_type()->get_return_type()->print(os);
 
-    instr_ir += " ";
+    os << " ";
     assert(dynamic_cast<Function *>(this->get_operand(0)) && "Wrong call operand function");
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += "(";
+    print_as_op(os, this->get_operand(0), false);
+    os << "(";
     for (int i = 1; i < (int) this->get_num_operand(); i++) {
         if (i > 1)
-            instr_ir += ", ";
-        instr_ir += this->get_operand(i)->get_type()->print();
-        instr_ir += " ";
-        instr_ir += print_as_op(this->get_operand(i), false);
+            os << ", ";
+        this->get_operand(i)->get_type()->print(os);
+        os << " ";
+        print_as_op(os, this->get_operand(i), false);
     }
-    instr_ir += ")";
-    return instr_ir;
+    os << ")";
 }
 
 BranchInst::BranchInst(Value *cond, BasicBlock *if_true, BasicBlock *if_false,
@@ -299,32 +307,30 @@ BranchInst *BranchInst::create_cond_br(Value *cond, BasicBlock *if_true, BasicBl
     if_false->add_pre_basic_block(bb);
     bb->add_succ_basic_block(if_false);
     bb->add_succ_basic_block(if_true);
-    return new BranchInst(cond, if_true, if_false, bb);
+    return new (bb->get_module()) BranchInst(cond, if_true, if_false, bb);
 }
 
 BranchInst *BranchInst::create_br(BasicBlock *if_true, BasicBlock *bb) {
     if_true->add_pre_basic_block(bb);
     bb->add_succ_basic_block(if_true);
-    return new BranchInst(if_true, bb);
+    return new (bb->get_module()) BranchInst(if_true, bb);
 }
 
 bool BranchInst::is_cond_br() const {
     return (int) get_num_operand() == 3;
 }
 
-std::string BranchInst::print() {
-    std::string instr_ir;
-    instr_ir += this->get_module()->get_instr_op_name(this->get_instr_type());
-    instr_ir += " ";
+void BranchInst::print(std::ostream &os) {
+    os << this->get_module()->get_instr_op_name(this->get_instr_type());
+    os << " ";
     // instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += print_as_op(this->get_operand(0), true);
+    print_as_op(os, this->get_operand(0), true);
     if (is_cond_br()) {
-        instr_ir += ", ";
-        instr_ir += print_as_op(this->get_operand(1), true);
-        instr_ir += ", ";
-        instr_ir += print_as_op(this->get_operand(2), true);
+        os << ", ";
+        print_as_op(os, this->get_operand(1), true);
+        os << ", ";
+        print_as_op(os, this->get_operand(2), true);
     }
-    return instr_ir;
 }
 
 ReturnInst::ReturnInst(Value *val, BasicBlock *bb)
@@ -338,30 +344,28 @@ ReturnInst::ReturnInst(BasicBlock *bb)
 }
 
 ReturnInst *ReturnInst::create_ret(Value *val, BasicBlock *bb) {
-    return new ReturnInst(val, bb);
+    return new (bb->get_module()) ReturnInst(val, bb);
 }
 
 ReturnInst *ReturnInst::create_void_ret(BasicBlock *bb) {
-    return new ReturnInst(bb);
+    return new (bb->get_module()) ReturnInst(bb);
 }
 
 bool ReturnInst::is_void_ret() const {
     return (int) get_num_operand() == 0;
 }
 
-std::string ReturnInst::print() {
-    std::string instr_ir;
-    instr_ir += this->get_module()->get_instr_op_name(this->get_instr_type());
-    instr_ir += " ";
+void ReturnInst::print(std::ostream &os) {
+    os << this->get_module()->get_instr_op_name(this->get_instr_type());
+    os << " ";
     if (!is_void_ret()) {
-        instr_ir += this->get_operand(0)->get_type()->print();
-        instr_ir += " ";
-        instr_ir += print_as_op(this->get_operand(0), false);
+        this->get_operand(0)->get_type()->print(os);
+        os << " ";
+        print_as_op(os, this->get_operand(0), false);
     } else {
-        instr_ir += "void";
+        os << "void";
     }
 
-    return instr_ir;
 }
 
 GetElementPtrInst::GetElementPtrInst(Value *ptr, std::vector<Value *> idxs, BasicBlock *bb)
@@ -399,27 +403,25 @@ Type *GetElementPtrInst::get_element_type() const {
 }
 
 GetElementPtrInst *GetElementPtrInst::create_gep(Value *ptr, std::vector<Value *> idxs, BasicBlock *bb) {
-    return new GetElementPtrInst(ptr, idxs, bb);
+    return new (bb->get_module()) GetElementPtrInst(ptr, idxs, bb);
 }
 
-std::string GetElementPtrInst::print() {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_module()->get_instr_op_name(this->get_instr_type());
-    instr_ir += " ";
+void GetElementPtrInst::print(std::ostream &os) {
+    os << "%";
+    this->print_name(os);
+    os << " = ";
+    os << this->get_module()->get_instr_op_name(this->get_instr_type());
+    os << " ";
     assert(this->get_operand(0)->get_type()->is_pointer_type());
-    instr_ir += this->get_operand(0)->get_type()->get_pointer_element_type()->print();
-    instr_ir += ", ";
+    this->get_operand(0)->get_type()->get_pointer_element_type()->print(os);
+    os << ", ";
     for (int i = 0; i < (int) this->get_num_operand(); i++) {
         if (i > 0)
-            instr_ir += ", ";
-        instr_ir += this->get_operand(i)->get_type()->print();
-        instr_ir += " ";
-        instr_ir += print_as_op(this->get_operand(i), false);
+            os << ", ";
+        this->get_operand(i)->get_type()->print(os);
+        os << " ";
+        print_as_op(os, this->get_operand(i), false);
     }
-    return instr_ir;
 }
 
 StoreInst::StoreInst(Value *val, Value *ptr, BasicBlock *bb)
@@ -429,20 +431,18 @@ StoreInst::StoreInst(Value *val, Value *ptr, BasicBlock *bb)
 }
 
 StoreInst *StoreInst::create_store(Value *val, Value *ptr, BasicBlock *bb) {
-    return new StoreInst(val, ptr, bb);
+    return new (bb->get_module()) StoreInst(val, ptr, bb);
 }
 
-std::string StoreInst::print() {
+void StoreInst::print(std::ostream &os) {
     // store i32 3, i32* %ptr
-    std::string instr_ir;
-    instr_ir += this->get_module()->get_instr_op_name(this->get_instr_type());
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += ", ";
-    instr_ir += print_as_op(this->get_operand(1), true);
-    return instr_ir;
+    os << this->get_module()->get_instr_op_name(this->get_instr_type());
+    os << " ";
+    this->get_operand(0)->get_type()->print(os);
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << ", ";
+    print_as_op(os, this->get_operand(1), true);
 }
 
 LoadInst::LoadInst(Type *ty, Value *ptr, BasicBlock *bb)
@@ -453,27 +453,25 @@ LoadInst::LoadInst(Type *ty, Value *ptr, BasicBlock *bb)
 }
 
 LoadInst *LoadInst::create_load(Type *ty, Value *ptr, BasicBlock *bb) {
-    return new LoadInst(ty, ptr, bb);
+    return new (bb->get_module()) LoadInst(ty, ptr, bb);
 }
 
 Type *LoadInst::get_load_type() const {
     return static_cast<PointerType *>(get_operand(0)->get_type())->get_element_type();
 }
 
-std::string LoadInst::print() {
+void LoadInst::print(std::ostream &os) {
     // %val = load i32* %ptr
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_module()->get_instr_op_name(this->get_instr_type());
-    instr_ir += " ";
+    os << "%";
+    this->print_name(os);
+    os << " = ";
+    os << this->get_module()->get_instr_op_name(this->get_instr_type());
+    os << " ";
     assert(this->get_operand(0)->get_type()->is_pointer_type());
-    instr_ir += this->get_operand(0)->get_type()->get_pointer_element_type()->print();
-    instr_ir += ",";
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), true);
-    return instr_ir;
+    this->get_operand(0)->get_type()->get_pointer_element_type()->print(os);
+    os << ",";
+    os << " ";
+    print_as_op(os, this->get_operand(0), true);
 }
 
 AllocaInst::AllocaInst(Type *ty, BasicBlock *bb)
@@ -482,23 +480,21 @@ AllocaInst::AllocaInst(Type *ty, BasicBlock *bb)
 }
 
 AllocaInst *AllocaInst::create_alloca(Type *ty, BasicBlock *bb) {
-    return new AllocaInst(ty, bb);
+    return new (bb->get_module()) AllocaInst(ty, bb);
 }
 
 Type *AllocaInst::get_alloca_type() const {
     return alloca_ty_;
 }
 
-std::string AllocaInst::print() {
+void AllocaInst::print(std::ostream &os) {
     // %ptr = alloca i32
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_module()->get_instr_op_name(this->get_instr_type());
-    instr_ir += " ";
-    instr_ir += get_alloca_type()->print();
-    return instr_ir;
+    os << "%";
+    this->print_name(os);
+    os << " = ";
+    os << this->get_module()->get_instr_op_name(this->get_instr_type());
+    os << " ";
+    get_alloca_type()->print(os);
 }
 
 ZextInst::ZextInst(OpID op, Value *val, Type *ty, BasicBlock *bb)
@@ -507,26 +503,24 @@ ZextInst::ZextInst(OpID op, Value *val, Type *ty, BasicBlock *bb)
 }
 
 ZextInst *ZextInst::create_zext(Value *val, Type *ty, BasicBlock *bb) {
-    return new ZextInst(Instruction::zext, val, ty, bb);
+    return new (bb->get_module()) ZextInst(Instruction::zext, val, ty, bb);
 }
 
 Type *ZextInst::get_dest_type() const {
     return dest_ty_;
 }
 
-std::string ZextInst::print() {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_module()->get_instr_op_name(this->get_instr_type());
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += " to ";
-    instr_ir += this->get_dest_type()->print();
-    return instr_ir;
+void ZextInst::print(std::ostream &os) {
+    os << "%";
+    this->print_name(os);
+    os << " = ";
+    os << this->get_module()->get_instr_op_name(this->get_instr_type());
+    os << " ";
+    this->get_operand(0)->get_type()->print(os);
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << " to ";
+    this->get_dest_type()->print(os);
 }
 
 SiToFpInst::SiToFpInst(OpID op, Value *val, Type *ty, BasicBlock *bb)
@@ -535,24 +529,22 @@ SiToFpInst::SiToFpInst(OpID op, Value *val, Type *ty, BasicBlock *bb)
 }
 
 SiToFpInst *SiToFpInst::create_sitofp(Value *val, Type *ty, BasicBlock *bb) {
-    return new SiToFpInst(Instruction::sitofp, val, ty, bb);
+    return new (bb->get_module()) SiToFpInst(Instruction::sitofp, val, ty, bb);
 }
 
 Type *SiToFpInst::get_dest_type() const { return dest_ty_; }
 
-std::string SiToFpInst::print() {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += "sitofp";
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += " to ";
-    instr_ir += this->get_dest_type()->print();
-    return instr_ir;
+void SiToFpInst::print(std::ostream &os) {
+    os << "%";
+    this->print_name(os);
+    os << " = ";
+    os << "sitofp";
+    os << " ";
+    this->get_operand(0)->get_type()->print(os);
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << " to ";
+    this->get_dest_type()->print(os);
 }
 
 FpToSiInst::FpToSiInst(OpID op, Value *val, Type *ty, BasicBlock *bb)
@@ -561,24 +553,22 @@ FpToSiInst::FpToSiInst(OpID op, Value *val, Type *ty, BasicBlock *bb)
 }
 
 FpToSiInst *FpToSiInst::create_fptosi(Value *val, Type *ty, BasicBlock *bb) {
-    return new FpToSiInst(Instruction::fptosi, val, ty, bb);
+    return new (bb->get_module()) FpToSiInst(Instruction::fptosi, val, ty, bb);
 }
 
 Type *FpToSiInst::get_dest_type() const { return dest_ty_; }
 
-std::string FpToSiInst::print() {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += "fptosi";
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += " to ";
-    instr_ir += this->get_dest_type()->print();
-    return instr_ir;
+void FpToSiInst::print(std::ostream &os) {
+    os << "%";
+    this->print_name(os);
+    os << " = ";
+    os << "fptosi";
+    os << " ";
+    this->get_operand(0)->get_type()->print(os);
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << " to ";
+    this->get_dest_type()->print(os);
 }
 
 PhiInst::PhiInst(OpID op, std::vector<Value *> vals, std::vector<BasicBlock *> val_bbs, Type *ty, BasicBlock *bb)
@@ -597,37 +587,37 @@ PhiInst::PhiInst(OpID op, std::vector<Value *> vals, std::vector<BasicBlock *> v
 PhiInst *PhiInst::create_phi(Type *ty, BasicBlock *bb) {
     std::vector < Value * > vals;
     std::vector < BasicBlock * > val_bbs;
-    return new PhiInst(Instruction::phi, vals, val_bbs, ty, bb);
+    return new (bb->get_module()) PhiInst(Instruction::phi, vals, val_bbs, ty, bb);
 }
 
-std::string PhiInst::print() {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_module()->get_instr_op_name(this->get_instr_type());
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
+void PhiInst::print(std::ostream &os) {
+    os << "%";
+    this->print_name(os);
+    os << " = ";
+    os << this->get_module()->get_instr_op_name(this->get_instr_type());
+    os << " ";
+    this->get_operand(0)->get_type()->print(os);
+    os << " ";
     for (int i = 0; i < (int) this->get_num_operand() / 2; i++) {
         if (i > 0)
-            instr_ir += ", ";
-        instr_ir += "[ ";
-        instr_ir += print_as_op(this->get_operand(2 * i), false);
-        instr_ir += ", ";
-        instr_ir += print_as_op(this->get_operand(2 * i + 1), false);
-        instr_ir += " ]";
+            os << ", ";
+        os << "[ ";
+        print_as_op(os, this->get_operand(2 * i), false);
+        os << ", ";
+        print_as_op(os, this->get_operand(2 * i + 1), false);
+        os << " ]";
     }
     if ((int) this->get_num_operand() / 2 < (int) (this->get_parent()->get_pre_basic_blocks().size())) {
         for (auto pre_bb: this->get_parent()->get_pre_basic_blocks()) {
             if (std::find(this->get_operands().begin(), this->get_operands().end(), static_cast<Value *>(pre_bb)) ==
                 this->get_operands().end()) {
                 // find a pre_bb is not in phi
-                instr_ir += ", [ undef, " + print_as_op(pre_bb, false) + " ]";
+                os << ", [ undef, ";
+                print_as_op(os, pre_bb, false);
+                os << " ]";
             }
         }
     }
-    return instr_ir;
 }
 
 std::list <std::pair<Value *, BasicBlock *>> PhiInst::getValueBBPair() {
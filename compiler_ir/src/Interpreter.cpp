@@ -0,0 +1,648 @@
+/*!
+ * @file Interpreter.cpp
+ * @brief 中间代码解释器实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "Interpreter.h"
+#include "BasicBlock.h"
+#include "Constant.h"
+#include "Function.h"
+#include "GlobalVariable.h"
+#include "Instruction.h"
+#include "Module.h"
+#include "Stats.h"
+#include "Type.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+/// 字节码操作码；a 为结果槽（store 为被写的值），b、c 为操作数槽
+enum Op : uint8_t {
+    MOV,
+    ADD, SUB, MUL, SDIV, SREM,
+    FADD, FSUB, FMUL, FDIV,
+    IEQ, INE, IGT, IGE, ILT, ILE,
+    FEQ, FNE, FGT, FGE, FLT, FLE,
+    SITOFP, FPTOSI,
+    LOAD4, LOAD8, STORE4, STORE8,
+    GEP,       ///< a = b + side[c] + Σ 槽 side[c+1+2k] * 步长 side[c+2+2k]，共 d 项
+    ALLOCA,    ///< a = 帧基址 + b
+    BR,        ///< 跳到 a
+    CONDBR,    ///< a 非零跳到 b，否则跳到 c
+    CALL,      ///< 调用函数 b，实参槽为 side[c..c+d)，结果写入 a（a < 0 为无返回值）
+    NATIVE,    ///< 调用库函数 b，其余同 CALL
+    RET,
+    RETVOID,
+    kNumOps
+};
+
+enum Native { GETINT, GETCH, GETARRAY, PUTINT, PUTCH, PUTARRAY, NOP, kNotNative };
+
+Native native_of(const std::string &name) {
+    if (name == "getint") return GETINT;
+    if (name == "getch") return GETCH;
+    if (name == "getarray") return GETARRAY;
+    if (name == "putint") return PUTINT;
+    if (name == "putch") return PUTCH;
+    if (name == "putarray") return PUTARRAY;
+    if (name == "starttime" || name == "stoptime") return NOP;
+    return kNotNative;
+}
+
+/// 寄存器槽栈的初始与最大大小，以及 alloca 栈的大小（与常见的 8MB 原生栈相同），超出时报栈溢出
+const size_t kRegStackSlots = 1 << 20;
+const size_t kMaxRegStackSlots = 1 << 25;
+const size_t kMemStackBytes = 8 << 20;
+
+int size_of(Type *ty) {
+    if (ty->is_array_type()) {
+        auto arr = static_cast<ArrayType *>(ty);
+        return static_cast<int>(arr->get_num_of_elements()) * size_of(arr->get_element_type());
+    }
+    return ty->is_pointer_type() ? 8 : 4;
+}
+
+int round_up(int value, int align) { return (value + align - 1) / align * align; }
+
+void write_init(Constant *init, Type *ty, char *dst) {
+    if (auto ci = dynamic_cast<ConstantInt *>(init)) {
+        int32_t v = ci->get_value();
+        std::memcpy(dst, &v, 4);
+    } else if (auto cf = dynamic_cast<ConstantFP *>(init)) {
+        float v = cf->get_value();
+        std::memcpy(dst, &v, 4);
+    } else if (auto arr = dynamic_cast<ConstantArray *>(init)) {
+        // 标量都占 4 字节，展开的位模式即内存映像
+        std::memcpy(dst, arr->get_raw_data(), arr->get_num_scalars() * 4);
+    }
+    // ConstantZero 与缺省初值：存储已清零
+}
+
+}  // namespace
+
+struct Interpreter::Code {
+    struct Inst {
+        const void *handler = nullptr;   ///< 处理代码地址，首次执行时按计数模式填入
+        Op op;
+        int32_t a = 0, b = 0, c = 0, d = 0;
+        Instruction *origin = nullptr;   ///< 对应的中间代码指令，phi 的复制也记在 phi 上
+    };
+
+    Function *func = nullptr;
+    std::vector<Inst> insts;
+    std::vector<int32_t> side;
+    std::vector<Slot> consts;     ///< 帧开头的常量槽初值
+    int num_regs = 0;
+    int frame_size = 0;
+    int threaded = -1;            ///< handler 对应的模式：0 不计数，1 计数
+    bool lowered = false;         ///< 第一次调用时才翻译
+    std::vector<uint64_t> counts;
+};
+
+Interpreter::Interpreter(Module *m) : module_(m) {
+    Stats::Timer timer("Interpreter::init");
+    // 全局变量放在一块连续存储中，地址在构造后不再变化
+    std::unordered_map<GlobalVariable *, int> offsets;
+    int size = 0;
+    for (auto gv: m->get_global_variable()) {
+        offsets[gv] = size;
+        size = round_up(size + size_of(gv->get_type()->get_pointer_element_type()), 8);
+    }
+    globals_.assign(size, 0);
+    for (auto gv: m->get_global_variable()) {
+        write_init(gv->get_init(), gv->get_type()->get_pointer_element_type(), globals_.data() + offsets[gv]);
+    }
+    global_addr_.reserve(offsets.size());
+    for (auto &[gv, offset]: offsets) global_addr_[gv] = globals_.data() + offset;
+
+    for (auto f: m->get_functions()) {
+        index_[f] = static_cast<int>(code_.size());
+        code_.emplace_back(new Code);
+        code_.back()->func = f;
+    }
+}
+
+Interpreter::~Interpreter() = default;
+
+Interpreter::Code &Interpreter::code_of(int func) {
+    Code &code = *code_[func];
+    if (!code.lowered) {
+        // 从二进制中间代码加载的模块中，没有被调用到的函数体不会被读入
+        code.lowered = true;
+        if (!code.func->is_declaration()) {
+            Stats::Timer timer("Interpreter::lower");
+            lower(code.func, code);
+        }
+    }
+    return code;
+}
+
+void Interpreter::lower(Function *f, Code &code) {
+    std::unordered_map<Value *, int> slots;
+    auto new_slot = [&]() { return code.num_regs++; };
+
+    // 1. 常量与全局变量地址占据帧开头的槽，0 号槽固定为整数 0
+    code.consts.push_back(Slot{0});
+    new_slot();
+    for (auto bb: f->get_basic_blocks()) {
+        for (auto instr: bb->get_instructions()) {
+            for (auto op: instr->get_operands()) {
+                if (op == nullptr || slots.count(op)) continue;
+                Slot s;
+                s.p = nullptr;
+                if (auto ci = dynamic_cast<ConstantInt *>(op)) {
+                    s.i = ci->get_value();
+                } else if (auto cf = dynamic_cast<ConstantFP *>(op)) {
+                    s.f = cf->get_value();
+                } else if (dynamic_cast<ConstantZero *>(op)) {
+                    s.p = nullptr;
+                } else if (auto gv = dynamic_cast<GlobalVariable *>(op)) {
+                    s.p = global_addr_.at(gv);
+                } else {
+                    continue;
+                }
+                slots[op] = new_slot();
+                code.consts.push_back(s);
+            }
+        }
+    }
+
+    // 2. 参数紧随常量，调用者直接写入
+    for (auto arg: f->get_args()) slots[arg] = new_slot();
+
+    // 3. 指令结果；phi 另有一个临时槽，alloca 在帧内分配空间
+    std::unordered_map<Instruction *, int> phi_temps;
+    for (auto bb: f->get_basic_blocks()) {
+        for (auto instr: bb->get_instructions()) {
+            if (!instr->is_void()) slots[instr] = new_slot();
+            if (instr->is_phi()) phi_temps[instr] = new_slot();
+        }
+    }
+
+    auto slot = [&](Value *v) { return slots.at(v); };
+    auto emit = [&](Op op, int a, int b, int c, int d, Instruction *origin) {
+        Code::Inst inst;
+        inst.op = op;
+        inst.a = a;
+        inst.b = b;
+        inst.c = c;
+        inst.d = d;
+        inst.origin = origin;
+        code.insts.push_back(inst);
+    };
+    // 前驱末尾的第一段复制：到达值写入 phi 的临时槽
+    auto phi_copies = [&](BasicBlock *from, BasicBlock *to) {
+        for (auto instr: to->get_instructions()) {
+            if (!instr->is_phi()) break;
+            for (unsigned i = 0; i + 1 < instr->get_num_operand(); i += 2) {
+                if (instr->get_operand(i + 1) != from) continue;
+                emit(MOV, phi_temps.at(instr), slot(instr->get_operand(i)), 0, 0, nullptr);
+                break;
+            }
+        }
+    };
+
+    // 跳转目标在所有块排好后回填：(字节码下标, 字段 a/b/c, 目标块)
+    struct Fixup {
+        size_t inst;
+        int32_t Code::Inst::*field;
+        BasicBlock *target;
+    };
+    std::unordered_map<BasicBlock *, int> block_pc;
+    std::vector<Fixup> fixups;
+    for (auto bb: f->get_basic_blocks()) {
+        block_pc[bb] = static_cast<int>(code.insts.size());
+        for (auto instr: bb->get_instructions()) {
+            if (instr->is_phi()) emit(MOV, slot(instr), phi_temps.at(instr), 0, 0, instr);
+        }
+        for (auto instr: bb->get_instructions()) {
+            int dst = instr->is_void() ? -1 : slot(instr);
+            switch (instr->get_instr_type()) {
+                case Instruction::phi:
+                    break;
+                case Instruction::add:
+                case Instruction::sub:
+                case Instruction::mul:
+                case Instruction::sdiv:
+                case Instruction::mod:
+                case Instruction::fadd:
+                case Instruction::fsub:
+                case Instruction::fmul:
+                case Instruction::fdiv: {
+                    static const Op ops[] = {ADD, SUB, MUL, SDIV, SREM, FADD, FSUB, FMUL, FDIV};
+                    Op op = ops[instr->get_instr_type() - Instruction::add];
+                    emit(op, dst, slot(instr->get_operand(0)), slot(instr->get_operand(1)), 0, instr);
+                    break;
+                }
+                case Instruction::cmp: {
+                    bool fp = instr->get_operand(0)->get_type()->is_float_type();
+                    int cc = static_cast<CmpInst *>(instr)->get_cmp_op() - CmpInst::EQ;
+                    Op op = static_cast<Op>((fp ? FEQ : IEQ) + cc);
+                    emit(op, dst, slot(instr->get_operand(0)), slot(instr->get_operand(1)), 0, instr);
+                    break;
+                }
+                case Instruction::zext:
+                    emit(MOV, dst, slot(instr->get_operand(0)), 0, 0, instr);
+                    break;
+                case Instruction::sitofp:
+                    emit(SITOFP, dst, slot(instr->get_operand(0)), 0, 0, instr);
+                    break;
+                case Instruction::fptosi:
+                    emit(FPTOSI, dst, slot(instr->get_operand(0)), 0, 0, instr);
+                    break;
+                case Instruction::alloca: {
+                    int bytes = size_of(static_cast<AllocaInst *>(instr)->get_alloca_type());
+                    code.frame_size = round_up(code.frame_size, 8);
+                    emit(ALLOCA, dst, code.frame_size, 0, 0, instr);
+                    code.frame_size += bytes;
+                    break;
+                }
+                case Instruction::load: {
+                    Op op = instr->get_type()->is_pointer_type() ? LOAD8 : LOAD4;
+                    emit(op, dst, slot(instr->get_operand(0)), 0, 0, instr);
+                    break;
+                }
+                case Instruction::store: {
+                    Value *val = instr->get_operand(0);
+                    Op op = val->get_type()->is_pointer_type() ? STORE8 : STORE4;
+                    emit(op, slot(val), slot(instr->get_operand(1)), 0, 0, instr);
+                    break;
+                }
+                case Instruction::getelementptr: {
+                    Value *ptr = instr->get_operand(0);
+                    Type *ty = ptr->get_type()->get_pointer_element_type();
+                    int start = static_cast<int>(code.side.size());
+                    code.side.push_back(0);
+                    int pairs = 0;
+                    for (unsigned i = 1; i < instr->get_num_operand(); i++) {
+                        if (i > 1) ty = ty->get_array_element_type();
+                        int stride = size_of(ty);
+                        Value *idx = instr->get_operand(i);
+                        if (auto ci = dynamic_cast<ConstantInt *>(idx)) {
+                            code.side[start] += ci->get_value() * stride;
+                        } else {
+                            code.side.push_back(slot(idx));
+                            code.side.push_back(stride);
+                            pairs++;
+                        }
+                    }
+                    emit(GEP, dst, slot(ptr), start, pairs, instr);
+                    break;
+                }
+                case Instruction::call: {
+                    auto callee = static_cast<Function *>(instr->get_operand(0));
+                    int start = static_cast<int>(code.side.size());
+                    for (unsigned i = 1; i < instr->get_num_operand(); i++) {
+                        code.side.push_back(slot(instr->get_operand(i)));
+                    }
+                    int nargs = static_cast<int>(instr->get_num_operand()) - 1;
+                    Native native = callee->is_declaration() && !callee->has_cached_ir()
+                                    ? native_of(callee->get_name()) : kNotNative;
+                    if (native != kNotNative) {
+                        emit(NATIVE, dst, native, start, nargs, instr);
+                    } else {
+                        emit(CALL, dst, index_.at(callee), start, nargs, instr);
+                    }
+                    break;
+                }
+                case Instruction::br: {
+                    auto br = static_cast<BranchInst *>(instr);
+                    BasicBlock *t = br->getTrueBB();
+                    phi_copies(bb, t);
+                    if (!br->is_cond_br()) {
+                        emit(BR, 0, 0, 0, 0, instr);
+                        fixups.push_back({code.insts.size() - 1, &Code::Inst::a, t});
+                        break;
+                    }
+                    BasicBlock *fb = br->getFalseBB();
+                    if (fb != t) phi_copies(bb, fb);
+                    emit(CONDBR, slot(br->get_condition()), 0, 0, 0, instr);
+                    fixups.push_back({code.insts.size() - 1, &Code::Inst::b, t});
+                    fixups.push_back({code.insts.size() - 1, &Code::Inst::c, fb});
+                    break;
+                }
+                case Instruction::ret:
+                    if (static_cast<ReturnInst *>(instr)->is_void_ret()) {
+                        emit(RETVOID, 0, 0, 0, 0, instr);
+                    } else {
+                        emit(RET, slot(instr->get_operand(0)), 0, 0, 0, instr);
+                    }
+                    break;
+            }
+        }
+        // 没有终结指令的块按打印时的约定返回零值
+        if (bb->get_terminator() == nullptr) {
+            emit(f->get_return_type()->is_void_type() ? RETVOID : RET, 0, 0, 0, 0, nullptr);
+        }
+    }
+    for (auto &fix: fixups) {
+        code.insts[fix.inst].*fix.field = block_pc.at(fix.target);
+    }
+    code.counts.assign(code.insts.size(), 0);
+}
+
+void Interpreter::call_native(int id, Slot *r, const int32_t *args, Slot &ret) {
+    switch (id) {
+        case GETINT:
+            ret.i = 0;
+            *in_ >> ret.i;
+            break;
+        case GETCH:
+            ret.i = in_->get();
+            break;
+        case GETARRAY: {
+            int n = 0;
+            *in_ >> n;
+            auto a = reinterpret_cast<int32_t *>(r[args[0]].p);
+            for (int i = 0; i < n; i++) *in_ >> a[i];
+            ret.i = n;
+            break;
+        }
+        case PUTINT:
+            *out_ << r[args[0]].i;
+            break;
+        case PUTCH:
+            out_->put(static_cast<char>(r[args[0]].i));
+            break;
+        case PUTARRAY: {
+            int n = r[args[0]].i;
+            auto a = reinterpret_cast<int32_t *>(r[args[1]].p);
+            *out_ << n << ":";
+            for (int i = 0; i < n; i++) *out_ << " " << a[i];
+            *out_ << "\n";
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+bool Interpreter::grow_regs(size_t n) {
+    if (n > kMaxRegStackSlots) return false;
+    regs_.resize(std::min(kMaxRegStackSlots, std::max(n, regs_.size() * 2)), Slot{0});
+    return true;
+}
+
+template<bool Profile>
+Interpreter::Slot Interpreter::execute(int func, size_t reg_base, size_t mem_base) {
+    // 与 Op 的顺序一一对应
+    static const void *const labels[kNumOps] = {
+        &&L_MOV,
+        &&L_ADD, &&L_SUB, &&L_MUL, &&L_SDIV, &&L_SREM,
+        &&L_FADD, &&L_FSUB, &&L_FMUL, &&L_FDIV,
+        &&L_IEQ, &&L_INE, &&L_IGT, &&L_IGE, &&L_ILT, &&L_ILE,
+        &&L_FEQ, &&L_FNE, &&L_FGT, &&L_FGE, &&L_FLT, &&L_FLE,
+        &&L_SITOFP, &&L_FPTOSI,
+        &&L_LOAD4, &&L_LOAD8, &&L_STORE4, &&L_STORE8,
+        &&L_GEP, &&L_ALLOCA,
+        &&L_BR, &&L_CONDBR, &&L_CALL, &&L_NATIVE, &&L_RET, &&L_RETVOID};
+
+    // IR 调用不递归执行本函数，调用者的状态压入 frames，返回时弹出
+    struct Frame {
+        Code *code;
+        const Code::Inst *call;   ///< 调用指令，返回后从其下一条继续
+        size_t reg_base;
+        size_t mem_base;
+    };
+    std::vector<Frame> frames(64);
+    size_t depth = 0;
+
+    Code *code = &code_of(func);
+    Slot *r;
+    char *frame;
+    const int32_t *side;
+    const Code::Inst *base;
+    const Code::Inst *ip;
+    uint64_t *counts;
+
+#define DISPATCH()                                  \
+    do {                                            \
+        if (Profile) counts[ip - base]++;           \
+        goto *ip->handler;                          \
+    } while (0)
+#define NEXT()      \
+    do {            \
+        ++ip;       \
+        DISPATCH(); \
+    } while (0)
+#define INT_BINARY(expr)                            \
+    {                                               \
+        uint32_t x = static_cast<uint32_t>(r[ip->b].i); \
+        uint32_t y = static_cast<uint32_t>(r[ip->c].i); \
+        r[ip->a].i = static_cast<int32_t>(expr);    \
+        NEXT();                                     \
+    }
+#define COMPARE(field, op)                                  \
+    {                                                       \
+        r[ip->a].i = r[ip->b].field op r[ip->c].field;      \
+        NEXT();                                             \
+    }
+
+    // 进入 code 的帧：实参已写入常量槽之后的参数槽
+enter:
+    if (code->insts.empty()) {
+        throw std::runtime_error("function @" + code->func->get_name() + " has no body");
+    }
+    if ((reg_base + code->num_regs > regs_.size() && !grow_regs(reg_base + code->num_regs)) ||
+        mem_base + code->frame_size > memory_.size()) {
+        throw std::runtime_error("stack overflow in @" + code->func->get_name());
+    }
+    if (code->threaded != Profile) {
+        for (auto &inst: code->insts) inst.handler = labels[inst.op];
+        code->threaded = Profile;
+    }
+    r = regs_.data() + reg_base;
+    std::copy(code->consts.begin(), code->consts.end(), r);
+    frame = memory_.data() + mem_base;
+    side = code->side.data();
+    base = code->insts.data();
+    ip = base;
+    counts = code->counts.data();
+    DISPATCH();
+
+L_MOV:
+    r[ip->a] = r[ip->b];
+    NEXT();
+L_ADD: INT_BINARY(x + y)
+L_SUB: INT_BINARY(x - y)
+L_MUL: INT_BINARY(x * y)
+L_SDIV:
+L_SREM: {
+    int32_t x = r[ip->b].i;
+    int32_t y = r[ip->c].i;
+    if (y == 0) throw std::runtime_error("division by zero in @" + code->func->get_name());
+    // INT_MIN / -1 在 C++ 中未定义，按补码回绕处理
+    if (ip->op == SDIV) {
+        r[ip->a].i = y == -1 ? static_cast<int32_t>(0u - static_cast<uint32_t>(x)) : x / y;
+    } else {
+        r[ip->a].i = y == -1 ? 0 : x % y;
+    }
+    NEXT();
+}
+L_FADD:
+    r[ip->a].f = r[ip->b].f + r[ip->c].f;
+    NEXT();
+L_FSUB:
+    r[ip->a].f = r[ip->b].f - r[ip->c].f;
+    NEXT();
+L_FMUL:
+    r[ip->a].f = r[ip->b].f * r[ip->c].f;
+    NEXT();
+L_FDIV:
+    r[ip->a].f = r[ip->b].f / r[ip->c].f;
+    NEXT();
+L_IEQ: COMPARE(i, ==)
+L_INE: COMPARE(i, !=)
+L_IGT: COMPARE(i, >)
+L_IGE: COMPARE(i, >=)
+L_ILT: COMPARE(i, <)
+L_ILE: COMPARE(i, <=)
+L_FEQ: COMPARE(f, ==)
+L_FNE: COMPARE(f, !=)
+L_FGT: COMPARE(f, >)
+L_FGE: COMPARE(f, >=)
+L_FLT: COMPARE(f, <)
+L_FLE: COMPARE(f, <=)
+L_SITOFP:
+    r[ip->a].f = static_cast<float>(r[ip->b].i);
+    NEXT();
+L_FPTOSI:
+    r[ip->a].i = static_cast<int32_t>(r[ip->b].f);
+    NEXT();
+L_LOAD4:
+    std::memcpy(&r[ip->a].i, r[ip->b].p, 4);
+    NEXT();
+L_LOAD8:
+    std::memcpy(&r[ip->a].p, r[ip->b].p, 8);
+    NEXT();
+L_STORE4:
+    std::memcpy(r[ip->b].p, &r[ip->a].i, 4);
+    NEXT();
+L_STORE8:
+    std::memcpy(r[ip->b].p, &r[ip->a].p, 8);
+    NEXT();
+L_GEP: {
+    const int32_t *g = side + ip->c;
+    char *p = r[ip->b].p + g[0];
+    for (int k = 0; k < ip->d; k++) {
+        p += static_cast<int64_t>(r[g[1 + 2 * k]].i) * g[2 + 2 * k];
+    }
+    r[ip->a].p = p;
+    NEXT();
+}
+L_ALLOCA:
+    r[ip->a].p = frame + ip->b;
+    NEXT();
+L_BR:
+    ip = base + ip->a;
+    DISPATCH();
+L_CONDBR:
+    ip = base + (r[ip->a].i ? ip->b : ip->c);
+    DISPATCH();
+L_CALL: {
+    Code &callee = code_of(ip->b);
+    size_t callee_base = reg_base + code->num_regs;
+    if (callee_base + callee.consts.size() + ip->d > regs_.size()) {
+        if (!grow_regs(callee_base + callee.consts.size() + ip->d)) {
+            throw std::runtime_error("stack overflow in @" + callee.func->get_name());
+        }
+        r = regs_.data() + reg_base;
+    }
+    // 实参直接写入被调帧中常量槽之后的参数槽
+    Slot *args = regs_.data() + callee_base + callee.consts.size();
+    for (int k = 0; k < ip->d; k++) args[k] = r[side[ip->c + k]];
+    if (depth == frames.size()) frames.resize(depth * 2);
+    frames[depth++] = {code, ip, reg_base, mem_base};
+    reg_base = callee_base;
+    mem_base += code->frame_size;
+    code = &callee;
+    goto enter;
+}
+L_NATIVE: {
+    Slot ret;
+    ret.p = nullptr;
+    call_native(ip->b, r, side + ip->c, ret);
+    if (ip->a >= 0) r[ip->a] = ret;
+    NEXT();
+}
+L_RET:
+L_RETVOID: {
+    Slot ret;
+    ret.p = nullptr;
+    if (ip->op == RET) ret = r[ip->a];
+    if (depth == 0) return ret;
+    // 回到调用者，结果写入调用指令的目的寄存器
+    const Frame &caller = frames[--depth];
+    code = caller.code;
+    reg_base = caller.reg_base;
+    mem_base = caller.mem_base;
+    r = regs_.data() + reg_base;
+    frame = memory_.data() + mem_base;
+    side = code->side.data();
+    base = code->insts.data();
+    counts = code->counts.data();
+    ip = caller.call;
+    if (ip->a >= 0) r[ip->a] = ret;
+    NEXT();
+}
+
+#undef COMPARE
+#undef INT_BINARY
+#undef NEXT
+#undef DISPATCH
+}
+
+int Interpreter::run_main() {
+    Function *main = nullptr;
+    for (auto f: module_->get_functions()) {
+        if (f->get_name() == "main") main = f;
+    }
+    if (main == nullptr) throw std::runtime_error("no main function");
+    regs_.assign(kRegStackSlots, Slot{0});
+    memory_.assign(kMemStackBytes, 0);
+
+    Stats::Timer timer("Interpreter::run");
+    int index = index_.at(main);
+    Slot ret = profiling_ ? execute<true>(index, 0, 0) : execute<false>(index, 0, 0);
+    out_->flush();
+    if (profiling_) Stats::count("interpreted instructions", get_executed());
+    return main->get_return_type()->is_void_type() ? 0 : ret.i;
+}
+
+uint64_t Interpreter::get_executed() const {
+    uint64_t total = 0;
+    for (auto &code: code_) {
+        for (auto n: code->counts) total += n;
+    }
+    return total;
+}
+
+void Interpreter::print_profile(std::ostream &os) const {
+    for (auto &code: code_) {
+        if (code->insts.empty()) continue;
+        std::unordered_map<Instruction *, uint64_t> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < code->insts.size(); i++) {
+            total += code->counts[i];
+            if (code->insts[i].origin) counts[code->insts[i].origin] += code->counts[i];
+        }
+        if (total == 0) continue;
+        os << "; @" << code->func->get_name() << ": " << total << " bytecodes executed\n";
+        for (auto bb: code->func->get_basic_blocks()) {
+            for (auto instr: bb->get_instructions()) {
+                auto it = counts.find(instr);
+                if (it == counts.end() || it->second == 0) continue;
+                os << std::setw(12) << it->second << "  ";
+                instr->print(os);
+                os << "\n";
+            }
+        }
+    }
+}
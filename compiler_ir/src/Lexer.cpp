@@ -130,9 +130,15 @@ bool Lexer::skipComment() {
 
 // ==================== 扫描函数 ====================
 
+Token Lexer::sourceToken(TokenType type, size_t start, size_t length, int startLine, int startCol) const {
+    return Token(type, std::string_view(source).substr(start, length), startLine, startCol,
+                 static_cast<uint32_t>(start));
+}
+
 Token Lexer::scanIdentifier() {
     int startLine = line;
     int startCol = column;
+    size_t start = pos;
     std::string value;
     
     while (isAlnum(currentChar())) {
@@ -144,16 +150,17 @@ Token Lexer::scanIdentifier() {
     std::string lowerValue = toLower(value);
     auto it = keywords.find(lowerValue);
     if (it != keywords.end()) {
-        return Token(it->second, value, startLine, startCol);
+        return sourceToken(it->second, start, pos - start, startLine, startCol);
     }
     
     // main 将返回 IDN 类型，但 Token::toString 会将其格式化为 KW
-    return Token(TokenType::IDN, value, startLine, startCol);
+    return sourceToken(TokenType::IDN, start, pos - start, startLine, startCol);
 }
 
 Token Lexer::scanNumber() {
     int startLine = line;
     int startCol = column;
+    size_t start = pos;
     std::string value;
     bool isFloat = false;
     
@@ -177,9 +184,9 @@ Token Lexer::scanNumber() {
     }
     
     if (isFloat) {
-        return Token(TokenType::FLOAT, value, startLine, startCol);
+        return sourceToken(TokenType::FLOAT, start, pos - start, startLine, startCol);
     } else {
-        return Token(TokenType::INT, value, startLine, startCol);
+        return sourceToken(TokenType::INT, start, pos - start, startLine, startCol);
     }
 }
 
@@ -248,7 +255,7 @@ Token Lexer::scanOperator() {
             }
             return Token(TokenType::ERROR, "|", startLine, startCol);
         default:
-            return Token(TokenType::ERROR, std::string(1, c), startLine, startCol);
+            return sourceToken(TokenType::ERROR, pos, 1, startLine, startCol);
     }
 }
 
@@ -277,7 +284,7 @@ Token Lexer::scanSeparator() {
             advance();
             return Token(TokenType::SE_COMMA, ",", startLine, startCol);
         default:
-            return Token(TokenType::ERROR, std::string(1, c), startLine, startCol);
+            return sourceToken(TokenType::ERROR, pos, 1, startLine, startCol);
     }
 }
 
@@ -322,8 +329,7 @@ bool Lexer::tokenize() {
             // 未知字符 - 创建ERROR token
             int startLine = line;
             int startCol = column;
-            std::string ch(1, c);
-            tokens.push_back(Token(TokenType::ERROR, ch, startLine, startCol));
+            tokens.push_back(sourceToken(TokenType::ERROR, pos, 1, startLine, startCol));
             advance();
         }
     }
@@ -0,0 +1,293 @@
+/*!
+ * @file LinearScan.cpp
+ * @brief 机器指令的线性扫描寄存器分配实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "LinearScan.h"
+#include "Stats.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+/// 分配顺序：调用者保存寄存器在前，用不到时才占用需要保存的寄存器
+const int kGprOrder[] = {RSI, RDI, R8, R9, RCX, RDX, RAX, RBX, R12, R13, R14, R15};
+const int kXmmOrder[] = {XMM0, XMM1, XMM2, XMM3, XMM4, XMM5, XMM6,
+                         XMM7, XMM8, XMM9, XMM10, XMM11, XMM12, XMM13};
+const int kGprScratch[] = {R10, R11};
+const int kXmmScratch[] = {XMM14, XMM15};
+
+bool is_callee_saved(int preg) {
+    return preg == RBX || (preg >= R12 && preg <= R15);
+}
+
+struct Interval {
+    int vreg;
+    int start;
+    int end;
+    int preg = -1;
+};
+
+struct Segment {
+    int start;
+    int end;
+};
+
+using Bits = std::vector<uint64_t>;
+
+bool test(const Bits &b, int i) { return (b[i >> 6] >> (i & 63)) & 1; }
+
+void set(Bits &b, int i) { b[i >> 6] |= uint64_t(1) << (i & 63); }
+
+/// 物理寄存器 preg 在 [start, end] 内是否被固定使用
+bool blocked(const std::vector<Segment> &segs, int start, int end) {
+    auto it = std::lower_bound(segs.begin(), segs.end(), start,
+                               [](const Segment &s, int pos) { return s.end < pos; });
+    return it != segs.end() && it->start <= end;
+}
+
+}  // namespace
+
+int LinearScan::run(MFunction &mf) {
+    const int nb = static_cast<int>(mf.blocks.size());
+    const int nv = static_cast<int>(mf.vreg_class.size());
+    const size_t words = (nv + 63) / 64;
+
+    // 1. 指令编号（偶数），记录每块的首末位置
+    std::vector<int> bstart(nb), bend(nb);
+    int pos = 0;
+    for (int b = 0; b < nb; b++) {
+        bstart[b] = pos;
+        pos += 2 * std::max<int>(1, static_cast<int>(mf.blocks[b].insts.size()));
+        bend[b] = pos - 2;
+    }
+
+    // 2. 后继块
+    std::vector<std::vector<int>> succ(nb);
+    for (int b = 0; b < nb; b++) {
+        auto &insts = mf.blocks[b].insts;
+        for (auto &inst: insts) {
+            if (inst.op == MInst::JCC || inst.op == MInst::JMP) succ[b].push_back(inst.ops[0].reg);
+        }
+        bool falls = insts.empty() || (insts.back().op != MInst::JMP && insts.back().op != MInst::RET);
+        if (falls && b + 1 < nb) succ[b].push_back(b + 1);
+    }
+
+    // 3. 块级活跃分析
+    std::vector<Bits> use(nb, Bits(words)), def(nb, Bits(words));
+    std::vector<Bits> live_in(nb, Bits(words)), live_out(nb, Bits(words));
+    std::vector<int> uses, defs;
+    for (int b = 0; b < nb; b++) {
+        for (auto &inst: mf.blocks[b].insts) {
+            uses.clear();
+            defs.clear();
+            inst.collect(uses, defs);
+            for (int r: uses) {
+                if (is_vreg(r) && !test(def[b], r - kNumPRegs)) set(use[b], r - kNumPRegs);
+            }
+            for (int r: defs) {
+                if (is_vreg(r)) set(def[b], r - kNumPRegs);
+            }
+        }
+    }
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int b = nb - 1; b >= 0; b--) {
+            Bits out(words);
+            for (int s: succ[b]) {
+                for (size_t w = 0; w < words; w++) out[w] |= live_in[s][w];
+            }
+            for (size_t w = 0; w < words; w++) {
+                uint64_t in = use[b][w] | (out[w] & ~def[b][w]);
+                if (in != live_in[b][w]) {
+                    live_in[b][w] = in;
+                    changed = true;
+                }
+            }
+            live_out[b] = std::move(out);
+        }
+    }
+
+    // 4. 虚拟寄存器的活跃区间，以及物理寄存器的固定占用区段
+    std::vector<int> first(nv, INT_MAX), last(nv, -1);
+    auto touch = [&](int v, int p) {
+        first[v] = std::min(first[v], p);
+        last[v] = std::max(last[v], p);
+    };
+    std::vector<std::vector<Segment>> fixed(kNumPRegs);
+    for (int b = 0; b < nb; b++) {
+        for (size_t w = 0; w < words; w++) {
+            for (uint64_t bits = live_in[b][w]; bits; bits &= bits - 1) {
+                touch(static_cast<int>(w * 64 + __builtin_ctzll(bits)), bstart[b]);
+            }
+            for (uint64_t bits = live_out[b][w]; bits; bits &= bits - 1) {
+                touch(static_cast<int>(w * 64 + __builtin_ctzll(bits)), bend[b]);
+            }
+        }
+        int live_end[kNumPRegs];
+        std::fill(std::begin(live_end), std::end(live_end), -1);
+        auto &insts = mf.blocks[b].insts;
+        for (int i = static_cast<int>(insts.size()) - 1; i >= 0; i--) {
+            int p = bstart[b] + 2 * i;
+            uses.clear();
+            defs.clear();
+            insts[i].collect(uses, defs);
+            for (int r: defs) {
+                if (is_vreg(r)) {
+                    touch(r - kNumPRegs, p);
+                } else if (r != RSP && r != RBP) {
+                    fixed[r].push_back({p, live_end[r] >= 0 ? live_end[r] : p});
+                    live_end[r] = -1;
+                }
+            }
+            for (int r: uses) {
+                if (is_vreg(r)) {
+                    touch(r - kNumPRegs, p);
+                } else if (r != RSP && r != RBP && live_end[r] < 0) {
+                    live_end[r] = p;
+                }
+            }
+        }
+        // 块入口处仍活跃的只有入口块的参数寄存器
+        for (int r = 0; r < kNumPRegs; r++) {
+            if (live_end[r] >= 0) fixed[r].push_back({bstart[b], live_end[r]});
+        }
+    }
+    for (auto &segs: fixed) {
+        std::sort(segs.begin(), segs.end(), [](const Segment &a, const Segment &b) { return a.start < b.start; });
+        std::vector<Segment> merged;
+        for (auto &s: segs) {
+            if (!merged.empty() && s.start <= merged.back().end) {
+                merged.back().end = std::max(merged.back().end, s.end);
+            } else {
+                merged.push_back(s);
+            }
+        }
+        segs = std::move(merged);
+    }
+
+    // 5. 线性扫描
+    std::vector<Interval> intervals;
+    for (int v = 0; v < nv; v++) {
+        if (last[v] >= 0) intervals.push_back({v, first[v], last[v]});
+    }
+    std::sort(intervals.begin(), intervals.end(), [](const Interval &a, const Interval &b) {
+        return a.start != b.start ? a.start < b.start : a.vreg < b.vreg;
+    });
+
+    std::vector<int> assignment(nv, -1);
+    std::vector<bool> spilled(nv, false);
+    std::vector<Interval *> active;
+    int spills = 0;
+    for (auto &cur: intervals) {
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&](Interval *a) { return a->end < cur.start; }),
+                     active.end());
+        RegClass cls = mf.vreg_class[cur.vreg];
+        bool taken[kNumPRegs] = {};
+        for (auto a: active) taken[a->preg] = true;
+
+        const int *order = cls == RegClass::GPR ? kGprOrder : kXmmOrder;
+        int count = cls == RegClass::GPR ? std::size(kGprOrder) : std::size(kXmmOrder);
+        for (int i = 0; i < count && cur.preg < 0; i++) {
+            if (!taken[order[i]] && !blocked(fixed[order[i]], cur.start, cur.end)) cur.preg = order[i];
+        }
+        if (cur.preg >= 0) {
+            active.push_back(&cur);
+            continue;
+        }
+
+        // 溢出结束最晚的区间
+        Interval *victim = nullptr;
+        for (auto a: active) {
+            if (mf.vreg_class[a->vreg] != cls || blocked(fixed[a->preg], cur.start, cur.end)) continue;
+            if (!victim || a->end > victim->end) victim = a;
+        }
+        spills++;
+        if (victim && victim->end > cur.end) {
+            cur.preg = victim->preg;
+            victim->preg = -1;
+            spilled[victim->vreg] = true;
+            *std::find(active.begin(), active.end(), victim) = &cur;
+        } else {
+            spilled[cur.vreg] = true;
+        }
+    }
+    for (auto &it: intervals) {
+        if (it.preg >= 0) assignment[it.vreg] = it.preg;
+    }
+
+    // 6. 改写指令：虚拟寄存器换成物理寄存器，溢出值经临时寄存器装入/写回
+    std::vector<int> slot(nv, -1);
+    bool saved[kNumPRegs] = {};
+    for (auto &block: mf.blocks) {
+        std::vector<MInst> out;
+        out.reserve(block.insts.size());
+        for (auto &inst: block.insts) {
+            uses.clear();
+            defs.clear();
+            inst.collect(uses, defs);
+            std::vector<std::pair<int, int>> scratch;  // 溢出的 vreg -> 临时寄存器
+            int ngpr = 0, nxmm = 0;
+            auto scratch_of = [&](int v) {
+                for (auto &s: scratch) {
+                    if (s.first == v) return s.second;
+                }
+                bool xmm = mf.vreg_class[v - kNumPRegs] == RegClass::XMM;
+                int r = xmm ? kXmmScratch[nxmm++] : kGprScratch[ngpr++];
+                scratch.emplace_back(v, r);
+                return r;
+            };
+            auto load_store = [&](int v, bool load) {
+                int s = slot[v - kNumPRegs];
+                if (s < 0) s = slot[v - kNumPRegs] = mf.new_slot(8, 8);
+                bool xmm = mf.vreg_class[v - kNumPRegs] == RegClass::XMM;
+                MOperand mem = MOperand::make_frame(s, 0);
+                MOperand r = MOperand::make_reg(scratch_of(v), 8);
+                if (load) {
+                    out.emplace_back(xmm ? MInst::MOVSS : MInst::MOV, std::vector<MOperand>{mem, r}, 8);
+                } else {
+                    out.emplace_back(xmm ? MInst::MOVSS : MInst::MOV, std::vector<MOperand>{r, mem}, 8);
+                }
+            };
+            std::vector<int> loaded;
+            for (int r: uses) {
+                if (is_vreg(r) && spilled[r - kNumPRegs] &&
+                    std::find(loaded.begin(), loaded.end(), r) == loaded.end()) {
+                    loaded.push_back(r);
+                    load_store(r, true);
+                }
+            }
+            MInst rewritten = inst;
+            for (auto &o: rewritten.ops) {
+                bool has_reg = o.is_reg() || o.base_reg() >= 0;
+                if (!has_reg || !is_vreg(o.reg)) continue;
+                o.reg = spilled[o.reg - kNumPRegs] ? scratch_of(o.reg) : assignment[o.reg - kNumPRegs];
+            }
+            // 寄存器间的自复制直接删去
+            bool self_move = (rewritten.op == MInst::MOV || rewritten.op == MInst::MOVSS) &&
+                             rewritten.ops[0].is_reg() && rewritten.ops[1].is_reg() &&
+                             rewritten.ops[0].reg == rewritten.ops[1].reg;
+            if (!self_move) out.push_back(std::move(rewritten));
+            for (int r: defs) {
+                if (is_vreg(r) && spilled[r - kNumPRegs]) load_store(r, false);
+            }
+        }
+        block.insts = std::move(out);
+    }
+    for (int v = 0; v < nv; v++) {
+        if (assignment[v] >= 0 && is_callee_saved(assignment[v])) saved[assignment[v]] = true;
+    }
+    mf.saved_regs.clear();
+    for (int r = 0; r < kNumPRegs; r++) {
+        if (saved[r]) mf.saved_regs.push_back(r);
+    }
+    Stats::count("regalloc spills", spills);
+    return spills;
+}
@@ -0,0 +1,69 @@
+/*!
+ * @file LoopInfo.cpp
+ * @brief 自然循环分析实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "LoopInfo.h"
+#include "BasicBlock.h"
+#include "Dominators.h"
+
+#include <unordered_set>
+
+LoopInfo::LoopInfo(const Dominators &dom) {
+    // 外层循环的 header 支配内层 header，在逆后序中先出现，
+    // 因此按逆后序处理时外层循环总是先建立
+    for (auto header: dom.get_rpo()) {
+        std::vector<BasicBlock *> latches;
+        for (auto pre: header->get_pre_basic_blocks()) {
+            if (dom.is_reachable(pre) && dom.dominates(header, pre)) {
+                latches.push_back(pre);
+            }
+        }
+        if (latches.empty()) {
+            continue;
+        }
+        std::unordered_set<BasicBlock *> body{header};
+        std::vector<BasicBlock *> worklist;
+        for (auto latch: latches) {
+            if (body.insert(latch).second) {
+                worklist.push_back(latch);
+            }
+        }
+        while (!worklist.empty()) {
+            BasicBlock *bb = worklist.back();
+            worklist.pop_back();
+            for (auto pre: bb->get_pre_basic_blocks()) {
+                if (dom.is_reachable(pre) && body.insert(pre).second) {
+                    worklist.push_back(pre);
+                }
+            }
+        }
+
+        auto loop = std::make_unique<Loop>();
+        loop->header = header;
+        loop->latches = std::move(latches);
+        for (auto bb: dom.get_rpo()) {
+            if (body.count(bb)) {
+                loop->blocks.push_back(bb);
+            }
+        }
+        loop->parent = get_loop_for(header);
+        loop->depth = loop->parent ? loop->parent->depth + 1 : 1;
+        for (auto bb: loop->blocks) {
+            innermost_[bb] = loop.get();
+        }
+        loops_.push_back(std::move(loop));
+    }
+}
+
+Loop *LoopInfo::get_loop_for(BasicBlock *bb) const {
+    auto it = innermost_.find(bb);
+    return it == innermost_.end() ? nullptr : it->second;
+}
+
+int LoopInfo::get_loop_depth(BasicBlock *bb) const {
+    Loop *loop = get_loop_for(bb);
+    return loop ? loop->depth : 0;
+}
@@ -0,0 +1,132 @@
+/*!
+ * @file MachineIR.cpp
+ * @brief x86-64 机器指令表示实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "MachineIR.h"
+
+Cond invert(Cond cc) {
+    switch (cc) {
+        case Cond::E: return Cond::NE;
+        case Cond::NE: return Cond::E;
+        case Cond::L: return Cond::GE;
+        case Cond::LE: return Cond::G;
+        case Cond::G: return Cond::LE;
+        case Cond::GE: return Cond::L;
+        case Cond::A: return Cond::BE;
+        case Cond::AE: return Cond::B;
+        case Cond::B: return Cond::AE;
+        case Cond::BE: return Cond::A;
+        case Cond::P: return Cond::NP;
+        case Cond::NP: return Cond::P;
+    }
+    return cc;
+}
+
+MOperand MOperand::make_reg(int reg, int size) {
+    MOperand o;
+    o.kind = REG;
+    o.reg = reg;
+    o.size = size;
+    return o;
+}
+
+MOperand MOperand::make_imm(int64_t value) {
+    MOperand o;
+    o.kind = IMM;
+    o.imm = value;
+    return o;
+}
+
+MOperand MOperand::make_mem(int base_reg, int64_t offset) {
+    MOperand o;
+    o.kind = MEM;
+    o.base = BASE_REG;
+    o.reg = base_reg;
+    o.imm = offset;
+    return o;
+}
+
+MOperand MOperand::make_frame(int slot, int64_t offset) {
+    MOperand o;
+    o.kind = MEM;
+    o.base = BASE_FRAME;
+    o.reg = slot;
+    o.imm = offset;
+    return o;
+}
+
+MOperand MOperand::make_symbol(const std::string &sym, int64_t offset) {
+    MOperand o;
+    o.kind = MEM;
+    o.base = BASE_SYMBOL;
+    o.sym = sym;
+    o.imm = offset;
+    return o;
+}
+
+MOperand MOperand::make_block(int index) {
+    MOperand o;
+    o.kind = BLOCK;
+    o.reg = index;
+    return o;
+}
+
+MOperand MOperand::make_func(const std::string &name) {
+    MOperand o;
+    o.kind = FUNC;
+    o.sym = name;
+    return o;
+}
+
+void MInst::collect(std::vector<int> &uses, std::vector<int> &defs) const {
+    auto use = [&](const MOperand &o) {
+        if (o.is_reg()) uses.push_back(o.reg);
+        else if (o.base_reg() >= 0) uses.push_back(o.base_reg());
+    };
+    switch (op) {
+        case MOV: case LEA: case MOVZX: case MOVSX:
+        case MOVSS: case CVTSI2SS: case CVTTSS2SI:
+            use(ops[0]);
+            if (ops[1].is_reg()) defs.push_back(ops[1].reg);
+            else use(ops[1]);
+            break;
+        case ADD: case SUB: case IMUL: case AND: case OR:
+        case ADDSS: case SUBSS: case MULSS: case DIVSS:
+            use(ops[0]);
+            use(ops[1]);
+            if (ops[1].is_reg()) defs.push_back(ops[1].reg);
+            break;
+        case CMP: case TEST: case UCOMISS: case IDIV:
+            for (auto &o: ops) use(o);
+            break;
+        case SETCC:
+            defs.push_back(ops[0].reg);
+            break;
+        default:
+            break;
+    }
+    uses.insert(uses.end(), implicit_uses.begin(), implicit_uses.end());
+    defs.insert(defs.end(), implicit_defs.begin(), implicit_defs.end());
+}
+
+const char *preg_name(int preg, int size) {
+    static const char *const names64[] = {
+        "%rax", "%rcx", "%rdx", "%rbx", "%rsp", "%rbp", "%rsi", "%rdi",
+        "%r8", "%r9", "%r10", "%r11", "%r12", "%r13", "%r14", "%r15"};
+    static const char *const names32[] = {
+        "%eax", "%ecx", "%edx", "%ebx", "%esp", "%ebp", "%esi", "%edi",
+        "%r8d", "%r9d", "%r10d", "%r11d", "%r12d", "%r13d", "%r14d", "%r15d"};
+    static const char *const names8[] = {
+        "%al", "%cl", "%dl", "%bl", "%spl", "%bpl", "%sil", "%dil",
+        "%r8b", "%r9b", "%r10b", "%r11b", "%r12b", "%r13b", "%r14b", "%r15b"};
+    static const char *const xmm[] = {
+        "%xmm0", "%xmm1", "%xmm2", "%xmm3", "%xmm4", "%xmm5", "%xmm6", "%xmm7",
+        "%xmm8", "%xmm9", "%xmm10", "%xmm11", "%xmm12", "%xmm13", "%xmm14", "%xmm15"};
+    if (is_xmm(preg)) return xmm[preg - XMM0];
+    if (size == 8) return names64[preg];
+    if (size == 1) return names8[preg];
+    return names32[preg];
+}
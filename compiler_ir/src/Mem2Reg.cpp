@@ -0,0 +1,198 @@
+/*!
+ * @file Mem2Reg.cpp
+ * @brief 将局部变量的 alloca 提升为SSA寄存器实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "Mem2Reg.h"
+#include "BasicBlock.h"
+#include "Constant.h"
+#include "Dominators.h"
+#include "Function.h"
+#include "Instruction.h"
+#include "Module.h"
+#include "Stats.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// 只作为 load 的地址或 store 的目的地址出现
+bool is_promotable(AllocaInst *alloca) {
+    Type *ty = alloca->get_alloca_type();
+    if (!ty->is_int32_type() && !ty->is_float_type()) {
+        return false;
+    }
+    for (auto &use: alloca->get_use_list()) {
+        auto user = dynamic_cast<Instruction *>(use.val_);
+        if (user == nullptr) {
+            return false;
+        }
+        if (!(user->is_load() || (user->is_store() && use.arg_no_ == 1))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Value *zero_of(Type *ty, Module *m) {
+    if (ty->is_float_type()) {
+        return ConstantFP::get(0.0f, m);
+    }
+    return ConstantInt::get(0, m);
+}
+
+/// 返回 load/store 访问的、正在提升的 alloca 的下标，否则为 -1
+int promoted_slot(Instruction *instr, const std::unordered_map<Value *, int> &slots) {
+    Value *ptr = nullptr;
+    if (instr->is_load()) {
+        ptr = instr->get_operand(0);
+    } else if (instr->is_store()) {
+        ptr = instr->get_operand(1);
+    } else {
+        return -1;
+    }
+    auto it = slots.find(ptr);
+    return it == slots.end() ? -1 : it->second;
+}
+
+}  // namespace
+
+bool Mem2Reg::run_on_function(Function *f) {
+    Module *m = f->get_parent();
+    std::vector<AllocaInst *> allocas;
+    std::unordered_map<Value *, int> slots;
+    for (auto bb: f->get_basic_blocks()) {
+        for (auto instr: bb->get_instructions()) {
+            auto alloca = dynamic_cast<AllocaInst *>(instr);
+            if (alloca != nullptr && is_promotable(alloca)) {
+                slots[alloca] = (int) allocas.size();
+                allocas.push_back(alloca);
+            }
+        }
+    }
+    if (allocas.empty()) {
+        return false;
+    }
+
+    const Dominators &dom = get_analyses().get_dominators(f);
+
+    // 在 store 所在块的迭代支配边界上放置phi
+    std::unordered_map<PhiInst *, int> phi_slots;
+    std::unordered_map<BasicBlock *, int> has_phi;     // 块 -> 最近放置phi的 alloca 下标 + 1
+    std::unordered_map<BasicBlock *, int> in_worklist;
+    uint64_t phis = 0;
+    for (int slot = 0; slot < (int) allocas.size(); slot++) {
+        std::vector<BasicBlock *> worklist;
+        for (auto &use: allocas[slot]->get_use_list()) {
+            auto store = static_cast<Instruction *>(use.val_);
+            BasicBlock *bb = store->get_parent();
+            if (store->is_store() && dom.is_reachable(bb) && in_worklist[bb] != slot + 1) {
+                in_worklist[bb] = slot + 1;
+                worklist.push_back(bb);
+            }
+        }
+        while (!worklist.empty()) {
+            BasicBlock *bb = worklist.back();
+            worklist.pop_back();
+            for (auto df: dom.get_frontier(bb)) {
+                if (has_phi[df] == slot + 1) {
+                    continue;
+                }
+                has_phi[df] = slot + 1;
+                auto phi = PhiInst::create_phi(allocas[slot]->get_alloca_type(), df);
+                df->get_instructions().remove(phi);
+                df->add_instr_begin(phi);
+                phi_slots[phi] = slot;
+                phis++;
+                if (in_worklist[df] != slot + 1) {
+                    in_worklist[df] = slot + 1;
+                    worklist.push_back(df);
+                }
+            }
+        }
+    }
+
+    // 沿支配树先序改名，每个块带着进入时各变量的到达值
+    std::vector<Value *> entry_values;
+    for (auto alloca: allocas) {
+        entry_values.push_back(zero_of(alloca->get_alloca_type(), m));
+    }
+    std::vector<std::pair<BasicBlock *, std::vector<Value *>>> stack;
+    stack.emplace_back(f->get_entry_block(), std::move(entry_values));
+    std::vector<Instruction *> dead;
+    while (!stack.empty()) {
+        BasicBlock *bb = stack.back().first;
+        std::vector<Value *> values = std::move(stack.back().second);
+        stack.pop_back();
+        dead.clear();
+        for (auto instr: bb->get_instructions()) {
+            if (instr->is_phi()) {
+                auto it = phi_slots.find(static_cast<PhiInst *>(instr));
+                if (it != phi_slots.end()) {
+                    values[it->second] = instr;
+                }
+                continue;
+            }
+            int slot = promoted_slot(instr, slots);
+            if (slot < 0) {
+                continue;
+            }
+            if (instr->is_load()) {
+                instr->replace_all_use_with(values[slot]);
+            } else {
+                values[slot] = instr->get_operand(0);
+            }
+            dead.push_back(instr);
+        }
+        for (auto instr: dead) {
+            bb->delete_instr(instr);
+        }
+        for (auto succ: bb->get_succ_basic_blocks()) {
+            for (auto instr: succ->get_instructions()) {
+                if (!instr->is_phi()) {
+                    break;
+                }
+                auto it = phi_slots.find(static_cast<PhiInst *>(instr));
+                if (it != phi_slots.end()) {
+                    static_cast<PhiInst *>(instr)->add_phi_pair_operand(values[it->second], bb);
+                }
+            }
+        }
+        auto &children = dom.get_children(bb);
+        for (auto child = children.rbegin(); child != children.rend(); ++child) {
+            stack.emplace_back(*child, values);
+        }
+    }
+
+    // 不可达块中剩下的访问没有到达值可用
+    for (auto bb: f->get_basic_blocks()) {
+        if (dom.is_reachable(bb)) {
+            continue;
+        }
+        dead.clear();
+        for (auto instr: bb->get_instructions()) {
+            int slot = promoted_slot(instr, slots);
+            if (slot < 0) {
+                continue;
+            }
+            if (instr->is_load()) {
+                instr->replace_all_use_with(zero_of(allocas[slot]->get_alloca_type(), m));
+            }
+            dead.push_back(instr);
+        }
+        for (auto instr: dead) {
+            bb->delete_instr(instr);
+        }
+    }
+
+    for (auto alloca: allocas) {
+        alloca->get_parent()->delete_instr(alloca);
+    }
+    Stats::count("allocas promoted", allocas.size());
+    Stats::count("phis inserted", phis);
+    return true;
+}
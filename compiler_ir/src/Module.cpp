@@ -5,17 +5,22 @@
  *@date 2022-10-04
  */
 #include "Module.h"
+#include "Constant.h"
+#include "IRBinary.h"
+#include "Stats.h"
 
+#include <cstring>
+#include <sstream>
 #include <utility>
 
 Module::Module(std::string name) : module_name_(std::move(name)) {
     /// @brief 创建类型指针对象
     /// @param name
-    void_ty_ = new Type(Type::VoidTyID, this);
-    label_ty_ = new Type(Type::LabelTyID, this);
-    int1_ty_ = new IntegerType(1, this);
-    int32_ty_ = new IntegerType(32, this);
-    float32_ty_ = new FloatType(this);
+    void_ty_ = new (this) Type(Type::VoidTyID, this);
+    label_ty_ = new (this) Type(Type::LabelTyID, this);
+    int1_ty_ = new (this) IntegerType(1, this);
+    int32_ty_ = new (this) IntegerType(32, this);
+    float32_ty_ = new (this) FloatType(this);
 
     /// @brief id 与 字符串的映射添加
     instr_id2string_.insert({Instruction::ret, "ret"});
@@ -43,11 +48,7 @@ Module::Module(std::string name) : module_name_(std::move(name)) {
  *
  */
 Module::~Module() {
-    delete void_ty_;
-    delete label_ty_;
-    delete int1_ty_;
-    delete int32_ty_;
-    delete float32_ty_;
+    // 类型、常量与所有IR对象都由 arena_ 持有，随其析构一并释放
 }
 
 /**
@@ -85,10 +86,7 @@ IntegerType *Module::get_int32_type() { return int32_ty_; }
  * @return PointerType*
  */
 PointerType *Module::get_pointer_type(Type *contained) {
-    if (pointer_map_.find(contained) == pointer_map_.end()) {
-        pointer_map_[contained] = new PointerType(contained);
-    }
-    return pointer_map_[contained];
+    return pointer_map_.get(contained, [&] { return new (this) PointerType(contained); });
 }
 
 /**
@@ -99,11 +97,41 @@ PointerType *Module::get_pointer_type(Type *contained) {
  * @return ArrayType*
  */
 ArrayType *Module::get_array_type(Type *contained, unsigned num_elements) {
-    if (array_map_.find({contained, num_elements}) == array_map_.end()) {
-        array_map_[{contained, num_elements}] =
-                new ArrayType(contained, num_elements);
-    }
-    return array_map_[{contained, num_elements}];
+    return array_map_.get({contained, static_cast<int>(num_elements)},
+                          [&] { return new (this) ArrayType(contained, num_elements); });
+}
+
+/**
+ * @brief Get the constant int object，获取唯一化的整数常量
+ *
+ * @param ty 整数类型（i1 或 i32）
+ * @param val 常量值
+ * @return ConstantInt*
+ */
+ConstantInt *Module::get_constant_int(IntegerType *ty, int val) {
+    return const_int_map_.get({ty, val}, [&] { return new (this) ConstantInt(ty, val); });
+}
+
+/**
+ * @brief Get the constant fp object，获取唯一化的浮点常量
+ *
+ * @param val 常量值
+ * @return ConstantFP*
+ */
+ConstantFP *Module::get_constant_fp(float val) {
+    uint32_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    return const_fp_map_.get(bits, [&] { return new (this) ConstantFP(float32_ty_, val); });
+}
+
+/**
+ * @brief Get the constant zero object，获取唯一化的零初始化常量
+ *
+ * @param ty 常量类型
+ * @return ConstantZero*
+ */
+ConstantZero *Module::get_constant_zero(Type *ty) {
+    return const_zero_map_.get(ty, [&] { return new (this) ConstantZero(ty); });
 }
 
 /**
@@ -163,6 +191,15 @@ std::list<GlobalVariable *> Module::get_global_variable() {
     return global_list_;
 }
 
+/**
+ * @brief 设置函数体的读入器，模块析构时一并释放
+ *
+ * @param reader 二进制中间代码读入器
+ */
+void Module::set_materializer(std::unique_ptr<IRBinaryReader> reader) {
+    materializer_ = std::move(reader);
+}
+
 /**
  * @brief Set the print name object，修正模块管理的函数下的名称
  *
@@ -175,19 +212,29 @@ void Module::set_print_name() {
 }
 
 /**
- * @brief 打印中间代码
+ * @brief 打印中间代码，逐条写入输出流
  *
- * @return std::string
+ * @param os 输出流
  */
-std::string Module::print() {
-    std::string module_ir;
+void Module::print(std::ostream &os) {
+    Stats::Timer timer("Module::print");
     for (auto global_val: this->global_list_) {
-        module_ir += global_val->print();
-        module_ir += "\n";
+        global_val->print(os);
+        os << "\n";
     }
     for (auto func: this->function_list_) {
-        module_ir += func->print();
-        module_ir += "\n";
+        func->print(os);
+        os << "\n";
     }
-    return module_ir;
+}
+
+/**
+ * @brief 打印中间代码
+ *
+ * @return std::string
+ */
+std::string Module::print() {
+    std::ostringstream os;
+    print(os);
+    return os.str();
 }
@@ -0,0 +1,163 @@
+/*!
+ * @file ParallelLexer.cpp
+ * @brief Chunked multi-threaded lexing
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "ParallelLexer.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include "SLRLexer.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+
+namespace {
+
+struct Chunk {
+    size_t begin;
+    size_t end;
+    std::vector<Token> tokens;   // Lines relative to the chunk, offsets absolute
+    size_t newlines = 0;
+    bool endsInComment = false;
+    size_t first = 0;            // Index of tokens[0] in the result
+};
+
+/**
+ * @brief Lex chunk.begin..chunk.end, optionally starting inside a block comment
+ *
+ * Lexing starts at 'from', which is past the comment when startInComment;
+ * tokens on that first line are shifted by the comment text before them.
+ * Inside a comment every byte is one column, as in SLRScan::skipBlockComment.
+ *
+ * A re-lex stops as soon as it produces a token that the speculative pass
+ * also produced at the same offset, line and column: both lexers are in the
+ * same state there, so the rest of the speculative tokens are reused.
+ */
+void lexChunk(Chunk& chunk, std::string_view source, bool startInComment, bool last) {
+    std::vector<Token> speculated;
+    speculated.swap(chunk.tokens);
+    bool speculatedEnd = chunk.endsInComment;
+
+    size_t from = chunk.begin;
+    if (startInComment) {
+        size_t close = source.substr(0, chunk.end).find("*/", chunk.begin);
+        if (close == std::string_view::npos) {
+            chunk.endsInComment = true;
+            if (!last) return;
+            // An unterminated comment stops before the final byte, which is lexed
+            from = chunk.end - 1;
+        } else {
+            from = close + 2;
+        }
+    }
+    int lineBase = static_cast<int>(std::count(source.data() + chunk.begin, source.data() + from, '\n'));
+    size_t lineStart = chunk.begin;
+    for (size_t i = from; i > chunk.begin; i--) {
+        if (source[i - 1] == '\n') {
+            lineStart = i;
+            break;
+        }
+    }
+    int columnBase = static_cast<int>(from - lineStart);
+
+    SLRLexer lexer;
+    lexer.reset(source.substr(from, chunk.end - from));
+    Token token;
+    size_t j = 0;
+    while (lexer.next(token)) {
+        if (token.line == 1) token.column += columnBase;
+        token.line += lineBase;
+        token.offset += static_cast<uint32_t>(from);
+        if (startInComment) {
+            while (j < speculated.size() && speculated[j].offset < token.offset) j++;
+            if (j < speculated.size() && speculated[j].offset == token.offset &&
+                speculated[j].line == token.line && speculated[j].column == token.column) {
+                chunk.tokens.insert(chunk.tokens.end(), speculated.begin() + j, speculated.end());
+                chunk.endsInComment = speculatedEnd;
+                return;
+            }
+        }
+        chunk.tokens.push_back(token);
+    }
+    if (!last) chunk.tokens.pop_back();   // Only the final chunk keeps END_OF_FILE
+    chunk.endsInComment = lexer.endedInComment();
+}
+
+}  // namespace
+
+ParallelLexer::ParallelLexer(int threads) : threads(threads) {
+    if (this->threads <= 0) {
+        this->threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+}
+
+std::vector<Token> ParallelLexer::analyze(std::string_view source) const {
+    size_t numChunks = std::min<size_t>(threads, source.size() / kMinChunk);
+    if (numChunks <= 1) {
+        SLRLexer lexer;
+        return lexer.analyze(source);
+    }
+
+    // 1. Cut just after the first newline at or past each even split point
+    std::vector<Chunk> chunks;
+    size_t begin = 0;
+    for (size_t i = 1; i <= numChunks && begin < source.size(); i++) {
+        size_t end = source.size();
+        if (i < numChunks) {
+            size_t target = std::max(begin, source.size() / numChunks * i);
+            const void* nl = std::memchr(source.data() + target, '\n', source.size() - target);
+            if (nl) end = static_cast<const char*>(nl) - source.data() + 1;
+        }
+        chunks.push_back(Chunk{begin, end});
+        begin = end;
+    }
+
+    // 2. Speculatively lex every chunk as if it started outside a comment
+    {
+        Stats::Timer timer("ParallelLexer::lex");
+        ThreadPool pool(static_cast<int>(chunks.size()));
+        for (size_t i = 0; i < chunks.size(); i++) {
+            pool.submit([&, i] {
+                Chunk& chunk = chunks[i];
+                chunk.newlines = std::count(source.data() + chunk.begin, source.data() + chunk.end, '\n');
+                lexChunk(chunk, source, false, i + 1 == chunks.size());
+            });
+        }
+        pool.wait();
+    }
+
+    // 3. Resolve comment state in order, re-lexing mispredicted chunks
+    size_t total = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        if (i > 0 && chunks[i - 1].endsInComment) {
+            Stats::count("lexer chunks re-lexed", 1);
+            lexChunk(chunks[i], source, true, i + 1 == chunks.size());
+        }
+        chunks[i].first = total;
+        total += chunks[i].tokens.size();
+    }
+
+    // 4. Concatenate, adding the lines before each chunk
+    std::vector<Token> tokens(total);
+    {
+        Stats::Timer timer("ParallelLexer::stitch");
+        ThreadPool pool(static_cast<int>(chunks.size()));
+        int line = 0;
+        for (auto& chunk : chunks) {
+            pool.submit([&tokens, &chunk, line] {
+                Token* out = tokens.data() + chunk.first;
+                for (const Token& t : chunk.tokens) {
+                    *out = t;
+                    out->line += line;
+                    out++;
+                }
+                std::vector<Token>().swap(chunk.tokens);
+            });
+            line += static_cast<int>(chunk.newlines);
+        }
+        pool.wait();
+    }
+    return tokens;
+}
@@ -0,0 +1,66 @@
+/*!
+ * @file PassManager.cpp
+ * @brief 中间代码优化遍框架实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "PassManager.h"
+#include "ConstFold.h"
+#include "DeadCodeElim.h"
+#include "Function.h"
+#include "GVN.h"
+#include "Inliner.h"
+#include "Mem2Reg.h"
+#include "Module.h"
+#include "SimplifyCFG.h"
+#include "Stats.h"
+
+bool FunctionPass::run(Module *m, AnalysisManager &am) {
+    analyses_ = &am;
+    bool changed = false;
+    for (auto func: m->get_functions()) {
+        if (func->is_declaration() || !run_on_function(func)) {
+            continue;
+        }
+        changed = true;
+        if (!preserves_cfg()) {
+            am.invalidate(func);
+        }
+    }
+    analyses_ = nullptr;
+    return changed;
+}
+
+bool PassManager::run(Module *m) {
+    bool changed = false;
+    for (auto &pass: passes_) {
+        Stats::Timer timer(pass->get_name());
+        changed |= pass->run(m, analyses_);
+    }
+    // 缓存中的分析指向本模块的基本块，不跨模块保留
+    analyses_.clear();
+    return changed;
+}
+
+void PassManager::build_pipeline(PassManager &pm, int level) {
+    if (level <= 0) {
+        return;
+    }
+    // 先删去 return 之后的指令与跳转，提升时的前驱/后继才与实际控制流一致
+    pm.add_pass<SimplifyCFG>();
+    pm.add_pass<Mem2Reg>();
+    // 折叠常量后条件跳转变为无条件跳转，化简CFG后单前驱的phi又产生新的常量
+    pm.add_pass<ConstFold>();
+    if (level >= 2) {
+        // 被调函数已提升并折叠，代价按化简后的大小估计；内联后实参常量随后续的折叠传播
+        pm.add_pass<Inliner>();
+        pm.add_pass<ConstFold>();
+    }
+    pm.add_pass<GVN>();
+    pm.add_pass<SimplifyCFG>();
+    pm.add_pass<ConstFold>();
+    pm.add_pass<DeadCodeElim>();
+    // 删除死代码后可能留下只含跳转的空块
+    pm.add_pass<SimplifyCFG>();
+}
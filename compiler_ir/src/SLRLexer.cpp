@@ -0,0 +1,42 @@
+/*!
+ * @file SLRLexer.cpp
+ * @brief Loading of the shared lexer DFA table
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "SLRLexer.h"
+#include <stdexcept>
+
+#ifdef SLR_HAS_EMBEDDED_DFA
+#include "SLRDFATableData.inc"
+#endif
+
+std::shared_ptr<const SLRDFATable> SLRLexer::loadDFA() {
+#ifdef SLR_HAS_EMBEDDED_DFA
+    // The generator is rebuilt (and rerun) whenever the NFA headers change,
+    // so the embedded copy cannot go stale; decoding is a few array copies
+    auto t = std::make_shared<SLRDFATable>();
+    std::copy(std::begin(kDFAByteClass), std::end(kDFAByteClass), t->byteClass.begin());
+    t->numClasses = kDFANumClasses;
+    t->next.assign(std::begin(kDFANext), std::end(kDFANext));
+    t->accepting.assign(std::begin(kDFAAccepting), std::end(kDFAAccepting));
+    for (uint8_t type : kDFAAcceptType) t->acceptType.push_back(static_cast<TokenType>(type));
+#ifdef SLR_VERIFY_TABLES
+    // Fallback check: the runtime construction must reproduce the embedded copy
+    auto built = buildDFA();
+    if (built->byteClass != t->byteClass || built->numClasses != t->numClasses || built->next != t->next ||
+        built->accepting != t->accepting || built->acceptType != t->acceptType) {
+        throw std::runtime_error("embedded lexer DFA does not match the token patterns");
+    }
+#endif
+    return t;
+#else
+    return buildDFA();
+#endif
+}
+
+std::shared_ptr<const SLRDFATable> SLRLexer::sharedTable() {
+    static const std::shared_ptr<const SLRDFATable> cached = loadDFA();
+    return cached;
+}
@@ -6,13 +6,17 @@
  */
 
 #include "SLRParser.h"
+#include "Stats.h"
 #include <cctype>
-#include <fstream>
 #include <stdexcept>
 
+#ifdef SLR_HAS_EMBEDDED_TABLE
+#include "SLRTableData.inc"
+#endif
+
 // Helper function to convert token to grammar symbol
-std::string SLRParser::getTokenSymbol(const Token& t) {
-    switch (t.type) {
+std::string SLRParser::getTokenSymbol(TokenType type) {
+    switch (type) {
         case TokenType::IDN: return "Ident";
         case TokenType::INT: return "IntConst";
         case TokenType::FLOAT: return "floatConst";
@@ -154,6 +158,58 @@ void SLRParser::initGrammar() {
     terminals.insert("$");
 }
 
+// FNV-1a over the productions, used to reject tables built for another grammar
+uint32_t SLRParser::computeGrammarHash() const {
+    uint32_t h = 2166136261u;
+    auto mix = [&h](const std::string& s) {
+        for (unsigned char c : s) {
+            h ^= c;
+            h *= 16777619u;
+        }
+        h ^= 0xff;
+        h *= 16777619u;
+    };
+    for (auto& p : grammar) {
+        mix(p.lhs);
+        for (auto& s : p.rhs) mix(s);
+    }
+    return h;
+}
+
+std::shared_ptr<const SLRTables> SLRParser::buildTables() {
+    SLRParser builder(nullptr);
+    auto t = std::make_shared<SLRTables>();
+    t->grammarHash = builder.computeGrammarHash();
+    builder.computeFirst();
+    builder.computeFollow(*t);
+    builder.buildCollection(*t);
+    builder.buildTable(*t);
+    return t;
+}
+
+std::shared_ptr<const SLRTables> SLRParser::loadTables() {
+#ifdef SLR_HAS_EMBEDDED_TABLE
+    SLRParser probe(nullptr);
+    auto t = std::make_shared<SLRTables>();
+    if (SLRTables::deserialize(kSLRTableData, sizeof(kSLRTableData), probe.computeGrammarHash(), *t)) {
+#ifdef SLR_VERIFY_TABLES
+        // Fallback check: the runtime construction must reproduce the cache
+        if (!(*buildTables() == *t)) {
+            throw std::runtime_error("embedded SLR table does not match the grammar");
+        }
+#endif
+        return t;
+    }
+    std::cerr << "Warning: embedded SLR table is stale, rebuilding at runtime" << std::endl;
+#endif
+    return buildTables();
+}
+
+std::shared_ptr<const SLRTables> SLRParser::sharedTables() {
+    static const std::shared_ptr<const SLRTables> cached = loadTables();
+    return cached;
+}
+
 void SLRParser::computeFirst() {
     for (auto& t : terminals) first[t].insert(t);
     bool changed = true;
@@ -179,7 +235,8 @@ void SLRParser::computeFirst() {
     }
 }
 
-void SLRParser::computeFollow() {
+void SLRParser::computeFollow(SLRTables& t) {
+    auto& follow = t.follow;
     follow["Program"].insert("$");
     bool changed = true;
     while (changed) {
@@ -248,7 +305,8 @@ std::set<Item> SLRParser::gotoState(std::set<Item> I, std::string X) {
     return closure(J);
 }
 
-void SLRParser::buildCollection() {
+void SLRParser::buildCollection(SLRTables& t) {
+    std::vector<std::pair<std::pair<int, std::string>, int>> gotoEdges;
     canonicalCollection.push_back(closure({{1, 0}}));
     bool changed = true;
     while (changed) {
@@ -274,13 +332,18 @@ void SLRParser::buildCollection() {
                     target = canonicalCollection.size() - 1;
                     changed = true;
                 }
-                if (nonTerminals.count(X)) gotoTable[{i, X}] = target;
+                if (nonTerminals.count(X)) gotoEdges.push_back({{(int)i, X}, target});
             }
         }
     }
+
+    // The state count is only known now, so the dense tables are sized here
+    t.reset(terminals, nonTerminals, canonicalCollection.size());
+    for (auto& e : gotoEdges) t.goTo(e.first.first, t.symbolId(e.first.second)) = e.second;
 }
 
-void SLRParser::buildTable() {
+void SLRParser::buildTable(SLRTables& t) {
+    auto& follow = t.follow;
     for (size_t i = 0; i < canonicalCollection.size(); i++) {
         for (auto& item : canonicalCollection[i]) {
             if (item.dotPos < (int)grammar[item.prodId - 1].rhs.size()) {
@@ -289,23 +352,22 @@ void SLRParser::buildTable() {
                     std::set<Item> nextI = gotoState(canonicalCollection[i], a);
                     for(size_t k=0; k<canonicalCollection.size(); k++) {
                         if(canonicalCollection[k] == nextI) {
-                            if(actionTable.count({i, a}) && actionTable[{i, a}].type == REDUCE) {
-                                // Keep shift (shift-reduce conflict resolution)
-                            }
-                            actionTable[{i, a}] = {SHIFT, (int)k};
+                            // Overwrites any reduce (shift-reduce conflict resolution)
+                            t.action(i, t.symbolId(a)) = {SHIFT, (int)k};
                             break;
                         }
                     }
                 }
             } else {
                 if (grammar[item.prodId - 1].lhs == "S'") {
-                    actionTable[{i, "$"}] = {ACC, 0};
+                    t.action(i, t.symbolId("$")) = {ACC, 0};
                 } else {
                     for (auto& f : follow[grammar[item.prodId - 1].lhs]) {
-                        if(actionTable.count({i, f}) && actionTable[{i, f}].type == SHIFT) {
+                        Action& cell = t.action(i, t.symbolId(f));
+                        if (cell.type == SHIFT) {
                             continue; // Shift-reduce: prefer shift
                         }
-                        actionTable[{i, f}] = {REDUCE, item.prodId};
+                        cell = {REDUCE, item.prodId};
                     }
                 }
             }
@@ -313,91 +375,249 @@ void SLRParser::buildTable() {
     }
 }
 
+void SLRParser::bindSymbols() {
+    tokenSymbol.assign(static_cast<int>(TokenType::ERROR) + 1, -1);
+    for (int type = 0; type < (int)tokenSymbol.size(); type++) {
+        tokenSymbol[type] = tables->symbolId(getTokenSymbol(static_cast<TokenType>(type)));
+    }
+    prodLhs.clear();
+    prodLen.clear();
+    for (auto& p : grammar) {
+        prodLhs.push_back(tables->symbolId(p.lhs));
+        prodLen.push_back(p.rhs[0] == "epsilon" ? 0 : (int)p.rhs.size());
+    }
+}
+
 bool SLRParser::parse(const std::vector<Token>& tokens) {
+    VectorTokenStream stream(tokens);
+    return parse(stream);
+}
+
+bool SLRParser::parse(TokenStream& tokens) {
     std::vector<int> stateStack = {0};
     std::vector<SemanticValue> valueStack;
+    arena = std::make_unique<ASTArena>();
+    astRoot = nullptr;
     
-    size_t ip = 0;
+    // One token of lookahead; an exhausted stream reads as end of input
+    const Token endOfInput(TokenType::END_OF_FILE, "$", 0, 0);
+    Token lookahead;
+    bool hasToken = tokens.next(lookahead);
+    size_t consumed = 0;                 // Tokens shifted or discarded so far
     hasError = false;
-    parseLog.str("");
-    parseLog.clear();
-    logStep = 1;
+    elementHash = kTokenHashBasis;
+    // The .spe trace ends at the first error; later errors only reach diag
+    ParseLogSink* log = parseLog;
+    
+    const int eofSym = tables->symbolId("$");
+    const Action errorAction;  // For tokens that are not grammar terminals
+    
+    // With --time-passes, semantic actions are timed as their own phase
+    const bool timing = Stats::enabled();
+    uint64_t reductions = 0;
+    uint64_t astNs = 0;
+    Stats::AllocCount astAlloc = {0, 0};
+    auto finish = [&](bool accepted) {
+        if (timing) {
+            Stats::count("reductions", reductions);
+            Stats::addTime("ast-build", astNs, reductions, astAlloc);
+        }
+        return accepted;
+    };
+    auto discard = [&]() {
+        hasToken = tokens.next(lookahead);
+        consumed++;
+    };
+    
+    // Panic-mode recovery: skip to a synchronizing ';' (consumed), '}' or '{'
+    // (kept), then unwind to a state that can take a stmt or decl followed by
+    // the lookahead and pretend one was just reduced. A '{' that no stmt can
+    // precede opens the body of a broken header such as "void main {": unwind
+    // to a state that can shift it after at most two inserted tokens, so the
+    // errors inside the body are still reported. False once input runs out.
+    const int semiSym = tables->symbolId(";");
+    const int lbraceSym = tables->symbolId("{");
+    const int rbraceSym = tables->symbolId("}");
+    size_t lastRecovery = static_cast<size_t>(-1);
+    // Depth-limited search for shifts that lead from state to one shifting '{'
+    auto reachesBrace = [&](auto& self, int state, int budget, std::vector<int>& path) -> bool {
+        if (tables->action(state, lbraceSym).type == SHIFT) return true;
+        if (budget == 0) return false;
+        for (int t = 0; t < tables->numTerminals; t++) {
+            if (t == lbraceSym || t == rbraceSym || t == eofSym) continue;
+            const Action& act = tables->action(state, t);
+            if (act.type != SHIFT) continue;
+            path.push_back(act.target);
+            if (self(self, act.target, budget - 1, path)) return true;
+            path.pop_back();
+        }
+        return false;
+    };
+    auto recover = [&]() {
+        if (consumed == lastRecovery) {
+            // The previous recovery made no progress; drop the offending token
+            if (!hasToken) return false;
+            discard();
+        }
+        while (true) {
+            // Braces opened inside a skipped group are skipped with it, so
+            // their '}' cannot close an enclosing block
+            int depth = 0;
+            while (hasToken) {
+                int a = tokenSymbol[static_cast<int>(lookahead.type)];
+                if (a == lbraceSym) {
+                    if (depth == 0) break;
+                    depth++;
+                } else if (a == rbraceSym) {
+                    if (depth == 0) break;
+                    if (--depth == 0) {
+                        discard();
+                        break;
+                    }
+                } else if (a == semiSym && depth == 0) {
+                    discard();
+                    break;
+                }
+                discard();
+            }
+            int a = hasToken ? tokenSymbol[static_cast<int>(lookahead.type)] : eofSym;
+            for (int i = static_cast<int>(stateStack.size()) - 1; i >= 0 && a >= 0; --i) {
+                const std::string& symbol = tables->symbols[a];
+                for (const char* sync : {"stmt", "decl"}) {
+                    auto follow = tables->follow.find(sync);
+                    if (follow == tables->follow.end() || !follow->second.count(symbol)) continue;
+                    int next = tables->goTo(stateStack[i], tables->symbolId(sync));
+                    if (next < 0 || tables->action(next, a).type == ERR) continue;
+                    stateStack.resize(i + 1);
+                    valueStack.resize(i);
+                    stateStack.push_back(next);
+                    valueStack.emplace_back();
+                    lastRecovery = consumed;
+                    return true;
+                }
+            }
+            for (int budget = 0; a == lbraceSym && budget <= 2; budget++) {
+                for (int i = static_cast<int>(stateStack.size()) - 1; i >= 0; --i) {
+                    std::vector<int> path;
+                    if (!reachesBrace(reachesBrace, stateStack[i], budget, path)) continue;
+                    stateStack.resize(i + 1);
+                    valueStack.resize(i);
+                    for (int next : path) {
+                        stateStack.push_back(next);
+                        valueStack.emplace_back();
+                    }
+                    lastRecovery = consumed;
+                    return true;
+                }
+            }
+            if (!hasToken) return false;
+            discard();
+        }
+    };
     
     while (true) {
         int s = stateStack.back();
-        std::string a;
-        if (ip >= tokens.size()) {
-            a = "$";
-        } else {
-            a = getTokenSymbol(tokens[ip]);
-        }
+        const Token& tok = hasToken ? lookahead : endOfInput;
+        int a = hasToken ? tokenSymbol[static_cast<int>(tok.type)] : eofSym;
         
-        if (actionTable.find({s, a}) == actionTable.end()) {
-            std::cerr << "Parse error at token: " << (ip < tokens.size() ? tokens[ip].value : "$") << std::endl;
-            parseLog << logStep++ << "\terror: unexpected '" 
-                     << (ip < tokens.size() ? tokens[ip].value : "$")
-                     << "' at state " << s << std::endl;
+        const Action& act = a < 0 ? errorAction : tables->action(s, a);
+        if (act.type == ERR) {
+            *diag << "Parse error at token: " << tok.value;
+            if (hasToken) *diag << " (line " << tok.line << ", column " << tok.column << ")";
+            *diag << std::endl;
+            if (log) {
+                log->error("unexpected '" + std::string(tok.value) + "' at state " + std::to_string(s));
+                log = nullptr;
+            }
             hasError = true;
-            return false;
+            if (!recover()) return finish(false);
+            continue;
         }
         
-        Action act = actionTable[{s, a}];
-        
         if (act.type == SHIFT) {
             stateStack.push_back(act.target);
-            SemanticValue val;
-            if (ip < tokens.size()) {
-                val.terminal = tokens[ip].value;
+            if (hasToken) {
+                elementHash = hashToken(elementHash, tok);
+                valueStack.emplace_back(tok.value);
+            } else {
+                valueStack.emplace_back();
             }
-            valueStack.push_back(val);
-            std::string tokenVal = (ip < tokens.size()) ? tokens[ip].value : "$";
-            parseLog << logStep++ << "\t" << a << "#" << tokenVal << "\tmove" << std::endl;
-            ip++;
+            if (log) log->shift(tables->symbols[a], tok.value);
+            discard();
         } else if (act.type == REDUCE) {
-            Production p = grammar[act.target - 1];
-            int len = p.rhs.size();
-            if (p.rhs[0] == "epsilon") len = 0;
-            
-            std::vector<SemanticValue> rhsValues;
-            for (int k = 0; k < len; k++) {
-                rhsValues.push_back(valueStack[valueStack.size() - len + k]);
-            }
+            const Production& p = grammar[act.target - 1];
+            int len = prodLen[act.target - 1];
             
-            for (int k = 0; k < len; k++) {
-                stateStack.pop_back();
-                valueStack.pop_back();
+            // After an error the values no longer match the productions, so
+            // only the state stack is kept up to date
+            SemanticValue result;
+            if (!hasError) {
+                uint64_t t0 = 0;
+                Stats::AllocCount a0 = {0, 0};
+                if (timing) {
+                    a0 = Stats::threadAllocs();
+                    t0 = Stats::nowNs();
+                }
+                result = reduce(act.target, valueStack.data() + valueStack.size() - len);
+                if (timing) {
+                    astNs += Stats::nowNs() - t0;
+                    Stats::AllocCount a1 = Stats::threadAllocs();
+                    astAlloc.allocs += a1.allocs - a0.allocs;
+                    astAlloc.bytes += a1.bytes - a0.bytes;
+                }
             }
-            
-            SemanticValue result = reduce(act.target, rhsValues);
-            if (shouldLogSymbol(p.lhs)) {
-                parseLog << logStep++ << "\t" << p.lhs << "#" << a << "\treduction" << std::endl;
+            reductions++;
+            stateStack.resize(stateStack.size() - len);
+            valueStack.erase(valueStack.end() - len, valueStack.end());
+            if (log && shouldLogSymbol(p.lhs)) {
+                log->reduce(p.lhs, tables->symbols[a]);
             }
             
             int t = stateStack.back();
-            if (gotoTable.find({t, p.lhs}) == gotoTable.end()) {
-                std::cerr << "Goto error" << std::endl;
-                parseLog << logStep++ << "\terror: goto failure on " << p.lhs << std::endl;
+            int next = tables->goTo(t, prodLhs[act.target - 1]);
+            if (next < 0) {
+                *diag << "Goto error" << std::endl;
+                if (log) log->error("goto failure on " + p.lhs);
                 hasError = true;
-                return false;
+                return finish(false);
             }
-            stateStack.push_back(gotoTable[{t, p.lhs}]);
-            valueStack.push_back(result);
+            stateStack.push_back(next);
+            valueStack.push_back(std::move(result));
         } else if (act.type == ACC) {
-            if (!valueStack.empty()) {
-                astRoot = valueStack.back().compUnit;
+            if (!hasError && !valueStack.empty()) {
+                astRoot = valueStack.back().node<CompUnitNode>();
             }
-            parseLog << logStep++ << "\tProgram#" << a << "\taccept" << std::endl;
-            return true;
+            if (log) log->accept(tables->symbols[a]);
+            return finish(!hasError);
         }
     }
 }
 
-void SLRParser::saveParseLog(const std::string& filepath) const {
-    std::ofstream out(filepath);
-    if (!out.is_open()) {
-        throw std::runtime_error("failed to open parse log file: " + filepath);
-    }
-    out << parseLog.str();
+// FNV-1a over the token type and spelling, so layout and comments do not
+// change the hash of a top-level element
+uint64_t SLRParser::hashToken(uint64_t h, const Token& tok) {
+    const uint64_t prime = 1099511628211ull;
+    h = (h ^ static_cast<uint8_t>(tok.type)) * prime;
+    for (char c : tok.value) {
+        h = (h ^ static_cast<uint8_t>(c)) * prime;
+    }
+    return (h ^ 0xff) * prime;
+}
+
+void StreamParseLog::shift(const std::string& symbol, std::string_view text) {
+    *out << step++ << '\t' << symbol << '#' << text << "\tmove\n";
+}
+
+void StreamParseLog::reduce(const std::string& lhs, const std::string& lookahead) {
+    *out << step++ << '\t' << lhs << '#' << lookahead << "\treduction\n";
+}
+
+void StreamParseLog::accept(const std::string& lookahead) {
+    *out << step++ << "\tProgram#" << lookahead << "\taccept\n";
+}
+
+void StreamParseLog::error(const std::string& message) {
+    *out << step++ << "\terror: " << message << '\n';
 }
 
 bool SLRParser::shouldLogSymbol(const std::string& symbol) const {
@@ -413,475 +633,480 @@ bool SLRParser::shouldLogSymbol(const std::string& symbol) const {
 }
 
 // Semantic actions - this is where AST is constructed
-SemanticValue SLRParser::reduce(int prodId, std::vector<SemanticValue>& vals) {
+SemanticValue SLRParser::reduce(int prodId, SemanticValue* vals) {
     SemanticValue result;
-    Production p = grammar[prodId - 1];
     
     // S' -> Program
     if (prodId == 1) {
-        result = vals[0];
+        result = std::move(vals[0]);
     }
     // Program -> compUnit
     else if (prodId == 2) {
-        result = vals[0];
+        result = std::move(vals[0]);
     }
     // compUnit -> compUnit element
     else if (prodId == 3) {
-        result = vals[0];
-        if (vals[1].decl) {
-            result.compUnit->decls.push_back(vals[1].decl);
-        } else if (vals[1].funcDef) {
-            result.compUnit->funcDefs.push_back(vals[1].funcDef);
+        result = std::move(vals[0]);
+        auto compUnit = result.node<CompUnitNode>();
+        auto element = vals[1].node<ASTNode>();
+        if (auto decl = dynamic_cast<DeclNode*>(element)) {
+            compUnit->decls.push_back(decl);
+        } else if (auto funcDef = dynamic_cast<FuncDefNode*>(element)) {
+            compUnit->funcDefs.push_back(funcDef);
         }
     }
     // compUnit -> element
     else if (prodId == 4) {
-        result.compUnit = std::make_shared<CompUnitNode>();
-        if (vals[0].decl) {
-            result.compUnit->decls.push_back(vals[0].decl);
-        } else if (vals[0].funcDef) {
-            result.compUnit->funcDefs.push_back(vals[0].funcDef);
+        auto compUnit = arena->make<CompUnitNode>();
+        auto element = vals[0].node<ASTNode>();
+        if (auto decl = dynamic_cast<DeclNode*>(element)) {
+            compUnit->decls.push_back(decl);
+        } else if (auto funcDef = dynamic_cast<FuncDefNode*>(element)) {
+            compUnit->funcDefs.push_back(funcDef);
         }
+        result = compUnit;
     }
     // element -> decl
+    // The lookahead is not shifted yet, so elementHash covers exactly this element
     else if (prodId == 5) {
-        result = vals[0];
+        result = std::move(vals[0]);
+        if (auto decl = result.node<DeclNode>()) decl->tokenHash = elementHash;
+        elementHash = kTokenHashBasis;
     }
     // element -> funcDef
     else if (prodId == 6) {
-        result = vals[0];
+        result = std::move(vals[0]);
+        if (auto funcDef = result.node<FuncDefNode>()) funcDef->tokenHash = elementHash;
+        elementHash = kTokenHashBasis;
     }
     // decl -> constDecl
     else if (prodId == 7) {
-        result.decl = vals[0].constDecl;
+        result = std::move(vals[0]);
     }
     // decl -> varDecl
     else if (prodId == 8) {
-        result.decl = vals[0].varDecl;
+        result = std::move(vals[0]);
     }
     // constDecl -> const bType constDefList ;
     else if (prodId == 9) {
-        result.constDecl = std::make_shared<ConstDeclNode>();
-        result.constDecl->bType = vals[1].bType;
-        result.constDecl->constDefs = vals[2].constDefList;
+        auto constDecl = arena->make<ConstDeclNode>();
+        constDecl->bType = vals[1].bType();
+        constDecl->constDefs = std::move(vals[2].list<ConstDefNode>());
+        result = constDecl;
     }
     // constDefList -> constDefList , constDef
     else if (prodId == 10) {
-        result.constDefList = vals[0].constDefList;
-        result.constDefList.push_back(vals[2].constDef);
+        result = std::move(vals[0]);
+        result.list<ConstDefNode>().push_back(vals[2].node<ConstDefNode>());
     }
     // constDefList -> constDef
     else if (prodId == 11) {
-        result.constDefList.push_back(vals[0].constDef);
+        result = std::vector<ConstDefNode*>{vals[0].node<ConstDefNode>()};
     }
     // bType -> int
     else if (prodId == 12) {
-        result.bType = BType::INT;
+        result = BType::INT;
     }
     // bType -> float
     else if (prodId == 13) {
-        result.bType = BType::FLOAT;
+        result = BType::FLOAT;
     }
     // constDef -> Ident = constInitVal
     else if (prodId == 14) {
-        result.constDef = std::make_shared<ConstDefNode>();
-        result.constDef->ident = vals[0].terminal;
-        result.constDef->initVal = vals[2].exp;
+        auto constDef = arena->make<ConstDefNode>();
+        constDef->ident = vals[0].terminal();
+        constDef->initVal = vals[2].node<ExpNode>();
+        result = constDef;
     }
     // constInitVal -> constExp
     else if (prodId == 15) {
-        result.exp = vals[0].exp;
+        result = std::move(vals[0]);
     }
     // varDecl -> bType varDefList ;
     else if (prodId == 16) {
-        result.varDecl = std::make_shared<VarDeclNode>();
-        result.varDecl->bType = vals[0].bType;
-        result.varDecl->varDefs = vals[1].varDefList;
+        auto varDecl = arena->make<VarDeclNode>();
+        varDecl->bType = vals[0].bType();
+        varDecl->varDefs = std::move(vals[1].list<VarDefNode>());
+        result = varDecl;
     }
     // varDefList -> varDefList , varDef
     else if (prodId == 17) {
-        result.varDefList = vals[0].varDefList;
-        result.varDefList.push_back(vals[2].varDef);
+        result = std::move(vals[0]);
+        result.list<VarDefNode>().push_back(vals[2].node<VarDefNode>());
     }
     // varDefList -> varDef
     else if (prodId == 18) {
-        result.varDefList.push_back(vals[0].varDef);
+        result = std::vector<VarDefNode*>{vals[0].node<VarDefNode>()};
     }
     // varDef -> Ident
     else if (prodId == 19) {
-        result.varDef = std::make_shared<VarDefNode>();
-        result.varDef->ident = vals[0].terminal;
+        auto varDef = arena->make<VarDefNode>();
+        varDef->ident = vals[0].terminal();
+        result = varDef;
     }
     // varDef -> Ident = initVal
     else if (prodId == 20) {
-        result.varDef = std::make_shared<VarDefNode>();
-        result.varDef->ident = vals[0].terminal;
-        result.varDef->initVal = vals[2].exp;
+        auto varDef = arena->make<VarDefNode>();
+        varDef->ident = vals[0].terminal();
+        varDef->initVal = vals[2].node<ExpNode>();
+        result = varDef;
     }
     // initVal -> exp
     else if (prodId == 21) {
-        result.exp = vals[0].exp;
+        result = std::move(vals[0]);
     }
     // funcDef -> funcType Ident ( ) block
     else if (prodId == 22) {
-        result.funcDef = std::make_shared<FuncDefNode>();
-        result.funcDef->returnType = BType::VOID;
-        result.funcDef->ident = vals[1].terminal;
-        result.funcDef->block = vals[4].block;
+        auto funcDef = arena->make<FuncDefNode>();
+        funcDef->returnType = BType::VOID;
+        funcDef->ident = vals[1].terminal();
+        funcDef->block = vals[4].node<BlockNode>();
+        result = funcDef;
     }
     // funcDef -> bType Ident ( ) block
     else if (prodId == 23) {
-        result.funcDef = std::make_shared<FuncDefNode>();
-        result.funcDef->returnType = vals[0].bType;
-        result.funcDef->ident = vals[1].terminal;
-        result.funcDef->block = vals[4].block;
+        auto funcDef = arena->make<FuncDefNode>();
+        funcDef->returnType = vals[0].bType();
+        funcDef->ident = vals[1].terminal();
+        funcDef->block = vals[4].node<BlockNode>();
+        result = funcDef;
     }
     // funcDef -> funcType Ident ( funcFParams ) block
     else if (prodId == 24) {
-        result.funcDef = std::make_shared<FuncDefNode>();
-        result.funcDef->returnType = BType::VOID;
-        result.funcDef->ident = vals[1].terminal;
-        result.funcDef->params = vals[3].funcFParams;
-        result.funcDef->block = vals[5].block;
+        auto funcDef = arena->make<FuncDefNode>();
+        funcDef->returnType = BType::VOID;
+        funcDef->ident = vals[1].terminal();
+        funcDef->params = std::move(vals[3].list<FuncFParamNode>());
+        funcDef->block = vals[5].node<BlockNode>();
+        result = funcDef;
     }
     // funcDef -> bType Ident ( funcFParams ) block
     else if (prodId == 25) {
-        result.funcDef = std::make_shared<FuncDefNode>();
-        result.funcDef->returnType = vals[0].bType;
-        result.funcDef->ident = vals[1].terminal;
-        result.funcDef->params = vals[3].funcFParams;
-        result.funcDef->block = vals[5].block;
+        auto funcDef = arena->make<FuncDefNode>();
+        funcDef->returnType = vals[0].bType();
+        funcDef->ident = vals[1].terminal();
+        funcDef->params = std::move(vals[3].list<FuncFParamNode>());
+        funcDef->block = vals[5].node<BlockNode>();
+        result = funcDef;
     }
     // funcType -> void
     else if (prodId == 26) {
-        result.bType = BType::VOID;
+        result = BType::VOID;
     }
     // funcFParams -> funcFParams , funcFParam
     else if (prodId == 27) {
-        result.funcFParams = vals[0].funcFParams;
-        result.funcFParams.push_back(vals[2].funcFParam);
+        result = std::move(vals[0]);
+        result.list<FuncFParamNode>().push_back(vals[2].node<FuncFParamNode>());
     }
     // funcFParams -> funcFParam
     else if (prodId == 28) {
-        result.funcFParams.push_back(vals[0].funcFParam);
+        result = std::vector<FuncFParamNode*>{vals[0].node<FuncFParamNode>()};
     }
     // funcFParam -> bType Ident
     else if (prodId == 29) {
-        result.funcFParam = std::make_shared<FuncFParamNode>();
-        result.funcFParam->bType = vals[0].bType;
-        result.funcFParam->ident = vals[1].terminal;
+        auto funcFParam = arena->make<FuncFParamNode>();
+        funcFParam->bType = vals[0].bType();
+        funcFParam->ident = vals[1].terminal();
+        result = funcFParam;
     }
     // block -> { blockItemList }
     else if (prodId == 30) {
-        result.block = std::make_shared<BlockNode>();
-        result.block->items = vals[1].blockItemList;
+        auto block = arena->make<BlockNode>();
+        block->items = std::move(vals[1].list<BlockItemNode>());
+        result = block;
     }
     // block -> { }
     else if (prodId == 31) {
-        result.block = std::make_shared<BlockNode>();
+        result = arena->make<BlockNode>();
     }
     // blockItemList -> blockItemList blockItem
     else if (prodId == 32) {
-        result.blockItemList = vals[0].blockItemList;
-        result.blockItemList.push_back(vals[1].blockItem);
+        result = std::move(vals[0]);
+        result.list<BlockItemNode>().push_back(vals[1].node<BlockItemNode>());
     }
     // blockItemList -> blockItem
     else if (prodId == 33) {
-        result.blockItemList.push_back(vals[0].blockItem);
+        result = std::vector<BlockItemNode*>{vals[0].node<BlockItemNode>()};
     }
     // blockItem -> decl
     else if (prodId == 34) {
-        result.blockItem = std::make_shared<BlockItemNode>();
-        result.blockItem->decl = vals[0].decl;
+        auto blockItem = arena->make<BlockItemNode>();
+        blockItem->decl = vals[0].node<DeclNode>();
+        result = blockItem;
     }
     // blockItem -> stmt
     else if (prodId == 35) {
-        result.blockItem = std::make_shared<BlockItemNode>();
-        result.blockItem->stmt = vals[0].stmt;
+        auto blockItem = arena->make<BlockItemNode>();
+        blockItem->stmt = vals[0].node<StmtNode>();
+        result = blockItem;
     }
     // stmt -> lVal = exp ;
     else if (prodId == 36) {
-        result.stmt = std::make_shared<StmtNode>();
-        result.stmt->stmtType = StmtType::ASSIGN;
-        result.stmt->lVal = vals[0].lVal;
-        result.stmt->exp = vals[2].exp;
+        auto stmt = arena->make<StmtNode>();
+        stmt->stmtType = StmtType::ASSIGN;
+        stmt->lVal = vals[0].node<LValNode>();
+        stmt->exp = vals[2].node<ExpNode>();
+        result = stmt;
     }
     // stmt -> exp ;
     else if (prodId == 37) {
-        result.stmt = std::make_shared<StmtNode>();
-        result.stmt->stmtType = StmtType::EXP;
-        result.stmt->exp = vals[0].exp;
+        auto stmt = arena->make<StmtNode>();
+        stmt->stmtType = StmtType::EXP;
+        stmt->exp = vals[0].node<ExpNode>();
+        result = stmt;
     }
     // stmt -> ;
     else if (prodId == 38) {
-        result.stmt = std::make_shared<StmtNode>();
-        result.stmt->stmtType = StmtType::EXP;
+        auto stmt = arena->make<StmtNode>();
+        stmt->stmtType = StmtType::EXP;
+        result = stmt;
     }
     // stmt -> block
     else if (prodId == 39) {
-        result.stmt = std::make_shared<StmtNode>();
-        result.stmt->stmtType = StmtType::BLOCK;
-        result.stmt->block = vals[0].block;
+        auto stmt = arena->make<StmtNode>();
+        stmt->stmtType = StmtType::BLOCK;
+        stmt->block = vals[0].node<BlockNode>();
+        result = stmt;
     }
     // stmt -> if ( cond ) stmt ElsePart
     else if (prodId == 40) {
-        result.stmt = std::make_shared<StmtNode>();
-        result.stmt->stmtType = StmtType::IF;
-        result.stmt->cond = vals[2].cond;
-        result.stmt->thenStmt = vals[4].stmt;
-        result.stmt->elseStmt = vals[5].stmt;
+        auto stmt = arena->make<StmtNode>();
+        stmt->stmtType = StmtType::IF;
+        stmt->cond = vals[2].node<CondNode>();
+        stmt->thenStmt = vals[4].node<StmtNode>();
+        stmt->elseStmt = vals[5].node<StmtNode>();
+        result = stmt;
     }
     // stmt -> return exp ;
     else if (prodId == 41) {
-        result.stmt = std::make_shared<StmtNode>();
-        result.stmt->stmtType = StmtType::RETURN;
-        result.stmt->exp = vals[1].exp;
+        auto stmt = arena->make<StmtNode>();
+        stmt->stmtType = StmtType::RETURN;
+        stmt->exp = vals[1].node<ExpNode>();
+        result = stmt;
     }
     // stmt -> return ;
     else if (prodId == 42) {
-        result.stmt = std::make_shared<StmtNode>();
-        result.stmt->stmtType = StmtType::RETURN;
+        auto stmt = arena->make<StmtNode>();
+        stmt->stmtType = StmtType::RETURN;
+        result = stmt;
     }
     // ElsePart -> else stmt
     else if (prodId == 43) {
-        result.stmt = vals[1].stmt;
+        result = std::move(vals[1]);
     }
     // ElsePart -> epsilon
     else if (prodId == 44) {
-        result.stmt = nullptr;
+        result = static_cast<ASTNode*>(nullptr);
     }
     // lVal -> Ident
     else if (prodId == 45) {
-        result.lVal = std::make_shared<LValNode>();
-        result.lVal->ident = vals[0].terminal;
+        auto lVal = arena->make<LValNode>();
+        lVal->ident = vals[0].terminal();
+        result = lVal;
     }
     // exp -> lOrExp
     else if (prodId == 46) {
-        result.exp = std::make_shared<AddExpNode>();
-        result.exp->left = nullptr;
-        auto mulExp = std::make_shared<MulExpNode>();
+        auto exp = arena->make<AddExpNode>();
+        exp->left = nullptr;
+        auto mulExp = arena->make<MulExpNode>();
         mulExp->left = nullptr;
-        auto unaryExp = std::make_shared<UnaryExpNode>();
+        auto unaryExp = arena->make<UnaryExpNode>();
         unaryExp->unaryType = UnaryExpNode::UnaryType::PRIMARY;
-        auto primaryExp = std::make_shared<PrimaryExpNode>();
+        auto primaryExp = arena->make<PrimaryExpNode>();
         primaryExp->primaryType = PrimaryExpNode::PrimaryType::PAREN_EXP;
-        primaryExp->exp = vals[0].lOrExp;
+        primaryExp->exp = vals[0].node<LOrExpNode>();
         unaryExp->primaryExp = primaryExp;
         mulExp->right = unaryExp;
-        result.exp->right = mulExp;
+        exp->right = mulExp;
+        result = exp;
     }
     // lOrExp -> lAndExp
     else if (prodId == 47) {
-        result.lOrExp = std::make_shared<LOrExpNode>();
-        result.lOrExp->left = nullptr;
-        result.lOrExp->right = vals[0].lAndExp;
+        auto lOrExp = arena->make<LOrExpNode>();
+        lOrExp->left = nullptr;
+        lOrExp->right = vals[0].node<LAndExpNode>();
+        result = lOrExp;
     }
     // lOrExp -> lOrExp || lAndExp
     else if (prodId == 48) {
-        result.lOrExp = std::make_shared<LOrExpNode>();
-        result.lOrExp->left = vals[0].lOrExp;
-        result.lOrExp->right = vals[2].lAndExp;
+        auto lOrExp = arena->make<LOrExpNode>();
+        lOrExp->left = vals[0].node<LOrExpNode>();
+        lOrExp->right = vals[2].node<LAndExpNode>();
+        result = lOrExp;
     }
     // lAndExp -> eqExp
     else if (prodId == 49) {
-        result.lAndExp = std::make_shared<LAndExpNode>();
-        result.lAndExp->left = nullptr;
-        result.lAndExp->right = vals[0].eqExp;
+        auto lAndExp = arena->make<LAndExpNode>();
+        lAndExp->left = nullptr;
+        lAndExp->right = vals[0].node<EqExpNode>();
+        result = lAndExp;
     }
     // lAndExp -> lAndExp && eqExp
     else if (prodId == 50) {
-        result.lAndExp = std::make_shared<LAndExpNode>();
-        result.lAndExp->left = vals[0].lAndExp;
-        result.lAndExp->right = vals[2].eqExp;
+        auto lAndExp = arena->make<LAndExpNode>();
+        lAndExp->left = vals[0].node<LAndExpNode>();
+        lAndExp->right = vals[2].node<EqExpNode>();
+        result = lAndExp;
     }
     // eqExp -> relExp
     else if (prodId == 51) {
-        result.eqExp = std::make_shared<EqExpNode>();
-        result.eqExp->left = nullptr;
-        result.eqExp->right = vals[0].relExp;
+        auto eqExp = arena->make<EqExpNode>();
+        eqExp->left = nullptr;
+        eqExp->right = vals[0].node<RelExpNode>();
+        result = eqExp;
     }
     // eqExp -> eqExp == relExp
-    else if (prodId == 52) {
-        result.eqExp = std::make_shared<EqExpNode>();
-        result.eqExp->left = vals[0].eqExp;
-        result.eqExp->op = EqOp::EQ;
-        result.eqExp->right = vals[2].relExp;
-    }
     // eqExp -> eqExp != relExp
-    else if (prodId == 53) {
-        result.eqExp = std::make_shared<EqExpNode>();
-        result.eqExp->left = vals[0].eqExp;
-        result.eqExp->op = EqOp::NE;
-        result.eqExp->right = vals[2].relExp;
+    else if (prodId == 52 || prodId == 53) {
+        auto eqExp = arena->make<EqExpNode>();
+        eqExp->left = vals[0].node<EqExpNode>();
+        eqExp->op = prodId == 52 ? EqOp::EQ : EqOp::NE;
+        eqExp->right = vals[2].node<RelExpNode>();
+        result = eqExp;
     }
     // relExp -> addExp
     else if (prodId == 54) {
-        result.relExp = std::make_shared<RelExpNode>();
-        result.relExp->left = nullptr;
-        result.relExp->right = vals[0].addExp;
-    }
-    // relExp -> relExp < addExp
-    else if (prodId == 55) {
-        result.relExp = std::make_shared<RelExpNode>();
-        result.relExp->left = vals[0].relExp;
-        result.relExp->op = RelOp::LT;
-        result.relExp->right = vals[2].addExp;
-    }
-    // relExp -> relExp > addExp
-    else if (prodId == 56) {
-        result.relExp = std::make_shared<RelExpNode>();
-        result.relExp->left = vals[0].relExp;
-        result.relExp->op = RelOp::GT;
-        result.relExp->right = vals[2].addExp;
-    }
-    // relExp -> relExp <= addExp
-    else if (prodId == 57) {
-        result.relExp = std::make_shared<RelExpNode>();
-        result.relExp->left = vals[0].relExp;
-        result.relExp->op = RelOp::LE;
-        result.relExp->right = vals[2].addExp;
-    }
-    // relExp -> relExp >= addExp
-    else if (prodId == 58) {
-        result.relExp = std::make_shared<RelExpNode>();
-        result.relExp->left = vals[0].relExp;
-        result.relExp->op = RelOp::GE;
-        result.relExp->right = vals[2].addExp;
+        auto relExp = arena->make<RelExpNode>();
+        relExp->left = nullptr;
+        relExp->right = vals[0].node<AddExpNode>();
+        result = relExp;
+    }
+    // relExp -> relExp < addExp | relExp > addExp | relExp <= addExp | relExp >= addExp
+    else if (prodId >= 55 && prodId <= 58) {
+        static const RelOp ops[] = {RelOp::LT, RelOp::GT, RelOp::LE, RelOp::GE};
+        auto relExp = arena->make<RelExpNode>();
+        relExp->left = vals[0].node<RelExpNode>();
+        relExp->op = ops[prodId - 55];
+        relExp->right = vals[2].node<AddExpNode>();
+        result = relExp;
     }
     // addExp -> mulExp
     else if (prodId == 59) {
-        result.addExp = std::make_shared<AddExpNode>();
-        result.addExp->left = nullptr;
-        result.addExp->right = vals[0].mulExp;
-    }
-    // addExp -> addExp + mulExp
-    else if (prodId == 60) {
-        result.addExp = std::make_shared<AddExpNode>();
-        result.addExp->left = vals[0].addExp;
-        result.addExp->op = BinaryOp::ADD;
-        result.addExp->right = vals[2].mulExp;
-    }
-    // addExp -> addExp - mulExp
-    else if (prodId == 61) {
-        result.addExp = std::make_shared<AddExpNode>();
-        result.addExp->left = vals[0].addExp;
-        result.addExp->op = BinaryOp::SUB;
-        result.addExp->right = vals[2].mulExp;
+        auto addExp = arena->make<AddExpNode>();
+        addExp->left = nullptr;
+        addExp->right = vals[0].node<MulExpNode>();
+        result = addExp;
+    }
+    // addExp -> addExp + mulExp | addExp - mulExp
+    else if (prodId == 60 || prodId == 61) {
+        auto addExp = arena->make<AddExpNode>();
+        addExp->left = vals[0].node<AddExpNode>();
+        addExp->op = prodId == 60 ? BinaryOp::ADD : BinaryOp::SUB;
+        addExp->right = vals[2].node<MulExpNode>();
+        result = addExp;
     }
     // mulExp -> unaryExp
     else if (prodId == 62) {
-        result.mulExp = std::make_shared<MulExpNode>();
-        result.mulExp->left = nullptr;
-        result.mulExp->right = vals[0].unaryExp;
-    }
-    // mulExp -> mulExp * unaryExp
-    else if (prodId == 63) {
-        result.mulExp = std::make_shared<MulExpNode>();
-        result.mulExp->left = vals[0].mulExp;
-        result.mulExp->op = BinaryOp::MUL;
-        result.mulExp->right = vals[2].unaryExp;
-    }
-    // mulExp -> mulExp / unaryExp
-    else if (prodId == 64) {
-        result.mulExp = std::make_shared<MulExpNode>();
-        result.mulExp->left = vals[0].mulExp;
-        result.mulExp->op = BinaryOp::DIV;
-        result.mulExp->right = vals[2].unaryExp;
-    }
-    // mulExp -> mulExp % unaryExp
-    else if (prodId == 65) {
-        result.mulExp = std::make_shared<MulExpNode>();
-        result.mulExp->left = vals[0].mulExp;
-        result.mulExp->op = BinaryOp::MOD;
-        result.mulExp->right = vals[2].unaryExp;
+        auto mulExp = arena->make<MulExpNode>();
+        mulExp->left = nullptr;
+        mulExp->right = vals[0].node<UnaryExpNode>();
+        result = mulExp;
+    }
+    // mulExp -> mulExp * unaryExp | mulExp / unaryExp | mulExp % unaryExp
+    else if (prodId >= 63 && prodId <= 65) {
+        static const BinaryOp ops[] = {BinaryOp::MUL, BinaryOp::DIV, BinaryOp::MOD};
+        auto mulExp = arena->make<MulExpNode>();
+        mulExp->left = vals[0].node<MulExpNode>();
+        mulExp->op = ops[prodId - 63];
+        mulExp->right = vals[2].node<UnaryExpNode>();
+        result = mulExp;
     }
     // unaryExp -> primaryExp
     else if (prodId == 66) {
-        result.unaryExp = std::make_shared<UnaryExpNode>();
-        result.unaryExp->unaryType = UnaryExpNode::UnaryType::PRIMARY;
-        result.unaryExp->primaryExp = vals[0].primaryExp;
+        auto unaryExp = arena->make<UnaryExpNode>();
+        unaryExp->unaryType = UnaryExpNode::UnaryType::PRIMARY;
+        unaryExp->primaryExp = vals[0].node<PrimaryExpNode>();
+        result = unaryExp;
     }
     // unaryExp -> unaryOp unaryExp
     else if (prodId == 67) {
-        result.unaryExp = std::make_shared<UnaryExpNode>();
-        result.unaryExp->unaryType = UnaryExpNode::UnaryType::UNARY_OP;
-        result.unaryExp->unaryOp = vals[0].unaryOp;
-        result.unaryExp->unaryExp = vals[1].unaryExp;
+        auto unaryExp = arena->make<UnaryExpNode>();
+        unaryExp->unaryType = UnaryExpNode::UnaryType::UNARY_OP;
+        unaryExp->unaryOp = vals[0].unaryOp();
+        unaryExp->unaryExp = vals[1].node<UnaryExpNode>();
+        result = unaryExp;
     }
     // unaryExp -> Ident ( )
     else if (prodId == 68) {
-        result.unaryExp = std::make_shared<UnaryExpNode>();
-        result.unaryExp->unaryType = UnaryExpNode::UnaryType::FUNC_CALL;
-        result.unaryExp->funcName = vals[0].terminal;
+        auto unaryExp = arena->make<UnaryExpNode>();
+        unaryExp->unaryType = UnaryExpNode::UnaryType::FUNC_CALL;
+        unaryExp->funcName = vals[0].terminal();
+        result = unaryExp;
     }
     // unaryExp -> Ident ( funcRParams )
     else if (prodId == 69) {
-        result.unaryExp = std::make_shared<UnaryExpNode>();
-        result.unaryExp->unaryType = UnaryExpNode::UnaryType::FUNC_CALL;
-        result.unaryExp->funcName = vals[0].terminal;
-        result.unaryExp->args = vals[2].funcRParams;
+        auto unaryExp = arena->make<UnaryExpNode>();
+        unaryExp->unaryType = UnaryExpNode::UnaryType::FUNC_CALL;
+        unaryExp->funcName = vals[0].terminal();
+        unaryExp->args = std::move(vals[2].list<ExpNode>());
+        result = unaryExp;
     }
     // primaryExp -> ( exp )
     else if (prodId == 70) {
-        result.primaryExp = std::make_shared<PrimaryExpNode>();
-        result.primaryExp->primaryType = PrimaryExpNode::PrimaryType::PAREN_EXP;
-        result.primaryExp->exp = vals[1].exp;
+        auto primaryExp = arena->make<PrimaryExpNode>();
+        primaryExp->primaryType = PrimaryExpNode::PrimaryType::PAREN_EXP;
+        primaryExp->exp = vals[1].node<ExpNode>();
+        result = primaryExp;
     }
     // primaryExp -> lVal
     else if (prodId == 71) {
-        result.primaryExp = std::make_shared<PrimaryExpNode>();
-        result.primaryExp->primaryType = PrimaryExpNode::PrimaryType::LVAL;
-        result.primaryExp->lVal = vals[0].lVal;
+        auto primaryExp = arena->make<PrimaryExpNode>();
+        primaryExp->primaryType = PrimaryExpNode::PrimaryType::LVAL;
+        primaryExp->lVal = vals[0].node<LValNode>();
+        result = primaryExp;
     }
     // primaryExp -> number
     else if (prodId == 72) {
-        result.primaryExp = std::make_shared<PrimaryExpNode>();
-        result.primaryExp->primaryType = PrimaryExpNode::PrimaryType::NUMBER;
-        result.primaryExp->number = vals[0].number;
+        auto primaryExp = arena->make<PrimaryExpNode>();
+        primaryExp->primaryType = PrimaryExpNode::PrimaryType::NUMBER;
+        primaryExp->number = vals[0].node<NumberNode>();
+        result = primaryExp;
     }
     // number -> IntConst
     else if (prodId == 73) {
-        result.number = std::make_shared<NumberNode>();
-        result.number->isFloat = false;
-        result.number->intVal = std::stoi(vals[0].terminal);
+        auto number = arena->make<NumberNode>();
+        number->isFloat = false;
+        number->intVal = std::stoi(std::string(vals[0].terminal()));
+        result = number;
     }
     // number -> floatConst
     else if (prodId == 74) {
-        result.number = std::make_shared<NumberNode>();
-        result.number->isFloat = true;
-        result.number->floatVal = std::stof(vals[0].terminal);
+        auto number = arena->make<NumberNode>();
+        number->isFloat = true;
+        number->floatVal = std::stof(std::string(vals[0].terminal()));
+        result = number;
     }
     // unaryOp -> +
     else if (prodId == 75) {
-        result.unaryOp = UnaryOp::PLUS;
+        result = UnaryOp::PLUS;
     }
     // unaryOp -> -
     else if (prodId == 76) {
-        result.unaryOp = UnaryOp::MINUS;
+        result = UnaryOp::MINUS;
     }
     // unaryOp -> !
     else if (prodId == 77) {
-        result.unaryOp = UnaryOp::NOT;
+        result = UnaryOp::NOT;
     }
     // funcRParams -> exp , funcRParams
     else if (prodId == 78) {
-        result.funcRParams.push_back(vals[0].exp);
-        for (auto& arg : vals[2].funcRParams) {
-            result.funcRParams.push_back(arg);
-        }
+        auto& rest = vals[2].list<ExpNode>();
+        rest.insert(rest.begin(), vals[0].node<ExpNode>());
+        result = std::move(vals[2]);
     }
     // funcRParams -> exp
     else if (prodId == 79) {
-        result.funcRParams.push_back(vals[0].exp);
+        result = std::vector<ExpNode*>{vals[0].node<ExpNode>()};
     }
     // constExp -> addExp
     else if (prodId == 80) {
-        result.exp = vals[0].addExp;
+        result = std::move(vals[0]);
     }
     // cond -> lOrExp
     else if (prodId == 81) {
-        result.cond = std::make_shared<CondNode>();
-        result.cond->lOrExp = vals[0].lOrExp;
+        auto cond = arena->make<CondNode>();
+        cond->lOrExp = vals[0].node<LOrExpNode>();
+        result = cond;
     }
     
     return result;
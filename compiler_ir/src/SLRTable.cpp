@@ -0,0 +1,205 @@
+/*!
+ * @file SLRTable.cpp
+ * @brief Binary (de)serialization of precomputed SLR tables
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "SLRTable.h"
+
+namespace {
+
+class Writer {
+public:
+    std::vector<unsigned char> buf;
+
+    void u8(uint8_t v) { buf.push_back(v); }
+    void u16(uint16_t v) {
+        u8(v & 0xff);
+        u8(v >> 8);
+    }
+    void u32(uint32_t v) {
+        u16(v & 0xffff);
+        u16(v >> 16);
+    }
+    void str(const std::string& s) {
+        u16(static_cast<uint16_t>(s.size()));
+        buf.insert(buf.end(), s.begin(), s.end());
+    }
+};
+
+class Reader {
+public:
+    Reader(const unsigned char* data, size_t size) : p(data), end(data + size) {}
+
+    bool ok() const { return good; }
+
+    uint8_t u8() {
+        if (p >= end) {
+            good = false;
+            return 0;
+        }
+        return *p++;
+    }
+    uint16_t u16() {
+        uint16_t lo = u8();
+        return lo | static_cast<uint16_t>(u8() << 8);
+    }
+    uint32_t u32() {
+        uint32_t lo = u16();
+        return lo | (static_cast<uint32_t>(u16()) << 16);
+    }
+    std::string str() {
+        uint16_t len = u16();
+        if (static_cast<size_t>(end - p) < len) {
+            good = false;
+            return "";
+        }
+        std::string s(reinterpret_cast<const char*>(p), len);
+        p += len;
+        return s;
+    }
+
+private:
+    const unsigned char* p;
+    const unsigned char* end;
+    bool good = true;
+};
+
+} // namespace
+
+void SLRTables::allocate() {
+    ids.clear();
+    for (size_t i = 0; i < symbols.size(); i++) ids[symbols[i]] = static_cast<int>(i);
+    actionCells.assign(static_cast<size_t>(numStates) * numTerminals, Action());
+    gotoCells.assign(static_cast<size_t>(numStates) * numNonTerminals(), -1);
+}
+
+void SLRTables::reset(const std::set<std::string>& terminals,
+                      const std::set<std::string>& nonTerminals, int nStates) {
+    symbols.assign(terminals.begin(), terminals.end());
+    symbols.insert(symbols.end(), nonTerminals.begin(), nonTerminals.end());
+    numTerminals = static_cast<int>(terminals.size());
+    numStates = nStates;
+    allocate();
+}
+
+int SLRTables::symbolId(const std::string& name) const {
+    auto it = ids.find(name);
+    return it == ids.end() ? -1 : it->second;
+}
+
+std::vector<unsigned char> SLRTables::serialize() const {
+    Writer w;
+    w.u8('S');
+    w.u8('L');
+    w.u8('R');
+    w.u8('T');
+    w.u32(kVersion);
+    w.u32(grammarHash);
+
+    w.u32(static_cast<uint32_t>(symbols.size()));
+    for (auto& s : symbols) w.str(s);
+    w.u32(static_cast<uint32_t>(numTerminals));
+    w.u32(static_cast<uint32_t>(numStates));
+
+    uint32_t nAction = 0;
+    for (auto& a : actionCells) nAction += a.type != ERR;
+    w.u32(nAction);
+    for (int s = 0; s < numStates; s++) {
+        for (int a = 0; a < numTerminals; a++) {
+            const Action& act = action(s, a);
+            if (act.type == ERR) continue;
+            w.u32(static_cast<uint32_t>(s));
+            w.u16(static_cast<uint16_t>(a));
+            w.u8(static_cast<uint8_t>(act.type));
+            w.u32(static_cast<uint32_t>(act.target));
+        }
+    }
+
+    uint32_t nGoto = 0;
+    for (int g : gotoCells) nGoto += g >= 0;
+    w.u32(nGoto);
+    for (int s = 0; s < numStates; s++) {
+        for (int A = numTerminals; A < static_cast<int>(symbols.size()); A++) {
+            if (goTo(s, A) < 0) continue;
+            w.u32(static_cast<uint32_t>(s));
+            w.u16(static_cast<uint16_t>(A));
+            w.u32(static_cast<uint32_t>(goTo(s, A)));
+        }
+    }
+
+    w.u32(static_cast<uint32_t>(follow.size()));
+    for (auto& kv : follow) {
+        w.u16(static_cast<uint16_t>(symbolId(kv.first)));
+        w.u16(static_cast<uint16_t>(kv.second.size()));
+        for (auto& s : kv.second) w.u16(static_cast<uint16_t>(symbolId(s)));
+    }
+    return w.buf;
+}
+
+bool SLRTables::deserialize(const unsigned char* data, size_t size,
+                            uint32_t expectedGrammarHash, SLRTables& out) {
+    Reader r(data, size);
+    if (r.u8() != 'S' || r.u8() != 'L' || r.u8() != 'R' || r.u8() != 'T') return false;
+    if (r.u32() != kVersion) return false;
+    if (r.u32() != expectedGrammarHash) return false;
+
+    SLRTables t;
+    t.grammarHash = expectedGrammarHash;
+
+    uint32_t nSymbols = r.u32();
+    if (nSymbols > size) return false;
+    t.symbols.resize(nSymbols);
+    for (auto& s : t.symbols) s = r.str();
+    uint32_t nTerminals = r.u32();
+    uint32_t nStates = r.u32();
+    if (!r.ok() || nTerminals > nSymbols || nStates > size) return false;
+    t.numTerminals = static_cast<int>(nTerminals);
+    t.numStates = static_cast<int>(nStates);
+    t.allocate();
+
+    uint32_t nAction = r.u32();
+    for (uint32_t i = 0; i < nAction && r.ok(); i++) {
+        uint32_t state = r.u32();
+        uint16_t sym = r.u16();
+        uint8_t type = r.u8();
+        int target = static_cast<int>(r.u32());
+        if (state >= nStates || sym >= nTerminals || type >= ERR) return false;
+        if (type == SHIFT && static_cast<uint32_t>(target) >= nStates) return false;
+        t.action(state, sym) = {static_cast<ActionType>(type), target};
+    }
+
+    uint32_t nGoto = r.u32();
+    for (uint32_t i = 0; i < nGoto && r.ok(); i++) {
+        uint32_t state = r.u32();
+        uint16_t sym = r.u16();
+        uint32_t target = r.u32();
+        if (state >= nStates || sym < nTerminals || sym >= nSymbols || target >= nStates) return false;
+        t.goTo(state, sym) = static_cast<int>(target);
+    }
+
+    uint32_t nFollow = r.u32();
+    for (uint32_t i = 0; i < nFollow && r.ok(); i++) {
+        uint16_t nt = r.u16();
+        uint16_t n = r.u16();
+        if (nt >= nSymbols) return false;
+        auto& set = t.follow[t.symbols[nt]];
+        for (uint16_t k = 0; k < n; k++) {
+            uint16_t s = r.u16();
+            if (s >= nSymbols) return false;
+            set.insert(t.symbols[s]);
+        }
+    }
+
+    if (!r.ok()) return false;
+    out = std::move(t);
+    return true;
+}
+
+bool SLRTables::operator==(const SLRTables& other) const {
+    return grammarHash == other.grammarHash && symbols == other.symbols &&
+           numTerminals == other.numTerminals && numStates == other.numStates &&
+           follow == other.follow && actionCells == other.actionCells &&
+           gotoCells == other.gotoCells;
+}
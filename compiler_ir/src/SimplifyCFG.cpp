@@ -0,0 +1,290 @@
+/*!
+ * @file SimplifyCFG.cpp
+ * @brief 控制流图化简实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "SimplifyCFG.h"
+#include "BasicBlock.h"
+#include "Constant.h"
+#include "Function.h"
+#include "Instruction.h"
+#include "Module.h"
+#include "Stats.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+/// 只删除一次出现（两个基本块之间可以有两条边）
+void erase_one(std::list<BasicBlock *> &bbs, BasicBlock *bb) {
+    auto it = std::find(bbs.begin(), bbs.end(), bb);
+    if (it != bbs.end()) {
+        bbs.erase(it);
+    }
+}
+
+bool contains(std::list<BasicBlock *> &bbs, BasicBlock *bb) {
+    return std::find(bbs.begin(), bbs.end(), bb) != bbs.end();
+}
+
+std::vector<PhiInst *> get_phis(BasicBlock *bb) {
+    std::vector<PhiInst *> phis;
+    for (auto instr: bb->get_instructions()) {
+        if (!instr->is_phi()) {
+            break;
+        }
+        phis.push_back(static_cast<PhiInst *>(instr));
+    }
+    return phis;
+}
+
+/// 删除边 from -> to；from 不再是前驱时去掉 to 中phi的对应来源
+void remove_edge(BasicBlock *from, BasicBlock *to) {
+    erase_one(from->get_succ_basic_blocks(), to);
+    erase_one(to->get_pre_basic_blocks(), from);
+    if (!contains(to->get_pre_basic_blocks(), from)) {
+        for (auto phi: get_phis(to)) {
+            phi->remove_source(from);
+        }
+    }
+}
+
+/// 删除指令；若仍有使用者（只可能在不可达代码中），先换成零值
+void drop_instr(Instruction *instr) {
+    if (!instr->get_use_list().empty() && !instr->get_type()->is_void_type()) {
+        instr->replace_all_use_with(ConstantZero::get(instr->get_type(), instr->get_module()));
+    }
+    instr->get_parent()->delete_instr(instr);
+}
+
+/// 只改写跳转与phi中对基本块的引用；Value::replace_all_use_with 还会改动前驱/后继链，这里由调用者自行维护
+void replace_block_uses(BasicBlock *from, BasicBlock *to) {
+    std::vector<std::pair<User *, unsigned>> uses;
+    for (auto &use: from->get_use_list()) {
+        uses.emplace_back(static_cast<User *>(use.val_), use.arg_no_);
+    }
+    for (auto &[user, arg_no]: uses) {
+        user->set_operand(arg_no, to);
+    }
+}
+
+std::vector<BasicBlock *> branch_targets(Instruction *br) {
+    std::vector<BasicBlock *> targets;
+    for (auto op: br->get_operands()) {
+        if (auto bb = dynamic_cast<BasicBlock *>(op)) {
+            targets.push_back(bb);
+        }
+    }
+    return targets;
+}
+
+bool truncate_after_terminator(Function *f) {
+    bool changed = false;
+    for (auto bb: f->get_basic_blocks()) {
+        auto &instrs = bb->get_instructions();
+        auto it = instrs.begin();
+        while (it != instrs.end() && !(*it)->isTerminator()) {
+            ++it;
+        }
+        if (it == instrs.end() || *it == instrs.back()) {
+            continue;
+        }
+        std::vector<Instruction *> dead;
+        for (++it; it != instrs.end(); ++it) {
+            dead.push_back(*it);
+        }
+        for (auto r = dead.rbegin(); r != dead.rend(); ++r) {
+            if ((*r)->is_br()) {
+                for (auto target: branch_targets(*r)) {
+                    remove_edge(bb, target);
+                }
+            }
+            drop_instr(*r);
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+bool fold_branches(Function *f) {
+    bool changed = false;
+    for (auto bb: f->get_basic_blocks()) {
+        auto br = dynamic_cast<BranchInst *>(bb->get_terminator());
+        if (br == nullptr || !br->is_cond_br()) {
+            continue;
+        }
+        BasicBlock *if_true = br->getTrueBB();
+        BasicBlock *if_false = br->getFalseBB();
+        auto cond = dynamic_cast<ConstantInt *>(br->get_condition());
+        if (cond == nullptr && if_true != if_false) {
+            continue;
+        }
+        BasicBlock *keep = (cond == nullptr || cond->get_value() != 0) ? if_true : if_false;
+        BasicBlock *drop = keep == if_true ? if_false : if_true;
+
+        for (auto target: {if_true, if_false}) {
+            erase_one(bb->get_succ_basic_blocks(), target);
+            erase_one(target->get_pre_basic_blocks(), bb);
+        }
+        bb->delete_instr(br);
+        BranchInst::create_br(keep, bb);
+        if (drop != keep) {
+            if (!contains(drop->get_pre_basic_blocks(), bb)) {
+                for (auto phi: get_phis(drop)) {
+                    phi->remove_source(bb);
+                }
+            }
+        } else {
+            // 两条边合成一条，phi中同一前驱只保留第一个来源
+            for (auto phi: get_phis(keep)) {
+                bool seen = false;
+                for (int i = 1; i < (int) phi->get_num_operand(); i += 2) {
+                    if (phi->get_operand(i) != bb) {
+                        continue;
+                    }
+                    if (seen) {
+                        phi->remove_operands(i - 1, i);
+                        i -= 2;
+                    }
+                    seen = true;
+                }
+            }
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+bool remove_unreachable(Function *f) {
+    auto &bbs = f->get_basic_blocks();
+    std::unordered_set<BasicBlock *> reachable;
+    std::vector<BasicBlock *> stack{bbs.front()};
+    reachable.insert(bbs.front());
+    while (!stack.empty()) {
+        BasicBlock *bb = stack.back();
+        stack.pop_back();
+        for (auto succ: bb->get_succ_basic_blocks()) {
+            if (reachable.insert(succ).second) {
+                stack.push_back(succ);
+            }
+        }
+    }
+    if (reachable.size() == bbs.size()) {
+        return false;
+    }
+    std::vector<BasicBlock *> dead;
+    for (auto bb: bbs) {
+        if (reachable.count(bb) == 0) {
+            dead.push_back(bb);
+        }
+    }
+    // 先删指令，解除块之间经由跳转与phi的相互引用，再删块
+    for (auto bb: dead) {
+        std::vector<Instruction *> instrs(bb->get_instructions().begin(), bb->get_instructions().end());
+        for (auto r = instrs.rbegin(); r != instrs.rend(); ++r) {
+            drop_instr(*r);
+        }
+    }
+    for (auto bb: dead) {
+        f->remove(bb);
+    }
+    Stats::count("blocks removed", dead.size());
+    return true;
+}
+
+bool merge_into_predecessor(Function *f) {
+    bool changed = false;
+    BasicBlock *entry = f->get_basic_blocks().front();
+    std::vector<BasicBlock *> bbs(f->get_basic_blocks().begin(), f->get_basic_blocks().end());
+    std::unordered_set<BasicBlock *> removed;
+    for (auto bb: bbs) {
+        if (bb == entry || removed.count(bb) || bb->get_pre_basic_blocks().size() != 1) {
+            continue;
+        }
+        BasicBlock *pred = bb->get_pre_basic_blocks().front();
+        auto br = dynamic_cast<BranchInst *>(pred->get_terminator());
+        if (pred == bb || br == nullptr || br->is_cond_br() || pred->get_succ_basic_blocks().size() != 1) {
+            continue;
+        }
+        // 单前驱的phi只有一个来源
+        for (auto phi: get_phis(bb)) {
+            Value *val = phi->get_num_operand() > 0 ? phi->get_operand(0)
+                                                    : ConstantZero::get(phi->get_type(), f->get_parent());
+            phi->replace_all_use_with(val);
+            bb->delete_instr(phi);
+        }
+        pred->delete_instr(br);
+        std::vector<Instruction *> instrs(bb->get_instructions().begin(), bb->get_instructions().end());
+        for (auto instr: instrs) {
+            bb->get_instructions().remove(instr);
+            instr->set_parent(pred);
+            pred->add_instruction(instr);
+        }
+        // 后继改以 pred 为前驱，后继phi中的来源块一并替换
+        pred->get_succ_basic_blocks() = bb->get_succ_basic_blocks();
+        for (auto succ: bb->get_succ_basic_blocks()) {
+            std::replace(succ->get_pre_basic_blocks().begin(), succ->get_pre_basic_blocks().end(), bb, pred);
+        }
+        replace_block_uses(bb, pred);
+        bb->get_pre_basic_blocks().clear();
+        bb->get_succ_basic_blocks().clear();
+        f->remove(bb);
+        removed.insert(bb);
+        changed = true;
+    }
+    Stats::count("blocks merged", removed.size());
+    return changed;
+}
+
+bool skip_forwarding_blocks(Function *f) {
+    bool changed = false;
+    BasicBlock *entry = f->get_basic_blocks().front();
+    std::vector<BasicBlock *> bbs(f->get_basic_blocks().begin(), f->get_basic_blocks().end());
+    for (auto bb: bbs) {
+        if (bb == entry || bb->get_num_of_instr() != 1 || bb->get_pre_basic_blocks().empty()) {
+            continue;
+        }
+        auto br = dynamic_cast<BranchInst *>(bb->get_terminator());
+        if (br == nullptr || br->is_cond_br()) {
+            continue;
+        }
+        BasicBlock *target = br->getTrueBB();
+        if (target == bb || !get_phis(target).empty()) {
+            continue;
+        }
+        std::vector<BasicBlock *> preds(bb->get_pre_basic_blocks().begin(), bb->get_pre_basic_blocks().end());
+        for (auto pred: preds) {
+            auto &succs = pred->get_succ_basic_blocks();
+            std::replace(succs.begin(), succs.end(), bb, target);
+            target->get_pre_basic_blocks().push_back(pred);
+        }
+        // 前驱的跳转指令是 bb 仅剩的使用者
+        replace_block_uses(bb, target);
+        erase_one(target->get_pre_basic_blocks(), bb);
+        bb->delete_instr(br);
+        bb->get_pre_basic_blocks().clear();
+        bb->get_succ_basic_blocks().clear();
+        f->remove(bb);
+        changed = true;
+    }
+    return changed;
+}
+
+}  // namespace
+
+bool SimplifyCFG::run_on_function(Function *f) {
+    bool changed = truncate_after_terminator(f);
+    bool round;
+    do {
+        round = fold_branches(f);
+        round |= remove_unreachable(f);
+        round |= merge_into_predecessor(f);
+        round |= skip_forwarding_blocks(f);
+        changed |= round;
+    } while (round);
+    return changed;
+}
@@ -0,0 +1,61 @@
+/*!
+ * @file SourceBuffer.cpp
+ * @brief 只读源文件缓冲区实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "SourceBuffer.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+
+SourceBuffer::~SourceBuffer() {
+    close();
+}
+
+void SourceBuffer::close() {
+    if (mapped_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    fallback_.clear();
+}
+
+bool SourceBuffer::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            ::close(fd);
+            data_ = static_cast<const char*>(p);
+            size_ = static_cast<size_t>(st.st_size);
+            mapped_ = true;
+            return true;
+        }
+    }
+    ::close(fd);
+
+    // 退化路径：普通读取
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    fallback_ = buffer.str();
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+    return true;
+}
@@ -0,0 +1,213 @@
+/*!
+ * @file Stats.cpp
+ * @brief 编译阶段统计实现，以及用于统计分配量的全局 operator new
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "Stats.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> statsEnabled(false);
+
+// 只在启用后累加；线程局部，不需要同步
+thread_local Stats::AllocCount threadAlloc = {0, 0};
+
+struct PhaseRecord {
+    std::string name;
+    uint64_t ns = 0;
+    uint64_t calls = 0;
+    uint64_t allocs = 0;
+    uint64_t bytes = 0;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<PhaseRecord> phases;            // 按首次出现顺序
+    std::map<std::string, size_t, std::less<>> phaseIndex;  // 透明比较，按 const char* 查找
+    std::vector<std::pair<std::string, uint64_t>> counters;
+    std::map<std::string, size_t, std::less<>> counterIndex;
+};
+
+Registry& registry() {
+    static Registry* r = new Registry();  // 不析构，退出阶段仍可安全使用
+    return *r;
+}
+
+void* countedAlloc(std::size_t n) {
+    if (n == 0) n = 1;
+    void* p;
+    while (!(p = std::malloc(n))) {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+    if (statsEnabled.load(std::memory_order_relaxed)) {
+        threadAlloc.allocs++;
+        threadAlloc.bytes += n;
+    }
+    return p;
+}
+
+std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+}  // namespace
+
+void Stats::enable() {
+    statsEnabled.store(true, std::memory_order_relaxed);
+}
+
+bool Stats::enabled() {
+    return statsEnabled.load(std::memory_order_relaxed);
+}
+
+Stats::AllocCount Stats::threadAllocs() {
+    return threadAlloc;
+}
+
+void Stats::addTime(const char* phase, uint64_t ns, uint64_t calls, AllocCount alloc) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = r.phaseIndex.find(phase);
+    if (it == r.phaseIndex.end()) {
+        it = r.phaseIndex.emplace(phase, r.phases.size()).first;
+        r.phases.emplace_back();
+        r.phases.back().name = phase;
+    }
+    PhaseRecord& rec = r.phases[it->second];
+    rec.ns += ns;
+    rec.calls += calls;
+    rec.allocs += alloc.allocs;
+    rec.bytes += alloc.bytes;
+}
+
+void Stats::count(const char* name, uint64_t n) {
+    if (!enabled()) return;
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = r.counterIndex.find(name);
+    if (it == r.counterIndex.end()) {
+        it = r.counterIndex.emplace(name, r.counters.size()).first;
+        r.counters.emplace_back(name, 0);
+    }
+    r.counters[it->second].second += n;
+}
+
+void Stats::report(std::ostream& os, bool phases, bool counters, bool json) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    char line[160];
+
+    if (json) {
+        os << "{";
+        if (phases) {
+            os << "\"phases\":[";
+            for (size_t i = 0; i < r.phases.size(); i++) {
+                const PhaseRecord& p = r.phases[i];
+                os << (i ? "," : "") << "{\"name\":" << jsonString(p.name)
+                   << ",\"ns\":" << p.ns << ",\"calls\":" << p.calls
+                   << ",\"allocs\":" << p.allocs << ",\"bytes\":" << p.bytes << "}";
+            }
+            os << "]";
+        }
+        if (counters) {
+            os << (phases ? "," : "") << "\"counters\":{";
+            for (size_t i = 0; i < r.counters.size(); i++) {
+                os << (i ? "," : "") << jsonString(r.counters[i].first) << ":" << r.counters[i].second;
+            }
+            os << "}";
+        }
+        os << "}" << std::endl;
+        return;
+    }
+
+    if (phases) {
+        os << "===== 阶段耗时（含子阶段） =====" << std::endl;
+        std::snprintf(line, sizeof(line), "%-28s %12s %10s %12s %14s",
+                      "phase", "time(ms)", "calls", "allocs", "alloc(bytes)");
+        os << line << std::endl;
+        for (const PhaseRecord& p : r.phases) {
+            std::snprintf(line, sizeof(line), "%-28s %12.3f %10llu %12llu %14llu",
+                          p.name.c_str(), p.ns / 1e6,
+                          static_cast<unsigned long long>(p.calls),
+                          static_cast<unsigned long long>(p.allocs),
+                          static_cast<unsigned long long>(p.bytes));
+            os << line << std::endl;
+        }
+    }
+    if (counters) {
+        os << "===== 统计 =====" << std::endl;
+        for (const auto& c : r.counters) {
+            std::snprintf(line, sizeof(line), "%-28s %12llu",
+                          c.first.c_str(), static_cast<unsigned long long>(c.second));
+            os << line << std::endl;
+        }
+    }
+}
+
+// ==================== 全局 operator new / delete ====================
+// 替换后所有 new 都经过这里，启用统计时记入当前线程的分配量
+
+void* operator new(std::size_t n) {
+    return countedAlloc(n);
+}
+
+void* operator new[](std::size_t n) {
+    return countedAlloc(n);
+}
+
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlloc(n);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlloc(n);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
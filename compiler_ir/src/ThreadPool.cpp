@@ -0,0 +1,95 @@
+/*!
+ * @file ThreadPool.cpp
+ * @brief 工作窃取线程池实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(std::thread::hardware_concurrency());
+        if (numThreads <= 0) numThreads = 1;
+    }
+    for (int i = 0; i < numThreads; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (int i = 0; i < numThreads; i++) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    size_t q = nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        pending++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[q]->mutex);
+        queues[q]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        queued++;
+    }
+    workAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+}
+
+bool ThreadPool::tryTake(size_t self, std::function<void()>& task) {
+    // 先取自己队列的队尾（最近提交，缓存更热）
+    {
+        std::lock_guard<std::mutex> lock(queues[self]->mutex);
+        if (!queues[self]->tasks.empty()) {
+            task = std::move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+            return true;
+        }
+    }
+    // 再从其他队列的队首窃取
+    for (size_t k = 1; k < queues.size(); k++) {
+        WorkQueue& victim = *queues[(self + k) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t self) {
+    while (true) {
+        std::function<void()> task;
+        if (tryTake(self, task)) {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                queued--;
+            }
+            task();
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (--pending == 0) allDone.notify_all();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workAvailable.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued <= 0) return;
+    }
+}
@@ -5,9 +5,11 @@
  *@date 2022-10-04
  */
 #include "Type.h"
+#include "IRArena.h"
 #include "Module.h"
 
 #include <cassert>
+#include <sstream>
 
 /**
  * @brief Construct a new Type object
@@ -27,6 +29,14 @@ Type::Type(TypeID tid, Module *m) {
  */
 Module *Type::get_module() { return m_; }
 
+void *Type::operator new(std::size_t size, Module *m) {
+    return m->get_arena().allocate(IRArena::Types, size);
+}
+
+void Type::operator delete(void *p, Module *m) {
+    m->get_arena().forget(IRArena::Types, p);
+}
+
 /**
  * @brief 判断两个类型是否一致
  *
@@ -171,52 +181,60 @@ int Type::get_size(bool extended) {
 /**
  * @brief 打印类型
  *
- * @return std::string，字符串
+ * @param os 输出流
  */
-std::string Type::print() {
-    std::string type_ir;
+void Type::print(std::ostream &os) {
     switch (this->get_type_id()) {
         case VoidTyID:
-            type_ir += "void";
+            os << "void";
             break;
         case LabelTyID:
-            type_ir += "label";
+            os << "label";
             break;
         case IntegerTy32ID:
         case IntegerTy1ID:
-            type_ir += "i";
-            type_ir += std::to_string(static_cast<IntegerType *>(this)->get_num_bits());
+            os << "i";
+            os << std::to_string(static_cast<IntegerType *>(this)->get_num_bits());
             break;
         case FunctionTyID:
-            type_ir += static_cast<FunctionType *>(this)->get_return_type()->print();
-            type_ir += " (";
+            static_cast<FunctionType *>(this)->get_return_type()->print(os);
+            os << " (";
             for (int i = 0;
                  i < (int) static_cast<FunctionType *>(this)->get_num_of_args(); i++) {
                 if (i)
-                    type_ir += ", ";
-                type_ir += static_cast<FunctionType *>(this)->get_param_type(i)->print();
+                    os << ", ";
+                static_cast<FunctionType *>(this)->get_param_type(i)->print(os);
             }
-            type_ir += ")";
+            os << ")";
             break;
         case PointerTyID:
-            type_ir += this->get_pointer_element_type()->print();
-            type_ir += "*";
+            this->get_pointer_element_type()->print(os);
+            os << "*";
             break;
         case ArrayTyID:
-            type_ir += "[";
-            type_ir +=
-                    std::to_string(static_cast<ArrayType *>(this)->get_num_of_elements());
-            type_ir += " x ";
-            type_ir += static_cast<ArrayType *>(this)->get_element_type()->print();
-            type_ir += "]";
+            os << "[";
+            os << static_cast<ArrayType *>(this)->get_num_of_elements();
+            os << " x ";
+            static_cast<ArrayType *>(this)->get_element_type()->print(os);
+            os << "]";
             break;
         case FloatTyID:
-            type_ir += "float";
+            os << "float";
             break;
         default:
             break;
     }
-    return type_ir;
+}
+
+/**
+ * @brief 打印类型
+ *
+ * @return std::string，字符串
+ */
+std::string Type::print() {
+    std::ostringstream os;
+    print(os);
+    return os.str();
 }
 
 /**
@@ -244,7 +262,7 @@ IntegerType::IntegerType(unsigned num_bits, Module *m)
  * @return IntegerType*
  */
 IntegerType *IntegerType::get(unsigned num_bits, Module *m) {
-    return new IntegerType(num_bits, m);
+    return new (m) IntegerType(num_bits, m);
 }
 
 /**
@@ -263,7 +281,7 @@ unsigned IntegerType::get_num_bits() { return num_bits_; }
  * @return 创建对象本身
  */
 FunctionType::FunctionType(Type *result, std::vector<Type *> params)
-        : Type(Type::FunctionTyID, nullptr) {
+        : Type(Type::FunctionTyID, result->get_module()) {
     assert(is_valid_return_type(result) && "Invalid return type for function!");
     result_ = result;
 
@@ -304,7 +322,7 @@ bool FunctionType::is_valid_argument_type(Type *ty) {
  * @return FunctionType* 函数类型指针
  */
 FunctionType *FunctionType::get(Type *result, std::vector<Type *> params) {
-    return new FunctionType(result, params);
+    return new (result->get_module()) FunctionType(result, params);
 }
 
 /**
@@ -16,11 +16,28 @@
  *@return 当前对象本身
  *@note
  *---------
- *初始化operands数组全为nullptr
+ *初始化operands数组全为nullptr，每个操作数一个未挂接的use节点
  */
 User::User(Type *ty, const std::string &name, unsigned num_ops)
         : Value(ty, name), num_ops_(num_ops) {
     operands_.resize(num_ops_, nullptr);
+    uses_.reserve(num_ops_);
+    for (unsigned i = 0; i < num_ops_; i++) {
+        uses_.emplace_back(this, i);
+    }
+}
+
+void User::unlink_uses() {
+    for (auto &use: uses_) {
+        use.unlink();
+    }
+}
+
+void User::link_uses() {
+    for (unsigned i = 0; i < uses_.size(); i++) {
+        uses_[i].arg_no_ = i;
+        if (operands_[i]) operands_[i]->add_use(uses_[i]);
+    }
 }
 
 /*!
@@ -42,15 +59,31 @@ Value *User::get_operand(unsigned i) const { return operands_[i]; }
  *设置数组中的第i个value数值常量指针
  *设置界限检查，查看索引i是否超限
  *--------
- *&emsp; value数组尾插入一个value
- *&emsp; 为value添加一个use关系
- *&emsp; 计数加一
+ *&emsp; 从旧value的use链上摘下第i个use节点
+ *&emsp; 设置新value并挂到其use链上
  */
 void User::set_operand(unsigned i, Value *v) {
     assert(i < num_ops_ && "set_operand out of index");
     // assert(operands_[i] == nullptr && "ith operand is not null");
+    uses_[i].unlink();
     operands_[i] = v;
-    v->add_use(this, i);
+    if (v) v->add_use(uses_[i]);
+}
+
+/*!
+ *@brief 复制另一个 User 的全部操作数，并登记相应的 use
+ *@param src 被复制的 User
+ */
+void User::copy_operands_from(const User *src) {
+    unlink_uses();
+    operands_ = src->operands_;
+    num_ops_ = operands_.size();
+    uses_.clear();
+    uses_.reserve(num_ops_);
+    for (unsigned i = 0; i < num_ops_; i++) {
+        uses_.emplace_back(this, i);
+    }
+    link_uses();
 }
 
 /*!
@@ -64,7 +97,15 @@ void User::set_operand(unsigned i, Value *v) {
  */
 void User::add_operand(Value *v) {
     operands_.push_back(v);
-    v->add_use(this, num_ops_);
+    if (uses_.size() == uses_.capacity()) {
+        // 扩容会搬移已有节点
+        unlink_uses();
+        uses_.emplace_back(this, num_ops_);
+        link_uses();
+    } else {
+        uses_.emplace_back(this, num_ops_);
+        if (v) v->add_use(uses_.back());
+    }
     num_ops_++;
 }
 
@@ -82,12 +123,19 @@ unsigned User::get_num_operand() const { return num_ops_; }
  *@param v value数值指针
  *@note
  *--------
- *遍历operands链表，对于每个value量的use_list进行检查
- *在operands表中删除对于本对象的使用
+ *从每个操作数的use链上摘下本对象持有的节点，每个 O(1)
  */
 void User::remove_use_of_ops() {
-    for (auto op: operands_) {
-        op->remove_use(this);
+    unlink_uses();
+}
+
+void User::link_deferred(const std::vector<DeferredUse> &uses) {
+    for (auto &d: uses) {
+        auto user = static_cast<User *>(d.user_);
+        if (d.arg_no_ >= user->num_ops_) continue;
+        Use &use = user->uses_[d.arg_no_];
+        Value *v = user->operands_[d.arg_no_];
+        if (v && !use.is_linked()) v->add_use(use);
     }
 }
 
@@ -97,14 +145,14 @@ void User::remove_use_of_ops() {
  *@param index2 索引2
  *@note
  *--------
- *遍历operands表索引范围，删除对于本user的使用
- *删除本表的相关operands
+ *删除本表的相关operands及其use节点
+ *后面的节点前移，重新编号并挂回use链
  *修改operands_size
  */
 void User::remove_operands(int index1, int index2) {
-    for (int i = index1; i <= index2; i++) {
-        operands_[i]->remove_use(this);
-    }
+    unlink_uses();
     operands_.erase(operands_.begin() + index1, operands_.begin() + index2 + 1);
+    uses_.erase(uses_.begin() + index1, uses_.begin() + index2 + 1);
     num_ops_ = operands_.size();
+    link_uses();
 }
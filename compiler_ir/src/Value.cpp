@@ -6,8 +6,11 @@
  */
 
 #include <cassert>
+#include <sstream>
 
 #include "BasicBlock.h"
+#include "IRArena.h"
+#include "Module.h"
 #include "Type.h"
 #include "User.h"
 #include "Value.h"
@@ -20,23 +23,32 @@
  */
 Value::Value(Type *ty, const std::string &name) : type_(ty), name_(name) {}
 
-/*!
- *@brief 添加use
- *@param val 使用该value的value
- *@param arg_no 在指令中的顺序
- *@note
- *---------
- *在use链中添加
- */
-void Value::add_use(Value *val, unsigned arg_no) {
-    use_list_.push_back(Use(val, arg_no));
+thread_local std::vector<DeferredUse> *Value::deferred_uses_ = nullptr;
+
+void *Value::operator new(std::size_t size, Module *m) {
+    return m->get_arena().allocate(IRArena::Values, size);
+}
+
+void Value::operator delete(void *p, Module *m) {
+    m->get_arena().forget(IRArena::Values, p);
 }
 
 /*!
  *@brief 获取value的名称
  *@return value字符串常量
  */
-std::string Value::get_name() const { return name_; }
+const std::string &Value::get_name() const {
+    if (slot_ >= 0 && name_.empty()) {
+        name_ = slot_prefix_ + std::to_string(slot_);
+    }
+    return name_;
+}
+
+std::string Value::print() {
+    std::ostringstream os;
+    print(os);
+    return os.str();
+}
 
 /*!
  *@brief 替换所有对于旧value的引用，改为新的
@@ -45,14 +57,17 @@ std::string Value::get_name() const { return name_; }
  *--------
  *支持对于所有的value的修改，包括基本块
  *&emsp; 首先遍历所属的use_list，修改其他value中对于当前value的引用为新value
+ *&emsp; （set_operand 会把节点移到新value的链上，因此先取下一个节点）
  *&emsp; 转换value类型为basicblock，修改成功即为对基本块间的类型调用修改，
  *&emsp; 依次修改前置后置的链表中对于该基本块的引用
  */
 void Value::replace_all_use_with(Value *new_val) {
-    for (auto use: use_list_) {
-        auto val = dynamic_cast<User *>(use.val_);
+    for (Use *use = use_head_; use;) {
+        Use *next = use->next_;
+        auto val = dynamic_cast<User *>(use->val_);
         assert(val && "new_val is not a user");
-        val->set_operand(use.arg_no_, new_val);
+        val->set_operand(use->arg_no_, new_val);
+        use = next;
     }
     auto val = dynamic_cast<BasicBlock *>(this);
     if (val) {
@@ -75,10 +90,13 @@ void Value::replace_all_use_with(Value *new_val) {
  *@param val value型指针
  *@note
  *----------
- *设置lambda函数，判定val的匹配
- *匹配成功则进行value的相关删除
+ *遍历use链，摘下 val 持有的节点
+ *User 删除自身的使用时直接摘下自己的节点（O(1)），不经过这里
  */
 void Value::remove_use(Value *val) {
-    auto is_val = [val](const Use &use) { return use.val_ == val; };
-    use_list_.remove_if(is_val);
+    for (Use *use = use_head_; use;) {
+        Use *next = use->next_;
+        if (use->val_ == val) use->unlink();
+        use = next;
+    }
 }
@@ -0,0 +1,270 @@
+/*!
+ * @file X86Backend.cpp
+ * @brief x86-64 汇编输出实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "X86Backend.h"
+#include "Constant.h"
+#include "Function.h"
+#include "GlobalVariable.h"
+#include "LinearScan.h"
+#include "Module.h"
+#include "Stats.h"
+#include "Type.h"
+#include "X86ISel.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+int round_up(int value, int align) { return (value + align - 1) / align * align; }
+
+const char *cond_name(Cond cc) {
+    switch (cc) {
+        case Cond::E: return "e";
+        case Cond::NE: return "ne";
+        case Cond::L: return "l";
+        case Cond::LE: return "le";
+        case Cond::G: return "g";
+        case Cond::GE: return "ge";
+        case Cond::A: return "a";
+        case Cond::AE: return "ae";
+        case Cond::B: return "b";
+        case Cond::BE: return "be";
+        case Cond::P: return "p";
+        case Cond::NP: return "np";
+    }
+    return "e";
+}
+
+/// 操作码到助记符；整数指令按宽度加 l/q 后缀
+std::string mnemonic(const MInst &inst) {
+    const char *q = inst.size == 8 ? "q" : "l";
+    switch (inst.op) {
+        case MInst::MOV: return std::string("mov") + q;
+        case MInst::LEA: return "leaq";
+        case MInst::MOVZX: return "movzbl";
+        case MInst::MOVSX: return "movslq";
+        case MInst::ADD: return std::string("add") + q;
+        case MInst::SUB: return std::string("sub") + q;
+        case MInst::IMUL: return std::string("imul") + q;
+        case MInst::AND: return std::string("and") + q;
+        case MInst::OR: return std::string("or") + q;
+        case MInst::CMP: return std::string("cmp") + q;
+        case MInst::TEST: return std::string("test") + q;
+        case MInst::CDQ: return "cltd";
+        case MInst::IDIV: return "idivl";
+        case MInst::SETCC: return std::string("set") + cond_name(inst.cc);
+        case MInst::JCC: return std::string("j") + cond_name(inst.cc);
+        case MInst::JMP: return "jmp";
+        case MInst::CALL: return "call";
+        case MInst::RET: return "ret";
+        case MInst::MOVSS: return "movss";
+        case MInst::CVTSI2SS: return "cvtsi2ssl";
+        case MInst::CVTTSS2SI: return "cvttss2si";
+        case MInst::ADDSS: return "addss";
+        case MInst::SUBSS: return "subss";
+        case MInst::MULSS: return "mulss";
+        case MInst::DIVSS: return "divss";
+        case MInst::UCOMISS: return "ucomiss";
+    }
+    return "";
+}
+
+/**
+ * @brief 单个函数的汇编输出状态：栈槽偏移与块标号
+ */
+class FunctionPrinter {
+public:
+    FunctionPrinter(const MFunction &mf, std::ostream &os) : mf_(mf), os_(os) {}
+
+    void print() {
+        // 保存区紧贴 %rbp，其下是各栈槽
+        int offset = 8 * static_cast<int>(mf_.saved_regs.size());
+        for (auto &slot: mf_.slots) {
+            offset = round_up(offset + slot.size, slot.align);
+            slot_offsets_.push_back(-offset);
+        }
+        int frame = round_up(offset + mf_.outgoing_size, 16);
+
+        os_ << "\t.globl\t" << mf_.name << "\n";
+        os_ << "\t.type\t" << mf_.name << ", @function\n";
+        os_ << mf_.name << ":\n";
+        os_ << "\tpushq\t%rbp\n";
+        os_ << "\tmovq\t%rsp, %rbp\n";
+        if (frame > 0) os_ << "\tsubq\t$" << frame << ", %rsp\n";
+        for (size_t i = 0; i < mf_.saved_regs.size(); i++) {
+            os_ << "\tmovq\t" << preg_name(mf_.saved_regs[i], 8) << ", " << -8 * static_cast<int>(i + 1)
+                << "(%rbp)\n";
+        }
+
+        uint64_t count = 0;
+        for (size_t b = 0; b < mf_.blocks.size(); b++) {
+            auto &insts = mf_.blocks[b].insts;
+            os_ << mf_.blocks[b].label << ":\n";
+            size_t n = insts.size();
+            int next = static_cast<int>(b + 1);
+            // 块尾跳转：跳到下一块的 jmp 删去，"jcc 下一块; jmp L" 改为 "j!cc L"
+            bool drop_jmp = n > 0 && insts[n - 1].op == MInst::JMP && insts[n - 1].ops[0].reg == next;
+            bool flip = n > 1 && !drop_jmp && insts[n - 1].op == MInst::JMP && insts[n - 2].op == MInst::JCC &&
+                        insts[n - 2].ops[0].reg == next;
+            for (size_t i = 0; i < n; i++) {
+                if (drop_jmp && i == n - 1) break;
+                if (flip && i == n - 2) {
+                    os_ << "\tj" << cond_name(invert(insts[i].cc)) << "\t" << mf_.blocks[insts[n - 1].ops[0].reg].label
+                        << "\n";
+                    count++;
+                    break;
+                }
+                print_inst(insts[i]);
+                count++;
+            }
+        }
+        os_ << "\t.size\t" << mf_.name << ", .-" << mf_.name << "\n";
+        Stats::count("machine instructions", count);
+    }
+
+private:
+    const MFunction &mf_;
+    std::ostream &os_;
+    std::vector<int> slot_offsets_;
+
+    void print_operand(const MOperand &o) {
+        switch (o.kind) {
+            case MOperand::REG:
+                os_ << preg_name(o.reg, o.size);
+                break;
+            case MOperand::IMM:
+                os_ << "$" << o.imm;
+                break;
+            case MOperand::MEM:
+                if (o.base == MOperand::BASE_FRAME) {
+                    os_ << slot_offsets_[o.reg] + o.imm << "(%rbp)";
+                } else if (o.base == MOperand::BASE_SYMBOL) {
+                    os_ << o.sym;
+                    if (o.imm != 0) os_ << (o.imm > 0 ? "+" : "") << o.imm;
+                    os_ << "(%rip)";
+                } else {
+                    if (o.imm != 0) os_ << o.imm;
+                    os_ << "(" << preg_name(o.reg, 8) << ")";
+                }
+                break;
+            case MOperand::BLOCK:
+                os_ << mf_.blocks[o.reg].label;
+                break;
+            case MOperand::FUNC:
+                os_ << o.sym;
+                break;
+            case MOperand::NONE:
+                break;
+        }
+    }
+
+    void print_inst(const MInst &inst) {
+        if (inst.op == MInst::RET) {
+            for (size_t i = 0; i < mf_.saved_regs.size(); i++) {
+                os_ << "\tmovq\t" << -8 * static_cast<int>(i + 1) << "(%rbp), " << preg_name(mf_.saved_regs[i], 8)
+                    << "\n";
+            }
+            os_ << "\tleave\n\tret\n";
+            return;
+        }
+        os_ << "\t" << mnemonic(inst);
+        for (size_t i = 0; i < inst.ops.size(); i++) {
+            os_ << (i == 0 ? "\t" : ", ");
+            print_operand(inst.ops[i]);
+        }
+        os_ << "\n";
+    }
+};
+
+/**
+ * @brief 全局变量初值的输出，相邻的零合并成一条 .zero
+ */
+class DataWriter {
+public:
+    explicit DataWriter(std::ostream &os) : os_(os) {}
+
+    ~DataWriter() { flush(); }
+
+    void word(uint32_t bits) {
+        if (bits == 0) {
+            zeros_ += 4;
+            return;
+        }
+        flush();
+        os_ << "\t.long\t" << bits << "\n";
+    }
+
+    void zero(int bytes) { zeros_ += bytes; }
+
+    void write(Constant *init, Type *ty) {
+        if (auto ci = dynamic_cast<ConstantInt *>(init)) {
+            word(static_cast<uint32_t>(ci->get_value()));
+        } else if (auto cf = dynamic_cast<ConstantFP *>(init)) {
+            float value = cf->get_value();
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            word(bits);
+        } else if (auto arr = dynamic_cast<ConstantArray *>(init)) {
+            const uint32_t *data = arr->get_raw_data();
+            for (size_t i = 0; i < arr->get_num_scalars(); i++) word(data[i]);
+        } else {
+            zero(X86ISel::size_of(ty));
+        }
+    }
+
+private:
+    std::ostream &os_;
+    int zeros_ = 0;
+
+    void flush() {
+        if (zeros_ > 0) os_ << "\t.zero\t" << zeros_ << "\n";
+        zeros_ = 0;
+    }
+};
+
+}  // namespace
+
+void X86Backend::emit(Module *m, std::ostream &os) {
+    std::map<uint32_t, std::string> float_consts;
+    X86ISel isel(float_consts);
+
+    os << "\t.text\n";
+    for (auto f: m->get_functions()) {
+        if (f->is_declaration()) continue;
+        MFunction mf = isel.lower(f);
+        LinearScan::run(mf);
+        emit_function(mf, os);
+    }
+
+    for (auto gv: m->get_global_variable()) {
+        Type *ty = gv->get_type()->get_pointer_element_type();
+        os << (gv->is_const() ? "\t.section\t.rodata\n" : "\t.data\n");
+        os << "\t.globl\t" << gv->get_name() << "\n";
+        os << "\t.align\t8\n";
+        os << "\t.type\t" << gv->get_name() << ", @object\n";
+        os << "\t.size\t" << gv->get_name() << ", " << X86ISel::size_of(ty) << "\n";
+        os << gv->get_name() << ":\n";
+        DataWriter(os).write(gv->get_init(), ty);
+    }
+
+    if (!float_consts.empty()) {
+        os << "\t.section\t.rodata\n";
+        os << "\t.align\t4\n";
+        for (auto &kv: float_consts) {
+            os << kv.second << ":\n";
+            os << "\t.long\t" << kv.first << "\n";
+        }
+    }
+    os << "\t.section\t.note.GNU-stack,\"\",@progbits\n";
+}
+
+void X86Backend::emit_function(const MFunction &mf, std::ostream &os) {
+    FunctionPrinter(mf, os).print();
+}
@@ -0,0 +1,534 @@
+/*!
+ * @file X86ISel.cpp
+ * @brief 中间代码到 x86-64 机器指令的指令选择实现
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "X86ISel.h"
+#include "BasicBlock.h"
+#include "Constant.h"
+#include "Function.h"
+#include "GlobalVariable.h"
+#include "Instruction.h"
+#include "Type.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const int kIntArgRegs[] = {RDI, RSI, RDX, RCX, R8, R9};
+const int kNumIntArgRegs = 6;
+const int kNumFloatArgRegs = 8;
+
+Cond int_cond(CmpInst::CmpOp op) {
+    switch (op) {
+        case CmpInst::EQ: return Cond::E;
+        case CmpInst::NE: return Cond::NE;
+        case CmpInst::GT: return Cond::G;
+        case CmpInst::GE: return Cond::GE;
+        case CmpInst::LT: return Cond::L;
+        case CmpInst::LE: return Cond::LE;
+    }
+    return Cond::E;
+}
+
+/// 交换两个操作数后等价的比较
+CmpInst::CmpOp swapped(CmpInst::CmpOp op) {
+    switch (op) {
+        case CmpInst::GT: return CmpInst::LT;
+        case CmpInst::GE: return CmpInst::LE;
+        case CmpInst::LT: return CmpInst::GT;
+        case CmpInst::LE: return CmpInst::GE;
+        default: return op;
+    }
+}
+
+MOperand reg(int r, int size) { return MOperand::make_reg(r, size); }
+
+}  // namespace
+
+int X86ISel::size_of(Type *ty) {
+    if (ty->is_array_type()) {
+        auto arr = static_cast<ArrayType *>(ty);
+        return static_cast<int>(arr->get_num_of_elements()) * size_of(arr->get_element_type());
+    }
+    if (ty->is_pointer_type()) return 8;
+    return 4;
+}
+
+RegClass X86ISel::class_of(Type *ty) const {
+    return ty->is_float_type() ? RegClass::XMM : RegClass::GPR;
+}
+
+int X86ISel::width_of(Type *ty) const {
+    return ty->is_pointer_type() ? 8 : 4;
+}
+
+MInst &X86ISel::emit(MInst::Opcode op, std::vector<MOperand> ops, int size) {
+    cur_->insts.emplace_back(op, std::move(ops), size);
+    return cur_->insts.back();
+}
+
+int X86ISel::vreg_of(Value *v) {
+    auto it = vregs_.find(v);
+    if (it != vregs_.end()) return it->second;
+    int r = mf_->new_vreg(class_of(v->get_type()));
+    vregs_.emplace(v, r);
+    return r;
+}
+
+std::string X86ISel::float_label(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    auto it = float_consts_.find(bits);
+    if (it != float_consts_.end()) return it->second;
+    std::string label = ".LCF" + std::to_string(float_consts_.size());
+    float_consts_.emplace(bits, label);
+    return label;
+}
+
+MOperand X86ISel::value_op(Value *v) {
+    if (auto ci = dynamic_cast<ConstantInt *>(v)) {
+        return MOperand::make_imm(ci->get_value());
+    }
+    if (auto cf = dynamic_cast<ConstantFP *>(v)) {
+        return MOperand::make_symbol(float_label(cf->get_value()), 0);
+    }
+    if (dynamic_cast<ConstantZero *>(v)) {
+        if (v->get_type()->is_float_type()) return MOperand::make_symbol(float_label(0.0f), 0);
+        return MOperand::make_imm(0);
+    }
+    // 作为值使用的地址：取地址到新寄存器
+    if (auto gv = dynamic_cast<GlobalVariable *>(v)) {
+        int r = mf_->new_vreg(RegClass::GPR);
+        emit(MInst::LEA, {MOperand::make_symbol(gv->get_name(), 0), reg(r, 8)}, 8);
+        return reg(r, 8);
+    }
+    auto slot = slots_.find(v);
+    if (slot != slots_.end()) {
+        int r = mf_->new_vreg(RegClass::GPR);
+        emit(MInst::LEA, {MOperand::make_frame(slot->second, 0), reg(r, 8)}, 8);
+        return reg(r, 8);
+    }
+    return reg(vreg_of(v), width_of(v->get_type()));
+}
+
+MOperand X86ISel::reg_op(Value *v) {
+    MOperand op = value_op(v);
+    if (op.is_reg()) return op;
+    RegClass cls = class_of(v->get_type());
+    MOperand dst = reg(mf_->new_vreg(cls), width_of(v->get_type()));
+    copy(op, dst, cls);
+    return dst;
+}
+
+void X86ISel::copy(const MOperand &src, const MOperand &dst, RegClass cls) {
+    if (src.is_reg() && dst.is_reg() && src.reg == dst.reg) return;
+    int size = dst.is_reg() || !src.is_reg() ? dst.size : src.size;
+    emit(cls == RegClass::XMM ? MInst::MOVSS : MInst::MOV, {src, dst}, size);
+}
+
+bool X86ISel::only_addressed(Instruction *gep) {
+    for (auto &use: gep->get_use_list()) {
+        auto user = dynamic_cast<Instruction *>(use.val_);
+        if (user == nullptr) return false;
+        if (!(user->is_load() && use.arg_no_ == 0) && !(user->is_store() && use.arg_no_ == 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+MOperand X86ISel::address(Value *ptr) {
+    auto slot = slots_.find(ptr);
+    if (slot != slots_.end()) return MOperand::make_frame(slot->second, 0);
+    if (auto gv = dynamic_cast<GlobalVariable *>(ptr)) {
+        return MOperand::make_symbol(gv->get_name(), 0);
+    }
+    if (auto gep = dynamic_cast<GetElementPtrInst *>(ptr)) {
+        if (only_addressed(gep)) return gep_address(gep);
+    }
+    return MOperand::make_mem(reg_op(ptr).reg, 0);
+}
+
+MOperand X86ISel::gep_address(GetElementPtrInst *gep) {
+    Value *ptr = gep->get_operand(0);
+    MOperand base = address(ptr);
+    Type *ty = ptr->get_type()->get_pointer_element_type();
+    int64_t offset = 0;
+    int dyn = -1;
+    for (unsigned i = 1; i < gep->get_num_operand(); i++) {
+        if (i > 1) ty = ty->get_array_element_type();
+        int64_t stride = size_of(ty);
+        Value *idx = gep->get_operand(i);
+        if (auto ci = dynamic_cast<ConstantInt *>(idx)) {
+            offset += ci->get_value() * stride;
+            continue;
+        }
+        // 变量下标：先把基址取到寄存器，再逐个累加 下标 * 步长
+        if (dyn < 0) {
+            dyn = mf_->new_vreg(RegClass::GPR);
+            emit(MInst::LEA, {base, reg(dyn, 8)}, 8);
+            base = MOperand::make_mem(dyn, 0);
+        }
+        int t = mf_->new_vreg(RegClass::GPR);
+        emit(MInst::MOVSX, {reg_op(idx), reg(t, 8)}, 8);
+        if (stride != 1) emit(MInst::IMUL, {MOperand::make_imm(stride), reg(t, 8)}, 8);
+        emit(MInst::ADD, {reg(t, 8), reg(dyn, 8)}, 8);
+    }
+    base.imm += offset;
+    return base;
+}
+
+MFunction X86ISel::lower(Function *f) {
+    MFunction mf;
+    mf.name = f->get_name();
+    mf_ = &mf;
+    vregs_.clear();
+    phi_temps_.clear();
+    slots_.clear();
+    block_index_.clear();
+
+    for (auto bb: f->get_basic_blocks()) {
+        block_index_[bb] = static_cast<int>(mf.blocks.size());
+        mf.blocks.push_back(MBlock{".L" + mf.name + "_" + std::to_string(mf.blocks.size()), {}});
+        for (auto instr: bb->get_instructions()) {
+            if (instr->is_alloca()) {
+                auto alloca = static_cast<AllocaInst *>(instr);
+                slots_[instr] = mf.new_slot(size_of(alloca->get_alloca_type()), 8);
+            }
+        }
+    }
+
+    size_t index = 0;
+    for (auto bb: f->get_basic_blocks()) {
+        cur_ = &mf.blocks[index++];
+        if (bb == f->get_entry_block()) lower_args(f);
+        // phi 的第二段复制：临时寄存器 -> phi 结果
+        for (auto instr: bb->get_instructions()) {
+            if (!instr->is_phi()) continue;
+            auto it = phi_temps_.find(instr);
+            if (it == phi_temps_.end()) {
+                it = phi_temps_.emplace(instr, mf.new_vreg(class_of(instr->get_type()))).first;
+            }
+            int w = width_of(instr->get_type());
+            copy(reg(it->second, w), reg(vreg_of(instr), w), class_of(instr->get_type()));
+        }
+        for (auto instr: bb->get_instructions()) {
+            if (!instr->is_phi()) lower_inst(instr);
+        }
+    }
+
+    mf_ = nullptr;
+    cur_ = nullptr;
+    return mf;
+}
+
+void X86ISel::lower_args(Function *f) {
+    int ni = 0, nf = 0, stack = 0;
+    for (auto arg: f->get_args()) {
+        Type *ty = arg->get_type();
+        RegClass cls = class_of(ty);
+        MOperand dst = reg(vreg_of(arg), width_of(ty));
+        MOperand src;
+        if (cls == RegClass::XMM && nf < kNumFloatArgRegs) {
+            src = reg(XMM0 + nf++, 4);
+        } else if (cls == RegClass::GPR && ni < kNumIntArgRegs) {
+            src = reg(kIntArgRegs[ni++], dst.size);
+        } else {
+            // 返回地址与保存的 %rbp 之上是经栈传递的参数
+            src = MOperand::make_mem(RBP, 16 + 8 * stack++);
+        }
+        copy(src, dst, cls);
+    }
+}
+
+void X86ISel::lower_inst(Instruction *instr) {
+    switch (instr->get_instr_type()) {
+        case Instruction::ret: {
+            auto ret = static_cast<ReturnInst *>(instr);
+            std::vector<int> uses;
+            if (!ret->is_void_ret()) {
+                Value *v = instr->get_operand(0);
+                if (v->get_type()->is_float_type()) {
+                    copy(value_op(v), reg(XMM0, 4), RegClass::XMM);
+                    uses.push_back(XMM0);
+                } else {
+                    copy(value_op(v), reg(RAX, width_of(v->get_type())), RegClass::GPR);
+                    uses.push_back(RAX);
+                }
+            }
+            emit(MInst::RET, {}).implicit_uses = uses;
+            break;
+        }
+        case Instruction::br:
+            lower_br(instr);
+            break;
+        case Instruction::add:
+        case Instruction::sub:
+        case Instruction::mul:
+        case Instruction::sdiv:
+        case Instruction::mod:
+        case Instruction::fadd:
+        case Instruction::fsub:
+        case Instruction::fmul:
+        case Instruction::fdiv:
+            lower_binary(instr);
+            break;
+        case Instruction::alloca:
+            break;
+        case Instruction::load: {
+            Type *ty = instr->get_type();
+            MOperand src = address(instr->get_operand(0));
+            src.size = width_of(ty);
+            copy(src, reg(vreg_of(instr), width_of(ty)), class_of(ty));
+            break;
+        }
+        case Instruction::store: {
+            auto store = static_cast<StoreInst *>(instr);
+            Value *val = store->get_rval();
+            Type *ty = val->get_type();
+            MOperand dst = address(store->get_lval());
+            dst.size = width_of(ty);
+            if (auto cf = dynamic_cast<ConstantFP *>(val)) {
+                // 浮点常量按位模式直接写入内存
+                uint32_t bits;
+                float f = cf->get_value();
+                std::memcpy(&bits, &f, sizeof(bits));
+                emit(MInst::MOV, {MOperand::make_imm(static_cast<int32_t>(bits)), dst}, 4);
+            } else if (dynamic_cast<ConstantZero *>(val) && ty->is_float_type()) {
+                emit(MInst::MOV, {MOperand::make_imm(0), dst}, 4);
+            } else {
+                MOperand src = value_op(val);
+                if (src.is_mem()) src = reg_op(val);
+                copy(src, dst, class_of(ty));
+            }
+            break;
+        }
+        case Instruction::cmp:
+            lower_cmp(static_cast<CmpInst *>(instr));
+            break;
+        case Instruction::phi:
+            break;
+        case Instruction::call:
+            lower_call(instr);
+            break;
+        case Instruction::getelementptr: {
+            auto gep = static_cast<GetElementPtrInst *>(instr);
+            // 只被访存使用时在使用处折叠进寻址方式
+            if (only_addressed(gep)) break;
+            emit(MInst::LEA, {gep_address(gep), reg(vreg_of(instr), 8)}, 8);
+            break;
+        }
+        case Instruction::zext:
+            copy(value_op(instr->get_operand(0)), reg(vreg_of(instr), 4), RegClass::GPR);
+            break;
+        case Instruction::sitofp:
+            emit(MInst::CVTSI2SS, {reg_op(instr->get_operand(0)), reg(vreg_of(instr), 4)});
+            break;
+        case Instruction::fptosi:
+            emit(MInst::CVTTSS2SI, {value_op(instr->get_operand(0)), reg(vreg_of(instr), 4)});
+            break;
+    }
+}
+
+void X86ISel::lower_binary(Instruction *instr) {
+    auto op = instr->get_instr_type();
+    Value *a = instr->get_operand(0);
+    Value *b = instr->get_operand(1);
+    MOperand dst = reg(vreg_of(instr), 4);
+
+    if (instr->get_type()->is_float_type()) {
+        MInst::Opcode opc = op == Instruction::fadd ? MInst::ADDSS :
+                            op == Instruction::fsub ? MInst::SUBSS :
+                            op == Instruction::fmul ? MInst::MULSS : MInst::DIVSS;
+        MOperand rhs = value_op(b);
+        copy(value_op(a), dst, RegClass::XMM);
+        emit(opc, {rhs, dst});
+        return;
+    }
+
+    if (op == Instruction::sdiv || op == Instruction::mod) {
+        // idiv 的被除数在 edx:eax，商在 eax，余数在 edx
+        MOperand divisor = reg_op(b);
+        copy(value_op(a), reg(RAX, 4), RegClass::GPR);
+        MInst &cdq = emit(MInst::CDQ, {});
+        cdq.implicit_uses = {RAX};
+        cdq.implicit_defs = {RDX};
+        MInst &idiv = emit(MInst::IDIV, {divisor});
+        idiv.implicit_uses = {RAX, RDX};
+        idiv.implicit_defs = {RAX, RDX};
+        copy(reg(op == Instruction::sdiv ? RAX : RDX, 4), dst, RegClass::GPR);
+        return;
+    }
+
+    if ((op == Instruction::add || op == Instruction::mul) && dynamic_cast<ConstantInt *>(a)) {
+        std::swap(a, b);
+    }
+    MInst::Opcode opc = op == Instruction::add ? MInst::ADD :
+                        op == Instruction::sub ? MInst::SUB : MInst::IMUL;
+    MOperand rhs = value_op(b);
+    copy(value_op(a), dst, RegClass::GPR);
+    emit(opc, {rhs, dst});
+}
+
+Cond X86ISel::emit_compare(CmpInst *cmp, int &parity) {
+    Value *a = cmp->get_operand(0);
+    Value *b = cmp->get_operand(1);
+    CmpInst::CmpOp op = cmp->get_cmp_op();
+    parity = 0;
+
+    if (a->get_type()->is_float_type()) {
+        // ucomiss 只有无符号条件；< 与 <= 交换操作数后用 a/ae，无序时为假
+        if (op == CmpInst::LT || op == CmpInst::LE) {
+            std::swap(a, b);
+            op = swapped(op);
+        }
+        MOperand lhs = reg_op(a);
+        emit(MInst::UCOMISS, {value_op(b), lhs});
+        switch (op) {
+            case CmpInst::GT: return Cond::A;
+            case CmpInst::GE: return Cond::AE;
+            case CmpInst::EQ: parity = 1; return Cond::E;
+            default: parity = 2; return Cond::NE;
+        }
+    }
+
+    // cmp 的第一个操作数不能是立即数
+    if (dynamic_cast<ConstantInt *>(a) && !dynamic_cast<ConstantInt *>(b)) {
+        std::swap(a, b);
+        op = swapped(op);
+    }
+    MOperand lhs = reg_op(a);
+    emit(MInst::CMP, {value_op(b), lhs}, lhs.size);
+    return int_cond(op);
+}
+
+bool X86ISel::is_fused_cmp(Instruction *instr) const {
+    auto uses = instr->get_use_list();
+    auto it = uses.begin();
+    if (it == uses.end()) return false;
+    auto user = dynamic_cast<Instruction *>((*it).val_);
+    if (++it != uses.end()) return false;
+    return user != nullptr && user->is_br() && user->get_parent() == instr->get_parent() &&
+           user == instr->get_parent()->get_terminator();
+}
+
+void X86ISel::lower_cmp(CmpInst *cmp) {
+    // 只被本块条件跳转使用的比较在跳转处生成
+    if (is_fused_cmp(cmp)) return;
+    int parity;
+    Cond cc = emit_compare(cmp, parity);
+    int d = vreg_of(cmp);
+    emit(MInst::SETCC, {reg(d, 1)}).cc = cc;
+    emit(MInst::MOVZX, {reg(d, 1), reg(d, 4)});
+    if (parity != 0) {
+        // == 还要求有序，!= 在无序时也为真
+        int t = mf_->new_vreg(RegClass::GPR);
+        emit(MInst::SETCC, {reg(t, 1)}).cc = parity == 1 ? Cond::NP : Cond::P;
+        emit(MInst::MOVZX, {reg(t, 1), reg(t, 4)});
+        emit(parity == 1 ? MInst::AND : MInst::OR, {reg(t, 4), reg(d, 4)});
+    }
+}
+
+void X86ISel::emit_phi_copies(BasicBlock *from, BasicBlock *to) {
+    for (auto instr: to->get_instructions()) {
+        if (!instr->is_phi()) continue;
+        for (unsigned i = 0; i + 1 < instr->get_num_operand(); i += 2) {
+            if (instr->get_operand(i + 1) != from) continue;
+            auto it = phi_temps_.find(instr);
+            if (it == phi_temps_.end()) {
+                it = phi_temps_.emplace(instr, mf_->new_vreg(class_of(instr->get_type()))).first;
+            }
+            Value *v = instr->get_operand(i);
+            copy(value_op(v), reg(it->second, width_of(instr->get_type())), class_of(instr->get_type()));
+            break;
+        }
+    }
+}
+
+void X86ISel::lower_br(Instruction *instr) {
+    auto br = static_cast<BranchInst *>(instr);
+    BasicBlock *bb = instr->get_parent();
+    if (!br->is_cond_br()) {
+        BasicBlock *target = br->getTrueBB();
+        emit_phi_copies(bb, target);
+        emit(MInst::JMP, {MOperand::make_block(block_index_.at(target))});
+        return;
+    }
+
+    BasicBlock *t = br->getTrueBB();
+    BasicBlock *f = br->getFalseBB();
+    emit_phi_copies(bb, t);
+    if (f != t) emit_phi_copies(bb, f);
+    MOperand tb = MOperand::make_block(block_index_.at(t));
+    MOperand fb = MOperand::make_block(block_index_.at(f));
+
+    Value *cond = br->get_condition();
+    if (auto ci = dynamic_cast<ConstantInt *>(cond)) {
+        emit(MInst::JMP, {ci->get_value() ? tb : fb});
+        return;
+    }
+    auto cmp = dynamic_cast<CmpInst *>(cond);
+    if (cmp && is_fused_cmp(cmp)) {
+        int parity;
+        Cond cc = emit_compare(cmp, parity);
+        if (parity == 1) {
+            emit(MInst::JCC, {fb}).cc = Cond::P;
+        } else if (parity == 2) {
+            emit(MInst::JCC, {tb}).cc = Cond::P;
+        }
+        emit(MInst::JCC, {tb}).cc = cc;
+    } else {
+        MOperand c = reg_op(cond);
+        emit(MInst::TEST, {c, c});
+        emit(MInst::JCC, {tb}).cc = Cond::NE;
+    }
+    emit(MInst::JMP, {fb});
+}
+
+void X86ISel::lower_call(Instruction *instr) {
+    auto func = static_cast<Function *>(instr->get_operand(0));
+    int ni = 0, nf = 0, stack = 0;
+    std::vector<std::pair<MOperand, MOperand>> moves;
+    std::vector<RegClass> classes;
+    for (unsigned i = 1; i < instr->get_num_operand(); i++) {
+        Value *v = instr->get_operand(i);
+        Type *ty = v->get_type();
+        RegClass cls = class_of(ty);
+        MOperand src = value_op(v);
+        if (cls == RegClass::XMM && nf < kNumFloatArgRegs) {
+            moves.emplace_back(src, reg(XMM0 + nf++, 4));
+            classes.push_back(cls);
+        } else if (cls == RegClass::GPR && ni < kNumIntArgRegs) {
+            moves.emplace_back(src, reg(kIntArgRegs[ni++], width_of(ty)));
+            classes.push_back(cls);
+        } else {
+            MOperand dst = MOperand::make_mem(RSP, 8 * stack++);
+            dst.size = width_of(ty);
+            if (src.is_mem()) src = reg_op(v);
+            copy(src, dst, cls);
+        }
+    }
+    mf_->outgoing_size = std::max(mf_->outgoing_size, 8 * stack);
+
+    // 参数寄存器最后才写，其间不再生成别的代码
+    std::vector<int> uses;
+    for (size_t i = 0; i < moves.size(); i++) {
+        copy(moves[i].first, moves[i].second, classes[i]);
+        uses.push_back(moves[i].second.reg);
+    }
+    MInst &call = emit(MInst::CALL, {MOperand::make_func(func->get_name())});
+    call.implicit_uses = uses;
+    call.implicit_defs = {RAX, RCX, RDX, RSI, RDI, R8, R9, R10, R11};
+    for (int x = XMM0; x <= XMM15; x++) call.implicit_defs.push_back(x);
+
+    Type *ret = instr->get_type();
+    if (!ret->is_void_type()) {
+        RegClass cls = class_of(ret);
+        int w = width_of(ret);
+        copy(reg(cls == RegClass::XMM ? XMM0 : RAX, w), reg(vreg_of(instr), w), cls);
+    }
+}
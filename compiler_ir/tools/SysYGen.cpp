@@ -0,0 +1,123 @@
+/*!
+ * @file SysYGen.cpp
+ * @brief Synthetic SysY workload generator
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#include "SysYGen.h"
+
+#include <algorithm>
+
+namespace {
+
+// Small xorshift PRNG: std:: distributions differ across standard libraries,
+// and workloads must be identical everywhere so timings stay comparable
+class Rng {
+public:
+    explicit Rng(uint32_t seed) : state(seed ? seed : 0x9e3779b9u) {}
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    int below(int n) { return static_cast<int>(next() % static_cast<uint32_t>(n)); }
+
+private:
+    uint32_t state;
+};
+
+class Generator {
+public:
+    Generator(const SysYGenOptions& o, std::string& out) : opt(o), out(out), rng(o.seed) {}
+
+    void run() {
+        globals();
+        for (int f = 0; f < opt.functions; f++) function(f);
+        out += "int main() {\n    return ";
+        out += opt.functions > 0 ? call(opt.functions) : "0";
+        out += ";\n}\n";
+    }
+
+private:
+    const SysYGenOptions& opt;
+    std::string& out;
+    Rng rng;
+
+    void globals() {
+        for (int g = 0; g < opt.globals; g++) {
+            std::string n = std::to_string(g);
+            out += "const int gc" + n + " = " + std::to_string(rng.below(1000)) + ";\n";
+            out += "int gv" + n + " = " + std::to_string(rng.below(1000)) + ";\n";
+            if (g % 4 == 0) {
+                out += "float gf" + n + " = " + std::to_string(rng.below(100)) + ".5;\n";
+            }
+        }
+        out += "\n";
+    }
+
+    // Operand usable inside function bodies: parameters, the local, a global or a literal
+    std::string leaf() {
+        switch (rng.below(5)) {
+            case 0: return "a";
+            case 1: return "b";
+            case 2: return "x";
+            case 3:
+                if (opt.globals > 0) {
+                    return (rng.below(2) ? "gc" : "gv") + std::to_string(rng.below(opt.globals));
+                }
+                return "a";
+            default: return std::to_string(1 + rng.below(97));
+        }
+    }
+
+    // Left-nested: each level wraps the previous one in parentheses
+    std::string nested(int depth) {
+        static const char* ops[] = {" + ", " - ", " * ", " % "};
+        std::string e = leaf();
+        for (int d = 0; d < depth; d++) {
+            int op = rng.below(4);
+            std::string rhs = op == 3 ? std::to_string(2 + rng.below(9)) : leaf();
+            e = "(" + e + ops[op] + rhs + ")";
+        }
+        return e;
+    }
+
+    std::string call(int f) {
+        std::string callee = "f" + std::to_string(f - 1);
+        return callee + "(" + std::to_string(f) + ", " + std::to_string(f * 3 + 1) + ")";
+    }
+
+    void function(int f) {
+        std::string n = std::to_string(f);
+        out += "int f" + n + "(int a, int b) {\n";
+        out += "    int x = a + b;\n";
+        out += "    float y = " + std::to_string(rng.below(10)) + ".25;\n";
+        out += "    x = " + nested(opt.exprDepth) + ";\n";
+        if (f > 0) {
+            // Call an earlier function so the call graph spans the program
+            out += "    x = x + f" + std::to_string(rng.below(f)) + "(x, b);\n";
+        }
+        if (opt.ifChain > 0) {
+            out += "    ";
+            for (int i = 0; i < opt.ifChain; i++) {
+                out += "if (x == " + std::to_string(i) + " || y > " + std::to_string(i) + ".0 && b != x) {\n";
+                out += "        x = " + nested(std::min(opt.exprDepth, 3)) + ";\n";
+                out += "    } else ";
+            }
+            out += "{\n        y = y * 2.0 + a;\n    }\n";
+        }
+        out += "    return x;\n}\n\n";
+    }
+};
+
+}  // namespace
+
+std::string generateSysY(const SysYGenOptions& options) {
+    std::string out;
+    Generator(options, out).run();
+    return out;
+}
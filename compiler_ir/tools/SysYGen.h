@@ -0,0 +1,35 @@
+/*!
+ * @file SysYGen.h
+ * @brief Synthetic SysY workload generator for benchmarks
+ * @version 1.0.0
+ * @date 2025
+ */
+
+#ifndef SYSYC_SYSYGEN_H
+#define SYSYC_SYSYGEN_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Shape of a generated program
+ *
+ * Programs only use the grammar SLRParser accepts: int/float globals and
+ * constants, functions with scalar parameters, assignments, nested
+ * if/else and calls to earlier functions. Output is deterministic for a
+ * given set of options.
+ */
+struct SysYGenOptions {
+    int functions = 16;     ///< Number of functions besides main
+    int exprDepth = 8;      ///< Parenthesis nesting of the main expression
+    int ifChain = 4;        ///< Length of the else-if chain in each function
+    int globals = 16;       ///< Global variables and constants (each)
+    uint32_t seed = 1;      ///< Seed for operators and literals
+};
+
+/**
+ * @brief Emit a complete SysY translation unit
+ */
+std::string generateSysY(const SysYGenOptions& options);
+
+#endif // SYSYC_SYSYGEN_H
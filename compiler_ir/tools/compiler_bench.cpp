@@ -0,0 +1,216 @@
+/*!
+ * @file compiler_bench.cpp
+ * @brief Throughput benchmark for the lexer, parser, IR generator and printer
+ * @version 1.0.0
+ * @date 2025
+ *
+ * usage: compiler_bench [--reps N] [--max-scale N] [--json] [files.sy...]
+ *
+ * Without files, runs the synthetic workloads from SysYGen at scales
+ * 1, 2, 4, ... max-scale so scaling curves can be compared across
+ * revisions. Each phase reports the fastest of N repetitions.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "IRGenerator.h"
+#include "SLRLexer.h"
+#include "SLRParser.h"
+#include "SysYGen.h"
+
+namespace {
+
+const char* const kUsage = "usage: compiler_bench [--reps N] [--max-scale N] [--json] [files.sy...]\n";
+
+/// True if all of text is a base-10 integer in [min, max]
+bool parseInt(const char* text, long min, long max, long& value) {
+    char* end;
+    errno = 0;
+    value = std::strtol(text, &end, 10);
+    return end != text && *end == '\0' && errno != ERANGE && value >= min && value <= max;
+}
+
+struct Workload {
+    std::string name;
+    std::string source;
+};
+
+struct Result {
+    std::string name;
+    size_t bytes = 0;
+    size_t tokens = 0;
+    double lexMs = 1e300;
+    double parseMs = 1e300;
+    double generateMs = 1e300;
+    double printMs = 1e300;
+    bool ok = true;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Workload families; each scales one dimension of the program
+std::vector<Workload> syntheticWorkloads(int maxScale) {
+    std::vector<Workload> w;
+    for (int scale = 1; scale <= maxScale; scale *= 2) {
+        std::string s = "@" + std::to_string(scale);
+        SysYGenOptions o;
+
+        o = SysYGenOptions();
+        o.functions = 256 * scale;
+        o.exprDepth = 4;
+        o.ifChain = 2;
+        w.push_back({"functions" + s, generateSysY(o)});
+
+        o = SysYGenOptions();
+        o.functions = 4;
+        o.exprDepth = 64 * scale;
+        o.ifChain = 0;
+        w.push_back({"deep-expr" + s, generateSysY(o)});
+
+        o = SysYGenOptions();
+        o.functions = 4;
+        o.exprDepth = 2;
+        o.ifChain = 32 * scale;
+        w.push_back({"if-chain" + s, generateSysY(o)});
+
+        o = SysYGenOptions();
+        o.functions = 1;
+        o.globals = 1024 * scale;
+        w.push_back({"globals" + s, generateSysY(o)});
+    }
+    return w;
+}
+
+Result run(const Workload& w, int reps) {
+    Result r;
+    r.name = w.name;
+    r.bytes = w.source.size();
+    SLRLexer lexer;
+    SLRParser parser;
+    std::ostringstream diag;
+    parser.setDiagnostics(diag);
+
+    for (int rep = 0; rep < reps && r.ok; rep++) {
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<Token> tokens = lexer.analyze(w.source);
+        r.lexMs = std::min(r.lexMs, elapsedMs(t0));
+        r.tokens = tokens.size();
+
+        t0 = std::chrono::steady_clock::now();
+        r.ok = parser.parse(tokens) && parser.getAST();
+        r.parseMs = std::min(r.parseMs, elapsedMs(t0));
+        if (!r.ok) break;
+
+        IRGenerator generator(w.name);
+        generator.setDiagnostics(diag);
+        t0 = std::chrono::steady_clock::now();
+        generator.generate(parser.getAST());
+        r.generateMs = std::min(r.generateMs, elapsedMs(t0));
+
+        t0 = std::chrono::steady_clock::now();
+        std::string ir = generator.print();
+        r.printMs = std::min(r.printMs, elapsedMs(t0));
+    }
+    return r;
+}
+
+void printTable(const std::vector<Result>& results) {
+    char line[200];
+    std::snprintf(line, sizeof(line), "%-16s %10s %9s %10s %10s %10s %10s %10s",
+                  "workload", "KiB", "tokens", "lex(ms)", "parse(ms)", "irgen(ms)", "print(ms)", "lex MB/s");
+    std::cout << line << std::endl;
+    for (const Result& r : results) {
+        if (!r.ok) {
+            std::cout << r.name << ": parse failed" << std::endl;
+            continue;
+        }
+        std::snprintf(line, sizeof(line), "%-16s %10.1f %9zu %10.3f %10.3f %10.3f %10.3f %10.1f",
+                      r.name.c_str(), r.bytes / 1024.0, r.tokens, r.lexMs, r.parseMs,
+                      r.generateMs, r.printMs, r.bytes / 1e3 / std::max(r.lexMs, 1e-6));
+        std::cout << line << std::endl;
+    }
+}
+
+void printJson(const std::vector<Result>& results) {
+    std::cout << "[";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::cout << (i ? ",\n " : "") << "{\"workload\":\"" << r.name << "\",\"ok\":" << (r.ok ? "true" : "false")
+                  << ",\"bytes\":" << r.bytes << ",\"tokens\":" << r.tokens;
+        if (r.ok) {
+            std::cout << ",\"lex_ms\":" << r.lexMs << ",\"parse_ms\":" << r.parseMs
+                      << ",\"generate_ms\":" << r.generateMs << ",\"print_ms\":" << r.printMs;
+        }
+        std::cout << "}";
+    }
+    std::cout << "]" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int reps = 5;
+    int maxScale = 8;
+    bool json = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--reps") || !std::strcmp(argv[i], "--max-scale")) {
+            const char* flag = argv[i];
+            long value;
+            if (i + 1 >= argc || !parseInt(argv[++i], 1, INT_MAX, value)) {
+                std::cerr << "compiler_bench: " << flag << " expects a positive integer\n" << kUsage;
+                return 1;
+            }
+            if (!std::strcmp(flag, "--reps")) {
+                reps = static_cast<int>(value);
+            } else {
+                maxScale = static_cast<int>(value);
+            }
+        } else if (!std::strcmp(argv[i], "--json")) {
+            json = true;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    std::vector<Workload> workloads;
+    if (files.empty()) {
+        workloads = syntheticWorkloads(maxScale);
+    }
+    for (const auto& path : files) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            std::cerr << "compiler_bench: cannot open " << path << std::endl;
+            return 1;
+        }
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        workloads.push_back({path, ss.str()});
+    }
+
+    // Build the shared lexer DFA and SLR tables before anything is timed
+    SLRParser::sharedTables();
+    SLRLexer::sharedTable();
+
+    std::vector<Result> results;
+    for (const Workload& w : workloads) results.push_back(run(w, reps));
+    if (json) {
+        printJson(results);
+    } else {
+        printTable(results);
+    }
+    bool ok = std::all_of(results.begin(), results.end(), [](const Result& r) { return r.ok; });
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+/*!
+ * @file dfa_tablegen.cpp
+ * @brief Build-time generator for the embedded lexer DFA table
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Runs the NFA -> DFA -> minimized DFA construction once and writes the
+ * resulting SLRDFATable as constexpr arrays that SLRLexer.cpp includes.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include "SLRLexer.h"
+
+template <typename T>
+static void writeArray(std::ostream& out, const char* type, const char* name, const T& values) {
+    out << "static constexpr " << type << " " << name << "[" << values.size() << "] = {";
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i % 16 == 0) out << "\n   ";
+        char num[16];
+        std::snprintf(num, sizeof(num), " %u,", static_cast<unsigned>(values[i]));
+        out << num;
+    }
+    out << "\n};\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <output.inc>" << std::endl;
+        return 1;
+    }
+
+    auto table = SLRLexer::buildDFA();
+    std::vector<uint8_t> acceptType;
+    for (TokenType type : table->acceptType) acceptType.push_back(static_cast<uint8_t>(type));
+
+    std::ofstream out(argv[1]);
+    if (!out.is_open()) {
+        std::cerr << "dfa_tablegen: cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+    out << "// Generated by dfa_tablegen from the SLRNFA token patterns. Do not edit.\n";
+    out << "static constexpr int kDFANumClasses = " << table->numClasses << ";\n";
+    writeArray(out, "uint8_t", "kDFAByteClass", table->byteClass);
+    writeArray(out, "uint16_t", "kDFANext", table->next);
+    writeArray(out, "uint8_t", "kDFAAccepting", table->accepting);
+    writeArray(out, "uint8_t", "kDFAAcceptType", acceptType);
+    return out.good() ? 0 : 1;
+}
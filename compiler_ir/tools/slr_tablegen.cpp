@@ -0,0 +1,39 @@
+/*!
+ * @file slr_tablegen.cpp
+ * @brief Build-time generator for the embedded SLR table
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Runs the SLR construction once and writes the serialized tables as a
+ * constexpr byte array that SLRParser.cpp includes.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include "SLRParser.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <output.inc>" << std::endl;
+        return 1;
+    }
+
+    std::vector<unsigned char> blob = SLRParser::buildTables()->serialize();
+
+    std::ofstream out(argv[1]);
+    if (!out.is_open()) {
+        std::cerr << "slr_tablegen: cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+    out << "// Generated by slr_tablegen from SLRParser::initGrammar(). Do not edit.\n";
+    out << "static constexpr unsigned char kSLRTableData[" << blob.size() << "] = {";
+    for (size_t i = 0; i < blob.size(); i++) {
+        if (i % 16 == 0) out << "\n   ";
+        char hex[8];
+        std::snprintf(hex, sizeof(hex), " 0x%02x,", blob[i]);
+        out << hex;
+    }
+    out << "\n};\n";
+    return out.good() ? 0 : 1;
+}
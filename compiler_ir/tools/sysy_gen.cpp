@@ -0,0 +1,91 @@
+/*!
+ * @file sysy_gen.cpp
+ * @brief Command-line front end for the synthetic SysY generator
+ * @version 1.0.0
+ * @date 2025
+ *
+ * usage: sysy_gen [--functions N] [--depth N] [--if-chain N] [--globals N]
+ *                 [--seed N] [-o out.sy]
+ */
+
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "SysYGen.h"
+
+namespace {
+
+const char* const kUsage =
+    "usage: sysy_gen [--functions N] [--depth N] [--if-chain N] [--globals N]\n"
+    "                [--seed N] [-o out.sy]\n";
+
+/// True if all of text is a base-10 integer in [min, max]
+bool parseInt(const char* text, long min, long max, long& value) {
+    char* end;
+    errno = 0;
+    value = std::strtol(text, &end, 10);
+    return end != text && *end == '\0' && errno != ERANGE && value >= min && value <= max;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    SysYGenOptions opt;
+    const char* output = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            std::cerr << "sysy_gen: missing value for " << argv[i] << "\n" << kUsage;
+            return 1;
+        }
+        const char* flag = argv[i];
+        const char* value = argv[++i];
+        int* count = nullptr;
+        if (!std::strcmp(flag, "--functions")) {
+            count = &opt.functions;
+        } else if (!std::strcmp(flag, "--depth")) {
+            count = &opt.exprDepth;
+        } else if (!std::strcmp(flag, "--if-chain")) {
+            count = &opt.ifChain;
+        } else if (!std::strcmp(flag, "--globals")) {
+            count = &opt.globals;
+        }
+        long number;
+        if (count) {
+            if (!parseInt(value, 0, INT_MAX, number)) {
+                std::cerr << "sysy_gen: " << flag << " expects a non-negative integer, got '" << value << "'\n"
+                          << kUsage;
+                return 1;
+            }
+            *count = static_cast<int>(number);
+        } else if (!std::strcmp(flag, "--seed")) {
+            if (!parseInt(value, 0, UINT32_MAX, number)) {
+                std::cerr << "sysy_gen: --seed expects an integer in [0, " << UINT32_MAX << "], got '" << value
+                          << "'\n" << kUsage;
+                return 1;
+            }
+            opt.seed = static_cast<uint32_t>(number);
+        } else if (!std::strcmp(flag, "-o")) {
+            output = value;
+        } else {
+            std::cerr << "sysy_gen: unknown option " << flag << "\n" << kUsage;
+            return 1;
+        }
+    }
+
+    std::string program = generateSysY(opt);
+    if (!output) {
+        std::cout << program;
+        return 0;
+    }
+    std::ofstream out(output);
+    if (!out.is_open()) {
+        std::cerr << "sysy_gen: cannot open " << output << std::endl;
+        return 1;
+    }
+    out << program;
+    return out.good() ? 0 : 1;
+}